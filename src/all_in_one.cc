@@ -14,13 +14,21 @@
 #include "libs/ntest.cpp"
 
 #include "analytics.cpp"
+#include "basic_dirent.cpp"
+#include "bulk_rename.cpp"
 #include "debug_log.cpp"
+#include "directory_jump.cpp"
+#include "directory_jump_index.cpp"
+#include "directory_listing_cache.cpp"
+#include "directory_size.cpp"
+#include "disk_usage.cpp"
 #include "drop_target.cpp"
 #include "explorer.cpp"
 #include "explorer_drop_source.cpp"
 #include "explorer_file_op_progress_sink.cpp"
 #include "file_operations.cpp"
 #include "finder.cpp"
+#include "finder_search.cpp"
 #include "icon_glyphs.cpp"
 #include "icon_library.cpp"
 #include "imgui_dependent_functions.cpp"
@@ -30,21 +38,32 @@
 #include "miscellaneous_functions.cpp"
 #include "miscellaneous_globals.cpp"
 #include "path.cpp"
+#include "persistence.cpp"
+#include "profiler.cpp"
 #include "pinned.cpp"
+#include "platform_posix.cpp"
+#include "platform_win32.cpp"
 #include "popup_modal_bulk_rename.cpp"
 #include "popup_modal_edit_pin.cpp"
 #include "popup_modal_error.cpp"
+#include "popup_modal_mirror.cpp"
 #include "popup_modal_new_directory.cpp"
 #include "popup_modal_new_file.cpp"
 #include "popup_modal_new_pin.cpp"
 #include "popup_modal_single_rename.cpp"
+#include "prefetch.cpp"
 #include "recent_files.cpp"
 #include "settings.cpp"
+#include "shortcut_cache.cpp"
+#include "state_snapshot.cpp"
+#include "state_snapshot_format.cpp"
 #include "stdafx.cpp"
 #include "style.cpp"
 #include "swan_glfw_opengl3.cpp"
 // #include "swan_win32_dx11.cpp"
 #include "tests.cpp"
+#include "tests_core_engines.cpp"
+#include "tests_platform.cpp"
 #include "theme_editor.cpp"
 #include "undelete_directory_progress_sink.cpp"
 #include "util.cpp"
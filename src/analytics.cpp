@@ -2,6 +2,148 @@
 #include "common_functions.hpp"
 #include "imgui_dependent_functions.hpp"
 
+#if SWAN_PROFILER
+
+static
+ImU32 profiler_zone_color(u32 zone_id) noexcept
+{
+    // spread neighbouring ids across the hue circle, keep them dark enough for white text
+    f32 hue = f32(u32(zone_id * 2654435761u) >> 8) / f32(1 << 24);
+    ImVec4 color = ImColor::HSV(hue, 0.55f, 0.65f);
+    return imgui::ColorConvertFloat4ToU32(color);
+}
+
+/// One lane per thread, one row per nesting depth, x axis spans the latest frame.
+static
+void render_profiler_flame_view(profiler_frame const &frame) noexcept
+{
+    if (frame.events.empty() || frame.end_ns <= frame.start_ns) {
+        imgui::TextUnformatted("No zones recorded in the latest frame.");
+        return;
+    }
+
+    auto draw_list = imgui::GetWindowDrawList();
+    f32 const row_height = imgui::GetTextLineHeight() + 2;
+    f32 const width = std::max(imgui::GetContentRegionAvail().x, 100.0f);
+    f64 const ns_per_px = f64(frame.end_ns - frame.start_ns) / f64(width);
+    ImVec2 const mouse = imgui::GetMousePos();
+
+    u64 lane_begin = 0;
+
+    while (lane_begin < frame.events.size()) {
+        u16 thread_idx = frame.events[lane_begin].thread_idx;
+        u64 lane_end = lane_begin;
+        u16 max_depth = 0;
+
+        for (; lane_end < frame.events.size() && frame.events[lane_end].thread_idx == thread_idx; ++lane_end) {
+            max_depth = std::max(max_depth, frame.events[lane_end].depth);
+        }
+
+        imgui::TextUnformatted(profiler_thread_name(thread_idx));
+
+        ImVec2 origin = imgui::GetCursorScreenPos();
+        ImVec2 lane_size = ImVec2(width, row_height * f32(max_depth + 1));
+        imgui::Dummy(lane_size);
+
+        draw_list->AddRectFilled(origin, origin + lane_size, imgui::GetColorU32(ImGuiCol_FrameBg));
+
+        for (u64 i = lane_begin; i < lane_end; ++i) {
+            auto const &event = frame.events[i];
+
+            u64 clipped_start_ns = std::max(event.start_ns, frame.start_ns);
+            u64 clipped_end_ns = std::min(event.start_ns + event.duration_ns, frame.end_ns);
+
+            ImVec2 min = origin + ImVec2(f32(f64(clipped_start_ns - frame.start_ns) / ns_per_px), row_height * event.depth);
+            ImVec2 max = ImVec2(std::max(origin.x + f32(f64(clipped_end_ns - frame.start_ns) / ns_per_px), min.x + 1), min.y + row_height - 1);
+
+            char const *name = profiler_zone_name(event.zone_id);
+
+            draw_list->AddRectFilled(min, max, profiler_zone_color(event.zone_id));
+
+            if (max.x - min.x > imgui::CalcTextSize(name).x + 4) {
+                draw_list->PushClipRect(min, max, true);
+                draw_list->AddText(min + ImVec2(2, 1), IM_COL32_WHITE, name);
+                draw_list->PopClipRect();
+            }
+
+            if (imgui::IsWindowHovered() && ImRect(min, max).Contains(mouse)) {
+                imgui::SetTooltip("%s\n%.1f us", name, f64(event.duration_ns) / 1000.0);
+            }
+        }
+
+        lane_begin = lane_end;
+    }
+}
+
+static
+void render_profiler() noexcept
+{
+    static std::vector<profiler_zone_summary> s_summaries = {};
+    static time_point_precise_t s_last_summary_time = {};
+
+    auto const &frame = profiler_last_frame();
+
+    imgui::Checkbox("Pause", &profiler_paused());
+    imgui::SameLineSpaced(2);
+    imgui::Text("Frame: %.3f ms, %zu zones", f64(frame.end_ns - frame.start_ns) / 1'000'000.0, frame.events.size());
+    imgui::SameLineSpaced(2);
+    imgui::Text("Dropped: %zu", profiler_num_events_dropped());
+
+    {
+        s32 history_seconds = s32(profiler_history_seconds());
+
+        if (imgui::Button("Export trace")) {
+            auto file_name = make_str("trace_%lld.json", std::chrono::system_clock::now().time_since_epoch() / std::chrono::seconds(1));
+            profiler_export_chrome_trace(global_state::execution_path() / "traces" / file_name);
+        }
+        if (imgui::IsItemHovered()) {
+            imgui::SetTooltip("Chrome Trace Event JSON, open with ui.perfetto.dev or chrome://tracing.\n"
+                              "Written to [traces] next to the executable, see the debug log.");
+        }
+        imgui::SameLine();
+        imgui::SetNextItemWidth(imgui::CalcTextSize("_").x * 20);
+        if (imgui::SliderInt("seconds of history", &history_seconds, 1, s32(profiler_history::MAX_SECONDS))) {
+            profiler_set_history_seconds(u32(history_seconds));
+        }
+    }
+
+    render_profiler_flame_view(frame);
+
+    if (s_summaries.empty() || time_diff_ms(s_last_summary_time, get_time_precise()) >= 500) {
+        s_summaries = profiler_zone_summaries();
+        s_last_summary_time = get_time_precise();
+    }
+
+    ImGuiTableFlags table_flags = ImGuiTableFlags_Borders|ImGuiTableFlags_RowBg|ImGuiTableFlags_SizingFixedFit|ImGuiTableFlags_ScrollY;
+
+    if (imgui::BeginTable("## profiler_zones", 7, table_flags, ImVec2(0, imgui::GetTextLineHeightWithSpacing() * 12))) {
+        imgui::TableSetupScrollFreeze(0, 1);
+        imgui::TableSetupColumn("Zone", ImGuiTableColumnFlags_WidthStretch);
+        imgui::TableSetupColumn("Calls");
+        imgui::TableSetupColumn("Calls (frame)");
+        imgui::TableSetupColumn("us (frame)");
+        imgui::TableSetupColumn("p50 us");
+        imgui::TableSetupColumn("p95 us");
+        imgui::TableSetupColumn("p99 us");
+        imgui::TableHeadersRow();
+
+        for (auto const &summary : s_summaries) {
+            imgui::TableNextRow();
+            imgui::TableNextColumn(); imgui::TextUnformatted(summary.name);
+            imgui::TableNextColumn(); imgui::Text("%zu", summary.num_calls_total);
+            imgui::TableNextColumn(); imgui::Text("%u", summary.num_calls_last_frame);
+            imgui::TableNextColumn(); imgui::Text("%.1f", summary.total_us_last_frame);
+            imgui::TableNextColumn(); imgui::Text("%.1f", summary.p50_us);
+            imgui::TableNextColumn(); imgui::Text("%.1f", summary.p95_us);
+            imgui::TableNextColumn(); imgui::Text("%.1f", summary.p99_us);
+        }
+
+        imgui::EndTable();
+    }
+}
+
+#endif // SWAN_PROFILER
+
 bool swan_windows::render_analytics(std::array<swan_windows::id, (u64)swan_windows::id::count - 1> const &window_render_order) noexcept
 {
     if (imgui::Begin(swan_windows::get_name(swan_windows::id::analytics), &global_state::settings().show.analytics)) {
@@ -15,6 +157,40 @@ bool swan_windows::render_analytics(std::array<swan_windows::id, (u64)swan_windo
 
         imgui::Separator();
 
+        {
+            auto const &startup = global_state::startup_timings_get();
+
+            imgui::Text("Time to first frame: %.1f ms", startup.time_to_first_frame_ms);
+            imgui::Text("State snapshot: %zu bytes, %u sections fresh, decoded in %.0f us off the main thread, waited %.0f us for it",
+                        startup.state_snapshot_size, startup.num_sections_from_snapshot, startup.state_snapshot_load_us, startup.state_snapshot_wait_us);
+            imgui::Text("Text files: %u sections, loaded in %.0f us (explorers excluded)", startup.num_sections_from_text, startup.text_fallback_us);
+            imgui::Text("Explorers initialized in %.0f us", startup.explorers_init_us);
+        }
+
+        imgui::Separator();
+
+        {
+            auto const &loop = global_state::render_loop_stats_get();
+
+            imgui::Text("Render loop: %.0f frames/s, %.0f%% of the time waiting for events", loop.frames_per_second, loop.waiting_percent);
+            imgui::Text("CPU: %.1f%% of one core", loop.cpu_percent);
+            imgui::SameLineSpaced(2);
+            if (loop.idle_cpu_percent < 0) {
+                imgui::TextUnformatted("Idle CPU: not idle yet");
+            } else {
+                imgui::Text("Idle CPU: %.1f%%", loop.idle_cpu_percent);
+            }
+            imgui::Text("%zu frames, %zu waits, woken by input %zu, by workers %zu, by timeout %zu",
+                        loop.num_frames_total, loop.num_waits_total, loop.num_wakes_by_input, loop.num_wakes_by_workers, loop.num_wakes_by_timeout);
+        }
+
+#if SWAN_PROFILER
+        imgui::Separator();
+        render_profiler();
+#endif
+
+        imgui::Separator();
+
         imgui::Text("IsMouseClicked(left): %d", imgui::IsMouseClicked(ImGuiMouseButton_Left));
         imgui::Text("IsMouseDown(left): %d", imgui::IsMouseDown(ImGuiMouseButton_Left));
         imgui::Text("IsMouseDragging(left): %d", imgui::IsMouseDragging(ImGuiMouseButton_Left));
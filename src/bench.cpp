@@ -0,0 +1,769 @@
+/*
+    Headless benchmarks of the core engines (core.hpp), built as the `swan_bench` target from the core's sources alone,
+    on Windows and with GCC/Clang alike. No window, GPU context or ImGui context is created.
+
+    swan_bench [--root <dir>] [--out <file.json>] [--only <substring>] [--iterations <n>] [--regenerate]
+               [--seed <n>] [--depth <n>] [--fan-out <n>] [--files-per-dir <n>] [--wide-files <n>]
+               [--symlink-percent <n>] [--max-file-size <bytes>]
+
+    A deterministic directory tree is generated under --root, or reused if it was generated with the same parameters.
+    Each benchmark runs --iterations times after a warmup run. Results are printed to stdout (or written to --out) as JSON,
+    progress goes to stderr. Diff two result files to compare commits.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#if defined(_WIN32)
+#   define NOMINMAX
+#   include <windows.h>
+#   include <winioctl.h>
+#else
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+#include "core.hpp"
+
+static
+std::string bench_utf8(std::filesystem::path const &path) noexcept
+{
+#if defined(_WIN32)
+    char utf8[MAX_PATH * 4]; cstr_clear(utf8);
+    (void) utf16_to_utf8(path.c_str(), utf8, lengthof(utf8));
+    return utf8;
+#else
+    return path.string(); // POSIX paths are bytes, UTF-8 ones here
+#endif
+}
+
+static
+std::filesystem::path bench_path(std::string const &utf8) noexcept
+{
+#if defined(_WIN32)
+    wchar_t utf16[MAX_PATH * 2]; cstr_clear(utf16);
+    (void) utf8_to_utf16(utf8.c_str(), utf16, lengthof(utf16));
+    return utf16;
+#else
+    return utf8;
+#endif
+}
+
+/// SplitMix64, so the generated tree is identical on every machine and standard library.
+struct bench_rng
+{
+    u64 state;
+
+    u64 next() noexcept
+    {
+        u64 z = (this->state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    u64 below(u64 n) noexcept { return n == 0 ? 0 : this->next() % n; }
+
+    bool chance_percent(u64 percent) noexcept { return this->below(100) < percent; }
+
+    /// Log-uniform in [1, max], most values are small with a long tail, like real file sizes.
+    u64 log_uniform(u64 max) noexcept
+    {
+        f64 unit = f64(this->next() >> 11) / f64(u64(1) << 53);
+        return std::max(u64(1), u64(std::pow(f64(max), unit)));
+    }
+};
+
+struct bench_tree_config
+{
+    u64 seed = 1;
+    u32 depth = 3;              // levels of subdirectories below the root
+    u32 fan_out = 6;            // subdirectories per directory, above the deepest level
+    u32 files_per_dir = 100;
+    u32 wide_files = 20'000;    // files in the single [wide] directory used for enumeration, sort and filter
+    u32 symlink_percent = 2;    // of files which are created as symlinks instead, a quarter of them dangling
+    u64 max_file_size = u64(1) << 20;
+
+    std::string to_string() const noexcept
+    {
+        return make_str("swan_bench_tree 1 seed=%zu depth=%u fan_out=%u files_per_dir=%u wide_files=%u symlink_percent=%u max_file_size=%zu",
+                        this->seed, this->depth, this->fan_out, this->files_per_dir, this->wide_files, this->symlink_percent, this->max_file_size);
+    }
+};
+
+struct bench_tree
+{
+    std::filesystem::path root = {};
+    std::filesystem::path wide_dir = {};
+    std::vector<std::filesystem::path> directories = {};
+    u64 num_files = 0;
+    u64 num_symlinks = 0;
+    u64 num_symlinks_failed = 0; // creating symlinks needs Developer Mode or elevation on Windows
+    u64 total_bytes = 0;
+    bool reused = false;
+};
+
+/// Name stems drawn from a few distributions seen in real directories.
+static
+std::string bench_generate_name(bench_rng &rng) noexcept
+{
+    static char const *s_words[] = {
+        "report", "draft", "final", "notes", "backup", "photo", "invoice", "budget", "scan", "readme",
+        "config", "data", "export", "archive", "image", "video", "track", "chapter", "build", "log",
+    };
+    static char const *s_unicode[] = {
+        "r\xc3\xa9sum\xc3\xa9", "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e", "\xce\xa9mega", "stra\xc3\x9f" "e", "\xd0\xbc\xd0\xb8\xd1\x80",
+    };
+    static char const *s_extensions[] = {
+        ".txt", ".jpg", ".JPG", ".png", ".pdf", ".docx", ".cpp", ".hpp", ".mp4", ".zip", ".json", "", ".tar.gz",
+    };
+
+    std::string name = {};
+    u64 kind = rng.below(100);
+
+    if (kind < 50) { // word_word
+        name += s_words[rng.below(lengthof(s_words))];
+        name += '_';
+        name += s_words[rng.below(lengthof(s_words))];
+    }
+    else if (kind < 70) { // camera and numbered sequences
+        name += make_str("IMG_%05zu", rng.below(100'000));
+    }
+    else if (kind < 85) { // long names
+        u64 len = 60 + rng.below(60);
+        for (u64 i = 0; i < len; ++i) {
+            name += char('a' + rng.below(26));
+        }
+    }
+    else if (kind < 95) { // non-ASCII
+        name += s_unicode[rng.below(lengthof(s_unicode))];
+        name += make_str(" %zu", rng.below(1000));
+    }
+    else { // spaces and dots
+        name += make_str("%s. %s v%zu.%zu", s_words[rng.below(lengthof(s_words))], s_words[rng.below(lengthof(s_words))], rng.below(10), rng.below(10));
+    }
+
+    name += s_extensions[rng.below(lengthof(s_extensions))];
+
+    return name;
+}
+
+static
+u64 bench_generate_file_size(bench_rng &rng, u64 max_file_size) noexcept
+{
+    u64 kind = rng.below(100);
+
+    if (kind < 30) return 0;
+    if (kind < 98) return rng.log_uniform(std::min(max_file_size, u64(64 * 1024)));
+    return rng.log_uniform(max_file_size);
+}
+
+/// Creates a sparse file of `size` bytes, so large trees take no real disk space.
+static
+bool bench_create_file(std::filesystem::path const &path, u64 size) noexcept
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    bool success = true;
+
+    if (size > 0) {
+        DWORD bytes_returned = 0;
+        (void) DeviceIoControl(file, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &bytes_returned, nullptr);
+
+        LARGE_INTEGER end = {};
+        end.QuadPart = s64(size);
+        success = SetFilePointerEx(file, end, nullptr, FILE_BEGIN) && SetEndOfFile(file);
+    }
+
+    CloseHandle(file);
+    return success;
+#else
+    s32 fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        return false;
+    }
+
+    bool success = ftruncate(fd, off_t(size)) == 0; // the extended range is a hole
+    close(fd);
+    return success;
+#endif
+}
+
+static
+bool bench_create_symlink(std::filesystem::path const &path, std::string const &target_utf8) noexcept
+{
+#if defined(_WIN32)
+    return CreateSymbolicLinkW(path.c_str(), bench_path(target_utf8).c_str(), SYMBOLIC_LINK_FLAG_ALLOW_UNPRIVILEGED_CREATE);
+#else
+    return symlink(target_utf8.c_str(), path.c_str()) == 0;
+#endif
+}
+
+static
+void bench_populate_directory(bench_tree &tree, bench_tree_config const &config, bench_rng &rng,
+                              std::filesystem::path const &dir, u32 num_files) noexcept
+{
+    std::unordered_set<std::string> names_taken = {};
+    std::vector<std::string> file_names = {};
+
+    for (u32 i = 0; i < num_files; ++i) {
+        std::string name = bench_generate_name(rng);
+        // names are compared case-insensitively on Windows, resolve collisions by appending the index, on every platform alike
+        std::string key = name;
+        std::transform(key.begin(), key.end(), key.begin(), [](char ch) noexcept { return char(tolower(u8(ch))); });
+        if (!names_taken.insert(key).second) {
+            name += make_str(" (%u)", i);
+        }
+
+        std::filesystem::path path = dir / bench_path(name);
+
+        if (!file_names.empty() && rng.chance_percent(config.symlink_percent)) {
+            bool dangling = rng.below(4) == 0;
+            std::string target = dangling ? "does_not_exist_" + name : file_names[rng.below(file_names.size())];
+
+            if (bench_create_symlink(path, target)) {
+                ++tree.num_symlinks;
+            } else {
+                ++tree.num_symlinks_failed;
+            }
+            continue;
+        }
+
+        u64 size = bench_generate_file_size(rng, config.max_file_size);
+
+        if (bench_create_file(path, size)) {
+            ++tree.num_files;
+            tree.total_bytes += size;
+            file_names.push_back(std::move(name));
+        }
+    }
+}
+
+static
+void bench_generate_subtree(bench_tree &tree, bench_tree_config const &config, bench_rng &rng,
+                            std::filesystem::path const &dir, u32 level) noexcept
+{
+    tree.directories.push_back(dir);
+    bench_populate_directory(tree, config, rng, dir, config.files_per_dir);
+
+    if (level == config.depth) {
+        return;
+    }
+
+    for (u32 i = 0; i < config.fan_out; ++i) {
+        std::filesystem::path sub_dir = dir / make_str("dir_%u_%zu", i, rng.below(1'000'000)); // short, keeps deep paths under MAX_PATH
+        std::error_code ec = {};
+        if (std::filesystem::create_directory(sub_dir, ec)) {
+            bench_generate_subtree(tree, config, rng, sub_dir, level + 1);
+        }
+    }
+}
+
+/// Generates the tree described by `config` under `root`, unless the marker file says it is already there.
+static
+bench_tree bench_generate_tree(std::filesystem::path const &root, bench_tree_config const &config, bool force) noexcept
+try {
+    bench_tree tree = {};
+    tree.root = root;
+    tree.wide_dir = root / "wide";
+
+    std::filesystem::path marker_path = root / "swan_bench_tree.txt";
+    std::string const marker = config.to_string();
+
+    if (!force) {
+        std::ifstream marker_file(marker_path);
+        std::string existing_marker = {};
+        std::getline(marker_file, existing_marker);
+
+        if (existing_marker == marker) {
+            tree.reused = true;
+            tree.directories.push_back(root / "tree");
+
+            for (auto it = std::filesystem::recursive_directory_iterator(root); it != std::filesystem::recursive_directory_iterator(); ++it) {
+                if (it->is_symlink()) {
+                    ++tree.num_symlinks;
+                } else if (it->is_directory()) {
+                    if (it->path() != tree.wide_dir && it->path() != tree.directories.front()) {
+                        tree.directories.push_back(it->path());
+                    }
+                } else if (it->path() != marker_path) {
+                    ++tree.num_files;
+                    tree.total_bytes += it->file_size();
+                }
+            }
+            tree.directories.push_back(tree.wide_dir); // last, as when generated
+
+            return tree;
+        }
+    }
+
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(tree.wide_dir);
+    std::filesystem::create_directories(root / "tree");
+
+    bench_rng rng = { config.seed };
+
+    bench_generate_subtree(tree, config, rng, root / "tree", 0);
+
+    tree.directories.push_back(tree.wide_dir);
+    bench_populate_directory(tree, config, rng, tree.wide_dir, config.wide_files);
+
+    std::ofstream(marker_path) << marker << '\n';
+
+    return tree;
+}
+catch (std::exception const &except) {
+    fprintf(stderr, "failed to generate tree: %s\n", except.what());
+    return {};
+}
+
+struct bench_result
+{
+    std::string name;
+    u64 num_items;
+    std::vector<f64> samples_us;
+};
+
+struct bench_context
+{
+    std::vector<bench_result> results = {};
+    char const *only = nullptr;
+    u32 iterations = 10;
+};
+
+/// Runs `body` once to warm up, then `context.iterations` times, calling the untimed `setup` before every run.
+template <typename Setup, typename Body>
+void bench_run(bench_context &context, char const *name, u64 num_items, Setup setup, Body body) noexcept
+{
+    if (context.only && !strstr(name, context.only)) {
+        return;
+    }
+
+    fprintf(stderr, "%s ...\n", name);
+
+    bench_result result = { name, num_items, {} };
+
+    for (u32 i = 0; i <= context.iterations; ++i) {
+        setup();
+
+        auto start = get_time_precise();
+        body();
+        f64 elapsed_us = f64(time_diff_us(start, get_time_precise()));
+
+        if (i > 0) {
+            result.samples_us.push_back(elapsed_us);
+        }
+    }
+
+    context.results.push_back(std::move(result));
+}
+
+static
+void bench_append_json_string(std::string &out, std::string_view str) noexcept
+{
+    out += '"';
+    for (char ch : str) {
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+        }
+        if (u8(ch) >= 0x20) {
+            out += ch;
+        }
+    }
+    out += '"';
+}
+
+static
+std::string bench_results_to_json(bench_context const &context, bench_tree_config const &config, bench_tree const &tree) noexcept
+{
+    std::string out = {};
+
+    out += "{\n  \"swan_bench\": 1,\n  \"build\": ";
+    bench_append_json_string(out, get_build_mode().str);
+    out += make_str(",\n  \"hardware_concurrency\": %u,\n  \"iterations\": %u,\n  \"tree\": {\"config\": ",
+                    std::thread::hardware_concurrency(), context.iterations);
+    bench_append_json_string(out, config.to_string());
+    out += make_str(", \"directories\": %zu, \"files\": %zu, \"symlinks\": %zu, \"symlinks_failed\": %zu, \"bytes\": %zu, \"reused\": %s},\n",
+                    tree.directories.size(), tree.num_files, tree.num_symlinks, tree.num_symlinks_failed, tree.total_bytes, tree.reused ? "true" : "false");
+    out += "  \"results\": [\n";
+
+    for (u64 i = 0; i < context.results.size(); ++i) {
+        auto const &result = context.results[i];
+        std::vector<f64> sorted = result.samples_us;
+        std::sort(sorted.begin(), sorted.end());
+
+        f64 median_us = sorted.empty() ? 0 : sorted[sorted.size() / 2];
+        f64 mean_us = sorted.empty() ? 0 : std::accumulate(sorted.begin(), sorted.end(), 0.0) / f64(sorted.size());
+        f64 items_per_second = median_us > 0 ? f64(result.num_items) / (median_us / 1'000'000.0) : 0;
+
+        out += "    {\"name\": ";
+        bench_append_json_string(out, result.name);
+        out += make_str(", \"items\": %zu, \"min_us\": %.1f, \"median_us\": %.1f, \"mean_us\": %.1f, \"max_us\": %.1f, \"items_per_second\": %.0f}%s\n",
+                        result.num_items, sorted.empty() ? 0 : sorted.front(), median_us, mean_us, sorted.empty() ? 0 : sorted.back(),
+                        items_per_second, i + 1 < context.results.size() ? "," : "");
+    }
+
+    out += "  ]\n}\n";
+
+    return out;
+}
+
+/// The entries of `listing` as an explorer holds them, ids in enumeration order.
+static
+std::vector<listed_dirent> bench_listed_dirents(directory_listing_cache::listing const &listing) noexcept
+{
+    std::vector<listed_dirent> dirents = {};
+    dirents.reserve(listing.entries.size());
+
+    for (auto const &entry : listing.entries) {
+        std::string_view name = listing.name(entry);
+
+        listed_dirent dirent = {};
+        dirent.basic.id = u32(dirents.size());
+        dirent.basic.size = entry.size;
+        dirent.basic.creation_time_raw = entry.creation_time_raw;
+        dirent.basic.last_write_time_raw = entry.last_write_time_raw;
+        dirent.basic.type = entry.type;
+        dirent.basic.path = path_create(name.data(), name.size());
+        dirents.push_back(dirent);
+    }
+
+    return dirents;
+}
+
+static
+void bench_listing(bench_context &context, bench_tree const &tree) noexcept
+{
+    directory_listing_cache::listing listing = {};
+    std::string const wide_dir = bench_utf8(tree.wide_dir);
+
+    (void) directory_listing_enumerate(wide_dir.c_str(), u64(-1), listing);
+    u64 const num_wide_entries = listing.entries.size();
+
+    bench_run(context, "enumerate_wide_dir", num_wide_entries, [] {}, [&] {
+        (void) directory_listing_enumerate(wide_dir.c_str(), u64(-1), listing);
+    });
+
+    std::vector<listed_dirent> dirents = bench_listed_dirents(listing);
+
+    {
+        std::vector<std::string> dirs = {};
+        u64 num_entries = 0;
+        for (auto const &dir : tree.directories) {
+            dirs.push_back(bench_utf8(dir));
+            (void) directory_listing_enumerate(dirs.back().c_str(), u64(-1), listing);
+            num_entries += listing.entries.size();
+        }
+
+        bench_run(context, "enumerate_tree", num_entries, [] {}, [&] {
+            for (auto const &dir : dirs) {
+                (void) directory_listing_enumerate(dir.c_str(), u64(-1), listing);
+            }
+        });
+    }
+
+    struct sort_case { char const *name; dirent_sort_spec::key by; };
+    sort_case const sort_cases[] = {
+        { "sort_by_id", dirent_sort_spec::key::id },
+        { "sort_by_path", dirent_sort_spec::key::path },
+        { "sort_by_type", dirent_sort_spec::key::kind },
+        { "sort_by_size", dirent_sort_spec::key::size },
+        { "sort_by_creation_time", dirent_sort_spec::key::creation_time },
+        { "sort_by_last_write_time", dirent_sort_spec::key::last_write_time },
+    };
+
+    for (auto const &sort_spec : sort_cases) {
+        bench_rng rng = { 42 };
+        dirent_sort_spec const spec = { sort_spec.by, true };
+
+        bench_run(context, sort_spec.name, num_wide_entries,
+            [&] {
+                // shuffle so every run sorts the same unsorted input
+                for (u64 i = dirents.size(); i > 1; --i) {
+                    std::swap(dirents[i - 1], dirents[rng.below(i)]);
+                }
+            },
+            [&] { (void) sort_dirents(dirents, std::span(&spec, 1)); });
+    }
+
+    struct filter_case
+    {
+        char const *name;
+        char const *text;
+        dirent_filter::mode how;
+        bool case_sensitive;
+        bool polarity;
+        bool show_directories;
+    };
+    filter_case const filter_cases[] = {
+        { "filter_none", "", dirent_filter::mode::contains, false, true, true },
+        { "filter_contains", "ort", dirent_filter::mode::contains, false, true, true },
+        { "filter_contains_case_sensitive", "IMG", dirent_filter::mode::contains, true, true, true },
+        { "filter_contains_inverted", "ort", dirent_filter::mode::contains, false, false, true },
+        { "filter_regex", ".*_[a-z]+\\.(jpg|png)", dirent_filter::mode::regex_match, false, true, true },
+        { "filter_regex_case_sensitive", "IMG_[0-9]{5}\\.JPG", dirent_filter::mode::regex_match, true, true, true },
+        { "filter_files_only", "", dirent_filter::mode::contains, false, true, false },
+    };
+
+    for (auto const &filter_spec : filter_cases) {
+        dirent_filter const filter = {
+            .text = filter_spec.text,
+            .how = filter_spec.how,
+            .case_sensitive = filter_spec.case_sensitive,
+            .polarity = filter_spec.polarity,
+            .kind_visible = { filter_spec.show_directories, true, true, true, true, true },
+        };
+
+        bench_run(context, filter_spec.name, num_wide_entries, [] {}, [&] {
+            (void) filter_dirents(dirents, filter);
+        });
+    }
+}
+
+static
+void bench_finder(bench_context &context, bench_tree const &tree) noexcept
+{
+    auto task = std::make_unique<progressive_task<std::vector<finder_match>>>();
+    std::atomic<u64> num_entries_checked = 0;
+
+    char const *search_value = "ort";
+    swan_path const root = path_create(bench_utf8(tree.root).c_str());
+
+    auto setup = [&] {
+        task->result.clear();
+        task->cancellation_token.store(false);
+        num_entries_checked.store(0);
+    };
+    auto search = [&] {
+        traverse_directory_recursively(root, num_entries_checked, *task, search_value, strlen(search_value), false);
+    };
+
+    setup();
+    search();
+
+    bench_run(context, "finder_traversal", num_entries_checked.load(), setup, search);
+}
+
+static
+void bench_bulk_rename(bench_context &context, bench_tree const &tree) noexcept
+{
+    u64 const num_transforms = std::max(u64(1000), u64(tree.num_files));
+
+    std::vector<bulk_rename_transform> transforms = {};
+    transforms.reserve(num_transforms);
+
+    bench_rng rng = { 7 };
+    for (u64 i = 0; i < num_transforms; ++i) {
+        std::string name = bench_generate_name(rng) + make_str(" %zu", i);
+        transforms.emplace_back(basic_dirent::kind::file, name.c_str(), "");
+    }
+
+    bulk_rename_preview preview = {};
+
+    bench_run(context, "bulk_rename_compile_and_apply_pattern", num_transforms, [] {}, [&] {
+        auto compiled = bulk_rename_compile_pattern("<name> - <counter:6><dotext>", false);
+        bulk_rename_apply_pattern(compiled.pattern, transforms, 1, 1, preview);
+    });
+
+    // renumber every name up by one, one long dependency chain
+    for (u64 i = 0; i < num_transforms; ++i) {
+        transforms[i].before = path_create(make_str("item_%07zu.dat", i).c_str());
+        transforms[i].after = path_create(make_str("item_%07zu.dat", i + 1).c_str());
+        transforms[i].stat.store(bulk_rename_transform::status::ready);
+    }
+    bench_run(context, "bulk_rename_build_plan_renumber", num_transforms, [] {}, [&] {
+        (void) bulk_rename_build_plan(transforms, false, false);
+    });
+
+    // swap neighbouring names, a cycle per pair
+    for (u64 i = 0; i < num_transforms; ++i) {
+        transforms[i].after = path_create(make_str("item_%07zu.dat", i ^ 1).c_str());
+    }
+    bench_run(context, "bulk_rename_build_plan_swaps", num_transforms, [] {}, [&] {
+        (void) bulk_rename_build_plan(transforms, false, false);
+    });
+
+    // a large rename list as an external script would paste back
+    std::string import_text = {};
+    for (u64 i = 0; i < num_transforms; ++i) {
+        import_text += make_str("[%zu] renamed_file_%07zu.txt\r\n", i, i);
+    }
+    std::vector<swan_path> imported_after = {};
+    std::vector<std::string> import_errors = {};
+
+    bench_run(context, "bulk_rename_parse_text_import", num_transforms, [] {}, [&] {
+        (void) bulk_rename_parse_text_import(import_text.c_str(), imported_after, num_transforms - 1, import_errors);
+    });
+    // baseline, the std::regex parser it replaced
+    bench_run(context, "bulk_rename_parse_text_import_regex", num_transforms, [] {}, [&] {
+        (void) bulk_rename_parse_text_import_regex(import_text.c_str(), imported_after, num_transforms - 1, import_errors);
+    });
+}
+
+#if defined(_WIN32)
+static
+void bench_utf(bench_context &context) noexcept
+{
+    bench_rng rng = { 3 };
+    std::vector<swan_path> names_utf8 = {};
+    for (u64 i = 0; i < 100'000; ++i) {
+        names_utf8.push_back(path_create(bench_generate_name(rng).c_str()));
+    }
+    std::vector<std::array<wchar_t, MAX_PATH>> names_utf16(names_utf8.size());
+
+    bench_run(context, "utf8_to_utf16", names_utf8.size(), [] {}, [&] {
+        for (u64 i = 0; i < names_utf8.size(); ++i) {
+            (void) utf8_to_utf16(names_utf8[i].data(), names_utf16[i].data(), names_utf16[i].size());
+        }
+    });
+
+    bench_run(context, "utf16_to_utf8", names_utf8.size(), [] {}, [&] {
+        for (u64 i = 0; i < names_utf8.size(); ++i) {
+            (void) utf16_to_utf8(names_utf16[i].data(), names_utf8[i].data(), names_utf8[i].size());
+        }
+    });
+}
+#endif
+
+static
+void bench_persistence(bench_context &context, bench_tree const &tree) noexcept
+{
+    directory_jump_index jump_index = {};
+    u32 now = 1'700'000'000;
+
+    for (u64 i = 0; i < tree.directories.size() * 4; ++i) {
+        jump_index.visit(bench_utf8(tree.directories[i % tree.directories.size()]), now + u32(i));
+    }
+
+    std::string serialized = {};
+
+    bench_run(context, "directory_jump_serialize", jump_index.entries.size(), [] {}, [&] {
+        serialized = jump_index.serialize();
+    });
+
+    bench_run(context, "directory_jump_deserialize", jump_index.entries.size(), [] {}, [&] {
+        directory_jump_index loaded = {};
+        (void) loaded.deserialize(serialized);
+    });
+
+    // a snapshot the size of a full recent files list, global_constants::MAX_RECENT_FILES entries
+    u64 const num_recent_files = 20'000;
+    std::string recent_files = {};
+    for (u64 i = 0; i < num_recent_files; ++i) {
+        auto const &dir = tree.directories[i % tree.directories.size()];
+        recent_files += make_str("1700000000 %s%cfile_%zu.txt\n", bench_utf8(dir).c_str(), PLATFORM_DIR_SEPARATOR, i);
+    }
+    std::string const settings(4096, 's');
+
+    std::vector<state_snapshot_section> sections = {
+        { state_snapshot_section::kind_settings, 1, 1, settings },
+        { state_snapshot_section::kind_recent_files, 1, 1, recent_files },
+        { state_snapshot_section::kind_directory_jump, 1, 1, serialized },
+    };
+    std::string snapshot = {};
+    std::vector<state_snapshot_section> unpacked = {};
+
+    bench_run(context, "state_snapshot_pack", 1, [] {}, [&] {
+        snapshot = state_snapshot_pack(sections);
+    });
+
+    bench_run(context, "state_snapshot_unpack", 1, [] {}, [&] {
+        (void) state_snapshot_unpack(snapshot, unpacked);
+    });
+
+    std::filesystem::path snapshot_path = tree.root / "swan_bench_snapshot.bin";
+
+    bench_run(context, "write_file_atomically", 1, [] {}, [&] {
+        (void) write_file_atomically(snapshot_path, snapshot);
+    });
+
+    std::error_code ec = {};
+    std::filesystem::remove(snapshot_path, ec);
+}
+
+s32 main(s32 argc, char **argv)
+try {
+    bench_tree_config config = {};
+    bench_context context = {};
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "swan_bench_tree";
+    std::filesystem::path out_path = {};
+    bool regenerate = false;
+
+    for (s32 i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        char const *value = i + 1 < argc ? argv[i + 1] : "";
+
+        auto number = [&]() noexcept { ++i; return u64(strtoull(value, nullptr, 10)); };
+
+        if      (arg == "--root")            { root = bench_path(value); ++i; }
+        else if (arg == "--out")             { out_path = bench_path(value); ++i; }
+        else if (arg == "--only")            { context.only = value; ++i; }
+        else if (arg == "--iterations")      { context.iterations = std::max(u32(1), u32(number())); }
+        else if (arg == "--regenerate")      { regenerate = true; }
+        else if (arg == "--seed")            { config.seed = number(); }
+        else if (arg == "--depth")           { config.depth = u32(number()); }
+        else if (arg == "--fan-out")         { config.fan_out = u32(number()); }
+        else if (arg == "--files-per-dir")   { config.files_per_dir = u32(number()); }
+        else if (arg == "--wide-files")      { config.wide_files = u32(number()); }
+        else if (arg == "--symlink-percent") { config.symlink_percent = u32(number()); }
+        else if (arg == "--max-file-size")   { config.max_file_size = number(); }
+        else {
+            fprintf(stderr, "unknown argument: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    fprintf(stderr, "tree: %s\n", root.string().c_str());
+    bench_tree tree = bench_generate_tree(root, config, regenerate);
+
+    if (tree.directories.empty()) {
+        return 1;
+    }
+    fprintf(stderr, "%s %zu directories, %zu files, %zu symlinks (%zu failed)\n",
+            tree.reused ? "reused" : "generated", tree.directories.size(), tree.num_files, tree.num_symlinks, tree.num_symlinks_failed);
+
+    bench_listing(context, tree);
+    bench_finder(context, tree);
+    bench_bulk_rename(context, tree);
+#if defined(_WIN32)
+    bench_utf(context);
+#endif
+    bench_persistence(context, tree);
+
+    std::string json = bench_results_to_json(context, config, tree);
+
+    if (out_path.empty()) {
+        fwrite(json.data(), 1, json.size(), stdout);
+    }
+    else if (!write_file_atomically(out_path, json)) {
+        fprintf(stderr, "failed to write %s\n", out_path.string().c_str());
+        return 1;
+    }
+
+    return 0;
+}
+catch (std::exception const &except) {
+    fprintf(stderr, "fatal: %s\n", except.what());
+    return 1;
+}
+catch (...) {
+    fprintf(stderr, "fatal: unknown error, catch(...)\n");
+    return 1;
+}
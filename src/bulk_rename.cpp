@@ -0,0 +1,1189 @@
+#include <bit>
+#include <charconv>
+#include <numeric>
+#include <optional>
+
+#if defined(_WIN32)
+#   define NOMINMAX
+#   include <windows.h>
+#endif
+
+#include "core.hpp"
+#if !SWAN_HEADLESS
+#   include "imgui_dependent_functions.hpp"
+#endif
+
+/// ASCII case insensitive comparison of the first `count` chars of `lhs` and `rhs`, for the keywords of patterns.
+static
+bool ascii_same_ignoring_case(char const *lhs, char const *rhs, u64 count) noexcept
+{
+    for (u64 i = 0; i < count; ++i) {
+        char l = lhs[i] >= 'A' && lhs[i] <= 'Z' ? char(lhs[i] - 'A' + 'a') : lhs[i];
+        char r = rhs[i] >= 'A' && rhs[i] <= 'Z' ? char(rhs[i] - 'A' + 'a') : rhs[i];
+        if (l != r) {
+            return false;
+        }
+        if (l == '\0') {
+            break;
+        }
+    }
+    return true;
+}
+
+bulk_rename_transform &bulk_rename_transform::operator=(bulk_rename_transform const &other) noexcept // for emplace_back
+{
+    this->last_updated_time = other.last_updated_time;
+    this->stat = other.stat.load();
+    this->obj_type = other.obj_type;
+    this->size = other.size;
+    this->after_key = other.after_key;
+    this->before = other.before;
+    this->after = other.after;
+    this->error = other.error;
+    return *this;
+}
+
+bulk_rename_transform::bulk_rename_transform(const bulk_rename_transform &other) noexcept // for emplace_back
+    : error(other.error)
+    , last_updated_time(other.last_updated_time)
+    , stat(other.stat.load())
+    , obj_type(other.obj_type)
+    , size(other.size)
+    , after_key(other.after_key)
+    , before(other.before)
+    , after(other.after)
+{
+}
+
+bulk_rename_transform::bulk_rename_transform(basic_dirent const *before, char const *after) noexcept
+    : stat(bulk_rename_transform::status::name_unchanged)
+    , obj_type(before->type)
+    , size(before->size)
+    , before(path_create(before->path.data()))
+    , after(path_create(after))
+{
+}
+
+bulk_rename_transform::bulk_rename_transform(basic_dirent::kind obj_type, char const *before, char const *after) noexcept
+    : stat(bulk_rename_transform::status::name_unchanged)
+    , obj_type(obj_type)
+    , before(path_create(before))
+    , after(path_create(after))
+{
+}
+
+bool bulk_rename_transform::operator!=(bulk_rename_transform const &other) const noexcept // for ntest
+{
+    return this->before != other.before || !path_equals_exactly(this->after, other.after);
+}
+
+std::ostream& operator<<(std::ostream &os, bulk_rename_transform const &r) // for ntest
+{
+    return os << "(" << (s32)r.obj_type << ") [" << r.before.data() << "]->[" << r.after.data() << ']';
+}
+
+/// Parses text exported by the bulk rename modal (and possibly edited elsewhere), one `[N] name` per line.
+/// Single pass straight over `text_input`, no copy of it is made and nothing is allocated unless there are errors.
+/// Returns success, the number of characters (not counting '\r') and the number of lines.
+std::tuple<bool, u64, u64> bulk_rename_parse_text_import(
+    char const *text_input,
+    std::vector<swan_path> &transforms_after,
+    u64 max_idx,
+    std::vector<std::string> &errors) noexcept
+try {
+    errors.clear();
+
+    // illegal in a filename: control characters and <>:"/\|?*
+    static constexpr auto s_illegal = []() {
+        std::array<bool, 256> table = {};
+        for (u64 ch = 1; ch <= 31; ++ch) table[ch] = true;
+        for (char ch : std::string_view("<>:\"/\\|?*")) table[u8(ch)] = true;
+        return table;
+    }();
+
+    u64 const max_num_lines = max_idx + 1;
+    u64 const max_name_len = swan_path().max_size() - 1;
+
+    u64 num_lines = 1;
+    u64 num_chars = 0;
+    bool success = true;
+
+    auto fail = [&](u64 line_num, std::string &&msg) {
+        success = false;
+        errors.emplace_back(make_str("Line %zu, ", line_num) + msg);
+    };
+
+    // counting lines first keeps the old contract of rejecting too long input before touching `transforms_after`
+    for (char const *ch = text_input; *ch != '\0'; ++ch) {
+        num_lines += u64(*ch == '\n');
+        num_chars += u64(*ch != '\r');
+    }
+    if (num_lines > max_num_lines) {
+        errors.emplace_back(make_str("Tried to import %zu lines, expected max %zu lines", num_lines, max_num_lines));
+        return { false, num_chars, num_lines };
+    }
+
+    // only the first byte of each slot needs clearing, a reused vector then costs nothing to reset
+    transforms_after.resize(max_num_lines);
+    for (auto &after : transforms_after) {
+        after[0] = '\0';
+    }
+
+    char const *cursor = text_input;
+
+    for (u64 line_num = 1; *cursor != '\0'; ++line_num) {
+        char const *line = cursor;
+        char const *line_end = line;
+        while (*line_end != '\0' && *line_end != '\n') ++line_end;
+        cursor = *line_end == '\n' ? line_end + 1 : line_end;
+
+        // tolerate CRLF line endings, a '\r' inside the name is reported as illegal below
+        char const *content_end = line_end;
+        while (content_end > line && content_end[-1] == '\r') --content_end;
+
+        if (content_end == line) {
+            continue; // blank line
+        }
+
+        // [N]<space>name
+        char const *p = line;
+        if (*p != '[') {
+            fail(line_num, "expected [ at start of line");
+            continue;
+        }
+        ++p;
+
+        u64 parsed_idx = 0;
+        char const *digits_begin = p;
+        bool overflow = false;
+        for (; p < content_end && *p >= '0' && *p <= '9'; ++p) {
+            overflow |= parsed_idx > (UINT64_MAX - 9) / 10;
+            parsed_idx = (parsed_idx * 10) + u64(*p - '0');
+        }
+        if (p == digits_begin || p == content_end || *p != ']') {
+            fail(line_num, "expected [N] with N a number");
+            continue;
+        }
+        ++p;
+        if (p == content_end || *p != ' ' || p + 1 == content_end) {
+            fail(line_num, "expected a space then a name after [N]");
+            continue;
+        }
+        ++p;
+
+        if (overflow || parsed_idx > max_idx) {
+            fail(line_num, make_str("parsed index [%.*s] exceeded max of %zu", s32(std::min(u64(p - digits_begin - 2), u64(32))), digits_begin, max_idx));
+            continue;
+        }
+
+        swan_path &after = transforms_after[parsed_idx];
+        u64 name_len = 0;
+        char illegal_ch = '\0';
+
+        char const *name_ch = p;
+
+        for (; name_ch < content_end; ++name_ch) {
+            char ch = *name_ch;
+            if (s_illegal[u8(ch)]) {
+                illegal_ch = ch;
+                break;
+            }
+            if (name_len == max_name_len) {
+                break;
+            }
+            after[name_len++] = ch;
+        }
+        after[std::min(name_len, max_name_len)] = '\0';
+
+        if (illegal_ch != '\0') {
+            fail(line_num, u8(illegal_ch) <= 31 ? make_str("name contains illegal control character [%d]", s32(illegal_ch))
+                                                : make_str("name contains illegal character [%c]", illegal_ch));
+            after = swan_path{};
+            continue;
+        }
+        if (name_ch < content_end) {
+            fail(line_num, "name is too long");
+            after = swan_path{};
+            continue;
+        }
+        if (after[name_len - 1] == '.') {
+            fail(line_num, "name ends with [.] character");
+            after = swan_path{};
+            continue;
+        }
+    }
+
+    return { success, num_chars, num_lines };
+}
+catch (std::exception const &except) {
+    errors.emplace_back(except.what());
+    return { false, 0, 0 };
+}
+catch (...) {
+    errors.emplace_back("catch (...)");
+    return { false, 0, 0 };
+}
+
+/// The std::regex based parser `bulk_rename_parse_text_import` replaced. Not used by Swan,
+/// kept as the baseline swan_bench measures against and the reference the tests check the replacement with.
+std::tuple<bool, std::string, u64> bulk_rename_parse_text_import_regex(
+    char const *text_input,
+    std::vector<swan_path> &transforms_after,
+    u64 max_idx,
+    std::vector<std::string> &errors) noexcept
+try {
+    errors.clear();
+
+    std::string text_sanitized = text_input;
+    text_sanitized.erase(std::remove(text_sanitized.begin(), text_sanitized.end(), '\r'), text_sanitized.end());
+    u64 num_lines = 1 + std::count(text_sanitized.begin(), text_sanitized.end(), '\n');
+
+    {
+        u64 max_num_lines = max_idx + 1;
+        if (num_lines > max_num_lines) {
+            errors.emplace_back(make_str("Tried to import %zu lines, expected max %zu lines", num_lines, max_num_lines));
+            return { false, text_sanitized, num_lines };
+        }
+    }
+
+    bool success = true;
+    transforms_after.resize(num_lines);
+
+    char const *valid_line_syntax = "\\[[0-9]{1,}\\] .{1,}";
+    static std::regex const s_valid_line_regex(valid_line_syntax);
+
+    char const *line = strtok(text_sanitized.data(), "\n");
+
+    for (u64 line_num = 1; line != nullptr; ++line_num, line = strtok(nullptr, "\n")) {
+        if (cstr_empty(line)) {
+            continue;
+        }
+        std::string_view line_vw(line, strlen(line));
+
+        if (!std::regex_match(line_vw.begin(), line_vw.end(), s_valid_line_regex)) {
+            success = false;
+            errors.emplace_back(make_str("Line %zu, syntax did not regex_match /%s/", line_num, valid_line_syntax));
+            continue;
+        }
+
+        assert(line[0] == '[');
+
+        char *parsed_idx_end;
+        u64 parsed_idx = strtoull(line + 1, &parsed_idx_end, 10);
+        assert(*parsed_idx_end == ']');
+        char const *cparsed_idx_end = parsed_idx_end;
+
+        if (parsed_idx > max_idx) {
+            success = false;
+            errors.emplace_back(make_str("Line %zu, parsed index [%zu] exceeded max of %zu", line_num, parsed_idx, max_idx));
+            continue;
+        }
+
+        u64 prefix_len = std::distance(line, cparsed_idx_end) + strlen("] ");
+        assert(prefix_len >= 4); // at minimum "[N] "
+
+        char const *name = line + prefix_len;
+        std::string_view name_vw(name);
+
+        if (name_vw.ends_with(".")) {
+            success = false;
+            errors.emplace_back(make_str("Line %zu, name ends with [.] character", line_num));
+            continue;
+        }
+
+        {
+            char const *illegal_ch = nullptr;
+
+            for (auto const &ch : name_vw) {
+                illegal_ch = strchr("<>:\"/\\|?*", ch);
+                if (illegal_ch) {
+                    success = false;
+                    errors.emplace_back(make_str("Line %zu, name contains illegal character [%c]", line_num, *illegal_ch));
+                    break;
+                }
+            }
+            if (illegal_ch) {
+                continue;
+            }
+        }
+
+        transforms_after[parsed_idx] = path_create(name);
+    }
+
+    return { success, text_sanitized, num_lines };
+}
+catch (std::exception const &except) {
+    errors.emplace_back(except.what());
+    return { false, {}, 0 };
+}
+catch (...) {
+    errors.emplace_back("catch (...)");
+    return { false, {}, 0 };
+}
+
+/// The one case folding rule of bulk rename, under which the conflict indicator, the preview and the plan all compare names:
+/// uppercase by the file system's casing rules rather than the user's locale, as NTFS and the ignore-case ordinal comparison of
+/// Windows do, so two names fold alike exactly when they would name the same entry.
+/// ASCII names (the vast majority) are folded in place without going through UTF-16, which only Windows does for the rest.
+static
+std::string fold_name_case(char const *name) noexcept
+{
+    std::string folded = name;
+    bool ascii = true;
+
+    for (auto &ch : folded) {
+        if (u8(ch) >= 0x80) {
+            ascii = false;
+            break;
+        }
+        if (ch >= 'a' && ch <= 'z') {
+            ch = char(ch - 'a' + 'A');
+        }
+    }
+
+    if (ascii) {
+        return folded;
+    }
+
+#if defined(_WIN32)
+    std::array<wchar_t, sizeof(swan_path)> name_utf16; // a UTF-8 name never has more UTF-16 units than bytes
+    std::array<wchar_t, sizeof(swan_path)> folded_utf16;
+    std::array<char, sizeof(swan_path) * 3> folded_utf8; // and a UTF-16 unit never more than 3 UTF-8 bytes
+
+    // without LCMAP_LINGUISTIC_CASING the mapping is the file system's, one UTF-16 unit to one
+    if (utf8_to_utf16(name, name_utf16.data(), name_utf16.size()) == 0
+        || LCMapStringEx(LOCALE_NAME_INVARIANT, LCMAP_UPPERCASE, name_utf16.data(), -1, folded_utf16.data(), s32(folded_utf16.size()), nullptr, nullptr, 0) == 0
+        || utf16_to_utf8(folded_utf16.data(), folded_utf8.data(), folded_utf8.size()) == 0)
+    {
+        return name; // compared exactly rather than not at all
+    }
+
+    return folded_utf8.data();
+#else
+    return name; // elsewhere only ASCII is folded, the rest compared exactly
+#endif
+}
+
+bulk_rename_plan bulk_rename_build_plan(std::vector<bulk_rename_transform> const &transforms, bool reverse, bool selected_only) noexcept
+try {
+    using status_t = bulk_rename_transform::status;
+    using step_kind = bulk_rename_plan::step_kind;
+
+    bulk_rename_plan plan = {};
+
+    status_t const status_to_include = reverse ? status_t::execute_success : status_t::ready;
+    u32 constexpr none = u32(-1);
+
+    std::vector<u32> included = {};
+    std::unordered_map<std::string, u32> source_name_to_idx = {};
+    source_name_to_idx.reserve(transforms.size());
+
+    for (u32 i = 0; i < u32(transforms.size()); ++i) {
+        auto const &transform = transforms[i];
+        if ((selected_only && !transform.selected) || transform.stat.load() != status_to_include) {
+            continue;
+        }
+        included.push_back(i);
+        source_name_to_idx.emplace(fold_name_case((reverse ? transform.after : transform.before).data()), i);
+    }
+
+    // blocker[i] is the transform currently holding the name i wants, it has to move out first.
+    // A transform never blocks itself, that is a case-only rename which MoveFileW handles fine.
+    std::vector<u32> blocker(transforms.size(), none);
+    std::vector<std::vector<u32>> waiters(transforms.size());
+
+    for (u32 i : included) {
+        auto const &transform = transforms[i];
+        auto found = source_name_to_idx.find(fold_name_case((reverse ? transform.before : transform.after).data()));
+
+        if (found != source_name_to_idx.end() && found->second != i) {
+            blocker[i] = found->second;
+            waiters[found->second].push_back(i);
+        }
+    }
+
+    enum class mark : u8 { unvisited, on_path, done };
+    std::vector<mark> marks(transforms.size(), mark::unvisited);
+
+    // appends `root_idx` and everything transitively waiting on it, each after the transform it waits on.
+    // `cycle_breaker` is the transform parked under a temporary name, it moves to its target right after its blocker moves.
+    auto append_job = [&](std::vector<bulk_rename_plan::step> &job, u32 root_idx, u32 cycle_breaker) {
+        u64 head = job.size();
+        job.push_back({ root_idx, step_kind::direct });
+        marks[root_idx] = mark::done;
+
+        for (; head < job.size(); ++head) {
+            u32 current = job[head].transform_idx;
+            if (job[head].kind != step_kind::direct) {
+                continue;
+            }
+            if (cycle_breaker != none && current == blocker[cycle_breaker]) {
+                job.push_back({ cycle_breaker, step_kind::from_temp });
+            }
+            for (u32 waiter : waiters[current]) {
+                if (marks[waiter] != mark::done) {
+                    marks[waiter] = mark::done;
+                    job.push_back({ waiter, step_kind::direct });
+                }
+            }
+        }
+    };
+
+    // chains and trees: start from transforms whose target is free
+    for (u32 i : included) {
+        if (blocker[i] == none) {
+            auto &job = plan.jobs.emplace_back();
+            append_job(job, i, none);
+            plan.num_steps += job.size();
+        }
+    }
+
+    // whatever remains is a cycle, possibly with chains hanging off it.
+    // Walk blockers until a transform repeats, that one is on the cycle; park it under a temporary name.
+    for (u32 i : included) {
+        if (marks[i] == mark::done) {
+            continue;
+        }
+
+        u32 current = i;
+        while (marks[current] == mark::unvisited) {
+            marks[current] = mark::on_path;
+            current = blocker[current];
+            assert(current != none);
+        }
+        u32 cycle_breaker = current;
+
+        for (u32 walked = i; marks[walked] == mark::on_path; walked = blocker[walked]) {
+            marks[walked] = mark::unvisited; // reset for append_job
+        }
+
+        auto &job = plan.jobs.emplace_back();
+        job.push_back({ cycle_breaker, step_kind::to_temp });
+        marks[cycle_breaker] = mark::done;
+
+        for (u32 waiter : waiters[cycle_breaker]) {
+            if (marks[waiter] != mark::done) {
+                append_job(job, waiter, cycle_breaker);
+            }
+        }
+
+        plan.num_steps += job.size();
+        ++plan.num_cycles;
+    }
+
+    return plan;
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+    return {};
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return {};
+}
+
+bulk_rename_compile_pattern_result bulk_rename_compile_pattern(char const *pattern, bool squish_adjacent_spaces) noexcept
+try {
+    assert(pattern != nullptr);
+
+    using opcode = bulk_rename_pattern::opcode;
+
+    bulk_rename_compile_pattern_result result = {};
+    auto &compiled = result.pattern;
+
+    auto fail = [&](char const *fmt, auto... args) noexcept -> bulk_rename_compile_pattern_result & {
+        result.success = false;
+        result.pattern = {};
+        snprintf(result.error.data(), result.error.size(), fmt, args...);
+        return result;
+    };
+
+    if (pattern[0] == '\0') {
+        return fail("empty pattern");
+    }
+
+    auto emit_literal_char = [&](char ch) {
+        if (!compiled.program.empty() && compiled.program.back().op == opcode::literal) {
+            ++compiled.program.back().b;
+        } else {
+            compiled.program.push_back({ opcode::literal, u16(compiled.literals.size()), 1 });
+        }
+        compiled.literals.push_back(ch);
+    };
+
+    // parses an unsigned decimal of at most 5 digits, advances `str` past it
+    auto parse_u16 = [](char const *&str, u16 &out) noexcept -> bool {
+        u32 value = 0;
+        u32 num_digits = 0;
+        for (; *str >= '0' && *str <= '9' && num_digits < 5; ++str, ++num_digits) {
+            value = (value * 10) + u32(*str - '0');
+        }
+        out = u16(std::min(value, u32(UINT16_MAX - 1)));
+        return num_digits > 0;
+    };
+
+    for (u64 i = 0; pattern[i] != '\0'; ++i) {
+        char ch = pattern[i];
+
+        if (ch == '>') {
+            return fail("unexpected '>' at position %zu, no preceding '<'", i);
+        }
+        if (ch != '<') {
+            if (u8(ch) <= 31 || ch == 127 || strchr("\\/\"|?*:", ch)) {
+                return fail("illegal filename character [%c] at position %zu", ch, i);
+            }
+            if (squish_adjacent_spaces && ch == ' ' && i > 0 && pattern[i-1] == ' ') {
+                continue;
+            }
+            emit_literal_char(ch);
+            continue;
+        }
+
+        u64 const opening_chevron_pos = i;
+        char const *expr = pattern + i + 1;
+        char const *expr_end = strchr(expr, '>');
+        if (expr_end == nullptr) {
+            return fail("unclosed '<' at position %zu", opening_chevron_pos);
+        }
+        u64 expr_len = u64(expr_end - expr);
+        if (expr_len == 0) {
+            return fail("empty expression at position %zu", opening_chevron_pos);
+        }
+        if (std::memchr(expr, '<', expr_len)) {
+            return fail("unexpected '<' inside expression at position %zu", opening_chevron_pos);
+        }
+
+        auto expr_equals = [&](char const *known) noexcept {
+            return strlen(known) == expr_len && ascii_same_ignoring_case(expr, known, expr_len);
+        };
+
+        bulk_rename_pattern::instruction instr = {};
+
+        if (expr_equals("name")) {
+            instr.op = opcode::name;
+        }
+        else if (expr_equals("ext")) {
+            instr.op = opcode::ext;
+        }
+        else if (expr_equals("dotext")) {
+            instr.op = opcode::dotext;
+        }
+        else if (expr_equals("size") || expr_equals("bytes")) {
+            instr.op = opcode::size;
+        }
+        else if (expr_equals("counter")) {
+            instr.op = opcode::counter;
+        }
+        else if (expr_len > strlen("counter:") && ascii_same_ignoring_case(expr, "counter:", strlen("counter:"))) {
+            char const *width = expr + strlen("counter:");
+            instr.op = opcode::counter;
+            if (!parse_u16(width, instr.a) || width != expr_end || instr.a > 20) {
+                return fail("counter width at position %zu must be a number from 0 to 20", opening_chevron_pos);
+            }
+        }
+        else {
+            // slice: <first,last> or <first,> or <,last>
+            char const *cursor = expr;
+            instr.op = opcode::slice;
+            instr.a = 0;
+            instr.b = UINT16_MAX;
+
+            bool has_first = parse_u16(cursor, instr.a);
+            if (*cursor != ',') {
+                return fail("unknown expression at position %zu", opening_chevron_pos);
+            }
+            ++cursor;
+            while (*cursor == ' ') ++cursor;
+            bool has_last = parse_u16(cursor, instr.b);
+
+            if (cursor != expr_end || (!has_first && !has_last)) {
+                return fail("unknown expression at position %zu", opening_chevron_pos);
+            }
+            if (has_last && instr.a > instr.b) {
+                return fail("slice at position %zu is malformed, first is greater than last", opening_chevron_pos);
+            }
+        }
+
+        compiled.program.push_back(instr);
+        i += expr_len + 1; // loop increment steps over '>'
+    }
+
+    result.success = true;
+    return result;
+}
+catch (std::exception const &except) {
+    bulk_rename_compile_pattern_result result = {};
+    snprintf(result.error.data(), result.error.size(), "%s", except.what());
+    return result;
+}
+catch (...) {
+    bulk_rename_compile_pattern_result result = {};
+    snprintf(result.error.data(), result.error.size(), "catch (...)");
+    return result;
+}
+
+/// Runs `pattern` for one transform. Writes into `out` unless it is null, which only measures.
+/// Returns the length of the resulting name, or 0 with `prob` set.
+static
+u64 run_bulk_rename_pattern(
+    bulk_rename_pattern const &pattern,
+    bulk_rename_transform const &transform,
+    s64 counter,
+    char *out,
+    bulk_rename_preview::problem &prob) noexcept
+{
+    using opcode = bulk_rename_pattern::opcode;
+    using problem = bulk_rename_preview::problem;
+
+    std::string_view full = transform.before.data();
+    std::string_view name = full;
+    std::string_view ext = {};
+
+    if (transform.obj_type != basic_dirent::kind::directory) {
+        u64 dot_pos = full.rfind('.');
+        if (dot_pos != std::string_view::npos && dot_pos != 0) {
+            name = full.substr(0, dot_pos);
+            ext = full.substr(dot_pos + 1);
+        }
+    }
+
+    static u64 const max_len = swan_path().max_size() - 1;
+    u64 len = 0;
+
+    auto put = [&](std::string_view str) noexcept {
+        if (out != nullptr && !str.empty() && len + str.size() <= max_len) {
+            memcpy(out + len, str.data(), str.size());
+        }
+        len += str.size();
+    };
+
+    for (auto const &instr : pattern.program) {
+        switch (instr.op) {
+            case opcode::literal: put(std::string_view(pattern.literals.data() + instr.a, instr.b)); break;
+            case opcode::name:    put(name); break;
+            case opcode::ext:     put(ext); break;
+            case opcode::dotext:  if (!ext.empty()) { put("."); put(ext); } break;
+            case opcode::counter: {
+                // to_chars rather than snprintf, this runs for every transform on every keystroke
+                char digits[24];
+                u64 magnitude = counter < 0 ? (~u64(counter) + 1) : u64(counter);
+                u64 num_digits = u64(std::to_chars(digits, digits + sizeof(digits), magnitude).ptr - digits);
+                if (counter < 0) put("-");
+                for (u64 pad = num_digits; pad < instr.a; ++pad) put("0");
+                put(std::string_view(digits, num_digits));
+                break;
+            }
+            case opcode::size: {
+                char digits[24];
+                put(std::string_view(digits, u64(std::to_chars(digits, digits + sizeof(digits), transform.size).ptr - digits)));
+                break;
+            }
+            case opcode::slice: {
+                u64 last = instr.b == UINT16_MAX ? full.size() - 1 : instr.b;
+                if (full.empty() || instr.a >= full.size() || last >= full.size()) {
+                    prob = problem::slice_out_of_bounds;
+                    return 0;
+                }
+                put(full.substr(instr.a, last - instr.a + 1));
+                break;
+            }
+        }
+    }
+
+    if (len == 0) {
+        prob = problem::empty;
+        return 0;
+    }
+    if (len > max_len) {
+        prob = problem::too_long;
+        return 0;
+    }
+    if (out != nullptr && out[len - 1] == '.') {
+        prob = problem::ends_with_dot;
+    }
+
+    return len;
+}
+
+/// Hash of a name as `fold_name_case` folds it. ASCII names are hashed as they are, folding each character on the way.
+static
+u64 bulk_rename_name_hash(char const *name) noexcept
+{
+    auto hash_folded = [](char const *folded) noexcept {
+        u64 hash = 0xcbf29ce484222325ull; // FNV-1a
+        for (; *folded != '\0'; ++folded) {
+            hash ^= u8((*folded >= 'a' && *folded <= 'z') ? (*folded - 'a' + 'A') : *folded);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    };
+
+    for (char const *ch = name; *ch != '\0'; ++ch) {
+        if (u8(*ch) >= 0x80) {
+            return hash_folded(fold_name_case(name).c_str());
+        }
+    }
+    return hash_folded(name);
+}
+
+/// Whether two names fold alike under `fold_name_case`. Only called once the hashes of both names agree.
+/// Both names must be NUL terminated, as they are in the preview arena.
+static
+bool bulk_rename_name_equal(char const *lhs, char const *rhs) noexcept
+{
+    return fold_name_case(lhs) == fold_name_case(rhs);
+}
+
+void bulk_rename_apply_pattern(
+    bulk_rename_pattern const &pattern,
+    std::span<bulk_rename_transform const> transforms,
+    s64 counter_start,
+    s64 counter_step,
+    bulk_rename_preview &out) noexcept
+try {
+    using problem = bulk_rename_preview::problem;
+
+    u64 const num_transforms = transforms.size();
+    u64 constexpr chunk_size = 4096;
+
+    out.offsets.resize(num_transforms + 1);
+    out.problems.assign(num_transforms, problem::none);
+    out.hashes.resize(num_transforms);
+    out.num_problems = 0;
+    out.num_collisions = 0;
+    out.first_collision_idx = u64(-1);
+
+    std::vector<u64> chunk_starts = {};
+    for (u64 start = 0; start < num_transforms; start += chunk_size) {
+        chunk_starts.push_back(start);
+    }
+
+    auto for_each_transform_parallel = [&](auto &&func) {
+        std::atomic<u64> next_chunk_idx = 0;
+        run_parallel_workers(parallel_worker_count(chunk_starts.size()), [&](u64) noexcept {
+            for (u64 chunk_idx; (chunk_idx = next_chunk_idx.fetch_add(1)) < chunk_starts.size(); ) {
+                u64 start = chunk_starts[chunk_idx];
+                u64 end = std::min(start + chunk_size, num_transforms);
+                for (u64 i = start; i < end; ++i) {
+                    func(i);
+                }
+            }
+        });
+    };
+
+    // pass 1: measure, so every name knows where it goes in the arena
+    out.offsets[0] = 0;
+    for_each_transform_parallel([&](u64 i) noexcept {
+        s64 counter = counter_start + (s64(i) * counter_step);
+        out.offsets[i + 1] = run_bulk_rename_pattern(pattern, transforms[i], counter, nullptr, out.problems[i]) + 1; // + NUL
+    });
+    std::inclusive_scan(out.offsets.begin() + 1, out.offsets.end(), out.offsets.begin() + 1);
+
+    // pass 2: write, chunks touch disjoint parts of the arena
+    out.arena.resize(out.offsets[num_transforms]);
+    for_each_transform_parallel([&](u64 i) noexcept {
+        char *dst = out.arena.data() + out.offsets[i];
+        s64 counter = counter_start + (s64(i) * counter_step);
+        u64 len = out.problems[i] == problem::none ? run_bulk_rename_pattern(pattern, transforms[i], counter, dst, out.problems[i]) : 0;
+        dst[len] = '\0';
+        out.hashes[i] = bulk_rename_name_hash(dst);
+    });
+
+    out.num_problems = u64(std::count_if(out.problems.begin(), out.problems.end(), [](problem p) noexcept { return p != problem::none; }));
+
+    // open addressing over the hashes computed above, a node based set costs more than everything else here combined
+    u64 table_size = std::bit_ceil(std::max(num_transforms * 2, u64(16)));
+    out.table.assign(table_size, u32(-1));
+
+    for (u64 i = 0; i < num_transforms; ++i) {
+        std::string_view name(out.name(i), out.offsets[i + 1] - out.offsets[i] - 1);
+        if (name.empty() || out.problems[i] != problem::none) {
+            continue; // rows with a problem are left unchanged, the name they would have had never reaches the disk
+        }
+        for (u64 slot = out.hashes[i] & (table_size - 1); ; slot = (slot + 1) & (table_size - 1)) {
+            u32 occupant = out.table[slot];
+            if (occupant == u32(-1)) {
+                out.table[slot] = u32(i);
+                break;
+            }
+            if (out.hashes[occupant] == out.hashes[i] && bulk_rename_name_equal(out.name(occupant), out.name(i))) {
+                if (out.num_collisions++ == 0) {
+                    out.first_collision_idx = i;
+                }
+                break;
+            }
+        }
+    }
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+    out.num_problems = transforms.size();
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    out.num_problems = transforms.size();
+}
+
+std::string bulk_rename_collision_index::key(char const *name) noexcept
+{
+    return cstr_empty(name) ? std::string() : fold_name_case(name);
+}
+
+void bulk_rename_collision_index::add(std::string const &key) noexcept
+try {
+    if (key.empty()) {
+        return; // reported as empty, not as conflicting with every other empty name
+    }
+    u32 &count = this->counts[key];
+    if (count == 1) {
+        this->num_conflicting += 2; // the existing name and this one
+    } else if (count > 1) {
+        this->num_conflicting += 1;
+    }
+    ++count;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+void bulk_rename_collision_index::remove(std::string const &key) noexcept
+{
+    if (key.empty()) {
+        return;
+    }
+    auto found = this->counts.find(key);
+    if (found == this->counts.end()) {
+        assert(false && "removing key which was never added");
+        return;
+    }
+
+    u32 &count = found->second;
+    if (count == 2) {
+        this->num_conflicting -= 2;
+    } else if (count > 2) {
+        this->num_conflicting -= 1;
+    }
+
+    if (--count == 0) {
+        this->counts.erase(found);
+    }
+}
+
+void bulk_rename_collision_index::rebuild(std::vector<std::string> const &untouched_keys, std::vector<bulk_rename_transform> &transforms) noexcept
+try {
+    this->counts.clear();
+    this->counts.reserve(untouched_keys.size() + transforms.size());
+    this->num_conflicting = 0;
+
+    for (auto const &untouched_key : untouched_keys) {
+        this->add(untouched_key);
+    }
+    for (auto &transform : transforms) {
+        transform.after_key = key(transform.after.data());
+        this->add(transform.after_key);
+    }
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+void bulk_rename_collision_index::update(bulk_rename_transform &transform) noexcept
+try {
+    std::string new_key = key(transform.after.data());
+    if (new_key != transform.after_key) {
+        this->remove(transform.after_key);
+        this->add(new_key);
+        transform.after_key = std::move(new_key);
+    }
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+bool bulk_rename_collision_index::conflicts(bulk_rename_transform const &transform) const noexcept
+{
+    auto found = this->counts.find(transform.after_key);
+    return found != this->counts.end() && found->second > 1;
+}
+
+namespace bulk_rename_journal_replay_detail
+{
+    struct item
+    {
+        std::string_view src;
+        std::string_view dst;
+        std::string_view temp;
+        bool parked = false;
+        bool done = false;
+        bool failed = false;
+    };
+
+    struct line_reader
+    {
+        std::string_view line;
+        u64 pos = 0;
+
+        bool read_u64(u64 &out) noexcept
+        {
+            if (this->pos < this->line.size() && this->line[this->pos] == ' ') {
+                ++this->pos;
+            }
+            auto [ptr, ec] = std::from_chars(this->line.data() + this->pos, this->line.data() + this->line.size(), out);
+            if (ec != std::errc()) {
+                return false;
+            }
+            this->pos = u64(ptr - this->line.data());
+            return true;
+        }
+
+        bool read_str(std::string_view &out) noexcept
+        {
+            u64 len = 0;
+            if (!this->read_u64(len) || this->pos >= this->line.size() || this->line[this->pos] != ' ') {
+                return false;
+            }
+            ++this->pos;
+            if (len > this->line.size() - this->pos) {
+                return false;
+            }
+            out = this->line.substr(this->pos, len);
+            this->pos += len;
+            return true;
+        }
+    };
+}
+
+std::vector<bulk_rename_recovery> bulk_rename_journal_replay(std::string_view journal, bool probe_filesystem) noexcept
+try {
+    using namespace bulk_rename_journal_replay_detail;
+    using step_kind = bulk_rename_plan::step_kind;
+
+    std::vector<bulk_rename_recovery> recoveries = {};
+
+    swan_path working_directory = {};
+    std::string working_directory_prefix = {}; // with a trailing separator
+    std::unordered_map<std::string, std::string> original_name_of = {}; // current name -> name before the session
+    bool session_open = false;
+
+    std::unordered_map<u32, item> items = {};
+    std::vector<std::vector<bulk_rename_plan::step>> jobs = {};
+    bool transaction_open = false;
+
+    auto exists = [&](std::string_view name) {
+        std::string full_path = working_directory_prefix;
+        full_path += name;
+        platform_file_info info;
+        return platform_stat(full_path.c_str(), info, false).ok();
+    };
+
+    auto move = [&](std::string_view from, std::string_view to) {
+        std::string original;
+        if (auto found = original_name_of.find(std::string(from)); found != original_name_of.end()) {
+            original = std::move(found->second);
+            original_name_of.erase(found);
+        } else {
+            original = from;
+        }
+        if (original != to) {
+            original_name_of[std::string(to)] = std::move(original);
+        }
+    };
+
+    // outcome of a step as recorded in the journal, if it was
+    auto recorded_outcome = [](bulk_rename_plan::step step, item const &it) noexcept -> std::optional<bool> {
+        switch (step.kind) {
+            case step_kind::direct:    if (it.done) return true; if (it.failed) return false; break;
+            case step_kind::to_temp:   if (it.parked || it.done) return true; if (it.failed) return false; break;
+            case step_kind::from_temp: if (it.done) return true; if (it.failed) return false; break;
+        }
+        return std::nullopt;
+    };
+
+    // whether this step could be the last one of its job to have happened, judged by what exists on disk
+    auto looks_like_last_done = [&](bulk_rename_plan::step step, item const &it) noexcept {
+        switch (step.kind) {
+            case step_kind::direct:    return exists(it.dst) && !exists(it.src);
+            case step_kind::to_temp:   return exists(it.temp);
+            case step_kind::from_temp: return it.parked && !exists(it.temp);
+        }
+        return false;
+    };
+
+    auto resolve_transaction = [&](bool ended) {
+        if (!transaction_open) {
+            return;
+        }
+        transaction_open = false;
+
+        // the steps of a job run in order, so what happened is a prefix of each job
+        for (auto const &job : jobs) {
+            s64 last_done_idx = -1;
+
+            for (u64 i = 0; i < job.size(); ++i) {
+                auto found = items.find(job[i].transform_idx);
+                if (found != items.end() && recorded_outcome(job[i], found->second) == true) {
+                    last_done_idx = s64(i);
+                }
+            }
+            if (!ended && probe_filesystem) {
+                for (s64 i = s64(job.size()) - 1; i > last_done_idx; --i) {
+                    auto found = items.find(job[i].transform_idx);
+                    if (found != items.end() && !recorded_outcome(job[i], found->second).has_value() && looks_like_last_done(job[i], found->second)) {
+                        last_done_idx = i;
+                        break;
+                    }
+                }
+            }
+
+            for (u64 i = 0; i < job.size(); ++i) {
+                auto found = items.find(job[i].transform_idx);
+                if (found == items.end()) {
+                    continue;
+                }
+                item const &it = found->second;
+                if (!recorded_outcome(job[i], it).value_or(s64(i) <= last_done_idx)) {
+                    continue;
+                }
+                switch (job[i].kind) {
+                    case step_kind::direct:    move(it.src, it.dst); break;
+                    case step_kind::to_temp:   move(it.src, it.temp); break;
+                    case step_kind::from_temp: move(it.temp, it.dst); break;
+                }
+            }
+        }
+
+        items.clear();
+        jobs.clear();
+    };
+
+    auto end_session = [&](bool closed_normally) {
+        resolve_transaction(false);
+
+        if (session_open && !closed_normally && !original_name_of.empty()) {
+            bulk_rename_recovery recovery = { .working_directory = working_directory };
+            recovery.transforms.reserve(original_name_of.size());
+
+            for (auto const &[current_name, original_name] : original_name_of) {
+                auto &transform = recovery.transforms.emplace_back(basic_dirent::kind::nil, original_name.c_str(), current_name.c_str());
+                transform.stat.store(bulk_rename_transform::status::execute_success);
+            }
+            std::sort(recovery.transforms.begin(), recovery.transforms.end(), [](bulk_rename_transform const &lhs, bulk_rename_transform const &rhs) noexcept {
+                return strcmp(lhs.before.data(), rhs.before.data()) < 0;
+            });
+
+            recoveries.push_back(std::move(recovery));
+        }
+
+        session_open = false;
+        original_name_of.clear();
+    };
+
+    u64 line_num = 0;
+
+    // a line without its '\n' was cut short by the crash, it and anything after it is ignored
+    for (u64 line_start = 0, line_end; (line_end = journal.find('\n', line_start)) != std::string_view::npos; line_start = line_end + 1) {
+        line_reader reader = { journal.substr(line_start, line_end - line_start) };
+        if (reader.line.ends_with('\r')) {
+            reader.line.remove_suffix(1);
+        }
+
+        if (line_num++ == 0) {
+            if (reader.line != "swan_bulk_rename_journal 1") {
+                print_debug_msg("FAILED bulk rename journal has an unknown header");
+                return {};
+            }
+            continue;
+        }
+        if (reader.line.empty()) {
+            continue;
+        }
+
+        char const kind = reader.line[0];
+        reader.pos = 1;
+        bool valid = true;
+
+        if (kind == 'W') {
+            end_session(false);
+
+            std::string_view working_directory_view;
+            valid = reader.read_str(working_directory_view);
+            if (valid) {
+                valid = working_directory_view.size() < working_directory.size();
+                working_directory = path_create(working_directory_view.data(), working_directory_view.size());
+                working_directory_prefix = working_directory.data();
+                std::replace(working_directory_prefix.begin(), working_directory_prefix.end(), '/', PLATFORM_DIR_SEPARATOR);
+                if (!working_directory_prefix.ends_with(PLATFORM_DIR_SEPARATOR)) working_directory_prefix += PLATFORM_DIR_SEPARATOR;
+                session_open = true;
+            }
+        }
+        else if (kind == 'C') {
+            end_session(true);
+        }
+        else if (!session_open) {
+            valid = false;
+        }
+        else if (kind == 'B') {
+            resolve_transaction(false);
+            transaction_open = true;
+        }
+        else if (kind == 'E') {
+            resolve_transaction(true);
+        }
+        else if (!transaction_open) {
+            valid = false;
+        }
+        else if (kind == 'I') {
+            u64 idx = 0;
+            item it = {};
+            valid = reader.read_u64(idx) && reader.read_str(it.src) && reader.read_str(it.dst) && reader.read_str(it.temp);
+            if (valid) {
+                items[u32(idx)] = it;
+            }
+        }
+        else if (kind == 'J') {
+            u64 num_steps = 0;
+            valid = reader.read_u64(num_steps);
+            auto &job = jobs.emplace_back();
+
+            for (u64 i = 0; valid && i < num_steps; ++i) {
+                u64 idx = 0;
+                valid = reader.read_u64(idx) && reader.pos < reader.line.size();
+                if (valid) {
+                    char step_char = reader.line[reader.pos++];
+                    valid = step_char == 'd' || step_char == 't' || step_char == 'f';
+                    step_kind k = step_char == 'd' ? step_kind::direct : step_char == 't' ? step_kind::to_temp : step_kind::from_temp;
+                    job.push_back({ u32(idx), k });
+                }
+            }
+        }
+        else if (one_of(kind, { 'P', 'D', 'F' })) {
+            u64 idx = 0;
+            valid = reader.read_u64(idx);
+            if (auto found = items.find(u32(idx)); valid && found != items.end()) {
+                found->second.parked |= kind == 'P';
+                found->second.done   |= kind == 'D';
+                found->second.failed |= kind == 'F';
+            }
+        }
+        else {
+            valid = false;
+        }
+
+        if (!valid) {
+            print_debug_msg("FAILED bulk rename journal line %zu is malformed, ignoring the rest", line_num);
+            break;
+        }
+    }
+
+    end_session(false);
+
+    return recoveries;
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+    return {};
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return {};
+}
@@ -7,6 +7,7 @@
 #include "stdafx.hpp"
 #include "path.hpp"
 #include "util.hpp"
+#include "profiler.hpp"
 #include "data_types.hpp"
 
 namespace global_constants
@@ -16,7 +17,7 @@ namespace global_constants
     std::vector<icon_font_glyph> const &icon_font_glyphs_lucide() noexcept;
 
     constexpr u64 num_explorers = 4;
-    constexpr u64 MAX_RECENT_FILES = 100;
+    constexpr u64 MAX_RECENT_FILES = 20'000;
 
 } // global_constants
 
@@ -43,6 +44,7 @@ namespace swan_windows
         icon_library,
         imgui_demo,
         imspinner_demo,
+        disk_usage,
         count
     };
 
@@ -68,6 +70,7 @@ namespace swan_windows
             case id::icon_library: return " Icon Library ";
             case id::imgui_demo: return " ImGui Demo ";
             case id::imspinner_demo: return " ImSpinner Demo ";
+            case id::disk_usage: return " Disk Usage ";
             default: assert(false && "Window has no name"); return nullptr;
         }
     }
@@ -98,6 +101,8 @@ namespace swan_windows
 
     bool render_imspinner_demo(bool &open, bool any_popups_open) noexcept;
 
+    bool render_disk_usage(bool &open, bool any_popups_open) noexcept;
+
 }
 
 namespace swan_popup_modals
@@ -111,6 +116,7 @@ namespace swan_popup_modals
         bit_pos_edit_pin,
         bit_pos_new_file,
         bit_pos_new_directory,
+        bit_pos_mirror,
         bit_pos_count
     };
 
@@ -123,6 +129,7 @@ namespace swan_popup_modals
     constexpr char const *label_edit_pin = " Edit Pin ## popup_modal";
     constexpr char const *label_new_file = " New File ## popup_modal";
     constexpr char const *label_new_directory = " New Directory ## popup_modal";
+    constexpr char const *label_mirror = " Mirror ## popup_modal";
 
     void open_single_rename(explorer_window &expl_opened_from, explorer_window::dirent const &rename_target, std::function<void ()> on_rename_callback) noexcept;
     void open_bulk_rename(explorer_window &expl_opened_from, std::function<void ()> on_rename_callback) noexcept;
@@ -131,6 +138,7 @@ namespace swan_popup_modals
     void open_edit_pin(pinned_path *pin) noexcept;
     void open_new_file(char const *parent_directory_utf8, s32 initiating_expl_id = -1) noexcept;
     void open_new_directory(char const *parent_directory_utf8, s32 initiating_expl_id = -1) noexcept;
+    void open_mirror(s32 src_expl_id, s32 dst_expl_id) noexcept;
 
     void render_single_rename() noexcept;
     void render_bulk_rename() noexcept;
@@ -139,6 +147,7 @@ namespace swan_popup_modals
     void render_edit_pin() noexcept;
     void render_new_file() noexcept;
     void render_new_directory() noexcept;
+    void render_mirror() noexcept;
 
 } // namespace swan_popup_modals
 
@@ -150,26 +159,30 @@ namespace global_state
 
     struct recent_files
     {
-        std::deque<recent_file> *container;
+        std::list<recent_file>  *container;
         std::mutex              *mutex;
     };
     recent_files            recent_files_get() noexcept;
     void                    recent_files_update(char const *action, char const *full_file_path) noexcept;
-    u64                     recent_files_find_idx(char const *search_path) noexcept;
-    void                    recent_files_move_to_front(u64 recent_file_idx, char const *new_action = nullptr) noexcept;
-    void                    recent_files_add(char const *action, char const *full_file_path) noexcept;
-    void                    recent_files_remove(u64 recent_file_idx) noexcept;
+    bool                    recent_files_contains(char const *search_path) noexcept;
+    void                    recent_files_move_to_front(u64 path_key, char const *new_action = nullptr) noexcept;
+    void                    recent_files_remove(u64 path_key) noexcept;
+    u64                     recent_files_path_changed(char const *old_path, char const *new_path, bool is_directory, std::scoped_lock<std::mutex> *supplied_lock) noexcept;
+    u64                     recent_files_deleted(char const *path, char const *recycle_bin_path, bool is_directory, std::scoped_lock<std::mutex> *supplied_lock) noexcept;
+    u64                     recent_files_directories_changed(std::vector<recent_files_directory_change> const &changes, std::scoped_lock<std::mutex> *supplied_lock) noexcept;
     bool                    recent_files_save_to_disk(std::scoped_lock<std::mutex> *supplied_lock) noexcept;
+    bool                    recent_files_save_latest_to_disk(std::scoped_lock<std::mutex> *supplied_lock) noexcept;
     std::pair<bool, u64>    recent_files_load_from_disk(char dir_separator) noexcept;
 
     struct completed_file_operations
     {
         std::deque<completed_file_operation> *container;
         std::mutex                           *mutex;
+        completed_file_operation_group_index *groups;
     };
     completed_file_operations   completed_file_operations_get() noexcept;
     std::pair<bool, u64>        completed_file_operations_load_from_disk(char dir_separator) noexcept;
-    u32                         completed_file_operations_calc_next_group_id() noexcept;
+    u32                         completed_file_operations_next_group_id() noexcept;
     bool                        completed_file_operations_save_to_disk(std::scoped_lock<std::mutex> *lock) noexcept;
 
     std::vector<pinned_path> &  pinned_get() noexcept;
@@ -181,6 +194,48 @@ namespace global_state
     void                        pinned_update_directory_separators(char new_dir_separator) noexcept;
     void                        pinned_swap(u64 pin1_idx, u64 pin2_idx) noexcept;
 
+    directory_jump_index &      directory_jump_get() noexcept;
+    void                        directory_jump_visit(swan_path const &directory) noexcept;
+    std::pair<bool, u64>        directory_jump_load_from_disk() noexcept;
+    bool                        directory_jump_save_to_disk() noexcept;
+
+    struct listing_cache
+    {
+        directory_listing_cache *container;
+        std::mutex              *mutex;
+    };
+    listing_cache               listing_cache_get() noexcept;
+
+    struct shortcut_cache
+    {
+        shortcut_kind_cache *container;
+        std::mutex          *mutex;
+    };
+    shortcut_cache              shortcut_cache_get() noexcept;
+
+    struct size_cache
+    {
+        directory_size_cache *container;
+        std::mutex           *mutex;
+    };
+    size_cache                  directory_size_cache_get() noexcept;
+    std::pair<bool, u64>        directory_sizes_load_from_disk() noexcept;
+    bool                        directory_sizes_save_to_disk(bool flush) noexcept;
+
+    prefetch_stats &            prefetch_stats_get() noexcept;
+    /// User initiated scans and file operations in flight. The prefetcher holds off while nonzero so it never competes with them
+    /// for the disk; increment it for the duration of any such work, e.g. `++count; SCOPE_EXIT { --count; };`.
+    std::atomic<s32> &          foreground_io_count() noexcept;
+
+    startup_timings &           startup_timings_get() noexcept;
+
+    render_loop_stats &         render_loop_stats_get() noexcept;
+    void                        wake_render_loop() noexcept;
+    bool                        render_loop_consume_wake() noexcept;
+
+    void                        mark_dirty(persisted_file file) noexcept;
+    void                        mark_dirty(explorer_window const &expl) noexcept;
+
     HWND &                  window_handle() noexcept;
     std::filesystem::path & execution_path() noexcept;
     swan_thread_pool_t &    thread_pool() noexcept;
@@ -190,6 +245,8 @@ namespace global_state
     s32 &                   page_size() noexcept;
 
     file_operation_command_buf &file_op_cmd_buf() noexcept;
+    file_operation_progress &permanent_delete_progress() noexcept;
+    file_operation_progress &fast_copy_progress() noexcept;
 
     std::vector<s64> &delete_icon_textures_queue() noexcept;
 
@@ -237,13 +294,105 @@ void perform_file_operations(
     bool *init_done,
     std::string *init_error,
     char dir_sep_ut8,
+    s32 num_max_file_operations,
+    bool verify_copies = false) noexcept;
+
+void perform_permanent_delete(
+    std::wstring working_directory_utf16,
+    std::wstring paths_to_delete_utf16,
+    std::mutex *init_done_mutex,
+    std::condition_variable *init_done_cond,
+    bool *init_done,
+    std::string *init_error,
+    char dir_sep_utf8,
     s32 num_max_file_operations) noexcept;
 
-std::tuple<bool, std::string, u64> bulk_rename_parse_text_import(
-    char const *text,
-    std::vector<swan_path> &transforms_after,
-    u64 max_idx,
-    std::vector<std::string> &errors) noexcept;
+file_copy_strategy choose_fast_copy_strategy(fast_copy_candidate const &c) noexcept;
+
+file_copy_strategy try_fast_copy_file(
+    wchar_t const *src_path_utf16,
+    wchar_t const *dst_path_utf16,
+    file_operation_progress *progress = nullptr,
+    fast_copy_volume_cache *volumes = nullptr) noexcept;
+
+file_hash_result hash_file_contents(wchar_t const *full_path_utf16, std::atomic_bool const *cancellation_token = nullptr, bool bypass_cache = false) noexcept;
+
+void verify_copied_file(
+    std::wstring src_path_utf16,
+    std::wstring dst_path_utf16,
+    swan_path dst_path_utf8,
+    u32 group_id,
+    std::shared_ptr<std::atomic<u64>> num_verifications_outstanding) noexcept;
+
+void build_mirror_plan(
+    progressive_task<mirror_plan> &task,
+    std::wstring src_root_utf16,
+    std::wstring dst_root_utf16,
+    mirror_plan::options options,
+    std::atomic<u64> &num_entries_compared) noexcept;
+
+void perform_mirror_plan(
+    s32 dst_expl_id,
+    std::wstring src_root_utf16,
+    std::wstring dst_root_utf16,
+    std::vector<mirror_plan::entry> entries,
+    std::mutex *init_done_mutex,
+    std::condition_variable *init_done_cond,
+    bool *init_done,
+    std::string *init_error,
+    char dir_sep_utf8,
+    s32 num_max_file_operations) noexcept;
+
+/// Kind of the target of the .lnk file at `lnk_path_utf8`, from shortcut_kind_cache or else by loading the shortcut on the
+/// calling thread, which gets a COM apartment of its own if it has none. Blocks on I/O, keep it off the main thread.
+basic_dirent::kind shortcut_kind_resolve(char const *lnk_path_utf8, platform_file_time lnk_write_time) noexcept;
+
+/// `shortcut_kind_lookup_t` over shortcut_kind_cache, what explorers and the prefetcher list directories with.
+bool shortcut_kind_find_cached(char const *lnk_path_utf8, platform_file_time lnk_write_time, basic_dirent::kind &out) noexcept;
+
+/// Resolves `shortcuts` (names of .lnk files in `directory`) off the main thread in batches, setting `resolved_shortcuts_key`
+/// of explorer `expl_id` after each. Replaces whatever that explorer requested before.
+void shortcut_kinds_resolve_deferred(s32 expl_id, swan_path const &directory, std::vector<shortcut_to_resolve> &&shortcuts) noexcept;
+
+/// Queues directories for the prefetcher to enumerate into directory_listing_cache at background priority, most likely first.
+/// An `urgent` request goes ahead of what is queued, otherwise it replaces it.
+void prefetch_directories(std::vector<swan_path> const &candidates, bool urgent) noexcept;
+
+/// Walks every directory of `job` in parallel on a pool of its own, reusing directory_size_cache records wherever they still hold.
+void directory_sizes_compute(std::shared_ptr<directory_size_job> job) noexcept;
+
+/// For a change notification on `directory_utf8`, forgets what it directly holds, so the next walk lists it again.
+void directory_sizes_invalidate(char const *directory_utf8) noexcept;
+
+/// The cluster size of the volume holding `path_utf8`, what sizes on disk are rounded up to. 4096 where it can't be found.
+u64 volume_cluster_size(char const *path_utf8) noexcept;
+
+/// Lays `count` sizes, sorted largest first, out as cells filling [min, max] whose areas are proportional to the sizes.
+/// Squarified (Bruls, Huizing, van Wijk): rows are grown along the shorter side while that keeps the worst aspect ratio down.
+void treemap_squarify(u64 const *sizes, u64 count, ImVec2 min, ImVec2 max, std::vector<treemap_cell> &out) noexcept(false);
+
+/// Name a transform is parked under while a rename cycle is broken, in the same directory.
+std::string bulk_rename_temp_name(u32 transform_idx) noexcept;
+
+std::filesystem::path bulk_rename_journal_path() noexcept;
+
+/// Reverts what `bulk_rename_journal_replay` recovered, then removes the journal or rewrites it with whatever failed to revert.
+/// Returns the number of items reverted, the number which failed to, and whether the journal was removed or rewritten.
+std::tuple<u64, u64, bool> bulk_rename_revert_interrupted(std::vector<bulk_rename_recovery> &recoveries) noexcept;
+
+/// Replays the journal left by bulk renames interrupted by a crash and, if anything is still renamed, offers to revert it.
+void bulk_rename_offer_revert_of_interrupted() noexcept;
+
+/// Partitions `expl.cwd_entries` by `filtered` and sorts the unfiltered ones by `expl.column_sort_specs`, see explorer.cpp.
+std::vector<explorer_window::dirent>::iterator
+sort_cwd_entries(explorer_window &expl, std::source_location sloc = std::source_location::current()) noexcept;
+
+/// Body of the finder's search task, walks `search_directories` recursively appending matches to `search_task.result`.
+void search_proc(progressive_task<std::vector<finder_window::match>> &search_task,
+                 std::vector<finder_window::search_directory> search_directories,
+                 std::atomic<u64> &num_entries_checked,
+                 std::array<char, 1024> search_value,
+                 bool detailed_symlinks) noexcept;
 
 std::optional<ntest::report_result> run_tests(std::filesystem::path const &output_path,
                                               void (*assertion_callback)(ntest::assertion const &, bool)) noexcept;
@@ -278,9 +427,13 @@ void erase(global_state::completed_file_operations &obj,
 
 void pop_back(global_state::completed_file_operations &obj) noexcept;
 
+void push_front(global_state::completed_file_operations &obj, completed_file_operation const &elem, u64 max_size) noexcept;
+
+void clear(global_state::completed_file_operations &obj) noexcept;
+
 void erase(global_state::recent_files &obj,
-           std::deque<recent_file>::iterator first,
-           std::deque<recent_file>::iterator last,
+           std::list<recent_file>::iterator first,
+           std::list<recent_file>::iterator last,
            bool delete_icon_texture = true) noexcept;
 
 void open_file_properties(char const *full_path_utf8) noexcept;
@@ -289,4 +442,22 @@ bool window_render_order_save_to_disk(std::array<swan_windows::id, (u64)swan_win
 
 std::array<swan_windows::id, (u64)swan_windows::id::count - 1> window_render_order_load_from_disk() noexcept;
 
-u64 recent_files_reorder_and_dedupe(std::deque<recent_file> &elems) noexcept;
+u64 recent_files_reorder_and_dedupe(std::list<recent_file> &elems) noexcept;
+
+struct state_snapshot_load_result
+{
+    std::array<bool, state_snapshot_section::kind_count> loaded;
+    swan_settings settings;
+    ImGuiStyle style;
+    std::array<swan_windows::id, (u64)swan_windows::id::count - 1> window_render_order;
+};
+
+state_snapshot_load_result state_snapshot_load_from_disk() noexcept;
+
+bool state_snapshot_save_to_disk(std::array<swan_windows::id, (u64)swan_windows::id::count - 1> const &window_render_order) noexcept;
+
+void persistence_write(std::filesystem::path full_path, std::string content, bool append = false) noexcept;
+
+void persistence_pump(std::array<swan_windows::id, (u64)swan_windows::id::count - 1> const &window_render_order, bool flush_all = false) noexcept;
+
+void persistence_flush(std::array<swan_windows::id, (u64)swan_windows::id::count - 1> const &window_render_order) noexcept;
@@ -0,0 +1,735 @@
+/*
+    Types and engines of Swan which depend on neither Win32 nor ImGui: paths, directory listings and their cache, sorting and
+    filtering of listings, the finder's traversal, bulk rename (text import, patterns, planning, journal replay) and the formats
+    directory jump and the state snapshot are persisted in. The filesystem is reached through platform.hpp only.
+
+    Built by every configuration, including GCC/Clang (swan_core) where they're tested like on Windows. swan_bench (bench.cpp)
+    is built from the core's sources alone, on either.
+    Left out, Win32 only: file operations (IFileOperation, the recycle bin, fast copy, mirroring), executing bulk renames and
+    writing their journal, resolving .lnk shortcuts, UTF-16 conversion and the GUI.
+
+    SWAN_HEADLESS builds (GCC/Clang) have no debug log and no profiler, the core's print_debug_msg calls and profiler zones
+    compile to nothing there.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <ostream>
+#include <regex>
+#include <source_location>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "primitives.hpp"
+#include "platform.hpp"
+#include "path.hpp"
+#include "util.hpp"
+
+#if !defined(SWAN_HEADLESS)
+#   if defined(_WIN32)
+#       define SWAN_HEADLESS 0
+#   else
+#       define SWAN_HEADLESS 1
+#   endif
+#endif
+
+#if SWAN_HEADLESS
+    struct headless_debug_msg
+    {
+        headless_debug_msg(char const *, std::source_location = std::source_location::current()) noexcept {}
+    };
+
+    template <typename... Args>
+    void print_debug_msg(headless_debug_msg, Args&&...) noexcept {}
+
+#   define SWAN_PROFILE_ZONE(name) ((void)0)
+#   define SWAN_PROFILE_FUNCTION() ((void)0)
+#endif
+
+/// Bundle of state for an asynchronous "progressive" task.
+/// Provides a facility to cancel the task and safely query the result before completion (hence progressive).
+/// Use when you need to read the result in a partially completed state.
+template <typename Result>
+struct progressive_task
+{
+    Result result = {};
+    std::mutex result_mutex = {};
+    std::atomic_bool started = false;
+    std::atomic_bool active_token = false;
+    std::atomic_bool cancellation_token = false;
+};
+
+/// Room for MAX_PATH (260) UTF-16 units less the NUL, at up to 4 UTF-8 bytes each, plus the NUL.
+struct swan_path final : std::array<char, ((260 - 1) * 4) + 1>
+{
+    // static swan_path create(char const *data, u64 count = u64(-1)) noexcept;
+
+    // u64 length() noexcept;
+
+    // bool ends_with(char const *end) noexcept;
+
+    // bool ends_with_one_of(char const *chars) noexcept;
+
+    // bool is_empty() noexcept;
+
+    // void clear() noexcept;
+
+    // void convert_separators(char new_dir_separator) noexcept;
+
+    // char pop_back() noexcept;
+    // bool pop_back_if(char if_ch) noexcept;
+    // bool pop_back_if_one_of(char const *chars_list) noexcept;
+    // bool pop_back_if_not(char if_not_ch) noexcept;
+
+    // u64 append(char const *append_data, char dir_separator = 0, bool prepend_slash = false, bool postpend_slash = false) noexcept;
+
+    // swan_path reconstruct_with_squished_separators() noexcept;
+
+    // swan_path reconstruct_canonically(char dir_sep_utf8) noexcept;
+
+    bool operator>(swan_path const &other) const noexcept { return strcmp(this->data(), other.data()) > 0; }
+    bool operator<(swan_path const &other) const noexcept { return strcmp(this->data(), other.data()) < 0; }
+};
+
+struct basic_dirent
+{
+    enum class kind : s8 {
+        nil = -1,
+        directory,
+        symlink_to_directory,
+        file,
+        symlink_to_file,
+        symlink_ambiguous,
+        invalid_symlink,
+        count
+    };
+
+    u64 size = 0;
+    platform_file_time creation_time_raw = 0;
+    platform_file_time last_write_time_raw = 0;
+    u32 id = {};
+    kind type = kind::nil;
+    swan_path path = {};
+
+    bool is_path_dotdot() const noexcept;
+    bool is_dotdot_dir() const noexcept;
+    bool is_directory() const noexcept;
+    bool is_symlink() const noexcept;
+    bool is_symlink_to_file() const noexcept;
+    bool is_symlink_to_directory() const noexcept;
+    bool is_symlink_ambiguous() const noexcept;
+    bool is_file() const noexcept;
+    char const *kind_cstr() const noexcept;
+    char const *kind_short_cstr() const noexcept; // GUI only, icon glyphs
+    char const *kind_icon() const noexcept; // GUI only, icon glyphs
+
+    static bool is_symlink(kind t) noexcept;
+    static char const *kind_description(kind t) noexcept;
+};
+
+/// Bounded LRU of recent directory listings shared by all explorers, so going back, forward or between siblings paints without
+/// enumerating the directory and resolving its .lnk files again. A listing is keyed by `path_loose_hash` of its directory and
+/// stamped with the directory's last write time from before it was enumerated, which changes whenever an entry is added, removed
+/// or renamed in it. A listing whose stamp no longer matches is stale. The stamp does not change when a file is written to in place,
+/// so a painted listing is also compared entry by entry against a fresh enumeration, off the main thread (see `same_entries_as`).
+/// Names are packed back to back in one buffer per listing.
+struct directory_listing_cache
+{
+    static u64 const MAX_LISTINGS = 32;
+    static u64 const MAX_ENTRIES_TOTAL = 256 * 1024;
+
+    struct entry
+    {
+        u64 size;
+        platform_file_time creation_time_raw;
+        platform_file_time last_write_time_raw;
+        u32 name_offset; // into `listing::names`
+        u16 name_len;
+        basic_dirent::kind type;
+    };
+
+    struct listing
+    {
+        u64 directory_key = 0;
+        platform_file_time directory_write_time = 0;
+        time_point_precise_t time_stored = {};
+        std::vector<entry> entries = {};
+        std::string names = {};
+
+        bool prefetched_unused = false; // stored by the prefetcher and not yet shown by an explorer
+
+        std::string_view name(entry const &e) const noexcept { return std::string_view(names.data() + e.name_offset, e.name_len); }
+
+        void append(basic_dirent const &dirent) noexcept;
+
+        /// Whether both listings hold the same names in the same order with the same sizes and write times.
+        /// Kinds are not compared, a shortcut resolved in one but not yet in the other is still the same entry.
+        bool same_entries_as(listing const &other) const noexcept;
+    };
+
+    std::list<listing> listings = {}; // most recently used first
+    std::unordered_map<u64, std::list<listing>::iterator> index = {}; // `listing::directory_key` -> listing
+    u64 num_entries_total = 0;
+    u64 num_hits = 0;
+    u64 num_misses = 0;
+    u64 num_stale = 0; // hits which revalidation found outdated
+    u64 num_prefetch_hits = 0; // hits on prefetched listings, each counted once
+    u64 num_prefetch_unused = 0; // prefetched listings evicted or replaced before any explorer showed them
+
+    bool contains(u64 directory_key) const noexcept { return this->index.contains(directory_key); }
+
+    /// Replaces any listing of the same directory, then evicts the least recently used listings beyond the limits.
+    void store(listing &&new_listing) noexcept;
+
+    /// Marks the listing most recently used and counts a hit, or counts a miss.
+    listing const *find(u64 directory_key) noexcept;
+
+    bool erase(u64 directory_key) noexcept;
+    void clear() noexcept;
+};
+
+enum class directory_listing_enumerate_result : u8
+{
+    success,
+    failed,
+    too_many_entries,
+};
+
+/// Known kind of the target of the .lnk file at `lnk_path_utf8` as last written at `lnk_write_time`, false if it isn't known.
+typedef bool (*shortcut_kind_lookup_t)(char const *lnk_path_utf8, platform_file_time lnk_write_time, basic_dirent::kind &out) noexcept;
+
+/// Enumerates `directory_utf8` into `out` the way explorers list a directory, ".." included unless it's a root. .lnk files (outside
+/// the recycle bin) get their target's kind from `find_shortcut_kind`, or `symlink_ambiguous` when it isn't known yet; without
+/// `find_shortcut_kind` they are files. `out` is stamped with the directory's last write time from before enumerating, 0 if
+/// unknown, so a change made meanwhile leaves the listing stale rather than wrong.
+directory_listing_enumerate_result directory_listing_enumerate(
+    char const *directory_utf8,
+    u64 max_entries,
+    directory_listing_cache::listing &out,
+    shortcut_kind_lookup_t find_shortcut_kind = nullptr) noexcept;
+
+struct finder_match
+{
+    basic_dirent basic = {};
+    char const *file_name = nullptr;
+    ptrdiff_t highlight_start_idx = 0;
+    u64 highlight_len = 0;
+};
+
+/// What the finder's traversal calls back into, both optional. Called on the traversing thread.
+struct finder_traversal_hooks
+{
+    void (*progress)() noexcept = nullptr; // every 1024 entries checked and after every match
+    basic_dirent::kind (*resolve_shortcut)(char const *lnk_path_utf8, platform_file_time lnk_write_time) noexcept = nullptr; // .lnk matches, when `detailed_symlinks`
+};
+
+/// Walks `directory_path_utf8` and everything below it, appending entries whose name contains `search_value` (case-sensitive)
+/// to `search_task.result`. Stops early once `search_task.cancellation_token` is set.
+void traverse_directory_recursively(swan_path const &directory_path_utf8,
+                                    std::atomic<u64> &num_entries_checked,
+                                    progressive_task<std::vector<finder_match>> &search_task,
+                                    char const *search_value,
+                                    u64 search_value_len,
+                                    bool detailed_symlinks,
+                                    finder_traversal_hooks const &hooks = {}) noexcept;
+
+/// One key of a multi-key sort of a listing, as the columns of an explorer's table sort it.
+struct dirent_sort_spec
+{
+    enum class key : u8
+    {
+        id,
+        path,
+        kind, // directories before everything else
+        size,
+        creation_time,
+        last_write_time,
+        size_on_disk, // of `sorted_size_on_disk`, filled by the caller beforehand
+    };
+
+    key by;
+    bool ascending; // as the explorer's columns mean it: names A to Z, but the largest sizes, times and ids and directories first
+};
+
+/// Partitions `dirents` by `filtered`, then sorts the unfiltered ones by `specs`, the first spec deciding first and `basic.id`
+/// breaking ties. Returns the start of the filtered ones, whose order is undefined.
+/// `Dirent` has members `basic`, `filtered` and `sorted_size_on_disk`, as `explorer_window::dirent` and `listed_dirent` do.
+template <typename Dirent>
+typename std::vector<Dirent>::iterator
+sort_dirents(std::vector<Dirent> &dirents, std::span<dirent_sort_spec const> specs) noexcept
+{
+    auto first_filtered_dirent = std::partition(dirents.begin(), dirents.end(), [](Dirent const &dirent) noexcept {
+        return !dirent.filtered;
+    });
+
+    static s32 const s_kind_precedence[(u64)basic_dirent::kind::count] = {
+        10, // directory
+        10, // symlink_to_directory
+        5,  // file
+        5,  // symlink_to_file
+        5,  // symlink_ambiguous
+        5,  // invalid_symlink
+    };
+
+    auto three_way = [](auto const &left, auto const &right) noexcept -> s64 { return s64(left > right) - s64(left < right); };
+
+    std::sort(dirents.begin(), first_filtered_dirent, [&](Dirent const &left, Dirent const &right) noexcept -> bool {
+        for (auto const &spec : specs) {
+            s64 delta = 0;
+
+            switch (spec.by) {
+                default:
+                case dirent_sort_spec::key::id:              delta = three_way(left.basic.id, right.basic.id); break;
+                case dirent_sort_spec::key::path:            delta = platform_compare_names(right.basic.path.data(), left.basic.path.data()); break;
+                case dirent_sort_spec::key::kind: {
+                    assert((s32)left.basic.type >= 0 && (s32)right.basic.type >= 0);
+                    delta = s_kind_precedence[(u64)left.basic.type] - s_kind_precedence[(u64)right.basic.type];
+                    break;
+                }
+                case dirent_sort_spec::key::size:            delta = three_way(left.basic.size, right.basic.size); break;
+                case dirent_sort_spec::key::creation_time:   delta = three_way(left.basic.creation_time_raw, right.basic.creation_time_raw); break;
+                case dirent_sort_spec::key::last_write_time: delta = three_way(left.basic.last_write_time_raw, right.basic.last_write_time_raw); break;
+                case dirent_sort_spec::key::size_on_disk:    delta = three_way(left.sorted_size_on_disk, right.sorted_size_on_disk); break;
+            }
+
+            if (delta != 0) {
+                return (delta > 0) == spec.ascending;
+            }
+        }
+
+        return left.basic.id < right.basic.id;
+    });
+
+    return first_filtered_dirent;
+}
+
+/// What `filter_dirents` keeps.
+struct dirent_filter
+{
+    enum class mode : u8
+    {
+        contains,
+        regex_match, // of the whole name
+    };
+
+    char const *text = "";
+    mode how = mode::contains;
+    bool case_sensitive = false;
+    bool polarity = true; // false keeps the entries which don't match instead
+    bool kind_visible[(u64)basic_dirent::kind::count] = {};
+};
+
+/// Sets `filtered`, `highlight_start_idx` and `highlight_len` of every entry of `dirents` by `filter`.
+/// A regex is compiled once for all entries. If it doesn't compile the entries are filtered by kind alone and the error is
+/// returned, empty otherwise. The time taken to compile it goes into `regex_compile_us`, unless null.
+template <typename Dirent>
+std::string filter_dirents(std::vector<Dirent> &dirents, dirent_filter const &filter, f64 *regex_compile_us = nullptr) noexcept
+try {
+    u64 filter_text_len = strlen(filter.text);
+    std::regex regex = {};
+    bool apply_text = filter_text_len > 0;
+    std::string error = {};
+
+    if (apply_text && filter.how == dirent_filter::mode::regex_match) {
+        auto compile_start = get_time_precise();
+        try {
+            auto syntax = filter.case_sensitive ? std::regex_constants::ECMAScript : std::regex_constants::ECMAScript | std::regex_constants::icase;
+            regex = std::regex(filter.text, syntax);
+        }
+        catch (std::exception const &except) {
+            error = except.what();
+            apply_text = false;
+        }
+        if (regex_compile_us) {
+            *regex_compile_us = f64(time_diff_us(compile_start, get_time_precise()));
+        }
+    }
+
+    for (auto &dirent : dirents) {
+        assert((s32)dirent.basic.type != -1);
+        bool visible = filter.kind_visible[(u64)dirent.basic.type];
+
+        dirent.filtered = !visible;
+        dirent.highlight_start_idx = 0;
+        dirent.highlight_len = 0;
+
+        if (!visible || !apply_text) {
+            continue;
+        }
+
+        char const *dirent_name = dirent.basic.path.data();
+
+        if (filter.how == dirent_filter::mode::regex_match) {
+            bool filtered_out = filter.polarity != std::regex_match(dirent_name, regex);
+            dirent.filtered = filtered_out;
+
+            if (!filtered_out && filter.polarity) {
+                // highlight the whole name since the whole name matched
+                dirent.highlight_len = path_length(dirent.basic.path);
+            }
+        }
+        else {
+            char const *match_start = platform_find_substring(dirent_name, filter.text, filter.case_sensitive);
+            bool filtered_out = filter.polarity != (match_start != nullptr);
+            dirent.filtered = filtered_out;
+
+            if (!filtered_out && filter.polarity) {
+                // highlight just the substring
+                dirent.highlight_start_idx = match_start - dirent_name;
+                dirent.highlight_len = filter_text_len;
+            }
+        }
+    }
+
+    return error;
+}
+catch (std::exception const &except) {
+    return except.what();
+}
+catch (...) {
+    return "catch(...)";
+}
+
+/// An entry of a listing with what sorting and filtering it needs and nothing else, for listings without a GUI.
+struct listed_dirent
+{
+    basic_dirent basic = {};
+    ptrdiff_t highlight_start_idx = 0;
+    u64 highlight_len = 0;
+    u64 sorted_size_on_disk = 0;
+    bool filtered = false;
+};
+
+/// Frecency database of every directory visited in any explorer, ranked the way zoxide ranks them: a visit adds 1 to the
+/// directory's rank, ranks are scaled down once their total passes `MAX_TOTAL_RANK` (forgetting anything that drops below 1),
+/// and a query weighs rank by how recently the directory was last visited.
+/// Paths are packed back to back in one buffer, next to an ASCII case folded copy which queries scan linearly.
+struct directory_jump_index
+{
+    static constexpr f64 MAX_TOTAL_RANK = 10'000;
+
+    struct entry
+    {
+        u32 path_offset; // into `paths` and `folded_paths`
+        u16 path_len;
+        u16 name_offset; // start of the last path component, relative to `path_offset`
+        f32 rank;
+        u32 last_visit; // seconds since the unix epoch
+        u64 path_key; // `path_loose_hash` of the path
+        u64 char_mask; // a bit per distinct folded char in the path, lets a query skip paths missing one of its chars
+    };
+
+    struct match
+    {
+        u32 entry_idx;
+        f32 score;
+    };
+
+    std::vector<entry> entries = {};
+    std::string paths = {};
+    std::string folded_paths = {};
+    std::unordered_map<u64, u32> index = {}; // `path_key` -> idx into `entries`
+    f64 total_rank = 0;
+    u64 num_unused_bytes = 0; // in `paths` and `folded_paths`, left behind by forgotten entries
+
+    std::string_view path(entry const &e) const noexcept { return std::string_view(paths.data() + e.path_offset, e.path_len); }
+
+    void visit(std::string_view path, u32 now) noexcept;
+    bool forget(std::string_view path) noexcept;
+    void query(char const *text, u32 now, u64 exclude_path_key, u64 max_matches, std::vector<match> &out) const noexcept;
+    void clear() noexcept;
+
+    std::string serialize() const noexcept;
+    bool deserialize(std::string_view data) noexcept;
+
+private:
+    u32 append(std::string_view path, f32 rank, u32 last_visit) noexcept;
+    void age() noexcept;
+    void compact() noexcept;
+};
+
+struct state_snapshot_section
+{
+    enum kind : u32
+    {
+        kind_settings = 0,
+        kind_pinned,
+        kind_recent_files,
+        kind_completed_file_operations,
+        kind_explorer_0,
+        kind_explorer_1,
+        kind_explorer_2,
+        kind_explorer_3,
+        kind_window_render_order,
+        kind_directory_jump,
+        kind_count
+    };
+
+    kind id;
+    u64 source_write_time; // FILETIME, 0 if the file didn't exist
+    u64 source_size;
+    std::string_view data;
+};
+
+/// Reads the fields sections of the state snapshot are encoded in, see state_snapshot_format.cpp.
+/// Reading past the end yields zeroes and clears `ok`.
+struct state_snapshot_reader
+{
+    std::string_view data;
+    bool ok = true;
+
+    template <typename Ty>
+    Ty take() noexcept
+    {
+        Ty value = {};
+        if (this->data.size() < sizeof(Ty)) {
+            this->ok = false;
+            this->data = {};
+        } else {
+            memcpy(&value, this->data.data(), sizeof(Ty));
+            this->data.remove_prefix(sizeof(Ty));
+        }
+        return value;
+    }
+
+    std::string_view take_str() noexcept
+    {
+        u16 len = this->take<u16>();
+        if (this->data.size() < len) {
+            this->ok = false;
+            this->data = {};
+            return {};
+        }
+        std::string_view str = this->data.substr(0, len);
+        this->data.remove_prefix(len);
+        return str;
+    }
+
+    swan_path take_path() noexcept
+    {
+        std::string_view str = this->take_str();
+        if (str.size() >= swan_path().max_size()) {
+            this->ok = false;
+            return {};
+        }
+        return path_create(str.data(), str.size());
+    }
+};
+
+template <typename Ty>
+void state_snapshot_put(std::string &out, Ty const &value)
+{
+    out.append((char const *)&value, sizeof(value));
+}
+
+inline
+void state_snapshot_put_str(std::string &out, std::string_view str)
+{
+    assert(str.size() <= UINT16_MAX);
+    state_snapshot_put(out, u16(str.size()));
+    out.append(str);
+}
+
+std::string state_snapshot_pack(std::vector<state_snapshot_section> const &sections) noexcept;
+
+/// Validates `snapshot` and splits it into sections which point into it. Fails, leaving `out` empty, on a bad magic, another version,
+/// a truncated file, a checksum mismatch or a section overrunning the payload.
+bool state_snapshot_unpack(std::string_view snapshot, std::vector<state_snapshot_section> &out) noexcept;
+
+/// Writes `content` to a temporary file next to `full_path` then renames it over `full_path`,
+/// so whoever reads `full_path` sees either the previous content or all of the new one, even if Swan dies mid-write.
+bool write_file_atomically(std::filesystem::path const &full_path, std::string_view content) noexcept;
+
+struct bulk_rename_transform
+{
+    enum class status : u8 {
+        error_name_empty,
+        execute_failed,
+        revert_failed,
+        ready,
+        execute_success,
+        revert_success,
+        name_unchanged,
+        count
+    };
+
+    std::string error = {};
+    time_point_precise_t last_updated_time = get_time_precise();
+    bool input_focused = false;
+    bool selected = false;
+
+    std::atomic<status> stat;
+    basic_dirent::kind obj_type;
+    u64 size = 0; // for the <size> pattern expression
+    std::string after_key = {}; // `after` case folded as last counted by `bulk_rename_collision_index`, empty if not counted
+    swan_path before;
+    swan_path after;
+
+    bulk_rename_transform(basic_dirent const *before, char const *after) noexcept;
+    bulk_rename_transform(basic_dirent::kind obj_type, char const *before, char const *after) noexcept;
+
+    bulk_rename_transform(bulk_rename_transform const &other) noexcept; // for emplace_back
+    bulk_rename_transform &operator=(bulk_rename_transform const &other) noexcept; // for emplace_back
+
+    bool operator!=(bulk_rename_transform const &other) const noexcept; // for ntest
+    friend std::ostream& operator<<(std::ostream &os, bulk_rename_transform const &r); // for ntest
+
+    /// Win32 only, see popup_modal_bulk_rename.cpp.
+    std::string execute(wchar_t const *working_directory, std::wstring &builder_before, std::wstring &builder_after) const noexcept;
+    std::string revert(wchar_t const *working_directory, std::wstring &builder_before, std::wstring &builder_after) const noexcept;
+};
+
+/// Case-insensitive multiset of the names a directory will hold once a bulk rename executes: the entries not being renamed
+/// plus every transform's non-empty `after`. Keyed by the case folded name, folded by the same rule the preview and the plan
+/// compare under, so an edited `after` is an O(1) update and a row can be checked for conflicts in O(1) as it is rendered,
+/// rather than sorting everything on every keystroke. An empty `after` isn't counted, its row reports it as empty instead.
+struct bulk_rename_collision_index
+{
+    std::unordered_map<std::string, u32> counts = {};
+    u64 num_conflicting = 0; // final names which share their name with at least one other
+
+    static std::string key(char const *name) noexcept; // empty for an empty name
+
+    void rebuild(std::vector<std::string> const &untouched_keys, std::vector<bulk_rename_transform> &transforms) noexcept;
+    void update(bulk_rename_transform &transform) noexcept; // call after `transform.after` changes
+    bool conflicts(bulk_rename_transform const &transform) const noexcept;
+
+    void add(std::string const &key) noexcept;
+    void remove(std::string const &key) noexcept;
+};
+
+/// A bulk rename pattern such as `<name>_<counter:3>.<ext>` compiled once into a flat program,
+/// so applying it to many transforms does no parsing. Runs of literal text share one instruction.
+struct bulk_rename_pattern
+{
+    enum class opcode : u8
+    {
+        literal,    // `literals[a, a+b)`
+        name,       // name without extension
+        ext,        // extension without dot, nothing if none
+        dotext,     // extension with dot, nothing if none
+        counter,    // counter zero padded to `a` digits
+        size,       // size in bytes
+        slice,      // characters [a, b] of the full name, b == UINT16_MAX for until the end
+    };
+
+    struct instruction
+    {
+        opcode op;
+        u16 a;
+        u16 b;
+    };
+
+    std::vector<instruction> program = {};
+    std::string literals = {};
+};
+
+struct bulk_rename_compile_pattern_result
+{
+    bool success;
+    bulk_rename_pattern pattern;
+    std::array<char, 256> error;
+};
+
+/// Output of applying a `bulk_rename_pattern` to a range of transforms. Kept around and reused between
+/// applications so live previews don't reallocate on every keystroke.
+struct bulk_rename_preview
+{
+    enum class problem : u8
+    {
+        none,
+        empty,
+        too_long,
+        slice_out_of_bounds,
+        ends_with_dot,
+    };
+
+    std::vector<char> arena = {};        // all resulting names back to back, each NUL terminated
+    std::vector<u64> offsets = {};       // `arena.data() + offsets[i]` is the resulting name of transform `i`
+    std::vector<problem> problems = {};
+    std::vector<u64> hashes = {};        // case-insensitive hash of each resulting name
+    std::vector<u32> table = {};         // open addressing table of transform indices, for duplicate detection
+    u64 num_problems = 0;
+    u64 num_collisions = 0;             // resulting names equal (ignoring case) to an earlier resulting name
+    u64 first_collision_idx = u64(-1);
+
+    char const *name(u64 idx) const noexcept { return this->arena.data() + this->offsets[idx]; }
+};
+
+/// Order in which the renames of a bulk rename must happen so that no rename targets a name still held by another transform,
+/// e.g. swapping [a] and [b], or renumbering [img_001..img_999] up by one.
+/// Each job is a dependency chain (strictly speaking a tree) which must run in order, separate jobs are independent.
+struct bulk_rename_plan
+{
+    enum class step_kind : u8
+    {
+        direct,     // source name -> target name
+        to_temp,    // source name -> temporary name, breaks a cycle
+        from_temp,  // temporary name -> target name, once the cycle's other renames have freed it
+    };
+
+    struct step
+    {
+        u32 transform_idx;
+        step_kind kind;
+    };
+
+    std::vector<std::vector<step>> jobs = {};
+    u64 num_steps = 0;
+    u64 num_cycles = 0;
+};
+
+/// Renames of a modal session not closed normally which are still in place according to the journal, as transforms from
+/// `before` (the original name) to `after` (the current name) with status `execute_success`, ready to be reverted.
+struct bulk_rename_recovery
+{
+    swan_path working_directory = {};
+    std::vector<bulk_rename_transform> transforms = {};
+};
+
+std::tuple<bool, u64, u64> bulk_rename_parse_text_import(
+    char const *text,
+    std::vector<swan_path> &transforms_after,
+    u64 max_idx,
+    std::vector<std::string> &errors) noexcept;
+
+std::tuple<bool, std::string, u64> bulk_rename_parse_text_import_regex(
+    char const *text,
+    std::vector<swan_path> &transforms_after,
+    u64 max_idx,
+    std::vector<std::string> &errors) noexcept;
+
+/// Replays the contents of a bulk rename journal, see `bulk_rename_journal`.
+/// Outcomes missing from an unterminated transaction are inferred from the filesystem only if `probe_filesystem`.
+std::vector<bulk_rename_recovery> bulk_rename_journal_replay(std::string_view journal, bool probe_filesystem) noexcept;
+
+bulk_rename_compile_pattern_result bulk_rename_compile_pattern(char const *pattern, bool squish_adjacent_spaces) noexcept;
+
+/// Applies `pattern` to every transform in parallel, transform `i` gets counter value `counter_start + i * counter_step`.
+void bulk_rename_apply_pattern(
+    bulk_rename_pattern const &pattern,
+    std::span<bulk_rename_transform const> transforms,
+    s64 counter_start,
+    s64 counter_step,
+    bulk_rename_preview &out) noexcept;
+
+/// Plans renames from `before` to `after` (or `after` to `before` when `reverse`) for transforms whose status is
+/// `ready` (or `execute_success` when `reverse`). Names are compared case-insensitively.
+bulk_rename_plan bulk_rename_build_plan(std::vector<bulk_rename_transform> const &transforms, bool reverse, bool selected_only) noexcept;
+
+/// Runs the tests of the core engines, creating and removing files under `scratch_directory_utf8`. See tests_core_engines.cpp.
+void run_core_engine_tests(char const *scratch_directory_utf8) noexcept;
@@ -14,8 +14,9 @@ using static_vector = boost::container::static_vector<ElemTy, Size>;
 
 typedef BS::thread_pool swan_thread_pool_t;
 
-#include "path.hpp"
-#include "util.hpp"
+#include "core.hpp"
+
+static_assert(sizeof(swan_path) == ((MAX_PATH - 1) * 4) + 1);
 
 inline ImVec4 default_success_color() noexcept { return ImVec4(0, 1, 0, 1); }
 inline ImVec4 default_warning_color() noexcept { return ImVec4(1, 0.5f, 0, 1); }
@@ -25,19 +26,6 @@ inline ImVec4 default_directory_color() noexcept { return ImVec4(1, 1, 0, 1); }
 inline ImVec4 default_symlink_color() noexcept { return ImVec4(220/255.f, 189/255.f, 251/255.f, 1); }
 inline ImVec4 default_file_color() noexcept { return ImVec4(0.85f, 1, 0.85f, 1); }
 
-/// Bundle of state for an asynchronous "progressive" task.
-/// Provides a facility to cancel the task and safely query the result before completion (hence progressive).
-/// Use when you need to read the result in a partially completed state.
-template <typename Result>
-struct progressive_task
-{
-    Result result = {};
-    std::mutex result_mutex = {};
-    std::atomic_bool started = false;
-    std::atomic_bool active_token = false;
-    std::atomic_bool cancellation_token = false;
-};
-
 /// Bundle of state for an asynchronous task.
 /// Provides a facility to cancel the task, but does not provide a way to safely query the result before completion.
 /// Use when you DON'T need to read the result until the task is completed or cancelled.
@@ -63,73 +51,6 @@ struct winapi_error
     std::string formatted_message;
 };
 
-struct swan_path final : std::array<char, ((MAX_PATH - 1) * 4) + 1>
-{
-    // static swan_path create(char const *data, u64 count = u64(-1)) noexcept;
-
-    // u64 length() noexcept;
-
-    // bool ends_with(char const *end) noexcept;
-
-    // bool ends_with_one_of(char const *chars) noexcept;
-
-    // bool is_empty() noexcept;
-
-    // void clear() noexcept;
-
-    // void convert_separators(char new_dir_separator) noexcept;
-
-    // char pop_back() noexcept;
-    // bool pop_back_if(char if_ch) noexcept;
-    // bool pop_back_if_one_of(char const *chars_list) noexcept;
-    // bool pop_back_if_not(char if_not_ch) noexcept;
-
-    // u64 append(char const *append_data, char dir_separator = 0, bool prepend_slash = false, bool postpend_slash = false) noexcept;
-
-    // swan_path reconstruct_with_squished_separators() noexcept;
-
-    // swan_path reconstruct_canonically(char dir_sep_utf8) noexcept;
-
-    bool operator>(swan_path const &other) const noexcept { return strcmp(this->data(), other.data()) > 0; }
-    bool operator<(swan_path const &other) const noexcept { return strcmp(this->data(), other.data()) < 0; }
-};
-
-struct basic_dirent
-{
-    enum class kind : s8 {
-        nil = -1,
-        directory,
-        symlink_to_directory,
-        file,
-        symlink_to_file,
-        symlink_ambiguous,
-        invalid_symlink,
-        count
-    };
-
-    u64 size = 0;
-    FILETIME creation_time_raw = {};
-    FILETIME last_write_time_raw = {};
-    u32 id = {};
-    kind type = kind::nil;
-    swan_path path = {};
-
-    bool is_path_dotdot() const noexcept;
-    bool is_dotdot_dir() const noexcept;
-    bool is_directory() const noexcept;
-    bool is_symlink() const noexcept;
-    bool is_symlink_to_file() const noexcept;
-    bool is_symlink_to_directory() const noexcept;
-    bool is_symlink_ambiguous() const noexcept;
-    bool is_file() const noexcept;
-    char const *kind_cstr() const noexcept;
-    char const *kind_short_cstr() const noexcept;
-    char const *kind_icon() const noexcept;
-
-    static bool is_symlink(kind t) noexcept;
-    static char const *kind_description(kind t) noexcept;
-};
-
 struct drive_info
 {
     u64 total_bytes;
@@ -195,6 +116,7 @@ struct swan_settings
 
     bool file_operations_src_path_full = true;
     bool file_operations_dst_path_full = true;
+    bool file_operations_verify_copies = false;
 
     bool startup_with_window_maximized = true;
     bool startup_with_previous_window_pos_and_size = true;
@@ -233,6 +155,7 @@ struct swan_settings
         bool theme_editor = false;
         bool icon_library = false;
         bool imspinner_demo = false;
+        bool disk_usage = false;
     };
 
     window_visibility show;
@@ -250,12 +173,16 @@ struct swan_settings
 
 enum update_cwd_entries_actions : u8
 {
-    nil              = 0b00, // 0
-    query_filesystem = 0b01, // 1
-    filter           = 0b10, // 2
-    full_refresh     = 0b11, // 3
+    nil                     = 0b000, // 0
+    query_filesystem        = 0b001, // 1
+    filter                  = 0b010, // 2
+    full_refresh            = 0b011, // 3
+    prefer_listing_cache    = 0b100, // 4, only meaningful with query_filesystem
+    query_filesystem_cached = 0b101, // 5, query_filesystem through directory_listing_cache, see update_cwd_entries
 };
 
+struct directory_size_job; // further below
+
 struct explorer_window
 {
     struct dirent
@@ -274,6 +201,9 @@ struct explorer_window
         std::array<char, 32> formatted_size;
     #endif
 
+        u32 size_job_slot = u32(-1); // into `explorer_window::size_job`, for directories
+        u64 sorted_size_on_disk = 0; // copied before sorting by "On disk", as walks keep adding to the job's sizes
+
         bool filtered = false;
         bool selected = false;
         bool cut = false;
@@ -299,6 +229,7 @@ struct explorer_window
         cwd_entries_table_col_size_bytes,
         cwd_entries_table_col_creation_time,
         cwd_entries_table_col_last_write_time,
+        cwd_entries_table_col_size_on_disk,
         cwd_entries_table_col_count
     };
 
@@ -389,6 +320,12 @@ struct explorer_window
     dirent *context_menu_target = nullptr;
     s64 tabbing_focus_idx = -1;
     std::vector<dirent>::iterator first_filtered_cwd_dirent_iter;
+    std::atomic<u64> stale_cached_listing_key = 0; // set off the main thread when the cwd was painted from an outdated listing
+    std::atomic<u64> resolved_shortcuts_key = 0; // set off the main thread when more .lnk entries of this directory can be classified
+    u64 prefetched_for_cwd_key = 0; // `path_loose_hash` of the cwd the prefetcher was last given candidates for
+    u64 prefetched_hovered_key = 0;
+    std::shared_ptr<directory_size_job> size_job = nullptr; // while the "On disk" column is shown
+    bool size_job_sorted = false;
 
     static u64 const NUM_TIMING_SAMPLES = 10;
 
@@ -469,13 +406,7 @@ struct finder_window
         swan_path path_utf8;
     };
 
-    struct match
-    {
-        basic_dirent basic = {};
-        char const *file_name = nullptr;
-        ptrdiff_t highlight_start_idx = 0;
-        u64 highlight_len = 0;
-    };
+    typedef finder_match match;
 
     progressive_task<std::vector<finder_window::match>> search_task = {};
     std::array<char, 1024> search_value = {};
@@ -518,7 +449,96 @@ struct file_operation_command_buf
     std::vector<item> items = {};
 
     void clear() noexcept;
-    generic_result execute(explorer_window &expl) noexcept;
+    generic_result execute(explorer_window &expl, bool verify_copies) noexcept;
+};
+
+/// One-way sync of a source directory tree into a destination directory tree. The plan holds the minimal set of
+/// copies, updates and deletes which make the destination match the source; subtrees missing on one side are a single entry.
+struct mirror_plan
+{
+    enum class action : char
+    {
+        copy = 'C',
+        update = 'U',
+        del = 'D',
+    };
+
+    struct options
+    {
+        bool delete_extras = true; // delete what exists in the destination but not in the source
+        bool compare_contents = false; // hash files of equal size instead of trusting last write times
+    };
+
+    struct entry
+    {
+        u64 src_size;
+        u64 dst_size;
+        action act;
+        basic_dirent::kind type;
+        std::wstring relative_path_utf16; // relative to both roots, backslash separated
+    };
+
+    std::vector<entry> entries = {};
+    std::vector<std::string> errors = {};
+    u64 num_bytes_to_copy = 0;
+    u64 num_copies = 0;
+    u64 num_updates = 0;
+    u64 num_deletes = 0;
+};
+
+/// Outcome of comparing the contents of a copied file against its source, stored as a char so it reads well when persisted.
+enum class file_operation_verification : char
+{
+    none = '-',     // verification not requested, or not applicable (directories, moves, deletes)
+    pending = 'P',  // copy completed, hashes being computed
+    match = 'V',    // source and destination hash the same
+    mismatch = 'X', // source and destination differ
+    failed = 'F',   // could not read source or destination to compare them
+};
+
+/// How the bytes of a copied file got to the destination, stored as a char so it reads well when persisted.
+enum class file_copy_strategy : char
+{
+    none = '-',     // not a copy, or a directory (its contents are copied by IFileOperation)
+    full = 'F',     // byte for byte, by IFileOperation
+    clone = 'C',    // block clone, destination shares extents with source (ReFS)
+    sparse = 'S',   // only allocated ranges of a sparse source were copied, holes stay holes
+};
+
+/// What `choose_fast_copy_strategy` decides on, gathered by `try_fast_copy_file`.
+struct fast_copy_candidate
+{
+    DWORD src_attributes;
+    DWORD src_volume_serial;
+    DWORD src_fs_flags;
+    DWORD dst_volume_serial;
+    DWORD dst_fs_flags;
+    bool src_has_alternate_streams;
+    bool src_has_explicit_security; // DACL protected from inheritance, or holding ACEs of its own
+};
+
+/// Volume information `try_fast_copy_file` would otherwise query for every file, kept across the files of one paste.
+struct fast_copy_volume_cache
+{
+    struct source_volume
+    {
+        DWORD serial;
+        DWORD fs_flags;
+    };
+
+    std::wstring dst_directory_utf16 = {}; // the directory the dst_ fields were queried for
+    DWORD dst_volume_serial = 0;
+    DWORD dst_fs_flags = 0;
+    bool dst_queried = false;
+    bool dst_valid = false; // false if the directory could not be opened or its volume queried
+    std::vector<source_volume> src_volumes = {}; // a paste rarely spans more than a couple, searched linearly
+};
+
+struct file_hash_result
+{
+    bool success;
+    u64 hash;
+    u64 num_bytes;
 };
 
 struct completed_file_operation
@@ -534,6 +554,8 @@ struct completed_file_operation
     swan_path dst_path = {};
     file_operation_type op_type = file_operation_type::nil;
     basic_dirent::kind obj_type = basic_dirent::kind::nil;
+    file_operation_verification verification = file_operation_verification::none;
+    file_copy_strategy copy_strategy = file_copy_strategy::none;
     bool selected = false;
 
     bool undone() const noexcept { return undo_time != time_point_system_t(); }
@@ -546,6 +568,47 @@ struct completed_file_operation
     completed_file_operation &operator=(completed_file_operation const &other) noexcept;
 };
 
+/// Index over the completed file operations history, maps a group_id to the span of records which belong to it.
+/// Every record is given a sequence number which increases towards the front of the history deque,
+/// the record at deque index `i` has sequence number `front_seq - i`. Keeping spans in sequence numbers rather than
+/// deque indices means records pushed to the front or popped from the back don't invalidate existing spans.
+struct completed_file_operation_group_index
+{
+    struct span
+    {
+        u64 newest_seq; // sequence number of the frontmost record in the group
+        u64 oldest_seq; // sequence number of the backmost record in the group
+        u64 count;      // number of records in the group, equals (newest_seq - oldest_seq + 1) unless interleaved with another group
+    };
+
+    std::unordered_map<u32, span> spans = {};
+    u64 front_seq = 0;
+    u64 num_records = 0; // mirrors size of the history deque, used to clamp spans whose bounds outlived the records they referred to
+    std::atomic<u32> next_group_id = 1; // monotonic, 0 is reserved for "no group"
+
+    void clear() noexcept;
+    void rebuild(std::deque<completed_file_operation> const &container) noexcept;
+    void on_push_front(u32 group_id) noexcept;
+    void on_pop_back(u32 group_id, u64 container_size_before_pop) noexcept;
+    void on_erase(std::deque<completed_file_operation> const &container, u64 first_idx, u64 last_idx) noexcept;
+    u32 acquire_group_id() noexcept;
+
+    /// Returns the half-open range of deque indices [first, last) spanned by `group_id`, or { 0, 0 } if the group is unknown.
+    /// The range contains only records of `group_id` unless the group was interleaved with a concurrent operation,
+    /// callers that care should still compare `group_id` of the records within the range.
+    std::pair<u64, u64> index_range(u32 group_id) const noexcept;
+};
+
+/// Progress of a file operation Swan performs itself (as opposed to delegating to IFileOperation), shown in the File Operations window.
+struct file_operation_progress
+{
+    std::atomic<u64> work_total = 0; // grows while the operation discovers more work
+    std::atomic<u64> work_so_far = 0;
+    std::atomic<u64> num_failed = 0;
+    std::atomic_bool active = false;
+    std::atomic_bool cancellation_token = false;
+};
+
 struct explorer_file_op_progress_sink : public IFileOperationProgressSink
 {
 private:
@@ -557,8 +620,17 @@ public:
     s32 dst_expl_id;
     s32 num_max_file_operations;
     swan_path dst_expl_cwd_when_operation_started;
+    std::shared_ptr<std::atomic<u64>> num_verifications_outstanding;
+    file_operation_progress *progress; // only for operations Swan performs itself, UpdateProgress reports cancellation through it
     bool contains_delete_operations;
+    bool verify_copies;
     char dir_sep_utf8;
+    std::atomic<u64> num_recent_files_changed = 0; // permanent delete records from several workers at once
+    std::vector<recent_files_directory_change> recent_files_directory_changes = {}; // applied together by FinishOperations
+    std::mutex recent_files_directory_changes_mutex = {};
+
+    void push_completed_copy(wchar_t const *src_path_utf16, wchar_t const *dst_path_utf16, basic_dirent::kind obj_type, file_copy_strategy strategy) noexcept;
+    void push_completed_delete(char const *deleted_path_utf8, char const *recycle_bin_path_utf8, basic_dirent::kind obj_type) noexcept;
 
     HRESULT PauseTimer() noexcept override;
     HRESULT ResetTimer() noexcept override;
@@ -588,6 +660,7 @@ public:
 struct undelete_directory_progress_sink : public IFileOperationProgressSink
 {
     swan_path destination_full_path_utf8;
+    u64 num_recent_files_changed = 0;
 
     HRESULT PauseTimer() noexcept override;
     HRESULT ResetTimer() noexcept override;
@@ -649,44 +722,251 @@ struct recent_file
     s64 icon_GLtexID = 0;
     ImVec2 icon_size = {};
     swan_path path = {};
-    std::string path2 = {}; // placed as temporary alternative to `path`, useful for some search/delete algorithms
     bool selected = false;
+    u64 path_key = 0; // `path_loose_hash` of `path`, key of the recent files index
 };
 
-struct bulk_rename_transform
+/// A directory renamed, moved or undeleted from `old_path` to `new_path`, or deleted into `recycle_bin_path` (empty when deleted
+/// for good). Collected over a bulk rename or file operation and applied together by `global_state::recent_files_directories_changed`.
+struct recent_files_directory_change
 {
-    enum class status : u8 {
-        error_name_empty,
-        execute_failed,
-        revert_failed,
-        ready,
-        execute_success,
-        revert_success,
-        name_unchanged,
-        count
+    std::string old_path;
+    std::string new_path;
+    std::string recycle_bin_path;
+    bool deleted;
+};
+
+/// Kind of the target of each .lnk file resolved so far, keyed by the .lnk's path and last write time, so each version of a
+/// shortcut is loaded once. Entries waiting on it are shown as `symlink_ambiguous`, see shortcut_cache.cpp.
+struct shortcut_kind_cache
+{
+    static u64 const MAX_SHORTCUTS = 16 * 1024;
+
+    struct target
+    {
+        platform_file_time lnk_write_time;
+        basic_dirent::kind kind;
     };
 
-    std::string error = {};
-    time_point_precise_t last_updated_time = get_time_precise();
-    bool input_focused = false;
-    bool selected = false;
+    std::unordered_map<u64, target> targets = {}; // `path_loose_hash` of the .lnk path -> target
+    u64 num_hits = 0;
+    u64 num_misses = 0; // includes shortcuts modified since they were resolved
+
+    /// Counts a hit when `lnk_key` was resolved with the same write time, a miss otherwise.
+    bool find(u64 lnk_key, platform_file_time lnk_write_time, basic_dirent::kind &out) noexcept;
+
+    /// Starts over once full, shortcuts come in directories rather than one by one so there is little to gain from LRU.
+    void store(u64 lnk_key, platform_file_time lnk_write_time, basic_dirent::kind kind) noexcept;
+};
+
+struct shortcut_to_resolve
+{
+    swan_path name;
+    platform_file_time lnk_write_time;
+};
+
+/// Counters of the prefetcher (prefetch.cpp), for tuning it. Whether prefetched listings get used is counted by
+/// directory_listing_cache, as `num_prefetch_hits` and `num_prefetch_unused`.
+struct prefetch_stats
+{
+    std::atomic<u64> num_requested = 0;
+    std::atomic<u64> num_superseded = 0;    // dropped from the queue by a newer request before being looked at
+    std::atomic<u64> num_already_cached = 0;
+    std::atomic<u64> num_skipped_drive = 0; // on network, removable or optical drives
+    std::atomic<u64> num_enumerated = 0;
+    std::atomic<u64> num_too_large = 0;
+    std::atomic<u64> num_failed = 0;
+    std::atomic<u64> num_backoffs = 0;      // directories held back while a user initiated scan or file operation ran
+};
+
+/// What each directory directly holds, for rebuilding recursive sizes on disk. Shared by all explorers and persisted in
+/// `data\directory_sizes.bin`, so revisiting a big tree costs a stat per directory rather than a walk. A record is keyed by
+/// `path_loose_hash` of the directory and holds while its last write time and file ID are unchanged: that catches entries
+/// added, removed or renamed in it, and a directory replaced by another of the same name. Totals are summed anew from the
+/// records of every directory below, so a change deep down shows in each ancestor. Files growing in place touch neither,
+/// which change notifications cover for the directories explorers watch, see directory_size.cpp.
+struct directory_size_cache
+{
+    static u64 const MAX_RECORDS = 512 * 1024;
+    static u64 const NUM_RECORDS_PER_EVICTION = MAX_RECORDS / 8;
+
+    struct record
+    {
+        platform_file_time write_time;
+        u64 file_id;
+        u64 size_on_disk; // of the files directly in it, each rounded up to whole clusters
+        u64 num_files;    // directly in it
+        std::string subdirectories; // names of the subdirectories to walk into, each followed by '\0'
+        u64 last_used = 0; // `clock` when last stored or found
+    };
+
+    std::unordered_map<u64, record> records = {}; // `path_loose_hash` of the directory -> record
+    u64 clock = 0;
+    u64 num_hits = 0;
+    u64 num_misses = 0; // includes records found outdated
+    u64 num_invalidated = 0;
+    u64 num_evicted = 0;
+    bool modified = false; // since last serialized, cleared by whoever persists it
+
+    bool find(u64 directory_key, platform_file_time write_time, u64 file_id, record &out) noexcept;
+
+    /// Once full, evicts the NUM_RECORDS_PER_EVICTION least recently used records, so a volume-sized walk keeps the newest
+    /// records rather than wiping them all every MAX_RECORDS directories.
+    void store(u64 directory_key, record const &r) noexcept;
 
-    std::atomic<status> stat;
-    basic_dirent::kind obj_type;
-    swan_path before;
-    swan_path after;
+    /// Forgets `directory_utf8`, ancestors keep their records as they hold no totals. Returns how many records were forgotten.
+    u64 invalidate(char const *directory_utf8) noexcept;
 
-    bulk_rename_transform(basic_dirent const *before, char const *after) noexcept;
-    bulk_rename_transform(basic_dirent::kind obj_type, char const *before, char const *after) noexcept;
+    void clear() noexcept;
+
+    std::string serialize() const noexcept;
+    bool deserialize(std::string_view data) noexcept;
+};
+
+/// The sizes on disk of the directories an explorer listed, computed in parallel off the main thread by `directory_sizes_compute`.
+/// Each slot grows as its walk goes, so the table streams partial totals, until `done`.
+struct directory_size_job
+{
+    directory_size_job(swan_path const &directory, std::vector<swan_path> &&names) noexcept(false)
+        : directory(directory), names(std::move(names)), sizes(this->names.size()), done(this->names.size()) {}
+
+    swan_path directory;
+    std::vector<swan_path> names;
+    std::vector<std::atomic<u64>> sizes;
+    std::vector<std::atomic<bool>> done;
+    std::atomic<u64> num_pending = 0;
+    std::atomic<u64> cluster_size = 0; // 0 until known
+    std::atomic<bool> cancelled = false;
+    time_point_precise_t listing_time = {}; // `explorer_window::last_filesystem_query_time` of the listing the job is for
+};
+
+/// Everything below the root the Disk Usage window scanned, kept small enough for volumes of millions of files:
+/// a node is 24 bytes, children are threaded through `first_child`/`next_sibling` and names live in one pool.
+struct disk_usage_tree
+{
+    static constexpr u32 NIL = u32(-1);
+    static constexpr u64 NUM_NAME_SLOTS = 1 << 20;
+
+    struct node
+    {
+        u64 size = 0; // on disk, for directories everything below them
+        u32 parent = NIL;
+        u32 first_child = NIL;
+        u32 next_sibling = NIL;
+        u32 name_offset : 31 = 0; // into `names`
+        u32 directory : 1 = 0;
+    };
+    static_assert(sizeof(node) == 24);
+
+    std::vector<node> nodes = {};
+    std::vector<char> names = {}; // null terminated, shared by every node of the same name that `intern_name` caught
+    std::vector<u32> name_slots = {}; // open addressed by name hash, NIL or an offset into `names`, lossy on collision
+
+    /// Links a node as the first child of `parent` (NIL for the root). Doesn't add `size` to the ancestors, see `add_size`.
+    /// Returns NIL once node indices run out.
+    u32 add_node(u32 parent, char const *name, u64 name_len, u64 size, bool directory) noexcept;
+
+    /// Adds `amount` to `node_idx` and every ancestor of it.
+    void add_size(u32 node_idx, u64 amount) noexcept;
 
-    bulk_rename_transform(bulk_rename_transform const &other) noexcept; // for emplace_back
-    bulk_rename_transform &operator=(bulk_rename_transform const &other) noexcept; // for emplace_back
+    u32 intern_name(char const *name, u64 name_len) noexcept;
+    char const *name(u32 node_idx) const noexcept;
 
-    bool operator!=(bulk_rename_transform const &other) const noexcept; // for ntest
-    friend std::ostream& operator<<(std::ostream &os, bulk_rename_transform const &r); // for ntest
+    /// The full path of `node_idx`, the root's name joined with every name down to it.
+    std::string path(u32 node_idx) const noexcept;
 
-    std::string execute(wchar_t const *working_directory, std::wstring &builder_before, std::wstring &builder_after) const noexcept;
-    std::string revert(wchar_t const *working_directory, std::wstring &builder_before, std::wstring &builder_after) const noexcept;
+    void clear() noexcept;
+};
+
+/// One cell of a treemap, in the order of the sizes it was laid out for.
+struct treemap_cell
+{
+    ImVec2 min;
+    ImVec2 max;
+};
+
+/// A section of `data\swan_state.bin`, the binary snapshot of everything Swan persists which is read at startup in place of
+/// the text files. Each section mirrors one of those files, `source_write_time` and `source_size` describe the file as it was
+/// when the snapshot was written: if it has changed since (edited by hand, or saved after the snapshot) the file wins.
+/// Where startup time went, shown in the analytics window.
+struct startup_timings
+{
+    f64 time_to_first_frame_ms = 0; // from process creation until the first frame was presented
+    f64 state_snapshot_load_us = 0; // mapping, validating and decoding the snapshot, off the main thread
+    f64 state_snapshot_wait_us = 0; // main thread blocked waiting for the above
+    f64 text_fallback_us = 0; // loading what the snapshot lacked from text files
+    f64 explorers_init_us = 0;
+    u64 state_snapshot_size = 0;
+    u32 num_sections_from_snapshot = 0;
+    u32 num_sections_from_text = 0;
+};
+
+/// Figures of the render loop over the latest full second, shown in the analytics window.
+struct render_loop_stats
+{
+    f64 frames_per_second = 0;
+    f64 waiting_percent = 0; // of wall time spent blocked in glfwWaitEventsTimeout
+    f64 cpu_percent = 0; // process CPU time over wall time, 100 = one core fully busy
+    f64 idle_cpu_percent = -1; // cpu_percent of the latest second without user input, -1 until there was one
+    u64 num_frames_total = 0;
+    u64 num_waits_total = 0;
+    u64 num_wakes_by_input = 0;
+    u64 num_wakes_by_workers = 0;
+    u64 num_wakes_by_timeout = 0;
+};
+
+/// State persisted to a file of its own under data\, written in the background some time after being marked dirty.
+enum class persisted_file : u32
+{
+    settings,
+    pinned,
+    recent_files, // rewrite the whole file
+    recent_files_latest, // append entries moved to the front since the last write
+    completed_file_operations,
+    explorer_0,
+    explorer_1,
+    explorer_2,
+    explorer_3,
+    window_render_order,
+    directory_jump,
+    directory_sizes,
+    count
+};
+
+/// Append-only write-ahead journal of the bulk rename transactions done while the bulk rename modal is open, so renames
+/// interrupted by a crash can be reverted on the next startup. The items of a transaction (source, target, and the temporary
+/// name a cycle may park it under) and the order they run in are flushed to disk before the first rename, outcomes are
+/// buffered and flushed in batches (parking under a temporary name is flushed right away). Outcomes lost to a crash are
+/// recovered by looking at which names exist on disk.
+///
+///     swan_bulk_rename_journal 1
+///     W <len> <working directory>                    modal session begins
+///     B <num items>                                  transaction begins
+///     I <idx> <len> <src> <len> <dst> <len> <temp>   item, one per transform
+///     J <num steps> <idx><d|t|f> ...                 job, steps are direct/to_temp/from_temp as in `bulk_rename_plan`
+///     P <idx>                                        src renamed to temp
+///     D <idx>                                        src (temp, if parked) renamed to dst
+///     F <idx>                                        rename failed, nothing moved
+///     E                                              transaction ended, every outcome above is complete
+///     C                                              modal session closed normally, nothing to revert
+struct bulk_rename_journal
+{
+    std::mutex mutex = {};
+    std::string buffer = {};
+    HANDLE file = INVALID_HANDLE_VALUE;
+    u64 num_outcomes_buffered = 0;
+    bool had_leftovers = false; // file held sessions not closed normally when opened, keep it after `commit`
+
+    static constexpr u64 outcomes_per_flush = 256;
+
+    bool open(swan_path const &working_directory) noexcept;
+    bool begin_transaction(std::vector<bulk_rename_transform> const &transforms, bulk_rename_plan const &plan, bool reverse) noexcept;
+    void record(char outcome, u32 transform_idx) noexcept;
+    void end_transaction() noexcept;
+    void commit() noexcept;
+
+private:
+    bool write_buffer(bool sync) noexcept;
 };
 
 struct icon_font_glyph
@@ -712,12 +992,15 @@ enum swan_confirmation_id : s32
     swan_id_confirm_delete_pin,
 
     swan_id_confirm_explorer_execute_delete,
+    swan_id_confirm_explorer_execute_permanent_delete,
     swan_id_confirm_explorer_unpin_directory,
 
     swan_id_confirm_completed_file_operations_forget,
     swan_id_confirm_completed_file_operations_forget_group,
     swan_id_confirm_completed_file_operations_forget_all,
 
+    swan_id_confirm_bulk_rename_revert_interrupted,
+
     swan_id_confirm_theme_editor_color_reset,
     swan_id_confirm_theme_editor_style_reset,
 
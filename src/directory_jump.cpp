@@ -0,0 +1,62 @@
+#include "stdafx.hpp"
+#include "data_types.hpp"
+#include "common_functions.hpp"
+#include "path.hpp"
+#include "util.hpp"
+
+static directory_jump_index g_directory_jump_index = {};
+
+directory_jump_index &global_state::directory_jump_get() noexcept
+{
+    return g_directory_jump_index;
+}
+
+/// Records a visit to `directory` by any explorer and marks the database for persisting.
+void global_state::directory_jump_visit(swan_path const &directory) noexcept
+{
+    u32 now = u32(std::chrono::system_clock::to_time_t(get_time_system()));
+
+    g_directory_jump_index.visit(std::string_view(directory.data(), path_length(directory)), now);
+
+    global_state::mark_dirty(persisted_file::directory_jump);
+}
+
+bool global_state::directory_jump_save_to_disk() noexcept
+try {
+    std::string data = g_directory_jump_index.serialize();
+
+    if (data.empty()) {
+        return false;
+    }
+
+    persistence_write(global_state::execution_path() / "data\\directory_jump.bin", std::move(data));
+
+    print_debug_msg("SUCCESS serialized %zu directories", g_directory_jump_index.entries.size());
+    return true;
+}
+catch (...) {
+    print_debug_msg("FAILED");
+    return false;
+}
+
+std::pair<bool, u64> global_state::directory_jump_load_from_disk() noexcept
+try {
+    std::filesystem::path full_path = global_state::execution_path() / "data\\directory_jump.bin";
+
+    std::ifstream in(full_path, std::ios::binary);
+
+    if (!in) {
+        return { false, 0 };
+    }
+
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    bool success = g_directory_jump_index.deserialize(data);
+
+    print_debug_msg("%s loaded %zu directories", success ? "SUCCESS" : "FAILED", g_directory_jump_index.entries.size());
+    return { success, g_directory_jump_index.entries.size() };
+}
+catch (...) {
+    print_debug_msg("FAILED");
+    return { false, 0 };
+}
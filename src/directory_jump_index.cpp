@@ -0,0 +1,333 @@
+#include <cmath>
+
+#include "core.hpp"
+#if !SWAN_HEADLESS
+#   include "imgui_dependent_functions.hpp"
+#endif
+
+// data\directory_jump.bin:
+//   8 bytes   "swanjmp1"
+//   u32       number of entries
+//   per entry f32 rank, u32 last visit, u16 path length, path (not null terminated)
+static char const DIRECTORY_JUMP_MAGIC[8] = { 's', 'w', 'a', 'n', 'j', 'm', 'p', '1' };
+
+/// Bit of `entry::char_mask` for a folded char, letters and digits get a bit of their own.
+static
+u64 directory_jump_char_bit(char folded) noexcept
+{
+    if (folded >= 'a' && folded <= 'z') return u64(1) << (folded - 'a');
+    if (folded >= '0' && folded <= '9') return u64(1) << (26 + folded - '0');
+    return u64(1) << (36 + u8(folded) % 28);
+}
+
+u32 directory_jump_index::append(std::string_view path, f32 rank, u32 last_visit) noexcept
+{
+    u32 path_offset = u32(this->paths.size());
+
+    u64 name_len = path.size();
+    while (name_len > 0 && strchr("\\/", path[name_len-1])) {
+        --name_len;
+    }
+    u64 name_offset = name_len;
+    while (name_offset > 0 && !strchr("\\/", path[name_offset-1])) {
+        --name_offset;
+    }
+
+    u64 char_mask = 0;
+
+    this->paths.append(path);
+    for (char ch : path) {
+        char folded = fold_path_char(ch);
+        this->folded_paths.push_back(folded);
+        char_mask |= directory_jump_char_bit(folded);
+    }
+
+    u32 entry_idx = u32(this->entries.size());
+    u64 path_key = path_loose_hash(path.data(), path.size());
+
+    this->entries.push_back({ path_offset, u16(path.size()), u16(name_offset), rank, last_visit, path_key, char_mask });
+    this->index.insert_or_assign(path_key, entry_idx);
+    this->total_rank += rank;
+
+    return entry_idx;
+}
+
+void directory_jump_index::visit(std::string_view path, u32 now) noexcept
+try {
+    if (path.empty() || path.size() > UINT16_MAX) {
+        return;
+    }
+
+    auto found = this->index.find(path_loose_hash(path.data(), path.size()));
+
+    if (found != this->index.end()) {
+        auto &existing = this->entries[found->second];
+        existing.rank += 1;
+        existing.last_visit = now;
+        this->total_rank += 1;
+    } else {
+        (void) this->append(path, 1, now);
+    }
+
+    if (this->total_rank > MAX_TOTAL_RANK) {
+        this->age();
+    }
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+bool directory_jump_index::forget(std::string_view path) noexcept
+{
+    auto found = this->index.find(path_loose_hash(path.data(), path.size()));
+
+    if (found == this->index.end()) {
+        return false;
+    }
+
+    u32 entry_idx = found->second;
+    this->index.erase(found);
+
+    auto const &forgotten = this->entries[entry_idx];
+    this->num_unused_bytes += forgotten.path_len;
+    this->total_rank -= forgotten.rank;
+
+    if (entry_idx != this->entries.size() - 1) {
+        this->entries[entry_idx] = this->entries.back();
+        this->index[this->entries[entry_idx].path_key] = entry_idx;
+    }
+    this->entries.pop_back();
+
+    if (this->num_unused_bytes > this->paths.size() / 2) {
+        this->compact();
+    }
+
+    return true;
+}
+
+/// Scales every rank down so the total lands at 90% of `MAX_TOTAL_RANK`, and forgets directories whose rank falls below 1.
+void directory_jump_index::age() noexcept
+{
+    f64 factor = 0.9 * MAX_TOTAL_RANK / this->total_rank;
+
+    for (auto &e : this->entries) {
+        e.rank = f32(e.rank * factor);
+    }
+    std::erase_if(this->entries, [](entry const &e) noexcept { return e.rank < 1; });
+
+    this->compact();
+}
+
+/// Repacks `paths` and `folded_paths` around the current entries, rebuilding the index and total rank.
+void directory_jump_index::compact() noexcept
+try {
+    std::vector<entry> old_entries = std::move(this->entries);
+    std::string old_paths = std::move(this->paths);
+
+    this->clear();
+    this->entries.reserve(old_entries.size());
+    this->index.reserve(old_entries.size());
+
+    for (auto const &e : old_entries) {
+        (void) this->append(std::string_view(old_paths.data() + e.path_offset, e.path_len), e.rank, e.last_visit);
+    }
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    this->clear();
+}
+
+void directory_jump_index::clear() noexcept
+{
+    this->entries.clear();
+    this->paths.clear();
+    this->folded_paths.clear();
+    this->index.clear();
+    this->total_rank = 0;
+    this->num_unused_bytes = 0;
+}
+
+/// Ranks every directory matching `text` into `out`, best first, at most `max_matches` of them.
+/// `text` is split on spaces into terms which must be found in order, anywhere in the path, ignoring ASCII case.
+/// A term found as a substring counts fully, one only found as a subsequence (e.g. "dcs" in "documents") counts half,
+/// and a last term found in the last path component counts double. That is multiplied by zoxide's frecency:
+/// rank x4 if visited within the hour, x2 within the day, x0.5 within the week, x0.25 otherwise.
+void directory_jump_index::query(char const *text, u32 now, u64 exclude_path_key, u64 max_matches, std::vector<match> &out) const noexcept
+try {
+    SWAN_PROFILE_ZONE("directory_jump_query");
+    out.clear();
+
+    std::string folded_text = {};
+    u64 char_mask = 0;
+
+    for (char const *ch = text; *ch != '\0'; ++ch) {
+        char folded = fold_path_char(*ch);
+        folded_text.push_back(folded);
+        if (folded != ' ') {
+            char_mask |= directory_jump_char_bit(folded);
+        }
+    }
+
+    u64 constexpr max_terms = 16;
+    std::vector<std::string_view> terms = {};
+    terms.reserve(max_terms);
+    {
+        std::string_view remaining = folded_text;
+        while (!remaining.empty() && terms.size() < max_terms) {
+            u64 term_len = std::min(remaining.find(' '), remaining.size());
+            if (term_len > 0) {
+                terms.push_back(remaining.substr(0, term_len));
+            }
+            remaining.remove_prefix(std::min(term_len + 1, remaining.size()));
+        }
+    }
+
+    if (terms.empty()) {
+        return;
+    }
+
+    for (u32 i = 0; i < u32(this->entries.size()); ++i) {
+        auto const &e = this->entries[i];
+
+        if ((e.char_mask & char_mask) != char_mask || e.path_key == exclude_path_key) {
+            continue;
+        }
+
+        std::string_view haystack(this->folded_paths.data() + e.path_offset, e.path_len);
+        u64 pos = 0;
+        u64 last_term_pos = 0;
+        f32 weight = 1;
+
+        for (auto const &term : terms) {
+            u64 found = haystack.find(term, pos);
+
+            if (found != std::string_view::npos) {
+                last_term_pos = found;
+                pos = found + term.size();
+                continue;
+            }
+
+            u64 num_term_chars_found = 0;
+            u64 first_found = 0;
+
+            for (; pos < haystack.size() && num_term_chars_found < term.size(); ++pos) {
+                if (haystack[pos] == term[num_term_chars_found]) {
+                    if (num_term_chars_found++ == 0) {
+                        first_found = pos;
+                    }
+                }
+            }
+
+            if (num_term_chars_found < term.size()) {
+                weight = 0;
+                break;
+            }
+
+            last_term_pos = first_found;
+            weight *= 0.5f;
+        }
+
+        if (weight == 0) {
+            continue;
+        }
+        if (last_term_pos >= e.name_offset) {
+            weight *= 2;
+        }
+
+        u32 seconds_since_visit = now > e.last_visit ? now - e.last_visit : 0;
+        f32 frecency =
+            seconds_since_visit < 60*60     ? e.rank * 4.0f :
+            seconds_since_visit < 60*60*24  ? e.rank * 2.0f :
+            seconds_since_visit < 60*60*24*7 ? e.rank * 0.5f :
+                                               e.rank * 0.25f;
+
+        out.push_back({ i, frecency * weight });
+    }
+
+    auto middle = out.begin() + std::min(max_matches, out.size());
+    std::partial_sort(out.begin(), middle, out.end(), [](match const &a, match const &b) noexcept { return a.score > b.score; });
+    out.erase(middle, out.end());
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+    out.clear();
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    out.clear();
+}
+
+std::string directory_jump_index::serialize() const noexcept
+try {
+    std::string data = {};
+    data.reserve(sizeof(DIRECTORY_JUMP_MAGIC) + sizeof(u32) + this->entries.size() * 10 + this->paths.size() - this->num_unused_bytes);
+
+    auto put = [&data](auto const &value) { data.append((char const *)&value, sizeof(value)); };
+
+    data.append(DIRECTORY_JUMP_MAGIC, sizeof(DIRECTORY_JUMP_MAGIC));
+    put(u32(this->entries.size()));
+
+    for (auto const &e : this->entries) {
+        put(e.rank);
+        put(e.last_visit);
+        put(e.path_len);
+        data.append(this->path(e));
+    }
+
+    return data;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return {};
+}
+
+bool directory_jump_index::deserialize(std::string_view data) noexcept
+{
+    this->clear();
+
+    auto take = [&data](auto &value) noexcept {
+        if (data.size() < sizeof(value)) return false;
+        memcpy(&value, data.data(), sizeof(value));
+        data.remove_prefix(sizeof(value));
+        return true;
+    };
+
+    if (!data.starts_with(std::string_view(DIRECTORY_JUMP_MAGIC, sizeof(DIRECTORY_JUMP_MAGIC)))) {
+        return false;
+    }
+    data.remove_prefix(sizeof(DIRECTORY_JUMP_MAGIC));
+
+    u32 num_entries = 0;
+    if (!take(num_entries)) {
+        return false;
+    }
+
+    try {
+        this->entries.reserve(num_entries);
+        this->index.reserve(num_entries);
+
+        for (u32 i = 0; i < num_entries; ++i) {
+            f32 rank = 0;
+            u32 last_visit = 0;
+            u16 path_len = 0;
+
+            if (!take(rank) || !take(last_visit) || !take(path_len) || data.size() < path_len) {
+                this->clear();
+                return false;
+            }
+
+            (void) this->append(data.substr(0, path_len), rank, last_visit);
+            data.remove_prefix(path_len);
+        }
+    }
+    catch (...) {
+        print_debug_msg("FAILED catch(...)");
+        this->clear();
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,165 @@
+#include "core.hpp"
+
+#if !SWAN_HEADLESS
+#   include "imgui_dependent_functions.hpp"
+#endif
+
+void directory_listing_cache::listing::append(basic_dirent const &dirent) noexcept
+try {
+    u64 name_len = path_length(dirent.path);
+
+    this->entries.push_back({ dirent.size, dirent.creation_time_raw, dirent.last_write_time_raw, u32(this->names.size()), u16(name_len), dirent.type });
+    this->names.append(dirent.path.data(), name_len);
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+bool directory_listing_cache::listing::same_entries_as(listing const &other) const noexcept
+{
+    if (this->entries.size() != other.entries.size() || this->names != other.names) {
+        return false;
+    }
+
+    for (u64 i = 0; i < this->entries.size(); ++i) {
+        auto const &lhs = this->entries[i];
+        auto const &rhs = other.entries[i];
+
+        if (lhs.name_len != rhs.name_len || lhs.size != rhs.size || lhs.last_write_time_raw != rhs.last_write_time_raw) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void directory_listing_cache::store(listing &&new_listing) noexcept
+try {
+    if (new_listing.entries.size() > MAX_ENTRIES_TOTAL / 4) {
+        // a listing this big would evict most of the others, and enumerating it dwarfs anything caching saves
+        (void) this->erase(new_listing.directory_key);
+        return;
+    }
+
+    (void) this->erase(new_listing.directory_key);
+
+    this->num_entries_total += new_listing.entries.size();
+    this->listings.push_front(std::move(new_listing));
+    this->index[this->listings.front().directory_key] = this->listings.begin();
+
+    while (this->listings.size() > MAX_LISTINGS || this->num_entries_total > MAX_ENTRIES_TOTAL) {
+        (void) this->erase(this->listings.back().directory_key);
+    }
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    this->clear();
+}
+
+directory_listing_cache::listing const *directory_listing_cache::find(u64 directory_key) noexcept
+{
+    auto found = this->index.find(directory_key);
+
+    if (found == this->index.end()) {
+        ++this->num_misses;
+        return nullptr;
+    }
+
+    ++this->num_hits;
+    if (found->second->prefetched_unused) {
+        found->second->prefetched_unused = false;
+        ++this->num_prefetch_hits;
+    }
+    this->listings.splice(this->listings.begin(), this->listings, found->second); // iterators stay valid
+
+    return &this->listings.front();
+}
+
+bool directory_listing_cache::erase(u64 directory_key) noexcept
+{
+    auto found = this->index.find(directory_key);
+
+    if (found == this->index.end()) {
+        return false;
+    }
+
+    this->num_entries_total -= found->second->entries.size();
+    this->num_prefetch_unused += found->second->prefetched_unused;
+    this->listings.erase(found->second);
+    this->index.erase(found);
+
+    return true;
+}
+
+void directory_listing_cache::clear() noexcept
+{
+    this->listings.clear();
+    this->index.clear();
+    this->num_entries_total = 0;
+}
+
+directory_listing_enumerate_result directory_listing_enumerate(
+    char const *directory_utf8,
+    u64 max_entries,
+    directory_listing_cache::listing &out,
+    shortcut_kind_lookup_t find_shortcut_kind) noexcept
+{
+    SWAN_PROFILE_FUNCTION();
+
+    out.directory_key = path_loose_hash(directory_utf8);
+    out.directory_write_time = 0;
+    out.time_stored = {};
+    out.entries.clear();
+    out.names.clear();
+    out.prefetched_unused = false;
+
+    bool inside_recycle_bin = directory_utf8[0] != '\0' && cstr_starts_with(directory_utf8 + 1, ":\\$Recycle.Bin\\"); // assume drive letter is first char
+
+    // stamped first, see the declaration. Left at 0 in the recycle bin, where deleting doesn't touch the directory's write time
+    if (platform_file_info directory_info = {}; !inside_recycle_bin && platform_stat(directory_utf8, directory_info).ok()) {
+        out.directory_write_time = directory_info.last_write_time;
+    }
+
+    platform_directory_enumerator enumerator;
+    platform_dirent found;
+
+    if (auto result = enumerator.open(directory_utf8, true); !result.ok()) {
+        print_debug_msg("FAILED platform_directory_enumerator::open [%s] %s", directory_utf8, platform_error_string(result.error_code).c_str());
+        return directory_listing_enumerate_result::failed;
+    }
+
+    basic_dirent entry = {};
+
+    while (enumerator.next(found)) {
+        entry.size = found.info.size;
+        entry.creation_time_raw = found.info.creation_time;
+        entry.last_write_time_raw = found.info.last_write_time;
+        memcpy(entry.path.data(), found.name, strlen(found.name) + 1); // names are shorter than a path
+
+        if (out.entries.size() >= max_entries) {
+            return directory_listing_enumerate_result::too_many_entries;
+        }
+
+        if (found.info.kind == platform_file_kind::directory || found.info.kind == platform_file_kind::symlink_to_directory) {
+            entry.type = basic_dirent::kind::directory;
+        }
+        else if (find_shortcut_kind != nullptr && !inside_recycle_bin && path_ends_with(entry.path, ".lnk")) {
+            // loading the shortcut is slow, unless it was resolved before it's left for shortcut_kinds_resolve_deferred
+            swan_path lnk_path = path_create(directory_utf8);
+            if (!path_append(lnk_path, entry.path.data(), PLATFORM_DIR_SEPARATOR, true)
+                || !find_shortcut_kind(lnk_path.data(), found.info.last_write_time, entry.type))
+            {
+                entry.type = basic_dirent::kind::symlink_ambiguous;
+            }
+        }
+        else {
+            entry.type = basic_dirent::kind::file;
+        }
+
+        out.append(entry);
+    }
+
+    out.time_stored = get_time_precise();
+
+    return directory_listing_enumerate_result::success;
+}
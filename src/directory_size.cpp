@@ -0,0 +1,473 @@
+#include "stdafx.hpp"
+#include "data_types.hpp"
+#include "common_functions.hpp"
+#include "path.hpp"
+#include "platform.hpp"
+#include "util.hpp"
+
+/*
+    Recursive directory sizes for the explorer's "On disk" column. An explorer hands its listed directories to
+    `directory_sizes_compute` as a directory_size_job, each is walked depth first by one of a few threads, and every directory
+    listed is recorded in directory_size_cache with its own files' size and its subdirectories' names. Walks take the record
+    of a directory which still holds instead of listing it, but still visit each of its subdirectories and sum the totals
+    anew, so after a change only the changed directory is listed again and every ancestor's total includes it.
+
+    Sizes on disk are file sizes rounded up to the volume's cluster size. Files small enough to live in the MFT, compressed
+    and sparse files are overestimated, hard links are counted once per link. Junctions and symlinks are not followed.
+*/
+
+namespace swan_directory_size
+{
+    static swan_thread_pool_t g_thread_pool(4); // walking is I/O bound, more threads mostly queue up in the filesystem
+
+    static u64 const NUM_FILES_PER_PROGRESS_UPDATE = 256;
+    static u64 const MIN_MS_BETWEEN_WAKES = 100;
+
+    static directory_size_cache g_cache = {};
+    static std::mutex g_cache_mutex = {};
+
+    // queued by the main thread, which must not wait on g_cache_mutex, and applied by whoever takes g_cache_mutex next
+    static std::vector<std::string> g_pending_invalidations = {};
+    static std::mutex g_pending_invalidations_mutex = {};
+
+    static std::atomic<bool> g_save_scheduled = false;
+}
+
+// data\directory_sizes.bin:
+//   8 bytes   "swandsz2"
+//   u32       number of records
+//   per record u64 directory key, u64 write time, u64 file ID, u64 size on disk, u64 number of files, u64 last used,
+//              u32 length of the subdirectory names, the names each followed by '\0'
+static char const DIRECTORY_SIZES_MAGIC[8] = { 's', 'w', 'a', 'n', 'd', 's', 'z', '2' };
+
+global_state::size_cache global_state::directory_size_cache_get() noexcept { return { &swan_directory_size::g_cache, &swan_directory_size::g_cache_mutex }; }
+
+bool directory_size_cache::find(u64 directory_key, platform_file_time write_time, u64 file_id, record &out) noexcept
+{
+    auto found = this->records.find(directory_key);
+
+    if (found == this->records.end() || found->second.write_time != write_time || found->second.file_id != file_id) {
+        ++this->num_misses;
+        return false;
+    }
+
+    ++this->num_hits;
+    found->second.last_used = ++this->clock;
+    out = found->second;
+    return true;
+}
+
+void directory_size_cache::store(u64 directory_key, record const &r) noexcept
+try {
+    if (this->records.size() >= MAX_RECORDS && !this->records.contains(directory_key)) {
+        // in batches, so the O(n) selection is paid once per NUM_RECORDS_PER_EVICTION stores
+        std::vector<std::pair<u64, u64>> by_age = {}; // last used, directory key
+        by_age.reserve(this->records.size());
+        for (auto const &[key, existing] : this->records) {
+            by_age.emplace_back(existing.last_used, key);
+        }
+        std::nth_element(by_age.begin(), by_age.begin() + NUM_RECORDS_PER_EVICTION, by_age.end());
+
+        for (u64 i = 0; i < NUM_RECORDS_PER_EVICTION; ++i) {
+            this->records.erase(by_age[i].second);
+        }
+        this->num_evicted += NUM_RECORDS_PER_EVICTION;
+    }
+
+    record &stored = this->records[directory_key];
+    stored = r;
+    stored.last_used = ++this->clock;
+    this->modified = true;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    this->clear();
+}
+
+u64 directory_size_cache::invalidate(char const *directory_utf8) noexcept
+{
+    u64 num_forgotten = this->records.erase(path_loose_hash(directory_utf8, strlen(directory_utf8)));
+
+    this->num_invalidated += num_forgotten;
+    this->modified |= num_forgotten > 0;
+    return num_forgotten;
+}
+
+void directory_size_cache::clear() noexcept
+{
+    this->modified |= !this->records.empty();
+    this->records.clear();
+}
+
+std::string directory_size_cache::serialize() const noexcept
+try {
+    std::string data = {};
+    data.reserve(sizeof(DIRECTORY_SIZES_MAGIC) + sizeof(u32) + this->records.size() * (6 * sizeof(u64) + sizeof(u32)));
+
+    auto put = [&data](auto const &value) { data.append((char const *)&value, sizeof(value)); };
+
+    data.append(DIRECTORY_SIZES_MAGIC, sizeof(DIRECTORY_SIZES_MAGIC));
+    put(u32(this->records.size()));
+
+    for (auto const &[directory_key, r] : this->records) {
+        put(directory_key);
+        put(r.write_time);
+        put(r.file_id);
+        put(r.size_on_disk);
+        put(r.num_files);
+        put(r.last_used);
+        put(u32(r.subdirectories.size()));
+        data.append(r.subdirectories);
+    }
+
+    return data;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return {};
+}
+
+bool directory_size_cache::deserialize(std::string_view data) noexcept
+{
+    this->clear();
+
+    auto take = [&data](auto &value) noexcept {
+        if (data.size() < sizeof(value)) return false;
+        memcpy(&value, data.data(), sizeof(value));
+        data.remove_prefix(sizeof(value));
+        return true;
+    };
+
+    if (!data.starts_with(std::string_view(DIRECTORY_SIZES_MAGIC, sizeof(DIRECTORY_SIZES_MAGIC)))) {
+        return false;
+    }
+    data.remove_prefix(sizeof(DIRECTORY_SIZES_MAGIC));
+
+    u32 num_records = 0;
+    if (!take(num_records) || num_records > MAX_RECORDS) {
+        return false;
+    }
+
+    try {
+        this->records.reserve(num_records);
+
+        for (u32 i = 0; i < num_records; ++i) {
+            u64 directory_key = 0;
+            u32 subdirectories_len = 0;
+            record r = {};
+
+            if (!take(directory_key) || !take(r.write_time) || !take(r.file_id) || !take(r.size_on_disk) || !take(r.num_files) || !take(r.last_used)
+                || !take(subdirectories_len) || data.size() < subdirectories_len)
+            {
+                this->clear();
+                return false;
+            }
+            r.subdirectories.assign(data.data(), subdirectories_len);
+            data.remove_prefix(subdirectories_len);
+
+            this->clock = std::max(this->clock, r.last_used);
+            this->records[directory_key] = std::move(r);
+        }
+    }
+    catch (...) {
+        print_debug_msg("FAILED catch(...)");
+        this->clear();
+        return false;
+    }
+
+    return true;
+}
+
+/// Forgets the directories queued by `directory_sizes_invalidate`. Call with `g_cache_mutex` held.
+static
+void directory_sizes_apply_invalidations() noexcept
+try {
+    using namespace swan_directory_size;
+
+    std::vector<std::string> pending = {};
+    {
+        std::scoped_lock lock(g_pending_invalidations_mutex);
+        pending.swap(g_pending_invalidations);
+    }
+    for (auto const &directory : pending) {
+        g_cache.invalidate(directory.c_str());
+    }
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+/// Adds `amount` to the slot a walk streams into, waking the render loop now and then so the table shows it.
+static
+void directory_size_progress(std::atomic<u64> &partial, u64 amount) noexcept
+{
+    static thread_local time_point_precise_t s_last_wake = {};
+
+    partial += amount;
+
+    if (time_diff_ms(s_last_wake, get_time_precise()) >= swan_directory_size::MIN_MS_BETWEEN_WAKES) {
+        s_last_wake = get_time_precise();
+        global_state::wake_render_loop();
+    }
+}
+
+/// Totals everything below `directory` (a buffer this appends to and restores) into `size_on_disk`, adding to `partial` as it
+/// goes. A directory whose record holds isn't listed, its subdirectories are visited all the same, each validated by its own
+/// record. Returns false if the job was cancelled, records of the directories listed until then are kept.
+/// A directory which can't be listed counts as empty, and isn't recorded.
+static
+bool directory_size_walk(std::string &directory, directory_size_job const &job, std::atomic<u64> &partial, u64 &size_on_disk) noexcept
+try {
+    using namespace swan_directory_size;
+
+    size_on_disk = 0;
+
+    if (job.cancelled.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    u64 const cluster_size = job.cluster_size.load();
+    u64 const directory_key = path_loose_hash(directory.data(), directory.size());
+
+    // stamped before listing, so a change made meanwhile leaves the record outdated rather than wrong
+    platform_file_info directory_info = {};
+    u64 file_id = 0;
+    bool stamped = platform_stat(directory.c_str(), directory_info).ok() && platform_file_id(directory.c_str(), file_id).ok();
+
+    directory_size_cache::record r = {};
+    bool cached = false;
+
+    if (stamped) {
+        std::scoped_lock lock(g_cache_mutex);
+        directory_sizes_apply_invalidations();
+        cached = g_cache.find(directory_key, directory_info.last_write_time, file_id, r);
+    }
+
+    if (cached) {
+        directory_size_progress(partial, r.size_on_disk);
+    }
+    else {
+        platform_directory_enumerator enumerator;
+        if (!enumerator.open(directory.c_str()).ok()) {
+            return true;
+        }
+
+        u64 unreported_size = 0;
+        u64 num_unreported_files = 0;
+        platform_dirent entry;
+
+        while (enumerator.next(entry)) {
+            if (job.cancelled.load(std::memory_order_relaxed)) {
+                return false;
+            }
+
+            if (entry.info.kind == platform_file_kind::directory && !entry.info.reparse_point) {
+                r.subdirectories.append(entry.name);
+                r.subdirectories.push_back('\0');
+            }
+            else if (entry.info.kind == platform_file_kind::file) {
+                u64 file_size_on_disk = (entry.info.size + cluster_size - 1) / cluster_size * cluster_size;
+
+                r.size_on_disk += file_size_on_disk;
+                r.num_files += 1;
+                unreported_size += file_size_on_disk;
+
+                if (++num_unreported_files == NUM_FILES_PER_PROGRESS_UPDATE) {
+                    directory_size_progress(partial, unreported_size);
+                    unreported_size = 0;
+                    num_unreported_files = 0;
+                }
+            }
+        }
+
+        directory_size_progress(partial, unreported_size);
+
+        if (stamped) {
+            r.write_time = directory_info.last_write_time;
+            r.file_id = file_id;
+
+            std::scoped_lock lock(g_cache_mutex);
+            g_cache.store(directory_key, r);
+        }
+    }
+
+    size_on_disk = r.size_on_disk;
+
+    u64 const directory_len = directory.size();
+
+    for (char const *name = r.subdirectories.c_str(); *name != '\0'; name += strlen(name) + 1) {
+        if (directory.back() != '\\') {
+            directory.push_back('\\');
+        }
+        directory.append(name);
+
+        u64 child_size_on_disk = 0;
+        bool finished = directory_size_walk(directory, job, partial, child_size_on_disk);
+
+        directory.resize(directory_len);
+
+        if (!finished) {
+            return false;
+        }
+        size_on_disk += child_size_on_disk;
+    }
+
+    return true;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return false;
+}
+
+u64 volume_cluster_size(char const *path_utf8) noexcept
+{
+    DWORD sectors_per_cluster = 0, bytes_per_sector = 0, num_free_clusters = 0, num_clusters = 0;
+    wchar_t root[] = { wchar_t(path_utf8[0]), L':', L'\\', L'\0' };
+
+    if (path_utf8[0] != '\0' && path_utf8[1] == ':' && GetDiskFreeSpaceW(root, &sectors_per_cluster, &bytes_per_sector, &num_free_clusters, &num_clusters)) {
+        return u64(sectors_per_cluster) * u64(bytes_per_sector);
+    }
+    return 4096; // the NTFS default, for UNC paths and failures
+}
+
+void directory_sizes_compute(std::shared_ptr<directory_size_job> job) noexcept
+try {
+    job->num_pending.store(job->names.size());
+
+    swan_directory_size::g_thread_pool.push_task([job]() noexcept {
+        SWAN_PROFILE_THREAD_NAME("directory sizes");
+
+        job->cluster_size.store(volume_cluster_size(job->directory.data()));
+
+        for (u64 slot = 0; slot < job->names.size(); ++slot) {
+            swan_directory_size::g_thread_pool.push_task([job, slot]() noexcept {
+                SWAN_PROFILE_THREAD_NAME("directory sizes");
+                SWAN_PROFILE_FUNCTION();
+
+                SCOPE_EXIT {
+                    if (--job->num_pending == 0 && !job->cancelled.load()) {
+                        global_state::mark_dirty(persisted_file::directory_sizes);
+                    }
+                    global_state::wake_render_loop();
+                };
+
+                try {
+                    std::string directory = job->directory.data();
+                    if (directory.empty() || directory.back() != '\\') {
+                        directory.push_back('\\');
+                    }
+                    directory.append(job->names[slot].data());
+
+                    u64 size_on_disk = 0;
+                    if (directory_size_walk(directory, *job, job->sizes[slot], size_on_disk)) {
+                        job->sizes[slot].store(size_on_disk);
+                        job->done[slot].store(true);
+                    }
+                }
+                catch (...) {
+                    print_debug_msg("FAILED catch(...)");
+                }
+            });
+        }
+    });
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+void directory_sizes_invalidate(char const *directory_utf8) noexcept
+try {
+    {
+        std::scoped_lock lock(swan_directory_size::g_pending_invalidations_mutex);
+        swan_directory_size::g_pending_invalidations.emplace_back(directory_utf8);
+    }
+    global_state::mark_dirty(persisted_file::directory_sizes);
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+/// Serializes the cache and queues it for the writer, unless nothing changed since last time. Holds `g_cache_mutex` throughout,
+/// so of two saves the later one also queues the later snapshot.
+static
+bool directory_sizes_write_snapshot() noexcept
+try {
+    using namespace swan_directory_size;
+
+    std::scoped_lock lock(g_cache_mutex);
+
+    directory_sizes_apply_invalidations();
+
+    if (!g_cache.modified) {
+        return true;
+    }
+
+    std::string data = g_cache.serialize();
+
+    if (data.empty()) {
+        return false;
+    }
+
+    g_cache.modified = false;
+    persistence_write(global_state::execution_path() / "data\\directory_sizes.bin", std::move(data));
+
+    print_debug_msg("SUCCESS serialized %zu directory sizes", g_cache.records.size());
+    return true;
+}
+catch (...) {
+    print_debug_msg("FAILED");
+    return false;
+}
+
+/// Serializing up to MAX_RECORDS records is too slow for the main thread `persistence_pump` runs on, so unless `flush`
+/// (for exit and the state snapshot) it happens on the thread pool.
+bool global_state::directory_sizes_save_to_disk(bool flush) noexcept
+try {
+    if (flush) {
+        return directory_sizes_write_snapshot();
+    }
+
+    if (!swan_directory_size::g_save_scheduled.exchange(true)) {
+        global_state::thread_pool().push_task([]() noexcept {
+            swan_directory_size::g_save_scheduled.store(false);
+            (void) directory_sizes_write_snapshot();
+        });
+    }
+    return true;
+}
+catch (...) {
+    print_debug_msg("FAILED");
+    swan_directory_size::g_save_scheduled.store(false);
+    return false;
+}
+
+/// Parses outside the lock and swaps in, walks running meanwhile lose what they recorded.
+std::pair<bool, u64> global_state::directory_sizes_load_from_disk() noexcept
+try {
+    std::filesystem::path full_path = global_state::execution_path() / "data\\directory_sizes.bin";
+
+    std::ifstream in(full_path, std::ios::binary);
+
+    if (!in) {
+        return { false, 0 };
+    }
+
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    directory_size_cache loaded = {};
+    bool success = loaded.deserialize(data);
+    u64 num_records = loaded.records.size();
+
+    if (success) {
+        std::scoped_lock lock(swan_directory_size::g_cache_mutex);
+        swan_directory_size::g_cache.records.swap(loaded.records);
+        swan_directory_size::g_cache.clock = std::max(swan_directory_size::g_cache.clock, loaded.clock);
+    }
+
+    print_debug_msg("%s loaded %zu directory sizes", success ? "SUCCESS" : "FAILED", num_records);
+    return { success, num_records };
+}
+catch (...) {
+    print_debug_msg("FAILED");
+    return { false, 0 };
+}
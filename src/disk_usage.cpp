@@ -0,0 +1,903 @@
+#include "stdafx.hpp"
+#include "data_types.hpp"
+#include "common_functions.hpp"
+#include "imgui_dependent_functions.hpp"
+#include "imgui_extension.hpp"
+#include "path.hpp"
+#include "platform.hpp"
+#include "util.hpp"
+
+/*
+    Disk Usage window: scans everything below a root (a drive or any directory) into a disk_usage_tree, and shows it as a
+    squarified treemap beside a table of the largest items. A few workers take directories off a shared stack, list them
+    without holding any lock and commit the entries in one go, so the tree fills in while the scan runs and the treemap,
+    re-laid out a few times a second, grows with it.
+
+    The treemap shows the node drilled into, a few levels deep. Laying out only walks the children of directories whose
+    cell is big enough to draw into, so neither drilling down nor streaming updates touch the rest of the tree.
+    Sizes on disk are rounded up to clusters like the explorer's "On disk" column, junctions and symlinks aren't followed.
+*/
+
+namespace swan_disk_usage
+{
+    static u64 const NUM_SCAN_THREADS = 6; // listing is I/O bound, a few more than directory_size.cpp as a whole volume has plenty to overlap
+    static swan_thread_pool_t g_thread_pool(NUM_SCAN_THREADS);
+
+    static u64 const NUM_LARGEST_FILES = 1000;
+    static s64 const MIN_MS_BETWEEN_WAKES = 100;
+    static s64 const MIN_MS_BETWEEN_LAYOUTS_WHILE_SCANNING = 250;
+    static u64 const MAX_LAYOUT_DEPTH = 4;
+    static u64 const MAX_CELLS = 16'384;
+    static u64 const MAX_CELLS_PER_DIRECTORY = 2'048; // the smaller rest of a directory share one cell
+    static f32 const MIN_CELL_SIDE_FOR_CHILDREN = 24; // pixels
+    static f32 const CELL_PADDING = 2; // pixels
+
+    struct scan
+    {
+        disk_usage_tree tree = {};
+        std::vector<u32> largest_files = {}; // min-heap on size, the NUM_LARGEST_FILES largest files so far
+        std::vector<u32> pending = {}; // directories waiting to be listed
+        u64 num_listing = 0; // directories taken off `pending` and not yet committed
+        std::mutex mutex = {}; // guards everything above
+        std::condition_variable pending_changed = {};
+
+        std::atomic<u64> generation = 0; // bumped by every commit into `tree`
+        std::atomic<u64> num_files = 0;
+        std::atomic<u64> num_directories = 0;
+        std::atomic<u64> num_unlistable = 0;
+        std::atomic<u64> num_workers = 0;
+        std::atomic<s64> duration_ms = -1; // -1 while scanning
+        std::atomic<bool> cancelled = false;
+        u64 cluster_size = 4096;
+        time_point_precise_t start_time = {};
+    };
+
+    struct cell
+    {
+        treemap_cell rect;
+        u32 node; // disk_usage_tree::NIL for the cell standing in for many small items
+        u32 depth;
+        u64 size;
+        f32 hue;
+        bool directory;
+        std::string label; // only for cells wide enough to show one
+    };
+
+    struct row
+    {
+        u32 node;
+        u64 size;
+        bool directory;
+        std::string name;
+    };
+
+    /// What was laid out for the node drilled into, kept until something it depends on changes.
+    struct layout
+    {
+        std::vector<cell> cells = {}; // pre-order, parents before their children
+        std::vector<row> contents = {}; // children of `view_root`, largest first
+        std::vector<u32> largest_files = {}; // largest first
+        u64 view_root_size = 0;
+        u64 generation = u64(-1);
+        u32 view_root = disk_usage_tree::NIL;
+        ImVec2 size = {};
+        time_point_precise_t time = {};
+    };
+
+    // main thread only
+    static std::shared_ptr<scan> g_scan = nullptr;
+    static layout g_layout = {};
+    static swan_path g_root_input = {};
+    static u32 g_view_root = 0;
+    static u32 g_selected = disk_usage_tree::NIL;
+    static drive_info_array_t g_drives = {};
+}
+
+u32 disk_usage_tree::intern_name(char const *name, u64 name_len) noexcept
+try {
+    if (this->name_slots.empty()) {
+        this->name_slots.assign(NUM_NAME_SLOTS, NIL);
+    }
+
+    u32 &slot = this->name_slots[xxh64(name, name_len) & (NUM_NAME_SLOTS - 1)];
+
+    // strncmp stops at the stored name's terminator, so the one past `name_len` is only read when the stored name is as long
+    if (slot != NIL && strncmp(&this->names[slot], name, name_len) == 0 && this->names[slot + name_len] == '\0') {
+        return slot;
+    }
+
+    if (this->names.size() + name_len + 1 > 0x7FFF'FFFF) { // what `node::name_offset` holds
+        return NIL;
+    }
+
+    u32 offset = u32(this->names.size());
+    this->names.insert(this->names.end(), name, name + name_len);
+    this->names.push_back('\0');
+
+    if (slot == NIL) {
+        slot = offset; // on collision the first name keeps the slot, the other is stored once per node
+    }
+
+    return offset;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return NIL;
+}
+
+u32 disk_usage_tree::add_node(u32 parent, char const *name, u64 name_len, u64 size, bool directory) noexcept
+try {
+    if (this->nodes.size() >= NIL) {
+        return NIL;
+    }
+
+    u32 name_offset = this->intern_name(name, name_len);
+    if (name_offset == NIL) {
+        return NIL;
+    }
+
+    u32 node_idx = u32(this->nodes.size());
+
+    node &added = this->nodes.emplace_back();
+    added.size = size;
+    added.parent = parent;
+    added.name_offset = name_offset;
+    added.directory = directory;
+
+    if (parent != NIL) {
+        added.next_sibling = this->nodes[parent].first_child;
+        this->nodes[parent].first_child = node_idx;
+    }
+
+    return node_idx;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return NIL;
+}
+
+void disk_usage_tree::add_size(u32 node_idx, u64 amount) noexcept
+{
+    for (u32 i = node_idx; i != NIL; i = this->nodes[i].parent) {
+        this->nodes[i].size += amount;
+    }
+}
+
+char const *disk_usage_tree::name(u32 node_idx) const noexcept
+{
+    return &this->names[this->nodes[node_idx].name_offset];
+}
+
+std::string disk_usage_tree::path(u32 node_idx) const noexcept
+try {
+    // no depth limit, a path cut short of the root would be relative and a rescan would target the wrong directory
+    std::vector<u32> chain = {};
+
+    for (u32 i = node_idx; i != NIL; i = this->nodes[i].parent) {
+        chain.push_back(i);
+    }
+
+    std::string retval = {};
+
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        if (!retval.empty() && retval.back() != '\\' && retval.back() != '/') {
+            retval.push_back('\\');
+        }
+        retval.append(this->name(*it));
+    }
+
+    return retval;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return {};
+}
+
+void disk_usage_tree::clear() noexcept
+{
+    this->nodes.clear();
+    this->names.clear();
+    this->name_slots.clear();
+}
+
+void treemap_squarify(u64 const *sizes, u64 count, ImVec2 min, ImVec2 max, std::vector<treemap_cell> &out) noexcept(false)
+{
+    f64 total = 0;
+    for (u64 i = 0; i < count; ++i) {
+        total += f64(sizes[i]);
+    }
+
+    f64 x = min.x, y = min.y;
+    f64 w = std::max(0.f, max.x - min.x), h = std::max(0.f, max.y - min.y);
+    f64 area_per_unit = total > 0 ? (w * h) / total : 0;
+
+    // of a row whose areas add up to `row_area`, laid against a side of `side`, from its largest and smallest areas
+    auto worst_aspect_ratio = [](f64 largest, f64 smallest, f64 row_area, f64 side) noexcept {
+        if (smallest <= 0 || row_area <= 0) return std::numeric_limits<f64>::infinity();
+        f64 side_sq = side * side, row_area_sq = row_area * row_area;
+        return std::max(side_sq * largest / row_area_sq, row_area_sq / (side_sq * smallest));
+    };
+
+    for (u64 row_start = 0; row_start < count; ) {
+        f64 side = std::min(w, h);
+        f64 row_area = f64(sizes[row_start]) * area_per_unit;
+        f64 worst = worst_aspect_ratio(row_area, row_area, row_area, side);
+        u64 row_end = row_start + 1;
+
+        for (; row_end < count; ++row_end) {
+            f64 area = f64(sizes[row_end]) * area_per_unit;
+            f64 worst_with = worst_aspect_ratio(f64(sizes[row_start]) * area_per_unit, area, row_area + area, side);
+            if (worst_with > worst) {
+                break;
+            }
+            worst = worst_with;
+            row_area += area;
+        }
+
+        f64 thickness = side > 0 ? row_area / side : 0;
+        f64 offset = 0;
+
+        for (u64 i = row_start; i < row_end; ++i) {
+            f64 length = thickness > 0 ? f64(sizes[i]) * area_per_unit / thickness : 0;
+
+            if (w >= h) { // a column against the left side
+                out.push_back({ ImVec2(f32(x), f32(y + offset)), ImVec2(f32(x + thickness), f32(y + offset + length)) });
+            } else { // a row against the top
+                out.push_back({ ImVec2(f32(x + offset), f32(y)), ImVec2(f32(x + offset + length), f32(y + thickness)) });
+            }
+            offset += length;
+        }
+
+        if (w >= h) {
+            x += thickness;
+            w = std::max(0.0, w - thickness);
+        } else {
+            y += thickness;
+            h = std::max(0.0, h - thickness);
+        }
+
+        row_start = row_end;
+    }
+}
+
+/// Keeps the NUM_LARGEST_FILES largest of the files offered in `s.largest_files`. Call with `s.mutex` held.
+static
+void disk_usage_offer_largest_file(swan_disk_usage::scan &s, u32 file_idx) noexcept(false)
+{
+    auto larger = [&s](u32 left, u32 right) noexcept { return s.tree.nodes[left].size > s.tree.nodes[right].size; };
+
+    if (s.largest_files.size() < swan_disk_usage::NUM_LARGEST_FILES) {
+        s.largest_files.push_back(file_idx);
+        std::push_heap(s.largest_files.begin(), s.largest_files.end(), larger);
+    }
+    else if (s.tree.nodes[file_idx].size > s.tree.nodes[s.largest_files.front()].size) {
+        std::pop_heap(s.largest_files.begin(), s.largest_files.end(), larger);
+        s.largest_files.back() = file_idx;
+        std::push_heap(s.largest_files.begin(), s.largest_files.end(), larger);
+    }
+}
+
+static
+void disk_usage_scan_worker(std::shared_ptr<swan_disk_usage::scan> s) noexcept
+try {
+    SWAN_PROFILE_THREAD_NAME("disk usage");
+    SWAN_PROFILE_FUNCTION();
+
+    SCOPE_EXIT {
+        if (--s->num_workers == 0) {
+            s->duration_ms.store(time_diff_ms(s->start_time, get_time_precise()));
+            global_state::wake_render_loop();
+        }
+    };
+
+    struct listed_entry
+    {
+        u32 name_offset; // into `listed_names`
+        u32 name_len;
+        u64 size;
+        bool directory;
+    };
+
+    std::vector<listed_entry> listed = {};
+    std::vector<char> listed_names = {};
+    std::string directory = {};
+    time_point_precise_t last_wake = {};
+
+    while (true) {
+        u32 directory_idx = disk_usage_tree::NIL;
+        {
+            std::unique_lock lock(s->mutex);
+
+            s->pending_changed.wait(lock, [&]() noexcept { return !s->pending.empty() || s->num_listing == 0 || s->cancelled.load(); });
+
+            if (s->pending.empty() || s->cancelled.load()) { // nothing is left, or ever will be
+                s->pending_changed.notify_all();
+                return;
+            }
+
+            directory_idx = s->pending.back(); // depth first keeps `pending` short
+            s->pending.pop_back();
+            ++s->num_listing;
+            directory = s->tree.path(directory_idx);
+        }
+
+        listed.clear();
+        listed_names.clear();
+        u64 files_size = 0;
+        u64 num_files = 0;
+
+        platform_directory_enumerator enumerator;
+
+        if (enumerator.open(directory.c_str()).ok()) {
+            platform_dirent entry;
+
+            while (enumerator.next(entry) && !s->cancelled.load(std::memory_order_relaxed)) {
+                bool is_directory = entry.info.kind == platform_file_kind::directory && !entry.info.reparse_point;
+
+                if (!is_directory && entry.info.kind != platform_file_kind::file) {
+                    continue; // links and devices take next to nothing of their own
+                }
+
+                u64 size = is_directory ? 0 : (entry.info.size + s->cluster_size - 1) / s->cluster_size * s->cluster_size;
+                u64 name_len = strlen(entry.name);
+
+                listed.push_back({ u32(listed_names.size()), u32(name_len), size, is_directory });
+                listed_names.insert(listed_names.end(), entry.name, entry.name + name_len);
+
+                files_size += size;
+                num_files += !is_directory;
+            }
+        }
+        else {
+            ++s->num_unlistable;
+        }
+
+        {
+            std::scoped_lock lock(s->mutex);
+
+            for (auto const &e : listed) {
+                u32 added = s->tree.add_node(directory_idx, &listed_names[e.name_offset], e.name_len, e.size, e.directory);
+
+                if (added == disk_usage_tree::NIL) {
+                    print_debug_msg("FAILED disk_usage_tree::add_node, tree is full");
+                    s->cancelled.store(true);
+                    break;
+                }
+                if (e.directory) {
+                    s->pending.push_back(added);
+                } else {
+                    disk_usage_offer_largest_file(*s, added);
+                }
+            }
+            s->tree.add_size(directory_idx, files_size);
+            --s->num_listing;
+        }
+        s->pending_changed.notify_all();
+
+        s->num_files += num_files;
+        s->num_directories += listed.size() - num_files;
+        ++s->generation;
+
+        if (time_diff_ms(last_wake, get_time_precise()) >= swan_disk_usage::MIN_MS_BETWEEN_WAKES) {
+            last_wake = get_time_precise();
+            global_state::wake_render_loop();
+        }
+    }
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    s->cancelled.store(true);
+    s->pending_changed.notify_all();
+}
+
+/// Cancels the scan running (if any) and starts one of `root_utf8`, which the window then shows.
+static
+void disk_usage_scan_start(char const *root_utf8) noexcept
+try {
+    using namespace swan_disk_usage;
+
+    if (g_scan != nullptr) {
+        g_scan->cancelled.store(true);
+        g_scan->pending_changed.notify_all();
+    }
+
+    std::string root = root_utf8;
+    std::replace(root.begin(), root.end(), '/', '\\');
+    while (root.size() > 3 && root.back() == '\\') {
+        root.pop_back();
+    }
+    if (root.size() == 2 && root[1] == ':') {
+        root.push_back('\\'); // "C:" alone is the current directory of drive C
+    }
+
+    auto s = std::make_shared<scan>();
+    s->cluster_size = volume_cluster_size(root.c_str());
+    s->start_time = get_time_precise();
+
+    u32 root_idx = s->tree.add_node(disk_usage_tree::NIL, root.data(), root.size(), 0, true);
+    s->pending.push_back(root_idx);
+
+    s->num_workers.store(NUM_SCAN_THREADS);
+    for (u64 i = 0; i < NUM_SCAN_THREADS; ++i) {
+        g_thread_pool.push_task([s]() noexcept { disk_usage_scan_worker(s); });
+    }
+
+    g_scan = s;
+    g_view_root = root_idx;
+    g_selected = disk_usage_tree::NIL;
+    g_layout = {};
+
+    print_debug_msg("disk usage scan of [%s] started", root.c_str());
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+/// Lays out the children of `parent` into `bounds`, recursing into directories with room to show theirs. Call with `s.mutex` held.
+static
+void disk_usage_layout_children(swan_disk_usage::scan &s, u32 parent, treemap_cell bounds, u32 depth, f32 parent_hue) noexcept(false)
+{
+    using namespace swan_disk_usage;
+
+    auto &tree = s.tree;
+    auto &cells = g_layout.cells;
+
+    std::vector<u32> children = {};
+    for (u32 child = tree.nodes[parent].first_child; child != disk_usage_tree::NIL; child = tree.nodes[child].next_sibling) {
+        if (tree.nodes[child].size > 0) {
+            children.push_back(child);
+        }
+    }
+    std::sort(children.begin(), children.end(), [&tree](u32 left, u32 right) noexcept { return tree.nodes[left].size > tree.nodes[right].size; });
+
+    // beyond MAX_CELLS_PER_DIRECTORY the smallest share one cell, NIL in `items`, which can sort anywhere
+    std::vector<std::pair<u64, u32>> items = {};
+    items.reserve(std::min(children.size(), MAX_CELLS_PER_DIRECTORY));
+
+    for (u64 i = 0; i < children.size(); ++i) {
+        if (i < MAX_CELLS_PER_DIRECTORY - 1 || children.size() == MAX_CELLS_PER_DIRECTORY) {
+            items.emplace_back(tree.nodes[children[i]].size, children[i]);
+        } else if (items.back().second != disk_usage_tree::NIL) {
+            items.emplace_back(tree.nodes[children[i]].size, disk_usage_tree::NIL);
+        } else {
+            items.back().first += tree.nodes[children[i]].size;
+        }
+    }
+    u64 num_grouped = children.size() - std::min(children.size(), MAX_CELLS_PER_DIRECTORY - 1);
+    std::stable_sort(items.begin(), items.end(), [](auto const &left, auto const &right) noexcept { return left.first > right.first; });
+
+    std::vector<u64> sizes = {};
+    sizes.reserve(items.size());
+    for (auto const &item : items) {
+        sizes.push_back(item.first);
+    }
+
+    std::vector<treemap_cell> rects = {};
+    treemap_squarify(sizes.data(), sizes.size(), bounds.min, bounds.max, rects);
+
+    f32 const line_height = imgui::GetTextLineHeight();
+    f32 const min_label_width = imgui::CalcTextSize("...").x * 2;
+
+    for (u64 i = 0; i < rects.size() && cells.size() < MAX_CELLS; ++i) {
+        treemap_cell const &rect = rects[i];
+        ImVec2 rect_size = rect.max - rect.min;
+
+        if (rect_size.x < 1 || rect_size.y < 1) {
+            continue;
+        }
+
+        cell c = {};
+        c.rect = rect;
+        c.node = items[i].second;
+        c.depth = depth;
+        c.size = items[i].first;
+        c.hue = depth == 0 ? std::fmod(f32(i) * 0.618034f, 1.f) : parent_hue; // golden ratio steps keep neighbours apart
+        c.directory = c.node != disk_usage_tree::NIL && tree.nodes[c.node].directory;
+
+        if (rect_size.x >= min_label_width && rect_size.y >= line_height) {
+            c.label = c.node != disk_usage_tree::NIL ? std::string(tree.name(c.node)) : make_str("(%zu smaller items)", num_grouped);
+        }
+
+        cells.push_back(std::move(c));
+
+        bool room_for_children = rect_size.x >= MIN_CELL_SIDE_FOR_CHILDREN && rect_size.y >= MIN_CELL_SIDE_FOR_CHILDREN + line_height;
+
+        if (cells.back().directory && room_for_children && depth + 1 < MAX_LAYOUT_DEPTH) {
+            treemap_cell inner = { rect.min + ImVec2(CELL_PADDING, line_height), rect.max - ImVec2(CELL_PADDING, CELL_PADDING) };
+            disk_usage_layout_children(s, cells.back().node, inner, depth + 1, cells.back().hue);
+        }
+    }
+}
+
+/// Lays out `swan_disk_usage::g_view_root` again if it changed, the canvas was resized, or the scan added to it.
+static
+void disk_usage_update_layout(ImVec2 canvas_size) noexcept
+try {
+    using namespace swan_disk_usage;
+
+    auto &s = *g_scan;
+    u64 generation = s.generation.load();
+    bool scanning = s.duration_ms.load() < 0;
+
+    bool stale = g_layout.view_root != g_view_root
+              || g_layout.size.x != canvas_size.x || g_layout.size.y != canvas_size.y
+              || (g_layout.generation != generation && (!scanning || time_diff_ms(g_layout.time, get_time_precise()) >= MIN_MS_BETWEEN_LAYOUTS_WHILE_SCANNING));
+
+    if (!stale) {
+        return;
+    }
+
+    SWAN_PROFILE_FUNCTION();
+
+    g_layout.cells.clear();
+    g_layout.contents.clear();
+    g_layout.largest_files.clear();
+    g_layout.view_root = g_view_root;
+    g_layout.size = canvas_size;
+    g_layout.generation = generation;
+    g_layout.time = get_time_precise();
+
+    std::scoped_lock lock(s.mutex);
+
+    auto &tree = s.tree;
+    g_layout.view_root_size = tree.nodes[g_view_root].size;
+
+    for (u32 child = tree.nodes[g_view_root].first_child; child != disk_usage_tree::NIL; child = tree.nodes[child].next_sibling) {
+        g_layout.contents.push_back({ child, tree.nodes[child].size, bool(tree.nodes[child].directory), tree.name(child) });
+    }
+    std::sort(g_layout.contents.begin(), g_layout.contents.end(), [](row const &left, row const &right) noexcept { return left.size > right.size; });
+
+    g_layout.largest_files = s.largest_files;
+    std::sort(g_layout.largest_files.begin(), g_layout.largest_files.end(), [&tree](u32 left, u32 right) noexcept { return tree.nodes[left].size > tree.nodes[right].size; });
+
+    disk_usage_layout_children(s, g_view_root, { ImVec2(0, 0), canvas_size }, 0, 0);
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    swan_disk_usage::g_layout.cells.clear();
+}
+
+/// The full path of `node_idx` in the current scan, for opening it in an explorer.
+static
+std::string disk_usage_node_path(u32 node_idx) noexcept
+{
+    std::scoped_lock lock(swan_disk_usage::g_scan->mutex);
+    return swan_disk_usage::g_scan->tree.path(node_idx);
+}
+
+static
+void disk_usage_render_treemap(u64 size_unit_multiplier) noexcept
+{
+    using namespace swan_disk_usage;
+
+    ImVec2 canvas_min = imgui::GetCursorScreenPos();
+    ImVec2 canvas_size = imgui::GetContentRegionAvail();
+
+    if (canvas_size.x < 1 || canvas_size.y < 1) {
+        return;
+    }
+
+    disk_usage_update_layout(canvas_size);
+
+    imgui::InvisibleButton("## disk_usage treemap", canvas_size, ImGuiButtonFlags_MouseButtonLeft|ImGuiButtonFlags_MouseButtonRight);
+    bool hovered = imgui::IsItemHovered();
+
+    ImDrawList *draw_list = imgui::GetWindowDrawList();
+    draw_list->PushClipRect(canvas_min, canvas_min + canvas_size, true);
+    SCOPE_EXIT { draw_list->PopClipRect(); };
+
+    ImVec2 mouse = imgui::GetMousePos() - canvas_min;
+    cell const *hovered_cell = nullptr;
+
+    for (auto const &c : g_layout.cells) {
+        ImVec2 min = canvas_min + c.rect.min;
+        ImVec2 max = canvas_min + c.rect.max;
+        f32 value = std::max(0.35f, 0.9f - 0.12f * f32(c.depth));
+        f32 saturation = c.node == disk_usage_tree::NIL ? 0 : (c.directory ? 0.3f : 0.55f);
+
+        draw_list->AddRectFilled(min, max, ImColor::HSV(c.hue, saturation, value));
+        draw_list->AddRect(min, max, IM_COL32(0, 0, 0, 96));
+
+        if (c.node == g_selected && c.node != disk_usage_tree::NIL) {
+            draw_list->AddRect(min, max, imgui::GetColorU32(ImGuiCol_NavHighlight), 0, 0, 2);
+        }
+        if (!c.label.empty()) {
+            ImVec4 clip(min.x, min.y, max.x - CELL_PADDING, max.y);
+            draw_list->AddText(nullptr, 0, min + ImVec2(CELL_PADDING + 1, 0), IM_COL32(0, 0, 0, 255), c.label.c_str(), nullptr, 0, &clip);
+        }
+
+        if (hovered && mouse.x >= c.rect.min.x && mouse.x < c.rect.max.x && mouse.y >= c.rect.min.y && mouse.y < c.rect.max.y) {
+            hovered_cell = &c; // the last one containing the mouse is the deepest
+        }
+    }
+
+    if (hovered_cell == nullptr) {
+        if (hovered && imgui::IsMouseClicked(ImGuiMouseButton_Right)) {
+            g_selected = disk_usage_tree::NIL;
+        }
+        return;
+    }
+
+    {
+        ImVec2 min = canvas_min + hovered_cell->rect.min;
+        ImVec2 max = canvas_min + hovered_cell->rect.max;
+        draw_list->AddRect(min, max, IM_COL32(255, 255, 255, 255));
+    }
+
+    if (hovered_cell->node == disk_usage_tree::NIL) {
+        if (imgui::BeginTooltip()) {
+            imgui::Text("Smaller items: %s", format_file_size(hovered_cell->size, size_unit_multiplier).data());
+            imgui::EndTooltip();
+        }
+        return;
+    }
+
+    if (imgui::BeginTooltip()) {
+        std::string path = disk_usage_node_path(hovered_cell->node);
+        imgui::TextUnformatted(path.c_str());
+        imgui::Separator();
+        imgui::Text("%s  (%.1lf %%)", format_file_size(hovered_cell->size, size_unit_multiplier).data(),
+                    g_layout.view_root_size > 0 ? f64(hovered_cell->size) / f64(g_layout.view_root_size) * 100.0 : 0.0);
+        if (hovered_cell->directory) {
+            imgui::TextDisabled("Double click to drill down");
+        }
+        imgui::EndTooltip();
+    }
+
+    if (imgui::IsMouseClicked(ImGuiMouseButton_Left)) {
+        g_selected = hovered_cell->node;
+    }
+    if (imgui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
+        if (hovered_cell->directory) {
+            // drill into the top-level cell containing it, so the next level down is what was clicked
+            u32 target = hovered_cell->node;
+            std::scoped_lock lock(g_scan->mutex);
+            while (g_scan->tree.nodes[target].parent != g_view_root && g_scan->tree.nodes[target].parent != disk_usage_tree::NIL) {
+                target = g_scan->tree.nodes[target].parent;
+            }
+            g_view_root = target;
+        } else {
+            (void) find_in_swan_explorer_0(disk_usage_node_path(hovered_cell->node).c_str());
+        }
+    }
+    if (imgui::IsMouseClicked(ImGuiMouseButton_Right)) {
+        std::scoped_lock lock(g_scan->mutex);
+        if (u32 parent = g_scan->tree.nodes[g_view_root].parent; parent != disk_usage_tree::NIL) {
+            g_view_root = parent;
+        }
+    }
+}
+
+static
+void disk_usage_render_tables(u64 size_unit_multiplier) noexcept
+{
+    using namespace swan_disk_usage;
+
+    s32 table_flags =
+        ImGuiTableFlags_SizingStretchProp|
+        ImGuiTableFlags_Resizable|
+        ImGuiTableFlags_BordersV|
+        ImGuiTableFlags_ScrollY|
+        (global_state::settings().tables_alt_row_bg ? ImGuiTableFlags_RowBg : 0)|
+        (global_state::settings().table_borders_in_body ? 0 : ImGuiTableFlags_NoBordersInBody)
+    ;
+
+    if (!imgui::BeginTabBar("## disk_usage tabs")) {
+        return;
+    }
+
+    if (imgui::BeginTabItem("Contents")) {
+        if (imgui::BeginTable("## disk_usage contents", 3, table_flags)) {
+            imgui::TableSetupColumn("Name", ImGuiTableColumnFlags_NoHide);
+            imgui::TableSetupColumn("Size");
+            imgui::TableSetupColumn("%");
+            imgui::TableSetupScrollFreeze(0, 1);
+            imgui::TableHeadersRow();
+
+            ImGuiListClipper clipper;
+            clipper.Begin(s32(g_layout.contents.size()));
+
+            while (clipper.Step())
+            for (s32 i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                row const &r = g_layout.contents[i];
+
+                imgui::TableNextRow();
+
+                imgui::TableNextColumn();
+                imgui::TextColored(r.directory ? directory_color() : file_color(), r.directory ? ICON_LC_FOLDER : ICON_LC_FILE);
+                imgui::SameLine();
+                auto label = make_str_static<1200>("%s ## %zu", r.name.c_str(), u64(r.node));
+                if (imgui::Selectable(label.data(), r.node == g_selected, ImGuiSelectableFlags_SpanAllColumns|ImGuiSelectableFlags_AllowDoubleClick)) {
+                    g_selected = r.node;
+                    if (imgui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
+                        if (r.directory) {
+                            g_view_root = r.node;
+                        } else {
+                            (void) find_in_swan_explorer_0(disk_usage_node_path(r.node).c_str());
+                        }
+                    }
+                }
+
+                imgui::TableNextColumn();
+                imgui::TextUnformatted(format_file_size(r.size, size_unit_multiplier).data());
+
+                imgui::TableNextColumn();
+                imgui::Text("%.1lf", g_layout.view_root_size > 0 ? f64(r.size) / f64(g_layout.view_root_size) * 100.0 : 0.0);
+            }
+
+            imgui::EndTable();
+        }
+        imgui::EndTabItem();
+    }
+
+    if (imgui::BeginTabItem("Largest files")) {
+        if (imgui::BeginTable("## disk_usage largest_files", 3, table_flags)) {
+            imgui::TableSetupColumn("Name", ImGuiTableColumnFlags_NoHide);
+            imgui::TableSetupColumn("Size");
+            imgui::TableSetupColumn("Location");
+            imgui::TableSetupScrollFreeze(0, 1);
+            imgui::TableHeadersRow();
+
+            ImGuiListClipper clipper;
+            clipper.Begin(s32(g_layout.largest_files.size()));
+
+            while (clipper.Step()) {
+                std::scoped_lock lock(g_scan->mutex); // nodes never move once added, only their ancestors' sizes change
+
+                for (s32 i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+                    u32 file_idx = g_layout.largest_files[i];
+                    auto const &tree = g_scan->tree;
+
+                    imgui::TableNextRow();
+
+                    imgui::TableNextColumn();
+                    auto label = make_str_static<1200>("%s ## largest %zu", tree.name(file_idx), u64(file_idx));
+                    if (imgui::Selectable(label.data(), file_idx == g_selected, ImGuiSelectableFlags_SpanAllColumns|ImGuiSelectableFlags_AllowDoubleClick)) {
+                        g_selected = file_idx;
+                        if (imgui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
+                            (void) find_in_swan_explorer_0(tree.path(file_idx).c_str());
+                        }
+                    }
+
+                    imgui::TableNextColumn();
+                    imgui::TextUnformatted(format_file_size(tree.nodes[file_idx].size, size_unit_multiplier).data());
+
+                    imgui::TableNextColumn();
+                    std::string location = tree.path(tree.nodes[file_idx].parent);
+                    imgui::TextUnformatted(location.c_str());
+                }
+            }
+
+            imgui::EndTable();
+        }
+        imgui::EndTabItem();
+    }
+
+    imgui::EndTabBar();
+}
+
+bool swan_windows::render_disk_usage(bool &open, [[maybe_unused]] bool any_popups_open) noexcept
+{
+    using namespace swan_disk_usage;
+
+    if (!imgui::Begin(swan_windows::get_name(swan_windows::id::disk_usage), &open)) {
+        return false;
+    }
+
+    u64 size_unit_multiplier = global_state::settings().size_unit_multiplier;
+    bool scanning = g_scan != nullptr && g_scan->duration_ms.load() < 0;
+
+    {
+        imgui::ScopedItemWidth w(imgui::CalcTextSize("C:\\  (1023.9 GB free)").x + imgui::GetFrameHeight());
+
+        if (imgui::BeginCombo("## disk_usage drive", ICON_LC_HARD_DRIVE " Drive")) {
+            if (imgui::IsWindowAppearing()) {
+                g_drives = query_available_drives_info();
+            }
+            for (auto const &drive : g_drives) {
+                auto label = make_str_static<64>("%c:\\  (%s free)", drive.letter, format_file_size(drive.available_bytes, size_unit_multiplier).data());
+                if (imgui::Selectable(label.data())) {
+                    g_root_input = path_create(make_str_static<4>("%c:\\", drive.letter).data());
+                    disk_usage_scan_start(g_root_input.data());
+                }
+            }
+            imgui::EndCombo();
+        }
+    }
+
+    imgui::SameLine();
+
+    bool start_scan = false;
+    {
+        imgui::ScopedItemWidth w(imgui::CalcTextSize("123456789_123456789_123456789_123456789_").x);
+
+        imgui::InputTextWithHint("## disk_usage root", "Directory to scan...", g_root_input.data(), g_root_input.max_size(),
+                                 ImGuiInputTextFlags_CallbackCharFilter, filter_chars_callback, (void *)windows_illegal_path_chars());
+
+        start_scan = imgui::IsItemFocused() && imgui::IsKeyPressed(ImGuiKey_Enter);
+    }
+
+    imgui::SameLine();
+
+    if (scanning) {
+        if (imgui::Button(ICON_LC_SEARCH_X "## disk_usage")) {
+            g_scan->cancelled.store(true);
+            g_scan->pending_changed.notify_all();
+        }
+        if (imgui::IsItemHovered()) imgui::SetTooltip("Cancel scan");
+    } else {
+        imgui::ScopedDisable d(path_is_empty(g_root_input));
+        start_scan |= imgui::Button(ICON_LC_SCAN_SEARCH "## disk_usage");
+        if (imgui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) imgui::SetTooltip("Scan");
+    }
+
+    if (start_scan && !path_is_empty(g_root_input)) {
+        if (directory_exists(g_root_input.data())) {
+            disk_usage_scan_start(g_root_input.data());
+        } else {
+            std::string action = make_str("Scan [%s] for disk usage.", g_root_input.data());
+            swan_popup_modals::open_error(action.c_str(), "Directory does not exist.");
+        }
+    }
+
+    if (g_scan == nullptr) {
+        imgui::TextDisabled("Pick a drive, or enter a directory and press Enter.");
+        return true;
+    }
+
+    scanning = g_scan->duration_ms.load() < 0;
+
+    imgui::SameLineSpaced(1);
+    {
+        s64 duration_ms = scanning ? time_diff_ms(g_scan->start_time, get_time_precise()) : g_scan->duration_ms.load();
+        u64 tree_bytes = 0;
+        {
+            std::scoped_lock lock(g_scan->mutex);
+            tree_bytes = g_scan->tree.nodes.capacity() * sizeof(disk_usage_tree::node) + g_scan->tree.names.capacity() + g_scan->tree.name_slots.capacity() * sizeof(u32);
+        }
+        imgui::Text("%s%zu files, %zu directories in %.1lf s", scanning ? "Scanning... " : (g_scan->cancelled.load() ? "Cancelled, " : ""),
+                    g_scan->num_files.load(), g_scan->num_directories.load(), f64(duration_ms) / 1000.0);
+        if (imgui::IsItemHovered()) {
+            imgui::SetTooltip("%zu directories couldn't be listed\n%s in memory", g_scan->num_unlistable.load(), format_file_size(tree_bytes, 1024).data());
+        }
+    }
+
+    {
+        std::string view_root_path = {};
+        bool at_root = false;
+        {
+            std::scoped_lock lock(g_scan->mutex);
+            view_root_path = g_scan->tree.path(g_view_root);
+            at_root = g_scan->tree.nodes[g_view_root].parent == disk_usage_tree::NIL;
+        }
+
+        {
+            imgui::ScopedDisable d(at_root);
+            if (imgui::Button(ICON_LC_ARROW_UP "## disk_usage up")) {
+                std::scoped_lock lock(g_scan->mutex);
+                g_view_root = g_scan->tree.nodes[g_view_root].parent;
+            }
+        }
+        if (imgui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) imgui::SetTooltip("Up (or right click the treemap)");
+
+        imgui::SameLine();
+        imgui::AlignTextToFramePadding();
+        imgui::Text("%s  %s", view_root_path.c_str(), format_file_size(g_layout.view_root_size, size_unit_multiplier).data());
+    }
+
+    ImVec2 avail = imgui::GetContentRegionAvail();
+
+    if (imgui::BeginChild("## disk_usage treemap child", ImVec2(avail.x * 0.65f, 0))) {
+        disk_usage_render_treemap(size_unit_multiplier);
+    }
+    imgui::EndChild();
+
+    imgui::SameLine();
+
+    if (imgui::BeginChild("## disk_usage tables child")) {
+        disk_usage_render_tables(size_unit_multiplier);
+    }
+    imgui::EndChild();
+
+    return true;
+}
@@ -305,7 +305,7 @@ generic_result add_selected_entries_to_file_op_payload(explorer_window &expl, ch
 }
 
 static
-generic_result delete_selected_entries(explorer_window &expl, swan_settings const &settings) noexcept
+generic_result delete_selected_entries(explorer_window &expl, swan_settings const &settings, bool permanent = false) noexcept
 {
     auto file_operation_task = [](
         std::wstring working_directory_utf16,
@@ -356,6 +356,7 @@ generic_result delete_selected_entries(explorer_window &expl, swan_settings cons
         prog_sink.dst_expl_cwd_when_operation_started = path_create("");
         prog_sink.dir_sep_utf8 = dir_sep_utf8;
         prog_sink.num_max_file_operations = num_max_file_operations;
+        prog_sink.verify_copies = false;
 
         // add items (IShellItem) for exec to IFileOperation
         {
@@ -428,7 +429,7 @@ generic_result delete_selected_entries(explorer_window &expl, swan_settings cons
                 return set_init_error_and_notify(errors);
             }
 
-            prog_sink.group_id = global_state::completed_file_operations_calc_next_group_id();
+            prog_sink.group_id = global_state::completed_file_operations_next_group_id();
         }
 
         DWORD cookie = {};
@@ -492,15 +493,28 @@ generic_result delete_selected_entries(explorer_window &expl, swan_settings cons
     bool initialization_done = false;
     std::string initialization_error = {};
 
-    global_state::thread_pool().push_task(file_operation_task,
-        cwd_utf16,
-        std::move(packed_paths_to_delete_utf16),
-        &expl.shlwapi_task_initialization_mutex,
-        &expl.shlwapi_task_initialization_cond,
-        &initialization_done,
-        &initialization_error,
-        settings.dir_separator_utf8,
-        settings.num_max_file_operations);
+    if (permanent) {
+        // skip IFileOperation entirely, it is far too slow for trees with many entries
+        global_state::thread_pool().push_task(perform_permanent_delete,
+            cwd_utf16,
+            std::move(packed_paths_to_delete_utf16),
+            &expl.shlwapi_task_initialization_mutex,
+            &expl.shlwapi_task_initialization_cond,
+            &initialization_done,
+            &initialization_error,
+            settings.dir_separator_utf8,
+            settings.num_max_file_operations);
+    } else {
+        global_state::thread_pool().push_task(file_operation_task,
+            cwd_utf16,
+            std::move(packed_paths_to_delete_utf16),
+            &expl.shlwapi_task_initialization_mutex,
+            &expl.shlwapi_task_initialization_cond,
+            &initialization_done,
+            &initialization_error,
+            settings.dir_separator_utf8,
+            settings.num_max_file_operations);
+    }
 
     {
         std::unique_lock lock(expl.shlwapi_task_initialization_mutex);
@@ -541,7 +555,8 @@ generic_result move_files_into(swan_path const &destination_utf8, explorer_windo
         &initialization_done,
         &initialization_error,
         global_state::settings().dir_separator_utf8,
-        global_state::settings().num_max_file_operations);
+        global_state::settings().num_max_file_operations,
+        global_state::settings().file_operations_verify_copies);
 
     {
         std::unique_lock lock(expl.shlwapi_task_initialization_mutex);
@@ -753,15 +768,32 @@ generic_result open_symlink(explorer_window::dirent const &dirent, explorer_wind
     }
 }
 
+/// What the "On disk" column shows for `dirent`, 0 while unknown.
+static
+u64 dirent_size_on_disk(explorer_window const &expl, explorer_window::dirent const &dirent) noexcept
+{
+    if (expl.size_job == nullptr) {
+        return 0;
+    }
+    if (dirent.basic.is_directory()) {
+        return dirent.size_job_slot < expl.size_job->sizes.size() ? expl.size_job->sizes[dirent.size_job_slot].load() : 0;
+    }
+    u64 cluster_size = expl.size_job->cluster_size.load();
+    if (!dirent.basic.is_file() || cluster_size == 0) {
+        return 0;
+    }
+    return (dirent.basic.size + cluster_size - 1) / cluster_size * cluster_size;
+}
+
 /// @brief Partitions and sorts `expl.cwd_entries` by `filtered` and `expl.sort_specs`, in place.
 /// Entries are partitioned by the `filtered` flag.
 /// The first partition contains the entries with `filtered == false`, sorted according to `expl.sort_specs`.
 /// The second partition contains entries with `filtered == true`, whose order is undefined.
 /// @return Iterator to the second partition, can be `cwd_entries.end()` if all entries are `filtered == false`.
-static
 std::vector<explorer_window::dirent>::iterator
-sort_cwd_entries(explorer_window &expl, std::source_location sloc = std::source_location::current()) noexcept
+sort_cwd_entries(explorer_window &expl, std::source_location sloc) noexcept
 {
+    SWAN_PROFILE_FUNCTION();
     f64 sort_us = 0;
     SCOPE_EXIT { expl.sort_timing_samples.push_back(sort_us); };
     scoped_timer<timer_unit::MICROSECONDS> sort_timer(&sort_us);
@@ -770,85 +802,258 @@ sort_cwd_entries(explorer_window &expl, std::source_location sloc = std::source_
 
     print_debug_msg("[ %d ] sort_cwd_entries() called from [%s:%d]", expl.id, path_cfind_filename(sloc.file_name()), sloc.line());
 
-    using dir_ent_t = explorer_window::dirent;
+    bool sorted_by_size_on_disk = false;
+    std::vector<dirent_sort_spec> specs = {};
+    specs.reserve(expl.column_sort_specs.size());
+
+    for (auto const &col_sort_spec : expl.column_sort_specs) {
+        dirent_sort_spec spec = { .by = dirent_sort_spec::key::id, .ascending = col_sort_spec.SortDirection == ImGuiSortDirection_Ascending };
+
+        switch (col_sort_spec.ColumnUserID) {
+            default:
+            case explorer_window::cwd_entries_table_col_id:              spec.by = dirent_sort_spec::key::id; break;
+            case explorer_window::cwd_entries_table_col_path:            spec.by = dirent_sort_spec::key::path; break;
+            case explorer_window::cwd_entries_table_col_object:
+            case explorer_window::cwd_entries_table_col_type:            spec.by = dirent_sort_spec::key::kind; break;
+            case explorer_window::cwd_entries_table_col_size_formatted:
+            case explorer_window::cwd_entries_table_col_size_bytes:      spec.by = dirent_sort_spec::key::size; break;
+            case explorer_window::cwd_entries_table_col_creation_time:   spec.by = dirent_sort_spec::key::creation_time; break;
+            case explorer_window::cwd_entries_table_col_last_write_time: spec.by = dirent_sort_spec::key::last_write_time; break;
+            case explorer_window::cwd_entries_table_col_size_on_disk:    spec.by = dirent_sort_spec::key::size_on_disk; sorted_by_size_on_disk = true; break;
+        }
+
+        specs.push_back(spec);
+    }
+
+    if (sorted_by_size_on_disk) {
+        // the comparator must see the same sizes throughout, or it's not a strict weak ordering
+        for (auto &dirent : cwd_entries) {
+            if (!dirent.filtered) {
+                dirent.sorted_size_on_disk = dirent_size_on_disk(expl, dirent);
+            }
+        }
+    }
+
+    auto first_filtered_dirent = sort_dirents(cwd_entries, std::span<dirent_sort_spec const>(specs));
 
-    auto first_filtered_dirent = std::partition(cwd_entries.begin(), cwd_entries.end(), [](dir_ent_t const &dirent) noexcept {
-        return !dirent.filtered;
-    });
+    return first_filtered_dirent;
+}
 
-    s32 obj_precedence_table[(u64)basic_dirent::kind::count] = {
-        10, // directory
-        10, // symlink_to_directory
-        5,  // file
-        5,  // symlink_to_file
-        5,  // symlink_ambiguous
-        5,  // invalid_symlink
+/// Keeps `expl.size_job` in step with the listing while the "On disk" column is shown, cancelling it otherwise.
+/// Once the job is done the entries are sorted again, if sorted by that column.
+static
+void update_directory_sizes(explorer_window &expl, bool column_shown) noexcept
+try {
+    auto cancel = [&]() noexcept {
+        if (expl.size_job != nullptr) {
+            expl.size_job->cancelled.store(true);
+            expl.size_job = nullptr;
+        }
     };
 
-    std::sort(cwd_entries.begin(), first_filtered_dirent, [&](dir_ent_t const &left, dir_ent_t const &right) noexcept -> bool {
-        s64 delta = 0;
+    if (!column_shown || path_is_empty(expl.cwd)) {
+        cancel();
+        return;
+    }
 
-        for (auto const &col_sort_spec : expl.column_sort_specs) {
-            switch (col_sort_spec.ColumnUserID) {
-                default:
-                case explorer_window::cwd_entries_table_col_id: {
-                    delta = left.basic.id - right.basic.id;
-                    break;
-                }
-                case explorer_window::cwd_entries_table_col_path: {
-                    delta = lstrcmpiA(right.basic.path.data(), left.basic.path.data());
-                    break;
-                }
-                case explorer_window::cwd_entries_table_col_object:
-                case explorer_window::cwd_entries_table_col_type: {
-                    assert((s32)right.basic.type >= 0);
-                    delta = obj_precedence_table[(u64)left.basic.type] - obj_precedence_table[(u64)right.basic.type];
-                    break;
-                }
-                // case explorer_window::cwd_entries_table_col_type: {
-                //     if (left.basic.type != right.basic.type) {
-                //         assert((s32)right.basic.type >= 0);
-                //         delta = obj_precedence_table[(u64)left.basic.type] - obj_precedence_table[(u64)right.basic.type];
-                //     } else {
-                //         delta = lstrcmpiA(path_cfind_file_ext(right.basic.path.data()), path_cfind_file_ext(left.basic.path.data()));
-                //     }
-                //     break;
-                // }
-                case explorer_window::cwd_entries_table_col_size_formatted:
-                case explorer_window::cwd_entries_table_col_size_bytes: {
-                    delta = left.basic.size - right.basic.size;
-                    break;
-                }
-                case explorer_window::cwd_entries_table_col_creation_time: {
-                    delta = CompareFileTime(&left.basic.creation_time_raw, &right.basic.creation_time_raw);
-                    break;
-                }
-                case explorer_window::cwd_entries_table_col_last_write_time: {
-                    delta = CompareFileTime(&left.basic.last_write_time_raw, &right.basic.last_write_time_raw);
-                    break;
-                }
+    bool job_current = expl.size_job != nullptr &&
+                       expl.size_job->listing_time == expl.last_filesystem_query_time &&
+                       path_loosely_same(expl.size_job->directory, expl.cwd);
+
+    if (!job_current) {
+        cancel();
+
+        std::vector<swan_path> names = {};
+
+        for (auto &dirent : expl.cwd_entries) {
+            if (dirent.basic.is_directory() && !dirent.basic.is_path_dotdot()) {
+                dirent.size_job_slot = u32(names.size());
+                names.push_back(dirent.basic.path);
+            } else {
+                dirent.size_job_slot = u32(-1);
             }
+        }
+
+        expl.size_job = std::make_shared<directory_size_job>(expl.cwd, std::move(names));
+        expl.size_job->listing_time = expl.last_filesystem_query_time;
+        expl.size_job_sorted = false;
+
+        directory_sizes_compute(expl.size_job);
+    }
+    else if (!expl.size_job_sorted && expl.size_job->num_pending.load() == 0) {
+        expl.size_job_sorted = true;
 
-            if (delta > 0) {
-                return col_sort_spec.SortDirection == ImGuiSortDirection_Ascending;
+        bool sorted_by_size_on_disk = std::any_of(expl.column_sort_specs.begin(), expl.column_sort_specs.end(), [](ImGuiTableColumnSortSpecs const &spec) noexcept {
+            return spec.ColumnUserID == explorer_window::cwd_entries_table_col_size_on_disk;
+        });
+        if (sorted_by_size_on_disk) {
+            expl.first_filtered_cwd_dirent_iter = sort_cwd_entries(expl);
+        }
+    }
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    expl.size_job = nullptr;
+}
+
+/// Asks the prefetcher for the directories `expl` is likely to open next: children of the cwd visited recently (most recent
+/// first), then pinned directories.
+static
+void prefetch_likely_next_directories(explorer_window const &expl) noexcept
+try {
+    static u64 const MAX_HISTORY_CANDIDATES = 4;
+    static u64 const MAX_CANDIDATES = 8;
+
+    std::vector<swan_path> candidates = {};
+
+    auto add_candidate = [&](swan_path const &candidate) noexcept {
+        bool duplicate = path_loosely_same(candidate, expl.cwd) ||
+                         std::any_of(candidates.begin(), candidates.end(), [&](swan_path const &c) noexcept { return path_loosely_same(c, candidate); });
+        if (!duplicate) {
+            candidates.push_back(candidate);
+        }
+    };
+
+    u64 cwd_len = path_length(expl.cwd);
+    while (cwd_len > 0 && strchr("\\/", expl.cwd[cwd_len - 1])) {
+        --cwd_len;
+    }
+
+    for (auto const &item : expl.wd_history) {
+        if (candidates.size() >= MAX_HISTORY_CANDIDATES) {
+            break;
+        }
+        if (!path_loosely_inside(item.path.data(), expl.cwd.data(), cwd_len)) {
+            continue;
+        }
+        // the child of the cwd on the way to wherever it was
+        swan_path child = item.path;
+        u64 end = cwd_len + 1;
+        while (child[end] != '\0' && child[end] != '\\' && child[end] != '/') {
+            ++end;
+        }
+        child[end] = '\0';
+        add_candidate(child);
+    }
+
+    for (auto const &pin : global_state::pinned_get()) {
+        if (candidates.size() >= MAX_CANDIDATES) {
+            break;
+        }
+        add_candidate(pin.path);
+    }
+
+    prefetch_directories(candidates, false);
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+/// Hovering a directory row for a moment is a good hint it is about to be opened.
+static
+void prefetch_hovered_directory(explorer_window &expl, explorer_window::dirent const &dirent) noexcept
+try {
+    swan_path directory = expl.cwd;
+    if (!path_append(directory, dirent.basic.path.data(), '\\', true)) {
+        return;
+    }
+
+    u64 directory_key = path_loose_hash(directory.data());
+    if (directory_key == expl.prefetched_hovered_key) {
+        return;
+    }
+    expl.prefetched_hovered_key = directory_key;
+
+    prefetch_directories({ directory }, true);
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+/// Runs off the main thread after an explorer painted a listing from directory_listing_cache. If the directory changed since the
+/// listing was stored, drops it and has the explorer refresh, unless it has moved on to another directory meanwhile.
+/// The directory's write time catches entries added, removed or renamed, files written to in place take enumerating it again.
+static
+void revalidate_cached_listing(s32 expl_id, swan_path directory, u64 directory_key, platform_file_time cached_write_time) noexcept
+{
+    SWAN_PROFILE_FUNCTION();
+
+    platform_file_info info = {};
+    bool current = platform_stat(directory.data(), info).ok() && info.last_write_time == cached_write_time;
+
+    if (current) {
+        thread_local directory_listing_cache::listing t_fresh = {};
+
+        current = directory_listing_enumerate(directory.data(), directory_listing_cache::MAX_ENTRIES_TOTAL, t_fresh, shortcut_kind_find_cached) == directory_listing_enumerate_result::success
+               && t_fresh.directory_write_time == cached_write_time;
+
+        if (current) {
+            auto listing_cache = global_state::listing_cache_get();
+            std::scoped_lock listing_cache_lock(*listing_cache.mutex);
+
+            // looked up directly, `find` would count a hit and mark the listing used. Evicted meanwhile counts as changed
+            auto found = listing_cache.container->index.find(directory_key);
+            current = found != listing_cache.container->index.end() && found->second->same_entries_as(t_fresh);
+        }
+    }
+
+    if (current) {
+        return;
+    }
+
+    print_debug_msg("[ %d ] cached listing stale [%s]", expl_id, directory.data());
+    {
+        auto listing_cache = global_state::listing_cache_get();
+        std::scoped_lock listing_cache_lock(*listing_cache.mutex);
+        (void) listing_cache.container->erase(directory_key);
+        ++listing_cache.container->num_stale;
+    }
+
+    global_state::explorers()[expl_id].stale_cached_listing_key.store(directory_key);
+    global_state::wake_render_loop();
+}
+
+/// Upgrades `symlink_ambiguous` entries of `expl` whose kind shortcut_kind_cache knows by now, returns how many.
+/// With `defer_unknown` the rest are handed to `shortcut_kinds_resolve_deferred`, replacing the explorer's previous request.
+static
+u64 apply_known_shortcut_kinds(explorer_window &expl, swan_path const &directory, bool defer_unknown) noexcept
+try {
+    SWAN_PROFILE_FUNCTION();
+
+    u64 num_upgraded = 0;
+    std::vector<shortcut_to_resolve> unknown = {};
+    {
+        auto shortcut_cache = global_state::shortcut_cache_get();
+        std::scoped_lock lock(*shortcut_cache.mutex);
+
+        for (auto &dirent : expl.cwd_entries) {
+            if (!dirent.basic.is_symlink_ambiguous()) {
+                continue;
             }
-            else if (delta < 0) {
-                return col_sort_spec.SortDirection != ImGuiSortDirection_Ascending;
+            swan_path lnk_path = directory;
+            if (!path_append(lnk_path, dirent.basic.path.data(), '\\', true)) {
+                continue;
             }
-            else { // delta == 0
-                continue; // go to next sort spec
+            platform_file_time lnk_write_time = dirent.basic.last_write_time_raw;
+
+            if (shortcut_cache.container->find(path_loose_hash(lnk_path.data()), lnk_write_time, dirent.basic.type)) {
+                ++num_upgraded;
+            }
+            else if (defer_unknown) {
+                unknown.push_back({ dirent.basic.path, lnk_write_time });
             }
         }
+    }
 
-        if (delta == 0) {
-            return left.basic.id < right.basic.id;
-        }
-        else {
-            return delta;
-        }
-    });
+    if (defer_unknown) {
+        shortcut_kinds_resolve_deferred(expl.id, directory, std::move(unknown));
+    }
 
-    return first_filtered_dirent;
+    return num_upgraded;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return 0;
 }
 
 explorer_window::update_cwd_entries_result explorer_window::update_cwd_entries(
@@ -856,6 +1061,7 @@ explorer_window::update_cwd_entries_result explorer_window::update_cwd_entries(
     std::string_view parent_dir,
     std::source_location sloc) noexcept
 {
+    SWAN_PROFILE_FUNCTION();
     f64 time_inside_func_us = 0;
     SCOPE_EXIT { this->update_cwd_entries_culmulative_us += time_inside_func_us; };
     scoped_timer<timer_unit::MICROSECONDS> culm_timer(&time_inside_func_us);
@@ -870,8 +1076,6 @@ explorer_window::update_cwd_entries_result explorer_window::update_cwd_entries(
     update_cwd_entries_timers timers = {};
     SCOPE_EXIT { this->update_cwd_entries_timing_samples.push_back(timers); };
 
-    char dir_sep_utf8 = global_state::settings().dir_separator_utf8;
-
     {
         scoped_timer<timer_unit::MICROSECONDS> function_timer(&timers.total_us);
 
@@ -900,9 +1104,7 @@ explorer_window::update_cwd_entries_result explorer_window::update_cwd_entries(
             this->cwd_entries.clear();
 
             if (parent_dir != "") {
-                bool inside_recycle_bin;
-
-                wchar_t search_path_utf16[512]; cstr_clear(search_path_utf16);
+                swan_path parent_dir_trimmed = {};
                 {
                     scoped_timer<timer_unit::MICROSECONDS> searchpath_setup_timer(&timers.searchpath_setup_us);
 
@@ -910,32 +1112,11 @@ explorer_window::update_cwd_entries_result explorer_window::update_cwd_entries(
                     while (*(&parent_dir.back() - num_trailing_spaces) == ' ') {
                         ++num_trailing_spaces;
                     }
-                    swan_path parent_dir_trimmed = {};
                     strncpy(parent_dir_trimmed.data(), parent_dir.data(), parent_dir.size() - num_trailing_spaces);
                     path_force_separator(parent_dir_trimmed, '\\');
-
-                    (void) utf8_to_utf16(parent_dir_trimmed.data(), search_path_utf16, lengthof(search_path_utf16));
-
-                    wchar_t dir_sep_w[] = { (wchar_t)dir_sep_utf8, L'\0' };
-
-                    if (!parent_dir.ends_with(dir_sep_utf8)) {
-                        (void) StrCatW(search_path_utf16, dir_sep_w);
-                    }
-                    (void) StrCatW(search_path_utf16, L"*");
-
-                    inside_recycle_bin = cstr_starts_with(parent_dir_trimmed.data() + 1, ":\\$Recycle.Bin\\"); // assume drive letter is first char
                 }
 
-                // just for debug log
-                {
-                    char utf8_buffer[2048]; cstr_clear(utf8_buffer);
-
-                    if (!utf16_to_utf8(search_path_utf16, utf8_buffer, lengthof(utf8_buffer))) {
-                        return retval;
-                    }
-
-                    print_debug_msg("[ %d ] querying filesystem, search_path = [%s]", this->id, utf8_buffer);
-                }
+                u64 const directory_key = path_loose_hash(parent_dir_trimmed.data());
 
                 std::scoped_lock lock(select_cwd_entries_on_next_update_mutex); // lock for rest of this function to prevent other threads from adding items and breaking order
                 {
@@ -943,121 +1124,120 @@ explorer_window::update_cwd_entries_result explorer_window::update_cwd_entries(
                     std::sort(select_cwd_entries_on_next_update.begin(), select_cwd_entries_on_next_update.end(), std::less<swan_path>());
                 }
 
-                scoped_timer<timer_unit::MICROSECONDS> filesystem_timer(&timers.filesystem_us);
+                auto add_entry = [&](explorer_window::dirent &entry) noexcept {
+                    if (entry.basic.is_path_dotdot()) {
+                        if (global_state::settings().explorer_show_dotdot_dir) {
+                            this->cwd_entries.emplace_back(entry);
+                            std::swap(this->cwd_entries.back(), this->cwd_entries.front());
+                        }
+                        return;
+                    }
 
-                WIN32_FIND_DATAW find_data;
-                HANDLE find_handle = FindFirstFileW(search_path_utf16, &find_data);
-                SCOPE_EXIT { FindClose(find_handle); };
+                    //? Don't bother trying to make this more efficient, instead work on issue #3 which will eliminate this code
+                    for (auto prev_selected_entry = s_preserve_select.begin(); prev_selected_entry != s_preserve_select.end(); ++prev_selected_entry) {
+                        bool was_selected_before_refresh = path_equals_exactly(entry.basic.path, *prev_selected_entry);
+                        if (was_selected_before_refresh) {
+                            entry.selected = true;
+                            retval.num_entries_selected += 1;
+                            std::swap(*prev_selected_entry, s_preserve_select.back());
+                            s_preserve_select.pop_back();
+                            break;
+                        }
+                    }
+                    {
+                        f64 search_us = 0;
+                        scoped_timer<timer_unit::MICROSECONDS> search_timer(&search_us);
 
-                if (find_handle == INVALID_HANDLE_VALUE) {
-                    print_debug_msg("[ %d ] find_handle == INVALID_HANDLE_VALUE", this->id);
-                    return retval;
-                }
-                retval.parent_dir_exists = true;
+                        if (!this->select_cwd_entries_on_next_update.empty()) {
+                            auto [first_iter, last_iter] = std::equal_range(this->select_cwd_entries_on_next_update.begin(),
+                                                                            this->select_cwd_entries_on_next_update.end(), entry.basic.path);
+                            if (bool found = std::distance(first_iter, last_iter) == 1) {
+                                entry.selected = true;
+                                retval.num_entries_selected += 1;
+                            }
+                        }
+                        timers.entries_to_select_search += search_us;
+                    }
 
-                u32 entry_id = 0;
+                    // this could throw on alloc failure, which will call std::terminate
+                    this->cwd_entries.emplace_back(entry);
+                };
 
-                do {
-                    explorer_window::dirent entry = {};
-                    entry.basic.id = entry_id;
-                    entry.basic.size = two_u32_to_one_u64(find_data.nFileSizeLow, find_data.nFileSizeHigh);
-                    entry.basic.creation_time_raw = find_data.ftCreationTime;
-                    entry.basic.last_write_time_raw = find_data.ftLastWriteTime;
+                auto add_listing_entries = [&](directory_listing_cache::listing const &listing) noexcept {
+                    u32 entry_id = 0;
 
-                    if (!utf16_to_utf8(find_data.cFileName, entry.basic.path.data(), entry.basic.path.size())) {
-                        continue;
-                    }
+                    for (auto const &listed : listing.entries) {
+                        explorer_window::dirent entry = {};
+                        entry.basic.id = entry_id++;
+                        entry.basic.size = listed.size;
+                        entry.basic.creation_time_raw = listed.creation_time_raw;
+                        entry.basic.last_write_time_raw = listed.last_write_time_raw;
+                        entry.basic.type = listed.type;
+                        auto name = listing.name(listed);
+                        memcpy(entry.basic.path.data(), name.data(), name.size());
 
-                    if (path_equals_exactly(entry.basic.path, ".")) {
-                        continue;
+                        add_entry(entry);
                     }
+                };
 
-                    if (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-                        entry.basic.type = basic_dirent::kind::directory;
-                    }
-                    else if (!inside_recycle_bin && path_ends_with(entry.basic.path, ".lnk")) {
-                        // TODO: this branch is quite slow, there should probably be an option to opt out of checking the type and validity of symlinks
+                bool served_from_listing_cache = false;
 
-                        entry.basic.type = basic_dirent::kind::invalid_symlink; // default value, if something fails below
+                if (actions & prefer_listing_cache) {
+                    scoped_timer<timer_unit::MICROSECONDS> filesystem_timer(&timers.filesystem_us);
+                    platform_file_time cached_write_time = 0;
 
-                        static std::wstring full_path_utf16 = {};
-                        full_path_utf16.clear();
-                        full_path_utf16.append(search_path_utf16);
-                        full_path_utf16.pop_back(); // remove '*'
-                        full_path_utf16.append(find_data.cFileName);
+                    {
+                        auto listing_cache = global_state::listing_cache_get();
+                        std::scoped_lock listing_cache_lock(*listing_cache.mutex);
 
-                        // Load the shortcut
-                        HRESULT com_handle = g_persist_file_interface->Load(full_path_utf16.c_str(), STGM_READ);
-                        if (FAILED(com_handle)) {
-                            WCOUT_IF_DEBUG("FAILED IPersistFile::Load [" << full_path_utf16.c_str() << "]\n");
-                        }
-                        else {
-                            // Get the target path
-                            wchar_t target_path_utf16[MAX_PATH];
-                            com_handle = g_shell_link->GetPath(target_path_utf16, lengthof(target_path_utf16), NULL, SLGP_RAWPATH);
-                            if (FAILED(com_handle)) {
-                                WCOUT_IF_DEBUG("FAILED IShellLinkW::GetPath [" << full_path_utf16.c_str() << "]\n");
-                            }
-                            else {
-                                if      (PathIsDirectoryW(target_path_utf16)) entry.basic.type = basic_dirent::kind::symlink_to_directory;
-                                else if (PathFileExistsW(target_path_utf16))  entry.basic.type = basic_dirent::kind::symlink_to_file;
-                                else                                          entry.basic.type = basic_dirent::kind::invalid_symlink;
-                            }
+                        if (auto const *listing = listing_cache.container->find(directory_key)) {
+                            served_from_listing_cache = true;
+                            cached_write_time = listing->directory_write_time;
+                            add_listing_entries(*listing);
                         }
                     }
-                    else {
-                        entry.basic.type = basic_dirent::kind::file;
+
+                    if (served_from_listing_cache) {
+                        print_debug_msg("[ %d ] listing cache hit [%s]", this->id, parent_dir_trimmed.data());
+                        retval.parent_dir_exists = true;
+
+                        // paint the cached listing now, find out off the main thread whether it was still current
+                        global_state::thread_pool().push_task([expl_id = this->id, parent_dir_trimmed, directory_key, cached_write_time]() noexcept {
+                            revalidate_cached_listing(expl_id, parent_dir_trimmed, directory_key, cached_write_time);
+                        });
                     }
+                }
 
-                    if (entry.basic.is_path_dotdot()) {
-                        if (global_state::settings().explorer_show_dotdot_dir) {
-                            this->cwd_entries.emplace_back(entry);
-                            std::swap(this->cwd_entries.back(), this->cwd_entries.front());
-                        }
-                    } else {
-                        // if (!s_preserve_select.empty()) {
-                        //     auto [first_iter, last_iter] = std::equal_range(s_preserve_select.begin(), s_preserve_select.end(), entry.basic.path);
-                        //     if (bool found = std::distance(first_iter, last_iter) == 1) {
-                        //         entry.selected = true;
-                        //         retval.num_entries_selected += 1;
-                        //         std::swap(*first_iter, s_preserve_select.back());
-                        //         s_preserve_select.pop_back();
-                        //     }
-                        // }
-                        //? Don't bother trying to make this more efficient, instead work on issue #3 which will eliminate this code
-                        for (auto prev_selected_entry = s_preserve_select.begin(); prev_selected_entry != s_preserve_select.end(); ++prev_selected_entry) {
-                            bool was_selected_before_refresh = path_equals_exactly(entry.basic.path, *prev_selected_entry);
-                            if (was_selected_before_refresh) {
-                                entry.selected = true;
-                                retval.num_entries_selected += 1;
-                                std::swap(*prev_selected_entry, s_preserve_select.back());
-                                s_preserve_select.pop_back();
-                                break;
-                            }
-                        }
-                        {
-                            f64 search_us = 0;
-                            scoped_timer<timer_unit::MICROSECONDS> search_timer(&search_us);
-
-                            if (!this->select_cwd_entries_on_next_update.empty()) {
-                                auto [first_iter, last_iter] = std::equal_range(this->select_cwd_entries_on_next_update.begin(),
-                                                                                this->select_cwd_entries_on_next_update.end(), entry.basic.path);
-                                if (bool found = std::distance(first_iter, last_iter) == 1) {
-                                    entry.selected = true;
-                                    retval.num_entries_selected += 1;
-                                }
-                            }
-                            timers.entries_to_select_search += search_us;
-                        }
+                if (!served_from_listing_cache) {
+                    print_debug_msg("[ %d ] querying filesystem [%s]", this->id, parent_dir_trimmed.data());
 
-                        // this could throw on alloc failure, which will call std::terminate
-                        this->cwd_entries.emplace_back(entry);
+                    scoped_timer<timer_unit::MICROSECONDS> filesystem_timer(&timers.filesystem_us);
+
+                    static directory_listing_cache::listing s_listing = {};
+
+                    auto result = directory_listing_enumerate(parent_dir_trimmed.data(), u64(-1), s_listing, shortcut_kind_find_cached);
+
+                    if (result != directory_listing_enumerate_result::success) {
+                        auto listing_cache = global_state::listing_cache_get();
+                        std::scoped_lock listing_cache_lock(*listing_cache.mutex);
+                        (void) listing_cache.container->erase(directory_key);
+                        return retval;
                     }
+                    retval.parent_dir_exists = true;
+
+                    add_listing_entries(s_listing);
+                    this->num_file_finds += s_listing.entries.size();
 
-                    ++this->num_file_finds;
-                    ++entry_id;
+                    if (s_listing.directory_write_time != 0) {
+                        auto listing_cache = global_state::listing_cache_get();
+                        std::scoped_lock listing_cache_lock(*listing_cache.mutex);
+                        // a copy, so s_listing keeps its capacity for the next enumeration
+                        listing_cache.container->store(directory_listing_cache::listing(s_listing));
+                    }
                 }
-                while (FindNextFileW(find_handle, &find_data));
+
+                // listings leave shortcuts nobody resolved yet as symlink_ambiguous, they are upgraded as they get resolved
+                (void) apply_known_shortcut_kinds(*this, parent_dir_trimmed, true);
 
                 this->refresh_message.clear();
                 this->refresh_message_tooltip.clear();
@@ -1072,75 +1252,22 @@ explorer_window::update_cwd_entries_result explorer_window::update_cwd_entries(
         if (actions & filter) {
             scoped_timer<timer_unit::MICROSECONDS> filter_timer(&timers.filter_us);
 
-            this->filter_error.clear();
-
-            bool dirent_type_to_visibility_table[(u64)basic_dirent::kind::count] = {
-                this->filter_show_directories, // directory
-                this->filter_show_symlink_directories, // symlink_to_directory
-                this->filter_show_files, // file
-                this->filter_show_symlink_files, // symlink_to_file
-                true, // symlink_ambiguous
-                this->filter_show_invalid_symlinks // invalid_symlink
+            dirent_filter cwd_filter = {
+                .text = this->filter_text.data(),
+                .how = this->filter_mode == explorer_window::filter_mode::regex_match ? dirent_filter::mode::regex_match : dirent_filter::mode::contains,
+                .case_sensitive = this->filter_case_sensitive,
+                .polarity = this->filter_polarity,
+                .kind_visible = {
+                    this->filter_show_directories, // directory
+                    this->filter_show_symlink_directories, // symlink_to_directory
+                    this->filter_show_files, // file
+                    this->filter_show_symlink_files, // symlink_to_file
+                    true, // symlink_ambiguous
+                    this->filter_show_invalid_symlinks // invalid_symlink
+                },
             };
 
-            u64 filter_text_len = strlen(this->filter_text.data());
-
-            for (auto &dirent : this->cwd_entries) {
-                assert((s32)dirent.basic.type != -1);
-                bool this_type_of_dirent_is_visible = dirent_type_to_visibility_table[(u64)dirent.basic.type];
-
-                dirent.filtered = !this_type_of_dirent_is_visible;
-                dirent.highlight_start_idx = 0;
-                dirent.highlight_len = 0;
-
-                if (this_type_of_dirent_is_visible && filter_text_len > 0) { // apply textual filter against dirent name
-                    char const *dirent_name = dirent.basic.path.data();
-
-                    switch (this->filter_mode) {
-                        default:
-                        case explorer_window::filter_mode::contains: {
-                            auto matcher = this->filter_case_sensitive ? StrStrA : StrStrIA;
-
-                            char const *match_start = matcher(dirent_name, this->filter_text.data());;
-                            bool filtered_out = this->filter_polarity != (bool)match_start;
-                            dirent.filtered = filtered_out;
-
-                            if (!filtered_out && filter_polarity == true) {
-                                // highlight just the substring
-                                dirent.highlight_start_idx = std::distance(dirent_name, match_start);
-                                dirent.highlight_len = filter_text_len;
-                            }
-
-                            break;
-                        }
-
-                        case explorer_window::filter_mode::regex_match: {
-                            static std::regex s_filter_regex;
-                            try {
-                                scoped_timer<timer_unit::MICROSECONDS> regex_ctor_timer(&timers.regex_ctor_us);
-                                s_filter_regex = this->filter_text.data();
-                            }
-                            catch (std::exception const &except) {
-                                this->filter_error = except.what();
-                                break;
-                            }
-
-                            auto match_flags = std::regex_constants::match_default | (std::regex_constants::icase * (this->filter_case_sensitive == 0));
-
-                            bool filtered_out = this->filter_polarity != std::regex_match(dirent_name, s_filter_regex, (std::regex_constants::match_flag_type)match_flags);
-                            dirent.filtered = filtered_out;
-
-                            if (!filtered_out && filter_polarity == true) {
-                                // highlight the whole path since we are using std::regex_match
-                                dirent.highlight_start_idx = 0;
-                                dirent.highlight_len = path_length(dirent.basic.path);
-                            }
-
-                            break;
-                        }
-                    }
-                }
-            }
+            this->filter_error = filter_dirents(this->cwd_entries, cwd_filter, &timers.regex_ctor_us);
         }
     }
 
@@ -1153,6 +1280,7 @@ explorer_window::update_cwd_entries_result explorer_window::update_cwd_entries(
 
 bool explorer_window::save_to_disk() const noexcept
 {
+    SWAN_PROFILE_FUNCTION();
     f64 save_to_disk_us = {};
     SCOPE_EXIT { this->save_to_disk_timing_samples.push_back(save_to_disk_us); };
     scoped_timer<timer_unit::MICROSECONDS> save_to_disk_timer(&save_to_disk_us);
@@ -1165,35 +1293,33 @@ bool explorer_window::save_to_disk() const noexcept
     bool result = true;
 
     try {
-        std::ofstream out(full_path);
-        if (!out) {
-            result = false;
-        } else {
-            out << "cwd " << path_length(cwd) << ' ' << cwd.data() << '\n';
+        std::ostringstream out;
+        out << "cwd " << path_length(cwd) << ' ' << cwd.data() << '\n';
 
-            out << "filter " << strlen(filter_text.data()) << ' ' << filter_text.data() << '\n';
+        out << "filter " << strlen(filter_text.data()) << ' ' << filter_text.data() << '\n';
 
-            out << "filter_mode "                       << (s32)filter_mode << '\n';
-            out << "filter_case_sensitive "             << (s32)filter_case_sensitive << '\n';
-            out << "filter_polarity "                   << (s32)filter_polarity << '\n';
-            out << "filter_show_directories "           << (s32)filter_show_directories << '\n';
-            out << "filter_show_symlink_directories "   << (s32)filter_show_symlink_directories << '\n';
-            out << "filter_show_files "                 << (s32)filter_show_files << '\n';
-            out << "filter_show_symlink_files "         << (s32)filter_show_symlink_files << '\n';
-            out << "filter_show_invalid_symlinks "      << (s32)filter_show_invalid_symlinks << '\n';
+        out << "filter_mode "                       << (s32)filter_mode << '\n';
+        out << "filter_case_sensitive "             << (s32)filter_case_sensitive << '\n';
+        out << "filter_polarity "                   << (s32)filter_polarity << '\n';
+        out << "filter_show_directories "           << (s32)filter_show_directories << '\n';
+        out << "filter_show_symlink_directories "   << (s32)filter_show_symlink_directories << '\n';
+        out << "filter_show_files "                 << (s32)filter_show_files << '\n';
+        out << "filter_show_symlink_files "         << (s32)filter_show_symlink_files << '\n';
+        out << "filter_show_invalid_symlinks "      << (s32)filter_show_invalid_symlinks << '\n';
 
-            out << "tree_node_open_debug_state "        << (s32)tree_node_open_debug_state << '\n';
-            out << "tree_node_open_debug_memory "       << (s32)tree_node_open_debug_memory << '\n';
-            out << "tree_node_open_debug_performance "  << (s32)tree_node_open_debug_performance << '\n';
-            out << "tree_node_open_debug_other "        << (s32)tree_node_open_debug_other << '\n';
+        out << "tree_node_open_debug_state "        << (s32)tree_node_open_debug_state << '\n';
+        out << "tree_node_open_debug_memory "       << (s32)tree_node_open_debug_memory << '\n';
+        out << "tree_node_open_debug_performance "  << (s32)tree_node_open_debug_performance << '\n';
+        out << "tree_node_open_debug_other "        << (s32)tree_node_open_debug_other << '\n';
 
-            out << "wd_history_pos "                    << wd_history_pos << '\n';
+        out << "wd_history_pos "                    << wd_history_pos << '\n';
 
-            for (auto const &item : wd_history) {
-                out << "wd_history_elem " << path_length(item.path) << ' ' << item.path.data() << ' '
-                    << std::chrono::system_clock::to_time_t(item.time_departed) << '\n';
-            }
+        for (auto const &item : wd_history) {
+            out << "wd_history_elem " << path_length(item.path) << ' ' << item.path.data() << ' '
+                << std::chrono::system_clock::to_time_t(item.time_departed) << '\n';
         }
+
+        persistence_write(std::move(full_path), std::move(out).str());
     }
     catch (std::exception const &except) {
         print_debug_msg("FAILED catch(std::exception) %s", except.what());
@@ -1454,6 +1580,8 @@ void explorer_window::advance_history(swan_path const &new_latest_entry) noexcep
     while (path_pop_back_if(new_latest_entry_clean, dir_sep_utf8));
     new_latest_entry_clean = path_reconstruct_canonically(new_latest_entry_clean.data());
 
+    global_state::directory_jump_visit(new_latest_entry_clean);
+
     if (!this->wd_history.empty() && path_loosely_same(new_latest_entry_clean, this->wd_history.back().path.data())) {
         return; // avoid pushing adjacent duplicates
     }
@@ -1493,7 +1621,7 @@ ascend_result try_ascend_directory(explorer_window &expl) noexcept
     // remove anything between end and final separator
     while (path_pop_back_if_not(res.parent_dir, dir_sep_utf8));
 
-    auto [parent_dir_exists, _] = expl.update_cwd_entries(query_filesystem, res.parent_dir.data());
+    auto [parent_dir_exists, _] = expl.update_cwd_entries(query_filesystem_cached, res.parent_dir.data());
     res.success = parent_dir_exists;
     print_debug_msg("[ %d ] try_ascend_directory parent_dir=[%s] res.success=%d", expl.id, res.parent_dir.data(), res.success);
 
@@ -1507,7 +1635,7 @@ ascend_result try_ascend_directory(explorer_window &expl) noexcept
         expl.cwd = res.parent_dir;
         expl.set_latest_valid_cwd(expl.cwd); // this may mutate filter
         (void) expl.update_cwd_entries(filter, res.parent_dir.data());
-        (void) expl.save_to_disk();
+        global_state::mark_dirty(expl);
     }
 
     return res;
@@ -1554,7 +1682,7 @@ descend_result try_descend_to_directory(explorer_window &expl, char const *targe
         return res;
     }
 
-    auto [cwd_exists, _] = expl.update_cwd_entries(query_filesystem, new_cwd_canoncial_utf8.data());
+    auto [cwd_exists, _] = expl.update_cwd_entries(query_filesystem_cached, new_cwd_canoncial_utf8.data());
 
     if (!cwd_exists) {
         descend_result res;
@@ -1570,7 +1698,7 @@ descend_result try_descend_to_directory(explorer_window &expl, char const *targe
     expl.cwd_latest_selected_dirent_idx = explorer_window::NO_SELECTION;
     expl.cwd_latest_selected_dirent_idx_changed = false;
     expl.filter_error.clear();
-    (void) expl.save_to_disk();
+    global_state::mark_dirty(expl);
 
     descend_result res;
     res.success = true;
@@ -1717,6 +1845,44 @@ bool swan_windows::render_explorer_debug(explorer_window &expl, bool &open, bool
         imgui::Text("format_file_size_culmulative: %.0lf ms", expl.format_file_size_culmulative_us / 1000.);
         imgui::Text("type_description_culmulative_us: %.0lf ms", expl.type_description_culmulative_us / 1000.);
 
+        imgui::SeparatorText("(Listing cache, shared)");
+        {
+            auto listing_cache = global_state::listing_cache_get();
+            std::scoped_lock listing_cache_lock(*listing_cache.mutex);
+            auto const &cache = *listing_cache.container;
+
+            imgui::Text("listings: %zu / %zu", cache.listings.size(), directory_listing_cache::MAX_LISTINGS);
+            imgui::Text("entries: %zu / %zu", cache.num_entries_total, directory_listing_cache::MAX_ENTRIES_TOTAL);
+            imgui::Text("hits: %zu, misses: %zu, stale: %zu", cache.num_hits, cache.num_misses, cache.num_stale);
+
+            auto const &prefetch = global_state::prefetch_stats_get();
+            u64 num_prefetched = prefetch.num_enumerated.load();
+            f64 prefetch_hit_rate = num_prefetched == 0 ? NAN : 100.0 * f64(cache.num_prefetch_hits) / f64(num_prefetched);
+
+            imgui::Text("prefetch hit rate: %.1lf %% (%zu of %zu used, %zu evicted unused)", prefetch_hit_rate, cache.num_prefetch_hits, num_prefetched, cache.num_prefetch_unused);
+            imgui::Text("prefetch requested: %zu, superseded: %zu, already cached: %zu", prefetch.num_requested.load(), prefetch.num_superseded.load(), prefetch.num_already_cached.load());
+            imgui::Text("prefetch skipped drive: %zu, too large: %zu, failed: %zu, backoffs: %zu",
+                        prefetch.num_skipped_drive.load(), prefetch.num_too_large.load(), prefetch.num_failed.load(), prefetch.num_backoffs.load());
+        }
+        {
+            auto shortcut_cache = global_state::shortcut_cache_get();
+            std::scoped_lock lock(*shortcut_cache.mutex);
+            auto const &cache = *shortcut_cache.container;
+
+            imgui::SeparatorText("(Shortcut cache, shared)");
+            imgui::Text("shortcuts: %zu / %zu", cache.targets.size(), shortcut_kind_cache::MAX_SHORTCUTS);
+            imgui::Text("hits: %zu, misses: %zu", cache.num_hits, cache.num_misses);
+        }
+        {
+            auto size_cache = global_state::directory_size_cache_get();
+            std::scoped_lock lock(*size_cache.mutex);
+            auto const &cache = *size_cache.container;
+
+            imgui::SeparatorText("(Directory size cache, shared)");
+            imgui::Text("records: %zu / %zu", cache.records.size(), directory_size_cache::MAX_RECORDS);
+            imgui::Text("hits: %zu, misses: %zu, invalidated: %zu, evicted: %zu", cache.num_hits, cache.num_misses, cache.num_invalidated, cache.num_evicted);
+        }
+
         imgui::TreePop();
     }
 
@@ -1754,7 +1920,7 @@ bool swan_windows::render_explorer_debug(explorer_window &expl, bool &open, bool
     static_assert(lengthof(open_states_begin) == lengthof(open_states_end));
 
     if (memcmp(open_states_begin, open_states_end, lengthof(open_states_end)) != 0) {
-        (void) expl.save_to_disk();
+        global_state::mark_dirty(expl);
     }
 
 #if 0
@@ -1867,7 +2033,7 @@ ImRect render_num_cwd_items_filtered(explorer_window &expl, cwd_count_info const
         } else {
             expl.reset_filter();
             (void) expl.update_cwd_entries(filter, expl.cwd.data());
-            (void) expl.save_to_disk();
+            global_state::mark_dirty(expl);
         }
     }
 
@@ -1948,11 +2114,11 @@ void render_button_history_right(explorer_window &expl) noexcept
         }
 
         expl.cwd = expl.wd_history[expl.wd_history_pos].path;
-        auto [back_dir_exists, _] = expl.update_cwd_entries(query_filesystem, expl.cwd.data());
+        auto [back_dir_exists, _] = expl.update_cwd_entries(query_filesystem_cached, expl.cwd.data());
         if (back_dir_exists) {
             expl.set_latest_valid_cwd(expl.cwd); // this may mutate filter
             (void) expl.update_cwd_entries(filter, expl.cwd.data());
-            (void) expl.save_to_disk();
+            global_state::mark_dirty(expl);
         }
     }
 
@@ -1978,7 +2144,7 @@ void render_button_history_left(explorer_window &expl) noexcept
         }
 
         expl.cwd = expl.wd_history[expl.wd_history_pos].path;
-        auto [forward_dir_exists, _] = expl.update_cwd_entries(query_filesystem, expl.cwd.data());
+        auto [forward_dir_exists, _] = expl.update_cwd_entries(query_filesystem_cached, expl.cwd.data());
         if (forward_dir_exists) {
             expl.set_latest_valid_cwd(expl.cwd); // this may mutate filter
             (void) expl.update_cwd_entries(filter, expl.cwd.data());
@@ -2042,7 +2208,7 @@ bool render_history_browser_popup(explorer_window &expl, bool cwd_exists) noexce
                 expl.advance_history(expl.cwd);
             }
 
-            expl.save_to_disk();
+            global_state::mark_dirty(expl);
             cleanup_and_close_popup();
         }
     }
@@ -2147,7 +2313,7 @@ bool render_filter_reset_button(explorer_window &expl) noexcept
         if (imgui::Button(ICON_LC_SEARCH_X "## clear_filter")) {
             expl.reset_filter();
             (void) expl.update_cwd_entries(filter, expl.cwd.data());
-            (void) expl.save_to_disk();
+            global_state::mark_dirty(expl);
             retval_cwd_entries_affected = true;
         }
     }
@@ -2253,7 +2419,7 @@ void render_drives_table(explorer_window &expl, char dir_sep_utf8, u64 size_unit
                     auto [drive_exists, _] = expl.update_cwd_entries(query_filesystem, expl.cwd.data());
                     if (drive_exists) {
                         (void) expl.update_cwd_entries(filter, expl.cwd.data());
-                        (void) expl.save_to_disk();
+                        global_state::mark_dirty(expl);
                     } else {
                         // TODO: handle error
                     }
@@ -2325,7 +2491,7 @@ render_filter_text_input_result render_filter_text_input(explorer_window &expl,
 
     if (imgui::InputTextWithHint("## explorer_window filter", ICON_LC_SEARCH, expl.filter_text.data(), expl.filter_text.size())) {
         (void) expl.update_cwd_entries(filter, expl.cwd.data());
-        (void) expl.save_to_disk();
+        global_state::mark_dirty(expl);
     }
     retval.focused = imgui::IsItemFocused();
 
@@ -2393,7 +2559,7 @@ bool render_filter_type_toggler_buttons(explorer_window &expl) noexcept
                 flip_bool(show);
             }
             (void) expl.update_cwd_entries(filter, expl.cwd.data());
-            (void) expl.save_to_disk();
+            global_state::mark_dirty(expl);
             retval_cwd_entries_affected = true;
         }
     }
@@ -2423,7 +2589,7 @@ bool render_filter_mode_toggle(explorer_window &expl) noexcept
     if (imgui::Button(label.data())) {
         inc_or_wrap<u64>((u64 &)expl.filter_mode, 0, u64(explorer_window::filter_mode::count) - 1);
         (void) expl.update_cwd_entries(filter, expl.cwd.data());
-        (void) expl.save_to_disk();
+        global_state::mark_dirty(expl);
         retval_cwd_entries_affected = true;
     }
 
@@ -2452,7 +2618,7 @@ bool render_filter_case_sensitivity_button(explorer_window &expl) noexcept
         if (imgui::Button(ICON_CI_CASE_SENSITIVE)) { // ICON_FA_CROSSHAIRS
             flip_bool(expl.filter_case_sensitive);
             (void) expl.update_cwd_entries(filter, expl.cwd.data());
-            (void) expl.save_to_disk();
+            global_state::mark_dirty(expl);
             retval_cwd_entries_affected = true;
         }
     }
@@ -2472,7 +2638,7 @@ bool render_filter_polarity_button(explorer_window &expl) noexcept
     if (imgui::Button(expl.filter_polarity ? (ICON_CI_EYE "## filter_polarity") : (ICON_CI_EYE_CLOSED "## filter_polarity"))) {
         flip_bool(expl.filter_polarity);
         (void) expl.update_cwd_entries(filter, expl.cwd.data());
-        (void) expl.save_to_disk();
+        global_state::mark_dirty(expl);
         retval_cwd_entries_affected = true;
     }
     if (imgui::IsItemHovered({}, 1)) {
@@ -2518,7 +2684,7 @@ void render_button_pin_cwd(explorer_window &expl, bool cwd_exists_before_edit) n
                 [pin_idx, &expl]() noexcept {
                     scoped_timer<timer_unit::MICROSECONDS> unpin_timer(&expl.unpin_us);
                     global_state::pinned_remove(pin_idx);
-                    (void) global_state::settings().save_to_disk();
+                    global_state::mark_dirty(persisted_file::settings);
                 },
                 /* confirmation_enabled = */ &(global_state::settings().confirm_explorer_unpin_directory)
             );
@@ -2526,7 +2692,7 @@ void render_button_pin_cwd(explorer_window &expl, bool cwd_exists_before_edit) n
         else {
             swan_popup_modals::open_new_pin(expl.cwd, false);
         }
-        (void) global_state::pinned_save_to_disk();
+        global_state::mark_dirty(persisted_file::pinned);
     }
     if (imgui::IsItemHovered({}, 1)) {
         imgui::SetTooltip("%s current working directory", already_pinned ? "Unpin" : "Pin");
@@ -2753,6 +2919,127 @@ void render_help_icon(explorer_window &expl) noexcept
     }
 }
 
+/// Frecency ranked matches for whatever was typed into the cwd input while it is not an existing directory, like zoxide's `z`.
+/// [Up]/[Down] move the highlight, [Enter] or clicking jumps. Returns true if the explorer jumped.
+static
+bool render_directory_jump_box(explorer_window &expl, ImRect const &input_rect, bool input_active, bool input_enter_pressed, char dir_sep_utf8) noexcept
+{
+    static s32 s_hovered_expl_id = -1; // keeps the box up while clicking into it takes focus away from the input
+    static s32 s_query_expl_id = -1;
+    static swan_path s_query = {};
+    static boost::container::static_vector<swan_path, 10> s_matches = {};
+    static std::vector<directory_jump_index::match> s_ranked = {};
+    static u64 s_highlight_idx = 0;
+    static f64 s_query_us = 0;
+
+    if ((!input_active && s_hovered_expl_id != expl.id) || path_is_empty(expl.cwd)) {
+        return false;
+    }
+
+    auto &jump_index = global_state::directory_jump_get();
+
+    if (s_query_expl_id != expl.id || !path_equals_exactly(s_query, expl.cwd)) {
+        s_query_expl_id = expl.id;
+        s_query = expl.cwd;
+        s_highlight_idx = 0;
+        {
+            scoped_timer<timer_unit::MICROSECONDS> query_timer(&s_query_us);
+            u32 now = u32(std::chrono::system_clock::to_time_t(get_time_system()));
+            jump_index.query(s_query.data(), now, path_loose_hash(expl.latest_valid_cwd.data()), s_matches.capacity(), s_ranked);
+        }
+        // copied out, the index may change before the next query
+        s_matches.clear();
+        for (auto const &ranked : s_ranked) {
+            std::string_view path = jump_index.path(jump_index.entries[ranked.entry_idx]);
+            s_matches.push_back(path_create(path.data(), path.size()));
+        }
+    }
+
+    if (s_matches.empty()) {
+        s_hovered_expl_id = -1;
+        return false;
+    }
+
+    if (input_active) {
+        if (imgui::IsKeyPressed(ImGuiKey_DownArrow)) s_highlight_idx = std::min(s_highlight_idx + 1, s_matches.size() - 1);
+        if (imgui::IsKeyPressed(ImGuiKey_UpArrow)) s_highlight_idx = s_highlight_idx > 0 ? s_highlight_idx - 1 : 0;
+    }
+
+    std::optional<u64> jump_idx = std::nullopt;
+    if (input_enter_pressed) {
+        jump_idx = std::min(s_highlight_idx, s_matches.size() - 1);
+    }
+
+    imgui::SetNextWindowPos(ImVec2(input_rect.Min.x, input_rect.Max.y));
+    imgui::SetNextWindowSize(ImVec2(input_rect.GetWidth(), 0)); // 0 auto fits the height
+
+    ImGuiWindowFlags window_flags =
+        ImGuiWindowFlags_NoTitleBar|
+        ImGuiWindowFlags_NoMove|
+        ImGuiWindowFlags_NoResize|
+        ImGuiWindowFlags_NoSavedSettings|
+        ImGuiWindowFlags_NoFocusOnAppearing|
+        ImGuiWindowFlags_NoNav
+    ;
+    auto window_label = make_str_static<64>("## directory_jump expl_%d", expl.id);
+
+    if (imgui::Begin(window_label.data(), nullptr, window_flags)) {
+        imgui::BringWindowToDisplayFront(imgui::GetCurrentWindow());
+
+        for (u64 i = 0; i < s_matches.size(); ++i) {
+            {
+                imgui::ScopedTextColor tc(directory_color());
+                imgui::TextUnformatted(get_icon(basic_dirent::kind::directory));
+            }
+            imgui::SameLine();
+
+            auto label = make_str_static<1200>("%s ## directory_jump_%zu", s_matches[i].data(), i);
+            if (imgui::Selectable(label.data(), i == s_highlight_idx)) {
+                jump_idx = i;
+            }
+        }
+
+        imgui::TextDisabled("[Enter] to jump, %zu directories ranked in %.0f us", jump_index.entries.size(), s_query_us);
+
+        s_hovered_expl_id = imgui::IsWindowHovered() ? expl.id : -1;
+    }
+    imgui::End();
+
+    if (!jump_idx.has_value()) {
+        return false;
+    }
+
+    swan_path typed_cwd = expl.cwd;
+    swan_path target = s_matches[jump_idx.value()];
+    path_force_separator(target, dir_sep_utf8);
+
+    s_hovered_expl_id = -1;
+    s_query_expl_id = -1;
+
+    expl.cwd = target;
+    auto [target_exists, _] = expl.update_cwd_entries(query_filesystem_cached, expl.cwd.data());
+
+    if (!target_exists) {
+        expl.cwd = typed_cwd;
+        (void) expl.update_cwd_entries(query_filesystem, expl.cwd.data());
+
+        if (jump_index.forget(std::string_view(target.data(), path_length(target)))) {
+            global_state::mark_dirty(persisted_file::directory_jump);
+        }
+        std::string action = make_str("Jump to [%s].", target.data());
+        swan_popup_modals::open_error(action.c_str(), "Directory not found, it was forgotten.");
+        return false;
+    }
+
+    expl.advance_history(expl.cwd);
+    expl.set_latest_valid_cwd(expl.cwd); // this may mutate filter
+    (void) expl.update_cwd_entries(filter, expl.cwd.data());
+    global_state::mark_dirty(expl);
+    imgui::ClearActiveID();
+
+    return true;
+}
+
 struct render_cwd_text_input_result
 {
     bool is_hovered;
@@ -2781,6 +3068,8 @@ render_cwd_text_input_result render_cwd_text_input(explorer_window &expl,
     };
 
     ImGuiInputTextState *input_text_state = nullptr;
+    ImRect input_rect = {};
+    bool input_active = false;
     {
         ImVec4 low_warning = warning_color(); low_warning.w /= 1.5;
         imgui::ScopedColor b(ImGuiCol_Border, low_warning, !path_is_empty(expl.cwd) && !cwd_exists_before_edit);
@@ -2794,6 +3083,8 @@ render_cwd_text_input_result render_cwd_text_input(explorer_window &expl,
             cwd_text_input_callback, (void *)&user_data);
 
         retval.is_hovered = imgui::IsItemHovered();
+        input_rect = imgui::GetItemRect();
+        input_active = imgui::IsItemActive();
 
         ImGuiID id = imgui::GetCurrentWindow()->GetID(label.data());
 
@@ -2825,7 +3116,12 @@ render_cwd_text_input_result render_cwd_text_input(explorer_window &expl,
             }
         }
 
-        (void) expl.save_to_disk();
+        global_state::mark_dirty(expl);
+    }
+
+    if (!cwd_exists_after_edit && render_directory_jump_box(expl, input_rect, input_active, is_input_text_enter_pressed, dir_sep_utf8)) {
+        cwd_exists_after_edit = true;
+        retval.edit_occurred = true;
     }
 
 #if 0
@@ -2844,6 +3140,7 @@ render_cwd_text_input_result render_cwd_text_input(explorer_window &expl,
 
 bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_window &finder, bool any_popups_open) noexcept
 {
+    SWAN_PROFILE_FUNCTION();
 #if 0
     // Get the current window's dock node
     ImGuiWindow* window = ImGui::FindWindowByName(expl.name);
@@ -2918,7 +3215,30 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
 
         bool window_focused_or_hovered = window_focused || window_hovered;
 
-        if (window_focused_or_hovered && imgui::IsKeyPressed(ImGuiKey_Delete)) {
+        if (window_focused_or_hovered && imgui::IsKeyPressed(ImGuiKey_Delete) && io.KeyShift) {
+            u64 num_entries_selected = std::count_if(expl.cwd_entries.begin(), expl.cwd_entries.end(),
+                                                     [](explorer_window::dirent const &e) noexcept { return e.selected; });
+
+            if (num_entries_selected > 0) {
+                imgui::OpenConfirmationModalWithCallback(
+                    /* confirmation_id  = */ swan_id_confirm_explorer_execute_permanent_delete,
+                    /* confirmation_msg = */ make_str("Are you sure you want to PERMANENTLY delete %zu file%s? This action cannot be undone.",
+                                                      num_entries_selected, pluralized(num_entries_selected, "", "s")).c_str(),
+                    /* on_yes_callback  = */
+                    [&]() noexcept {
+                        auto result = delete_selected_entries(expl, global_state::settings(), true);
+
+                        if (!result.success) {
+                            char const *action = "Permanently delete items.";
+                            char const *failed = result.error_or_utf8_path.c_str();
+                            swan_popup_modals::open_error(action, failed);
+                        }
+                    },
+                    /* confirmation_enabled = */ nullptr // always confirm, there is no way back
+                );
+            }
+        }
+        else if (window_focused_or_hovered && imgui::IsKeyPressed(ImGuiKey_Delete)) {
             u64 num_entries_selected = std::count_if(expl.cwd_entries.begin(), expl.cwd_entries.end(),
                                                      [](explorer_window::dirent const &e) noexcept { return e.selected; });
 
@@ -2936,7 +3256,7 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
                             char const *failed = result.error_or_utf8_path.c_str();
                             swan_popup_modals::open_error(action, failed);
                         }
-                        (void) global_state::settings().save_to_disk();
+                        global_state::mark_dirty(persisted_file::settings);
                     },
                     /* confirmation_enabled = */ &(global_state::settings().confirm_explorer_delete_via_keybind)
                 );
@@ -3004,7 +3324,7 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
                 finder.focus_search_value_input = true;
 
                 global_state::settings().show.finder = true;
-                (void) global_state::settings().save_to_disk();
+                global_state::mark_dirty(persisted_file::settings);
 
                 imgui::SetWindowFocus(swan_windows::get_name(swan_windows::id::finder));
             }
@@ -3053,13 +3373,13 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
                 swan_popup_modals::open_error(action.c_str(), failed.c_str());
             }
             else {
-                auto [pin_is_valid_dir, _] = expl.update_cwd_entries(query_filesystem, open_target_->path.data());
+                auto [pin_is_valid_dir, _] = expl.update_cwd_entries(query_filesystem_cached, open_target_->path.data());
                 if (pin_is_valid_dir) {
                     expl.cwd = open_target_->path;
                     expl.advance_history(open_target_->path);
                     expl.set_latest_valid_cwd(open_target_->path); // this may mutate filter
                     (void) expl.update_cwd_entries(filter, open_target_->path.data());
-                    (void) expl.save_to_disk();
+                    global_state::mark_dirty(expl);
                 } else {
                     (void) expl.update_cwd_entries(full_refresh, expl.cwd.data());
                 }
@@ -3079,6 +3399,15 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
             refresh(expl.update_request_from_outside);
             expl.update_request_from_outside = nil;
         }
+        else if (u64 stale_key = expl.stale_cached_listing_key.exchange(0); stale_key != 0 && stale_key == path_loose_hash(expl.cwd.data())) {
+            // painted from directory_listing_cache but the directory had changed, regardless of refresh mode since the user never saw it fresh
+            refresh(full_refresh);
+        }
+        else if (u64 resolved_key = expl.resolved_shortcuts_key.exchange(0); resolved_key != 0 && resolved_key == path_loose_hash(expl.cwd.data())) {
+            if (apply_known_shortcut_kinds(expl, expl.cwd, false) > 0) {
+                (void) expl.update_cwd_entries(filter, expl.cwd.data()); // kinds changed, so may visibility and order
+            }
+        }
         else if (global_state::settings().explorer_refresh_mode != swan_settings::explorer_refresh_mode_manual && cwd_exists_before_edit) {
             auto issue_read_dir_changes = [&]() noexcept {
                 wchar_t cwd_utf16[MAX_PATH];
@@ -3098,6 +3427,21 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
                     FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
                     NULL);
 
+                if (expl.read_dir_changes_overlapped.hEvent == NULL) {
+                    // auto-reset event signalled when a change arrives, the wait wakes an idle render loop so the change is noticed promptly.
+                    // Never unregistered, explorers live as long as the process.
+                    expl.read_dir_changes_overlapped.hEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+                    HANDLE wait_handle = NULL;
+
+                    if (expl.read_dir_changes_overlapped.hEvent == NULL ||
+                        !RegisterWaitForSingleObject(&wait_handle, expl.read_dir_changes_overlapped.hEvent,
+                                                     [](void *, BOOLEAN) { global_state::wake_render_loop(); },
+                                                     nullptr, INFINITE, WT_EXECUTEINWAITTHREAD))
+                    {
+                        print_debug_msg("[ %d ] FAILED to wait for directory change event: %s", expl.id, get_last_winapi_error().formatted_message.c_str());
+                    }
+                }
+
                 if (expl.read_dir_changes_handle == INVALID_HANDLE_VALUE) {
                     print_debug_msg("[ %d ] CreateFileW FAILED: INVALID_HANDLE_VALUE", expl.id);
                 } else {
@@ -3146,6 +3490,9 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
                     // ReadDirectoryChangesW in flight but not yet signalled, thus no changes and no refresh needed
                     // print_debug_msg("[ %d ] GetOverlappedResult FAILED: %d %s", expl.id, GetLastError(), get_last_error_string().c_str());
                 } else {
+                    // ReadDirectoryChangesW doesn't watch the subtree, so totals below the cwd still hold
+                    directory_sizes_invalidate(expl.read_dir_changes_target.data());
+
                     if (global_state::settings().explorer_refresh_mode == swan_settings::explorer_refresh_mode_automatic) {
                         issue_read_dir_changes();
                         if (expl.read_dir_changes_refresh_request_time == time_point_precise_t()) {
@@ -3171,6 +3518,15 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
     }
     // refresh logic end
 
+    if (cwd_exists_before_edit && imgui::GetFrameCount() > expl.frame_count_when_cwd_entries_updated) {
+        // the cwd listing has been shown, now is the time to guess where the user goes next
+        u64 cwd_key = path_loose_hash(expl.cwd.data());
+        if (cwd_key != expl.prefetched_for_cwd_key) {
+            expl.prefetched_for_cwd_key = cwd_key;
+            prefetch_likely_next_directories(expl);
+        }
+    }
+
     auto do_counting = [](explorer_window const &expl) noexcept -> cwd_count_info {
         // print_debug_msg("[ %d ] do_counting [%s]", expl.id, expl.cwd.data());
 
@@ -3299,10 +3655,11 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
             imgui::ScopedDisable d(global_state::file_op_cmd_buf().items.empty() || path_is_empty(expl.cwd) || !cwd_exists_after_edit);
             imgui::ScopedItemFlag no_nav(ImGuiItemFlags_NoNav, true);
             if (imgui::Button(ICON_LC_CLIPBOARD_PASTE)) {
-                auto result = global_state::file_op_cmd_buf().execute(expl);
+                bool verify = global_state::settings().file_operations_verify_copies || imgui::GetIO().KeyShift;
+                auto result = global_state::file_op_cmd_buf().execute(expl, verify);
                 // TODO: why is result unused?
             }
-            if (imgui::IsItemHovered({}, 1)) imgui::SetTooltip("Paste");
+            if (imgui::IsItemHovered({}, 1)) imgui::SetTooltip("Paste\nHold Shift to verify copies");
         }
         imgui::SameLineSpaced(1);
         render_help_icon(expl);
@@ -3408,6 +3765,7 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
                 0.05f, // cwd_entries_table_col_size_bytes
                 0.075f, // cwd_entries_table_col_creation_time
                 0.075f, // cwd_entries_table_col_last_write_time
+                0.05f, // cwd_entries_table_col_size_on_disk
             };
             f32 fixed_widths_sum = std::accumulate(widths, widths + lengthof(widths), 0.f);
             widths[explorer_window::cwd_entries_table_col_path] = 1.0f - fixed_widths_sum;
@@ -3424,6 +3782,7 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
             imgui::TableSetupColumn("Bytes", col_flags_sortable_prefer_desc|ImGuiTableColumnFlags_WidthStretch, widths[explorer_window::cwd_entries_table_col_size_bytes], explorer_window::cwd_entries_table_col_size_bytes);
             imgui::TableSetupColumn("Created", col_flags_sortable_prefer_asc|ImGuiTableColumnFlags_WidthStretch, widths[explorer_window::cwd_entries_table_col_creation_time], explorer_window::cwd_entries_table_col_creation_time);
             imgui::TableSetupColumn("Modified", col_flags_sortable_prefer_asc|ImGuiTableColumnFlags_WidthStretch, widths[explorer_window::cwd_entries_table_col_last_write_time], explorer_window::cwd_entries_table_col_last_write_time);
+            imgui::TableSetupColumn("On disk", col_flags_sortable_prefer_desc|ImGuiTableColumnFlags_WidthStretch|ImGuiTableColumnFlags_DefaultHide, widths[explorer_window::cwd_entries_table_col_size_on_disk], explorer_window::cwd_entries_table_col_size_on_disk);
             ImGui::TableSetupScrollFreeze(0, 1);
             imgui::TableHeadersRow();
 
@@ -3448,6 +3807,9 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
                     [](explorer_window::dirent const &ent) noexcept { return ent.filtered; });
             }
 
+            // directory sizes are walked only while someone looks at them
+            update_directory_sizes(expl, imgui::TableGetColumnFlags(explorer_window::cwd_entries_table_col_size_on_disk) & ImGuiTableColumnFlags_IsEnabled);
+
             // opens "Context" popup if a rendered dirent is right clicked
             auto [context_menu_target_row_rect, descend_target_, do_ascend_] = render_table_rows_for_cwd_entries(expl, cnt, size_unit_multiplier, any_popups_open, dir_sep_utf8, dir_sep_utf16);
 
@@ -3577,7 +3939,7 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
             handle_file_op_failure("copy", result);
         }
         else if (imgui::IsKeyPressed(ImGuiKey_V) && io.KeyCtrl && window_hovered && !global_state::file_op_cmd_buf().items.empty()) {
-            global_state::file_op_cmd_buf().execute(expl);
+            global_state::file_op_cmd_buf().execute(expl, global_state::settings().file_operations_verify_copies || io.KeyShift);
         }
         else if (imgui::IsKeyPressed(ImGuiKey_I) && io.KeyCtrl) {
             expl.invert_selection_on_visible_cwd_entries();
@@ -3632,11 +3994,11 @@ bool swan_windows::render_explorer(explorer_window &expl, bool &open, finder_win
         bool history_item_clicked = render_history_browser_popup(expl, cwd_exists_after_edit);
 
         if (history_item_clicked) {
-            auto [history_item_exists, _] = expl.update_cwd_entries(query_filesystem, expl.cwd.data());
+            auto [history_item_exists, _] = expl.update_cwd_entries(query_filesystem_cached, expl.cwd.data());
             if (history_item_exists) {
                 expl.set_latest_valid_cwd(expl.cwd); // this may mutate filter
                 (void) expl.update_cwd_entries(filter, expl.cwd.data());
-                (void) expl.save_to_disk();
+                global_state::mark_dirty(expl);
             } else {
                 std::string action = make_str("Navigate to history item [%s]", expl.cwd.data());
                 char const *failed = "Path not found, maybe it was renamed or deleted?";
@@ -3724,7 +4086,7 @@ void file_operation_command_buf::clear() noexcept
     }
 }
 
-generic_result file_operation_command_buf::execute(explorer_window &expl) noexcept
+generic_result file_operation_command_buf::execute(explorer_window &expl, bool verify_copies) noexcept
 {
     wchar_t cwd_utf16[2048]; cstr_clear(cwd_utf16);
 
@@ -3772,7 +4134,8 @@ generic_result file_operation_command_buf::execute(explorer_window &expl) noexce
         &initialization_done,
         &initialization_error,
         global_state::settings().dir_separator_utf8,
-        global_state::settings().num_max_file_operations);
+        global_state::settings().num_max_file_operations,
+        verify_copies);
 
     {
         std::unique_lock lock(expl.shlwapi_task_initialization_mutex);
@@ -3909,7 +4272,11 @@ render_table_rows_for_cwd_entries_result render_table_rows_for_cwd_entries(
                                     auto res = open_symlink(dirent, expl);
 
                                     if (res.success) {
-                                        if (dirent.basic.is_symlink_to_directory()) {
+                                        // an ambiguous one hasn't been resolved yet, open_symlink looked at the target regardless
+                                        bool target_is_directory = dirent.basic.is_symlink_to_directory() ||
+                                                                   (dirent.basic.is_symlink_ambiguous() && directory_exists(res.error_or_utf8_path.c_str()));
+
+                                        if (target_is_directory) {
                                             char const *target_dir_path = res.error_or_utf8_path.c_str();
 
                                             expl.cwd = path_create(target_dir_path);
@@ -3918,12 +4285,12 @@ render_table_rows_for_cwd_entries_result render_table_rows_for_cwd_entries(
                                             expl.set_latest_valid_cwd(expl.cwd); // this may mutate filter
                                             expl.advance_history(expl.cwd);
                                             (void) expl.update_cwd_entries(full_refresh, expl.cwd.data());
-                                            (void) expl.save_to_disk();
+                                            global_state::mark_dirty(expl);
                                         }
-                                        else if (dirent.basic.is_symlink_to_file()) {
+                                        else {
                                             char const *full_file_path = res.error_or_utf8_path.c_str();
                                             global_state::recent_files_update("Opened", full_file_path);
-                                            (void) global_state::recent_files_save_to_disk(nullptr);
+                                            global_state::mark_dirty(persisted_file::recent_files_latest);
                                         }
                                     } else {
                                         std::string action = make_str("Open symlink [%s].", dirent.basic.path.data());
@@ -3940,7 +4307,7 @@ render_table_rows_for_cwd_entries_result render_table_rows_for_cwd_entries(
                                     if (res.success) {
                                         char const *full_file_path = res.error_or_utf8_path.c_str();
                                         global_state::recent_files_update("Opened", full_file_path);
-                                        (void) global_state::recent_files_save_to_disk(nullptr);
+                                        global_state::mark_dirty(persisted_file::recent_files_latest);
                                     } else {
                                         std::string action = make_str("Open file [%s].", dirent.basic.path.data());
                                         char const *failed = res.error_or_utf8_path.c_str();
@@ -3961,6 +4328,10 @@ render_table_rows_for_cwd_entries_result render_table_rows_for_cwd_entries(
 
                     selectable_rect = imgui::GetItemRect();
 
+                    if (dirent.basic.is_directory() && !dirent.basic.is_path_dotdot() && imgui::IsItemHovered({}, .15f)) {
+                        prefetch_hovered_directory(expl, dirent);
+                    }
+
                     if (expl.tabbing_set_focus && expl.tabbing_focus_idx == s64(i) && !imgui::IsItemFocused()) {
                         expl.tabbing_set_focus = false;
                         imgui::FocusItem();
@@ -4216,13 +4587,27 @@ render_table_rows_for_cwd_entries_result render_table_rows_for_cwd_entries(
                 }
             }
 
+            if (imgui::TableSetColumnIndex(explorer_window::cwd_entries_table_col_size_on_disk)) {
+                if (expl.size_job != nullptr && !dirent.basic.is_path_dotdot() && (dirent.basic.is_directory() || dirent.basic.is_file())) {
+                    auto formatted_size = format_file_size(dirent_size_on_disk(expl, dirent), size_unit_multiplier);
+                    bool in_progress = dirent.basic.is_directory() && dirent.size_job_slot < expl.size_job->done.size() && !expl.size_job->done[dirent.size_job_slot].load();
+
+                    if (in_progress) {
+                        imgui::TextDisabled("%s", formatted_size.data()); // a partial total, still growing
+                    } else {
+                        imgui::TextUnformatted(formatted_size.data());
+                    }
+                    imgui::RenderTooltipWhenColumnTextTruncated(explorer_window::cwd_entries_table_col_size_on_disk, formatted_size.data());
+                }
+            }
+
             if (imgui::TableSetColumnIndex(explorer_window::cwd_entries_table_col_creation_time)) {
             #if CACHE_FORMATTED_STRING_COLUMNS
                 if (cstr_empty(dirent.creation_time.data())) {
                     f64 func_us = 0;
                     SCOPE_EXIT { expl.filetime_to_string_culmulative_us += func_us; };
                     scoped_timer<timer_unit::MICROSECONDS> timer(&func_us);
-                    dirent.creation_time = filetime_to_string(&dirent.basic.creation_time_raw).second;
+                    dirent.creation_time = filetime_to_string(dirent.basic.creation_time_raw).second;
                 }
                 imgui::TextUnformatted(dirent.creation_time.data());
                 imgui::RenderTooltipWhenColumnTextTruncated(explorer_window::cwd_entries_table_col_creation_time, dirent.creation_time.data());
@@ -4232,7 +4617,7 @@ render_table_rows_for_cwd_entries_result render_table_rows_for_cwd_entries(
                     f64 func_us = 0;
                     SCOPE_EXIT { expl.filetime_to_string_culmulative_us += func_us; };
                     scoped_timer<timer_unit::MICROSECONDS> timer(&func_us);
-                    result = filetime_to_string(&dirent.basic.creation_time_raw);
+                    result = filetime_to_string(dirent.basic.creation_time_raw);
                 }
                 imgui::TextUnformatted(result.second.data());
                 imgui::RenderTooltipWhenColumnTextTruncated(explorer_window::cwd_entries_table_col_creation_time, result.second.data());
@@ -4245,7 +4630,7 @@ render_table_rows_for_cwd_entries_result render_table_rows_for_cwd_entries(
                     f64 func_us = 0;
                     SCOPE_EXIT { expl.filetime_to_string_culmulative_us += func_us; };
                     scoped_timer<timer_unit::MICROSECONDS> timer(&func_us);
-                    dirent.last_write_time = filetime_to_string(&dirent.basic.last_write_time_raw).second;
+                    dirent.last_write_time = filetime_to_string(dirent.basic.last_write_time_raw).second;
                 }
                 imgui::TextUnformatted(dirent.last_write_time.data());
                 imgui::RenderTooltipWhenColumnTextTruncated(explorer_window::cwd_entries_table_col_last_write_time, dirent.last_write_time.data());
@@ -4255,7 +4640,7 @@ render_table_rows_for_cwd_entries_result render_table_rows_for_cwd_entries(
                     f64 func_us = 0;
                     SCOPE_EXIT { expl.filetime_to_string_culmulative_us += func_us; };
                     scoped_timer<timer_unit::MICROSECONDS> timer(&func_us);
-                    result = filetime_to_string(&dirent.basic.last_write_time_raw);
+                    result = filetime_to_string(dirent.basic.last_write_time_raw);
                 }
                 imgui::TextUnformatted(result.second.data());
                 imgui::RenderTooltipWhenColumnTextTruncated(explorer_window::cwd_entries_table_col_last_write_time, result.second.data());
@@ -4293,7 +4678,7 @@ render_dirent_context_menu(explorer_window &expl, cwd_count_info const &cnt, swa
                 if (res.success) {
                     char const *full_file_path = res.error_or_utf8_path.c_str();
                     global_state::recent_files_update("Opened", full_file_path);
-                    (void) global_state::recent_files_save_to_disk(nullptr);
+                    global_state::mark_dirty(persisted_file::recent_files_latest);
                 } else {
                     std::string action = make_str("Open file as administrator [%s].", expl.context_menu_target->basic.path.data());
                     char const *failed = res.error_or_utf8_path.c_str();
@@ -4324,7 +4709,7 @@ render_dirent_context_menu(explorer_window &expl, cwd_count_info const &cnt, swa
 
                     expl.advance_history(expl.cwd);
                     (void) expl.update_cwd_entries(full_refresh, expl.cwd.data());
-                    (void) expl.save_to_disk();
+                    global_state::mark_dirty(expl);
 
                     expl.scroll_to_nth_selected_entry_next_frame = 0;
                 }
@@ -4460,11 +4845,31 @@ render_dirent_context_menu(explorer_window &expl, cwd_count_info const &cnt, swa
                             char const *failed = result.error_or_utf8_path.c_str();
                             swan_popup_modals::open_error(action.c_str(), failed);
                         }
-                        (void) global_state::settings().save_to_disk();
+                        global_state::mark_dirty(persisted_file::settings);
                     },
                     /* confirmation_enabled = */ &(global_state::settings().confirm_explorer_delete_via_context_menu)
                 );
             }
+            if (imgui::Selectable("Delete permanently" "## single")) {
+                expl.deselect_all_cwd_entries();
+                expl.context_menu_target->selected = true;
+
+                imgui::OpenConfirmationModalWithCallback(
+                    /* confirmation_id  = */ swan_id_confirm_explorer_execute_permanent_delete,
+                    /* confirmation_msg = */ "Are you sure you want to PERMANENTLY delete this file? This action cannot be undone.",
+                    /* on_yes_callback  = */
+                    [&]() noexcept {
+                        auto result = delete_selected_entries(expl, global_state::settings(), true);
+
+                        if (!result.success) {
+                            char const *action = "Permanently delete item.";
+                            char const *failed = result.error_or_utf8_path.c_str();
+                            swan_popup_modals::open_error(action, failed);
+                        }
+                    },
+                    /* confirmation_enabled = */ nullptr // always confirm, there is no way back
+                );
+            }
             if (imgui::Selectable("Rename" "## single")) {
                 retval.open_single_rename_popup = true;
                 retval.single_dirent_to_be_renamed = expl.context_menu_target;
@@ -4472,9 +4877,22 @@ render_dirent_context_menu(explorer_window &expl, cwd_count_info const &cnt, swa
 
             imgui::Separator();
 
-            if (!global_state::file_op_cmd_buf().items.empty() && !path_is_empty(expl.cwd) && imgui::Selectable("Paste")) {
-                auto result = global_state::file_op_cmd_buf().execute(expl);
-                // TODO: why is result unused?
+            {
+                std::optional<bool> paste_verify = std::nullopt;
+
+                if (!global_state::file_op_cmd_buf().items.empty() && !path_is_empty(expl.cwd) && imgui::Selectable("Paste")) {
+                    paste_verify = settings.file_operations_verify_copies;
+                }
+                if (!global_state::file_op_cmd_buf().items.empty() && !path_is_empty(expl.cwd) && imgui::Selectable("Paste and verify")) {
+                    paste_verify = true;
+                }
+                if (paste_verify.has_value()) {
+                    auto result = global_state::file_op_cmd_buf().execute(expl, paste_verify.value());
+                    if (!result.success) {
+                        std::string action = make_str("Paste into [%s].", expl.cwd.data());
+                        swan_popup_modals::open_error(action.c_str(), result.error_or_utf8_path.c_str());
+                    }
+                }
             }
 
 
@@ -4546,6 +4964,21 @@ render_dirent_context_menu(explorer_window &expl, cwd_count_info const &cnt, swa
                 auto result = delete_selected_entries(expl, global_state::settings());
                 handle_failure("Delete", result);
             }
+            if (imgui::Selectable("Delete permanently" "## multi")) {
+                imgui::OpenConfirmationModalWithCallback(
+                    /* confirmation_id  = */ swan_id_confirm_explorer_execute_permanent_delete,
+                    /* confirmation_msg = */ make_str("Are you sure you want to PERMANENTLY delete %zu items? This action cannot be undone.", cnt.selected_dirents).c_str(),
+                    /* on_yes_callback  = */
+                    [&expl]() noexcept {
+                        auto result = delete_selected_entries(expl, global_state::settings(), true);
+
+                        if (!result.success) {
+                            swan_popup_modals::open_error("Permanently delete items.", result.error_or_utf8_path.c_str());
+                        }
+                    },
+                    /* confirmation_enabled = */ nullptr // always confirm, there is no way back
+                );
+            }
             if (imgui::Selectable("Bulk Rename")) {
                 retval.open_bulk_rename_popup = true;
             }
@@ -4711,10 +5144,10 @@ bool find_in_swan_explorer_0(char const *full_path) noexcept
     else {
         expl.cwd = expl.latest_valid_cwd = containing_dir_utf8;
         expl.advance_history(expl.cwd);
-        (void) expl.save_to_disk();
+        global_state::mark_dirty(expl);
 
         global_state::settings().show.explorer_0 = true;
-        (void) global_state::settings().save_to_disk();
+        global_state::mark_dirty(persisted_file::settings);
 
         expl.scroll_to_nth_selected_entry_next_frame = 0;
         imgui::SetWindowFocus(expl.name);
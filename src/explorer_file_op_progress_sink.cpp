@@ -99,18 +99,21 @@ HRESULT explorer_file_op_progress_sink::PostMoveItem(
     path_force_separator(dst_path_utf8, this->dir_sep_utf8);
 
     {
-        auto completed_file_operations = global_state::completed_file_operations_get();
+        // build the record before taking the lock, so the critical section is only the push (and trim of the oldest records)
+        completed_file_operation record(get_time_system(), time_point_system_t(), file_operation_type::move,
+                                        src_path_utf8.data(), dst_path_utf8.data(), derive_obj_type(attributes), this->group_id);
 
-        basic_dirent::kind obj_type = derive_obj_type(attributes);
-        auto completion_time = get_time_system();
+        auto completed_file_operations = global_state::completed_file_operations_get();
 
         std::scoped_lock lock(*completed_file_operations.mutex);
+        push_front(completed_file_operations, record, u64(this->num_max_file_operations));
+    }
 
-        while (completed_file_operations.container->size() >= this->num_max_file_operations && !completed_file_operations.container->empty())
-            pop_back(completed_file_operations);
-
-        completed_file_operations.container->emplace_front(completion_time, time_point_system_t(), file_operation_type::move,
-                                                           src_path_utf8.data(), dst_path_utf8.data(), obj_type, this->group_id);
+    if (attributes & SFGAO_FOLDER) {
+        std::scoped_lock lock(this->recent_files_directory_changes_mutex);
+        this->recent_files_directory_changes.push_back({ src_path_utf8.data(), dst_path_utf8.data(), "", false });
+    } else {
+        this->num_recent_files_changed += global_state::recent_files_path_changed(src_path_utf8.data(), dst_path_utf8.data(), false, nullptr);
     }
 
     return S_OK;
@@ -227,20 +230,7 @@ HRESULT explorer_file_op_progress_sink::PostDeleteItem(DWORD, IShellItem *item,
         }
     }
 
-    {
-        auto completed_file_operations = global_state::completed_file_operations_get();
-
-        basic_dirent::kind obj_type = derive_obj_type(attributes);
-        auto completion_time = get_time_system();
-
-        std::scoped_lock lock(*completed_file_operations.mutex);
-
-        while (completed_file_operations.container->size() >= this->num_max_file_operations && !completed_file_operations.container->empty())
-            pop_back(completed_file_operations);
-
-        completed_file_operations.container->emplace_front(completion_time, time_point_system_t(), file_operation_type::del,
-            deleted_item_path_utf8.data(), recycle_bin_item_path_utf8.data(), obj_type, this->group_id);
-    }
+    this->push_completed_delete(deleted_item_path_utf8.data(), recycle_bin_item_path_utf8.data(), derive_obj_type(attributes));
 
     print_debug_msg("src=[%s] dst=[%s]", deleted_item_path_utf8.data(), recycle_bin_item_path_utf8.data());
 
@@ -251,7 +241,7 @@ HRESULT explorer_file_op_progress_sink::PostCopyItem(
     DWORD,
     IShellItem *src_item,
     IShellItem *,
-    LPCWSTR new_name_utf16,
+    LPCWSTR,
     HRESULT result,
     IShellItem *dst_item) noexcept
 {
@@ -260,6 +250,12 @@ HRESULT explorer_file_op_progress_sink::PostCopyItem(
         return S_OK;
     }
 
+    if (dst_item == nullptr) {
+        // item was locked or skipped, I think... let's leave this assert here to monitor this assumption
+        assert(result == 0x00270005);
+        return S_OK;
+    }
+
     SFGAOF attributes = {};
     if (FAILED(src_item->GetAttributes(SFGAO_FOLDER|SFGAO_LINK, &attributes))) {
         print_debug_msg("FAILED IShellItem::GetAttributes(SFGAO_FOLDER|SFGAO_LINK)");
@@ -267,7 +263,6 @@ HRESULT explorer_file_op_progress_sink::PostCopyItem(
     }
 
     wchar_t *src_path_utf16 = nullptr;
-    swan_path src_path_utf8;
 
     if (FAILED(src_item->GetDisplayName(SIGDN_FILESYSPATH, &src_path_utf16))) {
         print_debug_msg("FAILED(item->GetDisplayName(SIGDN_FILESYSPATH, src_path_utf16)");
@@ -275,41 +270,44 @@ HRESULT explorer_file_op_progress_sink::PostCopyItem(
     }
     SCOPE_EXIT { CoTaskMemFree(src_path_utf16); };
 
-    if (!utf16_to_utf8(src_path_utf16, src_path_utf8.data(), src_path_utf8.max_size())) {
-        return S_OK;
-    }
-
     wchar_t *dst_path_utf16 = nullptr;
-    bool dst_path_utf16_needs_free = false;
-    swan_path dst_path_utf8 = path_create("");
-
-    if (dst_item != nullptr) {
-        if (FAILED(dst_item->GetDisplayName(SIGDN_FILESYSPATH, &dst_path_utf16))) {
-            print_debug_msg("FAILED(item->GetDisplayName(SIGDN_FILESYSPATH, dst_path_utf16)");
-            return S_OK;
-        }
-        dst_path_utf16_needs_free = true;
 
-        if (!utf16_to_utf8(dst_path_utf16, dst_path_utf8.data(), dst_path_utf8.max_size())) {
-            return S_OK;
-        }
+    if (FAILED(dst_item->GetDisplayName(SIGDN_FILESYSPATH, &dst_path_utf16))) {
+        print_debug_msg("FAILED(item->GetDisplayName(SIGDN_FILESYSPATH, dst_path_utf16)");
+        return S_OK;
     }
-    SCOPE_EXIT { if (dst_path_utf16_needs_free) CoTaskMemFree(dst_path_utf16); };
+    SCOPE_EXIT { CoTaskMemFree(dst_path_utf16); };
 
-    print_debug_msg("src=[%s] dst=[%s]", src_path_utf8.data(), dst_path_utf8.data());
+    this->push_completed_copy(src_path_utf16, dst_path_utf16, derive_obj_type(attributes),
+                              (attributes & SFGAO_FOLDER) ? file_copy_strategy::none : file_copy_strategy::full);
 
-    if (path_is_empty(dst_path_utf8)) {
-        // item was locked or skipped, I think... let's leave this assert here to monitor this assumption
-        assert(result == 0x00270005);
-        return S_OK;
-    }
+    return S_OK;
+}
 
+/// Records a completed copy, and queues its verification if requested. Also called directly by `perform_file_operations`
+/// for files it copied itself (block clones and sparse copies).
+void explorer_file_op_progress_sink::push_completed_copy(
+    wchar_t const *src_path_utf16,
+    wchar_t const *dst_path_utf16,
+    basic_dirent::kind obj_type,
+    file_copy_strategy strategy) noexcept
+{
+    swan_path src_path_utf8;
+    swan_path dst_path_utf8;
     swan_path new_name_utf8;
 
-    if (!utf16_to_utf8(new_name_utf16, new_name_utf8.data(), new_name_utf8.size())) {
-        return S_OK;
+    if (!utf16_to_utf8(src_path_utf16, src_path_utf8.data(), src_path_utf8.max_size())) {
+        return;
+    }
+    if (!utf16_to_utf8(dst_path_utf16, dst_path_utf8.data(), dst_path_utf8.max_size())) {
+        return;
+    }
+    if (!utf16_to_utf8(PathFindFileNameW(dst_path_utf16), new_name_utf8.data(), new_name_utf8.max_size())) {
+        return;
     }
 
+    print_debug_msg("src=[%s] dst=[%s] strategy=%c", src_path_utf8.data(), dst_path_utf8.data(), char(strategy));
+
     explorer_window &dst_expl = global_state::explorers()[this->dst_expl_id];
 
     bool dst_expl_cwd_same = path_loosely_same(dst_expl.cwd, this->dst_expl_cwd_when_operation_started);
@@ -324,48 +322,83 @@ HRESULT explorer_file_op_progress_sink::PostCopyItem(
     path_force_separator(dst_path_utf8, global_state::settings().dir_separator_utf8);
 
     {
-        auto completed_file_operations = global_state::completed_file_operations_get();
+        completed_file_operation record(get_time_system(), time_point_system_t(), file_operation_type::copy,
+                                        src_path_utf8.data(), dst_path_utf8.data(), obj_type, this->group_id);
 
-        basic_dirent::kind obj_type = derive_obj_type(attributes);
-        auto completion_time = get_time_system();
+        record.copy_strategy = strategy;
 
-        std::scoped_lock lock(*completed_file_operations.mutex);
+        bool verify = this->verify_copies && obj_type != basic_dirent::kind::directory;
+        if (verify) {
+            record.verification = file_operation_verification::pending;
+        }
 
-        while (completed_file_operations.container->size() >= this->num_max_file_operations && !completed_file_operations.container->empty())
-            pop_back(completed_file_operations);
+        {
+            auto completed_file_operations = global_state::completed_file_operations_get();
 
-        completed_file_operations.container->emplace_front(completion_time, time_point_system_t(), file_operation_type::copy,
-                                                           src_path_utf8.data(), dst_path_utf8.data(), obj_type, this->group_id);
-    }
+            std::scoped_lock lock(*completed_file_operations.mutex);
+            push_front(completed_file_operations, record, u64(this->num_max_file_operations));
+        }
 
-    return S_OK;
+        if (verify) {
+            // hash on the thread pool so IFileOperation can get on with copying the next item
+            this->num_verifications_outstanding->fetch_add(1);
+            global_state::thread_pool().push_task(verify_copied_file,
+                                                  std::wstring(src_path_utf16), std::wstring(dst_path_utf16),
+                                                  dst_path_utf8, this->group_id, this->num_verifications_outstanding);
+        }
+    }
 }
 
-HRESULT explorer_file_op_progress_sink::UpdateProgress(UINT work_total, UINT work_so_far) noexcept
+/// Records a completed delete. Also called directly by `perform_permanent_delete`, which passes an empty `recycle_bin_path_utf8`.
+void explorer_file_op_progress_sink::push_completed_delete(char const *deleted_path_utf8, char const *recycle_bin_path_utf8, basic_dirent::kind obj_type) noexcept
 {
-    print_debug_msg("%zu/%zu", work_so_far, work_total);
-    return S_OK;
+    completed_file_operation record(get_time_system(), time_point_system_t(), file_operation_type::del,
+                                    deleted_path_utf8, recycle_bin_path_utf8, obj_type, this->group_id);
+
+    auto completed_file_operations = global_state::completed_file_operations_get();
+
+    {
+        std::scoped_lock lock(*completed_file_operations.mutex);
+        push_front(completed_file_operations, record, u64(this->num_max_file_operations));
+    }
+
+    if (obj_type == basic_dirent::kind::directory) {
+        std::scoped_lock lock(this->recent_files_directory_changes_mutex);
+        this->recent_files_directory_changes.push_back({ deleted_path_utf8, "", recycle_bin_path_utf8, true });
+    } else {
+        this->num_recent_files_changed += global_state::recent_files_deleted(deleted_path_utf8, recycle_bin_path_utf8, false, nullptr);
+    }
 }
 
-HRESULT explorer_file_op_progress_sink::FinishOperations(HRESULT) noexcept
+HRESULT explorer_file_op_progress_sink::UpdateProgress(UINT work_total, UINT work_so_far) noexcept
 {
-    if (this->contains_delete_operations) {
-        auto recent_files = global_state::recent_files_get();
+    if (this->progress == nullptr) {
+        print_debug_msg("%zu/%zu", work_so_far, work_total);
+        return S_OK;
+    }
 
-        std::scoped_lock lock(*recent_files.mutex);
+    this->progress->work_total.store(work_total);
+    this->progress->work_so_far.store(work_so_far);
 
-        auto deleted_files_iter = std::stable_partition(recent_files.container->begin(), recent_files.container->end(), [](recent_file const &rf) noexcept {
-            wchar_t rf_path_utf16[MAX_PATH];
-            if (!utf8_to_utf16(rf.path.data(), rf_path_utf16, lengthof(rf_path_utf16))) return true;
-            return (bool) PathFileExistsW(rf_path_utf16);
-        });
+    global_state::wake_render_loop();
 
-        erase(recent_files, deleted_files_iter, recent_files.container->end());
+    return this->progress->cancellation_token.load() ? E_ABORT : S_OK;
+}
 
-        global_state::recent_files_save_to_disk(&lock);
+HRESULT explorer_file_op_progress_sink::FinishOperations(HRESULT) noexcept
+{
+    // files were updated as they were moved or deleted, directories are applied together in one pass over the recent files
+    {
+        std::scoped_lock lock(this->recent_files_directory_changes_mutex);
+        this->num_recent_files_changed += global_state::recent_files_directories_changed(this->recent_files_directory_changes, nullptr);
+        this->recent_files_directory_changes.clear();
+    }
+    if (this->num_recent_files_changed > 0) {
+        global_state::mark_dirty(persisted_file::recent_files);
     }
 
-    (void) global_state::completed_file_operations_save_to_disk(nullptr);
+    global_state::mark_dirty(persisted_file::completed_file_operations);
+    global_state::wake_render_loop();
 
     return S_OK;
 }
@@ -5,11 +5,14 @@
 
 static std::mutex g_completed_file_ops_mutex = {};
 static std::deque<completed_file_operation> g_completed_file_ops(1000);
+static completed_file_operation_group_index g_completed_file_ops_groups = {};
 static file_operation_command_buf g_file_op_payload = {};
+static file_operation_progress g_permanent_delete_progress = {};
+static file_operation_progress g_fast_copy_progress = {};
 
 global_state::completed_file_operations global_state::completed_file_operations_get() noexcept
 {
-    return { &g_completed_file_ops, &g_completed_file_ops_mutex };
+    return { &g_completed_file_ops, &g_completed_file_ops_mutex, &g_completed_file_ops_groups };
 }
 
 file_operation_command_buf &global_state::file_op_cmd_buf() noexcept
@@ -17,6 +20,16 @@ file_operation_command_buf &global_state::file_op_cmd_buf() noexcept
     return g_file_op_payload;
 }
 
+file_operation_progress &global_state::permanent_delete_progress() noexcept
+{
+    return g_permanent_delete_progress;
+}
+
+file_operation_progress &global_state::fast_copy_progress() noexcept
+{
+    return g_fast_copy_progress;
+}
+
 void erase(global_state::completed_file_operations &obj,
            std::deque<completed_file_operation>::iterator first,
            std::deque<completed_file_operation>::iterator last) noexcept
@@ -25,6 +38,7 @@ void erase(global_state::completed_file_operations &obj,
         if (iter->src_icon_GLtexID > 0) delete_icon_texture(iter->src_icon_GLtexID, "completed_file_operation");
         if (iter->dst_icon_GLtexID > 0) delete_icon_texture(iter->dst_icon_GLtexID, "completed_file_operation");
     }
+    obj.groups->on_erase(*obj.container, u64(first - obj.container->begin()), u64(last - obj.container->begin()));
     obj.container->erase(first, last);
 }
 
@@ -32,38 +46,171 @@ void pop_back(global_state::completed_file_operations &obj) noexcept
 {
     if (obj.container->back().src_icon_GLtexID > 0) delete_icon_texture(obj.container->back().src_icon_GLtexID, "completed_file_operation");
     if (obj.container->back().dst_icon_GLtexID > 0) delete_icon_texture(obj.container->back().dst_icon_GLtexID, "completed_file_operation");
+    obj.groups->on_pop_back(obj.container->back().group_id, obj.container->size());
     obj.container->pop_back();
 }
 
-u32 global_state::completed_file_operations_calc_next_group_id() noexcept
+void push_front(global_state::completed_file_operations &obj, completed_file_operation const &elem, u64 max_size) noexcept
 {
-    u32 max_group_id = 0;
-    u32 reserved_nil_value = std::numeric_limits<decltype(max_group_id)>::max();
+    while (obj.container->size() >= max_size && !obj.container->empty())
+        pop_back(obj);
+
+    obj.container->push_front(elem);
+    obj.groups->on_push_front(elem.group_id);
+}
+
+void clear(global_state::completed_file_operations &obj) noexcept
+{
+    obj.container->clear();
+    obj.groups->clear();
+}
 
-    std::scoped_lock lock(g_completed_file_ops_mutex);
+u32 global_state::completed_file_operations_next_group_id() noexcept
+{
+    return g_completed_file_ops_groups.acquire_group_id();
+}
+
+u32 completed_file_operation_group_index::acquire_group_id() noexcept
+{
+    u32 group_id = this->next_group_id.fetch_add(1);
 
-    for (auto const &file_op : g_completed_file_ops) {
-        if (file_op.group_id > max_group_id) {
-            max_group_id = file_op.group_id;
+    if (group_id == 0) {
+        group_id = this->next_group_id.fetch_add(1); // wrapped around, 0 is reserved
+    }
+
+    return group_id;
+}
+
+void completed_file_operation_group_index::clear() noexcept
+{
+    //! next_group_id is deliberately left alone, group ids are never reused within a session
+    this->spans.clear();
+    this->front_seq = 0;
+    this->num_records = 0;
+}
+
+void completed_file_operation_group_index::rebuild(std::deque<completed_file_operation> const &container) noexcept
+{
+    this->spans.clear();
+    this->front_seq = container.size();
+    this->num_records = container.size();
+
+    u32 max_group_id = 0;
+
+    for (u64 i = 0; i < container.size(); ++i) {
+        u32 group_id = container[i].group_id;
+        if (group_id == 0) {
+            continue;
         }
+        u64 seq = this->front_seq - i;
+
+        auto [iter, inserted] = this->spans.try_emplace(group_id, span{ seq, seq, 0 });
+        iter->second.oldest_seq = seq; // walking front to back, every visit is older than the last
+        ++iter->second.count;
+
+        max_group_id = std::max(max_group_id, group_id);
     }
 
-    if (max_group_id == reserved_nil_value) {
-        return 1; // wrap around
+    // never hand out a group_id which is still present in the history
+    u32 next = max_group_id == std::numeric_limits<u32>::max() ? 1 : max_group_id + 1;
+    u32 curr = this->next_group_id.load();
+    while (curr < next && !this->next_group_id.compare_exchange_weak(curr, next));
+}
+
+void completed_file_operation_group_index::on_push_front(u32 group_id) noexcept
+{
+    ++this->front_seq;
+    ++this->num_records;
+
+    if (group_id == 0) {
+        return;
+    }
+
+    auto [iter, inserted] = this->spans.try_emplace(group_id, span{ this->front_seq, this->front_seq, 0 });
+    iter->second.newest_seq = this->front_seq;
+    ++iter->second.count;
+}
+
+void completed_file_operation_group_index::on_pop_back(u32 group_id, u64 container_size_before_pop) noexcept
+{
+    assert(this->num_records == container_size_before_pop);
+    --this->num_records;
+
+    if (group_id == 0) {
+        return;
+    }
+
+    auto iter = this->spans.find(group_id);
+    if (iter == this->spans.end()) {
+        return;
+    }
+
+    if (--iter->second.count == 0) {
+        this->spans.erase(iter);
     } else {
-        return max_group_id + 1;
+        u64 popped_seq = this->front_seq - (container_size_before_pop - 1);
+        iter->second.oldest_seq = popped_seq + 1; // conservative when interleaved, remaining records are all newer
+    }
+}
+
+void completed_file_operation_group_index::on_erase(std::deque<completed_file_operation> const &container, u64 first_idx, u64 last_idx) noexcept
+{
+    assert(first_idx <= last_idx);
+    assert(last_idx <= container.size());
+
+    u64 num_erased = last_idx - first_idx;
+    if (num_erased == 0) {
+        return;
+    }
+
+    for (u64 i = first_idx; i < last_idx; ++i) {
+        u32 group_id = container[i].group_id;
+        if (group_id == 0) {
+            continue;
+        }
+        auto iter = this->spans.find(group_id);
+        if (iter != this->spans.end() && --iter->second.count == 0) {
+            this->spans.erase(iter);
+        }
+    }
+
+    // Records newer than the erased range shift towards the front of the deque, renumber them so that `front_seq - idx` still holds.
+    // Records older than the erased range keep their sequence numbers. Cost is proportional to the number of groups, not records.
+    u64 erased_newest_seq = this->front_seq - first_idx;
+    u64 erased_oldest_seq = this->front_seq - (last_idx - 1);
+
+    for (auto &[group_id, s] : this->spans) {
+        if (s.newest_seq > erased_newest_seq) s.newest_seq -= num_erased;
+        else if (s.newest_seq >= erased_oldest_seq) s.newest_seq = erased_oldest_seq - 1;
+
+        if (s.oldest_seq > erased_newest_seq) s.oldest_seq -= num_erased;
+        else if (s.oldest_seq >= erased_oldest_seq) s.oldest_seq = erased_oldest_seq;
+    }
+
+    this->front_seq -= num_erased;
+    this->num_records -= num_erased;
+}
+
+std::pair<u64, u64> completed_file_operation_group_index::index_range(u32 group_id) const noexcept
+{
+    auto iter = this->spans.find(group_id);
+    if (iter == this->spans.end()) {
+        return { 0, 0 };
     }
+    auto const &s = iter->second;
+    assert(s.newest_seq >= s.oldest_seq);
+
+    u64 first_idx = this->front_seq - s.newest_seq;
+    u64 last_idx = std::min(this->front_seq - s.oldest_seq + 1, this->num_records);
+
+    return { std::min(first_idx, last_idx), last_idx };
 }
 
 bool global_state::completed_file_operations_save_to_disk(std::scoped_lock<std::mutex> *supplied_lock) noexcept
 try {
     std::filesystem::path full_path = global_state::execution_path() / "data\\completed_file_operations.txt";
 
-    std::ofstream out(full_path);
-
-    if (!out) {
-        return false;
-    }
+    std::ostringstream out;
 
     auto completed_file_operations = global_state::completed_file_operations_get();
 
@@ -80,11 +227,13 @@ try {
                 << path_length(file_op.src_path) << ' '
                 << file_op.src_path.data() << ' '
                 << path_length(file_op.dst_path) << ' '
-                << file_op.dst_path.data() << '\n';
+                << file_op.dst_path.data() << ' '
+                << char(file_op.verification) << ' '
+                << char(file_op.copy_strategy) << '\n';
         }
     }
 
-    print_debug_msg("SUCCESS");
+    persistence_write(std::move(full_path), std::move(out).str());
     return true;
 }
 catch (std::exception const &except) {
@@ -101,7 +250,7 @@ try {
     auto completed_file_operations = global_state::completed_file_operations_get();
 
     std::scoped_lock lock(*completed_file_operations.mutex);
-    completed_file_operations.container->clear();
+    clear(completed_file_operations);
 
     std::filesystem::path full_path = global_state::execution_path() / "data\\completed_file_operations.txt";
 
@@ -152,17 +301,33 @@ try {
         iss.ignore(1);
 
         iss.read(stored_dst_path.data(), std::min(stored_dst_path_len, stored_dst_path.max_size() - 1));
+        iss.ignore(1);
+
+        // absent in records written before copy verification existed
+        char stored_verification = char(file_operation_verification::none);
+        iss >> stored_verification;
+        if (stored_verification == char(file_operation_verification::pending)) {
+            stored_verification = char(file_operation_verification::failed); // Swan exited before the comparison finished
+        }
+
+        // absent in records written before copy strategies were recorded
+        char stored_copy_strategy = char(file_copy_strategy::none);
+        iss >> stored_copy_strategy;
 
         path_force_separator(stored_src_path, dir_separator);
         path_force_separator(stored_dst_path, dir_separator);
 
-        completed_file_operations.container->emplace_back(stored_time_completion, stored_time_undo, file_operation_type(stored_op_type),
-                                                          stored_src_path.data(), stored_dst_path.data(), basic_dirent::kind(stored_obj_type), stored_group_id);
+        auto &record = completed_file_operations.container->emplace_back(stored_time_completion, stored_time_undo, file_operation_type(stored_op_type),
+                                                                          stored_src_path.data(), stored_dst_path.data(), basic_dirent::kind(stored_obj_type), stored_group_id);
+        record.verification = file_operation_verification(stored_verification);
+        record.copy_strategy = file_copy_strategy(stored_copy_strategy);
         ++num_loaded_successfully;
 
         line.clear();
     }
 
+    completed_file_operations.groups->rebuild(*completed_file_operations.container);
+
     print_debug_msg("SUCCESS loaded %zu records", num_loaded_successfully);
     return { true, num_loaded_successfully };
 }
@@ -213,6 +378,8 @@ completed_file_operation::completed_file_operation(completed_file_operation cons
     , dst_path(other.dst_path)
     , op_type(other.op_type)
     , obj_type(other.obj_type)
+    , verification(other.verification)
+    , copy_strategy(other.copy_strategy)
     , selected(other.selected)
 {
 }
@@ -230,6 +397,8 @@ completed_file_operation &completed_file_operation::operator=(completed_file_ope
     this->dst_path = other.dst_path;
     this->op_type = other.op_type;
     this->obj_type = other.obj_type;
+    this->verification = other.verification;
+    this->copy_strategy = other.copy_strategy;
     this->selected = other.selected;
 
     return *this;
@@ -477,6 +646,164 @@ generic_result enqueue_undelete_directory(char const *directory_path_in_recycle_
     return { initialization_error.empty(), initialization_error };
 }
 
+/// @brief Computes the XXH64 of a file's contents. Reads are double buffered with overlapped I/O,
+/// so the next chunk is being read from disk while the current one is hashed.
+/// @param full_path_utf16 Full path of the file to hash.
+/// @param cancellation_token Optional, checked between chunks.
+/// @param bypass_cache Read with FILE_FLAG_NO_BUFFERING, which flushes any cached writes first, so what is hashed is what reached the disk.
+file_hash_result hash_file_contents(wchar_t const *full_path_utf16, std::atomic_bool const *cancellation_token, bool bypass_cache) noexcept
+{
+    file_hash_result retval = {};
+
+    HANDLE file_handle = CreateFileW(full_path_utf16,
+                                     GENERIC_READ,
+                                     FILE_SHARE_READ,
+                                     NULL,
+                                     OPEN_EXISTING,
+                                     FILE_FLAG_OVERLAPPED|FILE_FLAG_SEQUENTIAL_SCAN|(bypass_cache ? FILE_FLAG_NO_BUFFERING : 0),
+                                     NULL);
+
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        return retval;
+    }
+    SCOPE_EXIT { CloseHandle(file_handle); };
+
+    // a multiple of any sector size, and VirtualAlloc is page aligned, as FILE_FLAG_NO_BUFFERING requires of reads
+    constexpr u64 chunk_size = 1024 * 1024;
+
+    std::byte *buffers[2] = { (std::byte *)VirtualAlloc(NULL, chunk_size, MEM_COMMIT|MEM_RESERVE, PAGE_READWRITE),
+                              (std::byte *)VirtualAlloc(NULL, chunk_size, MEM_COMMIT|MEM_RESERVE, PAGE_READWRITE) };
+    SCOPE_EXIT {
+        for (std::byte *buffer : buffers) {
+            if (buffer != nullptr) VirtualFree(buffer, 0, MEM_RELEASE);
+        }
+    };
+    if (buffers[0] == nullptr || buffers[1] == nullptr) {
+        return retval;
+    }
+
+    OVERLAPPED overlapped[2] = {};
+    bool in_flight[2] = {};
+
+    for (auto &ov : overlapped) {
+        ov.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        if (ov.hEvent == NULL) {
+            return retval;
+        }
+    }
+    SCOPE_EXIT {
+        // never free a buffer the kernel may still write into
+        for (u64 slot = 0; slot < 2; ++slot) {
+            if (in_flight[slot]) {
+                DWORD ignored = 0;
+                CancelIoEx(file_handle, &overlapped[slot]);
+                GetOverlappedResult(file_handle, &overlapped[slot], &ignored, TRUE);
+            }
+            if (overlapped[slot].hEvent != NULL) CloseHandle(overlapped[slot].hEvent);
+        }
+    };
+
+    auto issue_read = [&](u64 slot, u64 offset) noexcept -> bool {
+        overlapped[slot].Offset = DWORD(offset & 0xFFFF'FFFF);
+        overlapped[slot].OffsetHigh = DWORD(offset >> 32);
+        ResetEvent(overlapped[slot].hEvent);
+
+        if (ReadFile(file_handle, buffers[slot], DWORD(chunk_size), NULL, &overlapped[slot]) || GetLastError() == ERROR_IO_PENDING) {
+            in_flight[slot] = true;
+            return true;
+        }
+        return GetLastError() == ERROR_HANDLE_EOF;
+    };
+
+    xxh64_state state;
+    xxh64_reset(state);
+
+    u64 offset = 0;
+    u64 slot = 0;
+
+    if (!issue_read(slot, offset)) {
+        return retval;
+    }
+
+    while (in_flight[slot]) {
+        DWORD num_bytes_read = 0;
+        BOOL read_ok = GetOverlappedResult(file_handle, &overlapped[slot], &num_bytes_read, TRUE);
+        in_flight[slot] = false;
+
+        if (!read_ok && GetLastError() != ERROR_HANDLE_EOF) {
+            return retval;
+        }
+        if (num_bytes_read == 0) {
+            break;
+        }
+
+        offset += num_bytes_read;
+
+        if (cancellation_token != nullptr && cancellation_token->load()) {
+            return retval;
+        }
+        if (num_bytes_read == chunk_size && !issue_read(slot ^ 1, offset)) {
+            return retval;
+        }
+
+        xxh64_update(state, buffers[slot], num_bytes_read); // overlaps with the read issued above
+
+        slot ^= 1;
+    }
+
+    retval.success = true;
+    retval.hash = xxh64_digest(state);
+    retval.num_bytes = offset;
+
+    return retval;
+}
+
+/// @brief Compares the contents of a freshly copied file against its source and records the outcome
+/// on the matching completed_file_operation. Runs on the thread pool while IFileOperation carries on copying subsequent items.
+/// The destination is read past the page cache, so a match means the disk holds the copy, not just memory.
+void verify_copied_file(
+    std::wstring src_path_utf16,
+    std::wstring dst_path_utf16,
+    swan_path dst_path_utf8,
+    u32 group_id,
+    std::shared_ptr<std::atomic<u64>> num_verifications_outstanding) noexcept
+{
+    SWAN_PROFILE_FUNCTION();
+    file_hash_result src_hash = hash_file_contents(src_path_utf16.c_str());
+    file_hash_result dst_hash = hash_file_contents(dst_path_utf16.c_str(), nullptr, true);
+
+    file_operation_verification outcome;
+
+    if (!src_hash.success || !dst_hash.success) {
+        outcome = file_operation_verification::failed;
+    } else if (src_hash.num_bytes != dst_hash.num_bytes || src_hash.hash != dst_hash.hash) {
+        outcome = file_operation_verification::mismatch;
+    } else {
+        outcome = file_operation_verification::match;
+    }
+
+    print_debug_msg("verify [%s] %c src=%016llx dst=%016llx", dst_path_utf8.data(), char(outcome), src_hash.hash, dst_hash.hash);
+
+    auto completed_file_operations = global_state::completed_file_operations_get();
+
+    std::scoped_lock lock(*completed_file_operations.mutex);
+
+    auto [first_idx, last_idx] = completed_file_operations.groups->index_range(group_id);
+
+    for (u64 i = first_idx; i < last_idx; ++i) {
+        auto &cfo = completed_file_operations.container->operator[](i);
+
+        if (cfo.group_id == group_id && cfo.verification == file_operation_verification::pending && path_equals_exactly(cfo.dst_path, dst_path_utf8)) {
+            cfo.verification = outcome;
+            break;
+        }
+    }
+
+    if (num_verifications_outstanding->fetch_sub(1) == 1) {
+        global_state::mark_dirty(persisted_file::completed_file_operations);
+    }
+}
+
 u64 deselect_all(std::deque<completed_file_operation> &completed_operations) noexcept
 {
     u64 num_deselected = 0;
@@ -561,11 +888,11 @@ bool swan_windows::render_file_operations(bool &open, bool any_popups_open) noex
                 /* confirmation_id  = */ swan_id_confirm_completed_file_operations_forget_all,
                 /* confirmation_msg = */ "Are you sure you want to delete your ENTIRE file operations history? This action cannot be undone.",
                 /* on_yes_callback  = */
-                [completed_file_operations]() noexcept {
+                [completed_file_operations]() mutable noexcept {
                     std::scoped_lock lock(*completed_file_operations.mutex);
-                    completed_file_operations.container->clear();
-                    (void) global_state::completed_file_operations_save_to_disk(&lock);
-                    (void) global_state::settings().save_to_disk();
+                    clear(completed_file_operations);
+                    global_state::mark_dirty(persisted_file::completed_file_operations);
+                    global_state::mark_dirty(persisted_file::settings);
                 },
                 /* confirmation_enabled = */ &(global_state::settings().confirm_completed_file_operations_forget_all)
             );
@@ -587,6 +914,59 @@ bool swan_windows::render_file_operations(bool &open, bool any_popups_open) noex
         settings_change |= imgui::Checkbox("Full src path", &settings.file_operations_src_path_full);
         imgui::SameLineSpaced(1);
         settings_change |= imgui::Checkbox("Full dst path", &settings.file_operations_dst_path_full);
+        imgui::SameLineSpaced(1);
+        settings_change |= imgui::Checkbox("Verify copies", &settings.file_operations_verify_copies);
+        if (imgui::IsItemHovered()) imgui::SetTooltip("Compare the contents of every copied file against its source.\n"
+                                                      "Paste with Shift held to verify a single paste.");
+    }
+    {
+        auto &delete_progress = global_state::permanent_delete_progress();
+        u64 num_failed = delete_progress.num_failed.load();
+
+        if (delete_progress.active.load()) {
+            u64 work_total = delete_progress.work_total.load();
+            u64 work_so_far = delete_progress.work_so_far.load();
+
+            imgui::SameLineSpaced(2);
+            imgui::ProgressBar(work_total == 0 ? 0.f : f32(f64(work_so_far) / f64(work_total)), ImVec2(100, 0));
+            imgui::SameLine();
+            imgui::Text("Deleting %zu/%zu", work_so_far, work_total);
+            imgui::SameLine();
+            {
+                imgui::ScopedDisable d(delete_progress.cancellation_token.load());
+                if (imgui::Button(ICON_CI_DEBUG_STOP "## cancel permanent delete")) {
+                    delete_progress.cancellation_token.store(true);
+                }
+            }
+            if (imgui::IsItemHovered()) imgui::SetTooltip("Cancel permanent delete.\nWhatever was deleted so far stays deleted.");
+        }
+        else if (num_failed > 0) {
+            imgui::SameLineSpaced(2);
+            imgui::TextColored(error_color(), ICON_LC_MESSAGE_SQUARE_WARNING " %zu", num_failed);
+            if (imgui::IsItemHovered()) imgui::SetTooltip("%zu item%s could not be deleted by the last permanent delete.", num_failed, pluralized(num_failed, "", "s"));
+        }
+    }
+    {
+        auto &copy_progress = global_state::fast_copy_progress();
+
+        if (copy_progress.active.load() && copy_progress.work_total.load() > 0) {
+            u64 work_total = copy_progress.work_total.load();
+            u64 work_so_far = copy_progress.work_so_far.load();
+            u64 size_unit_multiplier = u64(global_state::settings().size_unit_multiplier);
+
+            imgui::SameLineSpaced(2);
+            imgui::ProgressBar(f32(f64(work_so_far) / f64(work_total)), ImVec2(100, 0));
+            imgui::SameLine();
+            imgui::Text("Copying %s/%s", format_file_size(work_so_far, size_unit_multiplier).data(), format_file_size(work_total, size_unit_multiplier).data());
+            imgui::SameLine();
+            {
+                imgui::ScopedDisable d(copy_progress.cancellation_token.load());
+                if (imgui::Button(ICON_CI_DEBUG_STOP "## cancel copy")) {
+                    copy_progress.cancellation_token.store(true);
+                }
+            }
+            if (imgui::IsItemHovered()) imgui::SetTooltip("Cancel paste.\nFiles copied so far stay, the one being copied is removed.");
+        }
     }
 
     enum file_ops_table_col : s32
@@ -662,6 +1042,35 @@ bool swan_windows::render_file_operations(bool &open, bool any_popups_open) noex
                 imgui::TextUnformatted(desc);
                 imgui::SameLine();
                 imgui::TextColored(icon_color, icon);
+
+                if (one_of(file_op.copy_strategy, { file_copy_strategy::clone, file_copy_strategy::sparse })) {
+                    imgui::SameLine();
+                    imgui::TextUnformatted(file_op.copy_strategy == file_copy_strategy::clone ? ICON_CI_COPY : ICON_CI_FILE_ZIP);
+                    if (imgui::IsItemHovered()) {
+                        imgui::SetTooltip(file_op.copy_strategy == file_copy_strategy::clone ? "Block cloned, no data was copied"
+                                                                                             : "Sparse copy, holes in the source were preserved");
+                    }
+                }
+
+                if (file_op.verification != file_operation_verification::none) {
+                    imgui::SameLine();
+                    switch (file_op.verification) {
+                        case file_operation_verification::pending:  imgui::TextUnformatted(ICON_CI_LOADING); break;
+                        case file_operation_verification::match:    imgui::TextColored(success_color(), ICON_CI_VERIFIED); break;
+                        case file_operation_verification::mismatch: imgui::TextColored(error_color(), ICON_CI_ERROR); break;
+                        case file_operation_verification::failed:   imgui::TextColored(warning_color(), ICON_CI_UNVERIFIED); break;
+                        default: break;
+                    }
+                    if (imgui::IsItemHovered()) {
+                        switch (file_op.verification) {
+                            case file_operation_verification::pending:  imgui::SetTooltip("Verifying copy..."); break;
+                            case file_operation_verification::match:    imgui::SetTooltip("Verified, destination matches source"); break;
+                            case file_operation_verification::mismatch: imgui::SetTooltip("MISMATCH, destination differs from source"); break;
+                            case file_operation_verification::failed:   imgui::SetTooltip("Verification failed, source or destination could not be read"); break;
+                            default: break;
+                        }
+                    }
+                }
             }
 
             if (imgui::TableSetColumnIndex(file_ops_table_col_completion_time)) {
@@ -761,7 +1170,16 @@ bool swan_windows::render_file_operations(bool &open, bool any_popups_open) noex
                         bool restorable = cfo.op_type == file_operation_type::del && !cfo.undone() && !path_is_empty(cfo.dst_path);
                         s_num_selected_when_context_menu_opened += u64(cfo.selected);
                         s_num_restorables_selected_when_context_menu_opened += u64(restorable && cfo.selected);
-                        s_num_restorables_in_group_when_context_menu_opened += u64(restorable && cfo.group_id == elem_iter->group_id);
+                    }
+
+                    if (elem_iter->group_id != 0) {
+                        auto [group_first_idx, group_last_idx] = completed_file_operations.groups->index_range(elem_iter->group_id);
+
+                        for (u64 j = group_first_idx; j < group_last_idx; ++j) {
+                            auto const &cfo = completed_file_operations.container->operator[](j);
+                            bool restorable = cfo.op_type == file_operation_type::del && !cfo.undone() && !path_is_empty(cfo.dst_path);
+                            s_num_restorables_in_group_when_context_menu_opened += u64(restorable && cfo.group_id == elem_iter->group_id);
+                        }
                     }
                 }
             }
@@ -881,10 +1299,16 @@ bool swan_windows::render_file_operations(bool &open, bool any_popups_open) noex
 
                             auto res = undelete_file(context_target.dst_path.data());
 
+                            if (res.step3_new_hardlink_created) {
+                                if (global_state::recent_files_path_changed(context_target.dst_path.data(), context_target.src_path.data(), false, nullptr) > 0) {
+                                    global_state::mark_dirty(persisted_file::recent_files);
+                                }
+                            }
+
                             if (res.success()) {
                                 context_target.undo_time = get_time_system();
                                 context_target.selected = false;
-                                (void) global_state::completed_file_operations_save_to_disk(&completed_file_ops_lock);
+                                global_state::mark_dirty(persisted_file::completed_file_operations);
                             }
                             else {
                                 std::string action = make_str("Undelete file [%s].", context_target.src_path.data());
@@ -904,7 +1328,7 @@ bool swan_windows::render_file_operations(bool &open, bool any_popups_open) noex
                                 if (res.step3_new_hardlink_created) {
                                     // not a complete success but enough to consider the deletion undone, as the last 2 steps are merely cleanup of the recycle bin
                                     context_target.undo_time = get_time_system();
-                                    (void) global_state::completed_file_operations_save_to_disk(&completed_file_ops_lock);
+                                    global_state::mark_dirty(persisted_file::completed_file_operations);
                                 }
                             }
                         }
@@ -963,7 +1387,11 @@ bool swan_windows::render_file_operations(bool &open, bool any_popups_open) noex
                 {
                     std::string clipboard = {};
 
-                    for (u64 i = 0; i < completed_file_operations.container->size(); ++i) {
+                    auto [first_idx, last_idx] = for_group_id == 0
+                        ? std::make_pair(u64(0), u64(completed_file_operations.container->size()))
+                        : completed_file_operations.groups->index_range(for_group_id);
+
+                    for (u64 i = first_idx; i < last_idx; ++i) {
                         auto const &cfo = completed_file_operations.container->operator[](i);
                         bool matched = for_group_id == 0 ? cfo.selected : cfo.group_id == for_group_id;
                         if (matched) {
@@ -1052,12 +1480,13 @@ bool swan_windows::render_file_operations(bool &open, bool any_popups_open) noex
                     auto selected_partition_iter = std::stable_partition(std::execution::par_unseq, begin_iter, end_iter,
                         [](completed_file_operation const &elem) noexcept { return !elem.selected; });
 
-                    for (auto iter = selected_partition_iter; iter != end_iter; ++iter) {
-                        erase(completed_file_operations, iter, iter + 1);
-                    }
+                    erase(completed_file_operations, selected_partition_iter, end_iter);
+
+                    // partitioning moved records between groups' spans, recompute them
+                    completed_file_operations.groups->rebuild(*completed_file_operations.container);
                 }
-                (void) global_state::completed_file_operations_save_to_disk(&completed_file_ops_lock);
-                (void) global_state::settings().save_to_disk(); // persist potential change to confirmation checkbox
+                global_state::mark_dirty(persisted_file::completed_file_operations);
+                global_state::mark_dirty(persisted_file::settings); // persist potential change to confirmation checkbox
             }
         }
 
@@ -1066,19 +1495,26 @@ bool swan_windows::render_file_operations(bool &open, bool any_popups_open) noex
 
             if (execute_forget_group_immediately || status.value_or(false)) {
                 u32 group_id = s_context_menu_target_iter.value()->group_id;
+                auto &container = *completed_file_operations.container;
+                auto [group_first_idx, group_last_idx] = completed_file_operations.groups->index_range(group_id);
+
+                // Erase each contiguous run of the group, walking backwards so that erasing a run doesn't shift runs yet to be visited.
+                // A group only has multiple runs if it was interleaved with a concurrent file operation.
+                for (u64 run_end = group_last_idx; run_end > group_first_idx; ) {
+                    if (container[run_end - 1].group_id != group_id) {
+                        --run_end;
+                        continue;
+                    }
+                    u64 run_begin = run_end - 1;
+                    while (run_begin > group_first_idx && container[run_begin - 1].group_id == group_id) {
+                        --run_begin;
+                    }
+                    erase(completed_file_operations, container.begin() + run_begin, container.begin() + run_end);
+                    run_end = run_begin;
+                }
 
-                auto predicate_same_group = [group_id](completed_file_operation const &cfo) noexcept { return cfo.group_id == group_id; };
-
-                auto begin_iter = completed_file_operations.container->begin();
-                auto end_iter   = completed_file_operations.container->end();
-
-                auto remove_group_begin_iter = std::find_if    (begin_iter,              end_iter, predicate_same_group);
-                auto remove_group_end_iter   = std::find_if_not(remove_group_begin_iter, end_iter, predicate_same_group);
-
-                erase(completed_file_operations, remove_group_begin_iter, remove_group_end_iter);
-
-                (void) global_state::completed_file_operations_save_to_disk(&completed_file_ops_lock);
-                (void) global_state::settings().save_to_disk(); // persist potential change to confirmation checkbox
+                global_state::mark_dirty(persisted_file::completed_file_operations);
+                global_state::mark_dirty(persisted_file::settings); // persist potential change to confirmation checkbox
             }
         }
 
@@ -1086,7 +1522,7 @@ bool swan_windows::render_file_operations(bool &open, bool any_popups_open) noex
     }
 
     if (settings_change) {
-        global_state::settings().save_to_disk();
+        global_state::mark_dirty(persisted_file::settings);
     }
 
     return true;
@@ -1119,6 +1555,352 @@ void print_SIGDN_values(char const *func_label, char const *item_name, IShellIte
     }
 }
 
+/// Picks how `try_fast_copy_file` should copy a file, or `file_copy_strategy::none` if it should be left to IFileOperation.
+/// Only the unnamed data stream, timestamps and basic attributes survive a fast copy, so anything carrying more than that
+/// (alternate data streams, explicit ACEs, encryption, compression) is excluded rather than silently losing it.
+file_copy_strategy choose_fast_copy_strategy(fast_copy_candidate const &c) noexcept
+{
+    DWORD constexpr unsupported_attributes = FILE_ATTRIBUTE_DIRECTORY|FILE_ATTRIBUTE_REPARSE_POINT|FILE_ATTRIBUTE_ENCRYPTED|FILE_ATTRIBUTE_COMPRESSED;
+
+    if ((c.src_attributes & unsupported_attributes) || c.src_has_alternate_streams || c.src_has_explicit_security) {
+        return file_copy_strategy::none;
+    }
+    if (c.src_volume_serial == c.dst_volume_serial && (c.src_fs_flags & FILE_SUPPORTS_BLOCK_REFCOUNTING)) {
+        return file_copy_strategy::clone;
+    }
+    if ((c.src_attributes & FILE_ATTRIBUTE_SPARSE_FILE) && (c.dst_fs_flags & FILE_SUPPORTS_SPARSE_FILES)) {
+        return file_copy_strategy::sparse;
+    }
+    return file_copy_strategy::none;
+}
+
+/// Returns true if the file has any named stream besides the unnamed data stream, or if its streams cannot be enumerated.
+static
+bool has_alternate_data_streams(wchar_t const *path_utf16) noexcept
+{
+    WIN32_FIND_STREAM_DATA stream = {};
+    HANDLE find_handle = FindFirstStreamW(path_utf16, FindStreamInfoStandard, &stream, 0);
+
+    if (find_handle == INVALID_HANDLE_VALUE) {
+        return GetLastError() != ERROR_HANDLE_EOF; // no streams at all is fine, failing to enumerate is not
+    }
+    SCOPE_EXIT { FindClose(find_handle); };
+
+    do {
+        if (wcscmp(stream.cStreamName, L"::$DATA") != 0) {
+            return true;
+        }
+    }
+    while (FindNextStreamW(find_handle, &stream));
+
+    return false;
+}
+
+/// Returns true if the DACL of the file is anything other than what a new file in the destination would inherit,
+/// i.e. it is protected from inheritance or holds ACEs of its own. Errs on the side of true.
+static
+bool has_explicit_security(HANDLE file_handle) noexcept
+{
+    PACL dacl = nullptr;
+    PSECURITY_DESCRIPTOR descriptor = nullptr;
+
+    if (GetSecurityInfo(file_handle, SE_FILE_OBJECT, DACL_SECURITY_INFORMATION, nullptr, nullptr, &dacl, nullptr, &descriptor) != ERROR_SUCCESS) {
+        return true;
+    }
+    SCOPE_EXIT { LocalFree(descriptor); };
+
+    SECURITY_DESCRIPTOR_CONTROL control = 0;
+    DWORD revision = 0;
+    if (!GetSecurityDescriptorControl(descriptor, &control, &revision) || (control & SE_DACL_PROTECTED) || dacl == nullptr) {
+        return true;
+    }
+
+    for (DWORD i = 0; i < dacl->AceCount; ++i) {
+        ACE_HEADER *ace = nullptr;
+        if (!GetAce(dacl, i, reinterpret_cast<void **>(&ace)) || !(ace->AceFlags & INHERITED_ACE)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/// Copies a regular file without pushing every byte through user space where the filesystem allows it:
+/// a block clone when source and destination share a ReFS volume (extents are shared until either side writes),
+/// otherwise a sparse copy of only the allocated ranges when the source is sparse and the destination supports it.
+/// See `choose_fast_copy_strategy` for which files qualify.
+/// Returns `file_copy_strategy::none` if the file does not qualify, anything fails, or `progress` is cancelled,
+/// in which case the destination has not been left behind and, unless cancelled, the caller should fall back to a full copy.
+/// Never overwrites, an existing destination is a failure.
+/// @param progress Optional, the size of the file is added to its total and the bytes copied to its progress, removed again on failure.
+/// Its cancellation token is checked between chunks.
+/// @param volumes Optional, pass the same one for every file of a paste so each volume is queried once rather than per file.
+file_copy_strategy try_fast_copy_file(
+    wchar_t const *src_path_utf16,
+    wchar_t const *dst_path_utf16,
+    file_operation_progress *progress,
+    fast_copy_volume_cache *volumes) noexcept
+{
+    fast_copy_volume_cache local_volumes = {};
+    if (volumes == nullptr) {
+        volumes = &local_volumes;
+    }
+
+    {
+        std::wstring_view dst_dir_utf16(dst_path_utf16, PathFindFileNameW(dst_path_utf16));
+
+        if (!volumes->dst_queried || volumes->dst_directory_utf16 != dst_dir_utf16) {
+            volumes->dst_directory_utf16 = dst_dir_utf16;
+            volumes->dst_queried = true;
+            volumes->dst_valid = false;
+
+            HANDLE dst_dir_handle = CreateFileW(volumes->dst_directory_utf16.c_str(),
+                                                FILE_READ_ATTRIBUTES,
+                                                FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE,
+                                                NULL,
+                                                OPEN_EXISTING,
+                                                FILE_FLAG_BACKUP_SEMANTICS,
+                                                NULL);
+
+            if (dst_dir_handle != INVALID_HANDLE_VALUE) {
+                SCOPE_EXIT { CloseHandle(dst_dir_handle); };
+                volumes->dst_valid = GetVolumeInformationByHandleW(dst_dir_handle, nullptr, 0, &volumes->dst_volume_serial, nullptr,
+                                                                   &volumes->dst_fs_flags, nullptr, 0);
+            }
+        }
+    }
+
+    // a clone needs both files on one volume, so a destination supporting neither strategy rules out every file without opening any
+    if (!volumes->dst_valid || !(volumes->dst_fs_flags & (FILE_SUPPORTS_BLOCK_REFCOUNTING|FILE_SUPPORTS_SPARSE_FILES))) {
+        return file_copy_strategy::none;
+    }
+
+    HANDLE src_handle = CreateFileW(src_path_utf16,
+                                    GENERIC_READ,
+                                    FILE_SHARE_READ|FILE_SHARE_DELETE,
+                                    NULL,
+                                    OPEN_EXISTING,
+                                    FILE_FLAG_SEQUENTIAL_SCAN,
+                                    NULL);
+
+    if (src_handle == INVALID_HANDLE_VALUE) {
+        return file_copy_strategy::none;
+    }
+    SCOPE_EXIT { CloseHandle(src_handle); };
+
+    BY_HANDLE_FILE_INFORMATION src_info = {};
+    if (!GetFileInformationByHandle(src_handle, &src_info)) {
+        return file_copy_strategy::none;
+    }
+    u64 const src_size = (u64(src_info.nFileSizeHigh) << 32) | u64(src_info.nFileSizeLow);
+    bool const src_sparse = src_info.dwFileAttributes & FILE_ATTRIBUTE_SPARSE_FILE;
+
+    DWORD src_fs_flags = 0;
+    {
+        auto src_volume = std::find_if(volumes->src_volumes.begin(), volumes->src_volumes.end(),
+                                       [&](fast_copy_volume_cache::source_volume const &v) { return v.serial == src_info.dwVolumeSerialNumber; });
+
+        if (src_volume != volumes->src_volumes.end()) {
+            src_fs_flags = src_volume->fs_flags;
+        }
+        else {
+            if (!GetVolumeInformationByHandleW(src_handle, nullptr, 0, nullptr, nullptr, &src_fs_flags, nullptr, 0)) {
+                return file_copy_strategy::none;
+            }
+            volumes->src_volumes.push_back({ src_info.dwVolumeSerialNumber, src_fs_flags });
+        }
+    }
+
+    fast_copy_candidate candidate = {};
+    candidate.src_attributes = src_info.dwFileAttributes;
+    candidate.src_volume_serial = src_info.dwVolumeSerialNumber;
+    candidate.src_fs_flags = src_fs_flags;
+    candidate.dst_volume_serial = volumes->dst_volume_serial;
+    candidate.dst_fs_flags = volumes->dst_fs_flags;
+
+    // cheap checks first, the stream and security checks only matter if there is a strategy to lose anything to
+    if (choose_fast_copy_strategy(candidate) == file_copy_strategy::none) {
+        return file_copy_strategy::none;
+    }
+
+    candidate.src_has_alternate_streams = has_alternate_data_streams(src_path_utf16);
+    candidate.src_has_explicit_security = has_explicit_security(src_handle);
+
+    file_copy_strategy const strategy = choose_fast_copy_strategy(candidate);
+    if (strategy == file_copy_strategy::none) {
+        return file_copy_strategy::none;
+    }
+
+    HANDLE dst_handle = CreateFileW(dst_path_utf16,
+                                    GENERIC_READ|GENERIC_WRITE|DELETE,
+                                    0,
+                                    NULL,
+                                    CREATE_NEW,
+                                    FILE_ATTRIBUTE_NORMAL,
+                                    NULL);
+
+    if (dst_handle == INVALID_HANDLE_VALUE) {
+        return file_copy_strategy::none;
+    }
+
+    bool success = false;
+    u64 num_bytes_reported = 0;
+
+    if (progress != nullptr) {
+        progress->work_total.fetch_add(src_size);
+    }
+
+    SCOPE_EXIT {
+        if (!success) {
+            // leave nothing behind, the fallback copy must not collide with a half written file
+            FILE_DISPOSITION_INFO disposition = { .DeleteFile = TRUE };
+            SetFileInformationByHandle(dst_handle, FileDispositionInfo, &disposition, sizeof(disposition));
+
+            if (progress != nullptr) {
+                progress->work_total.fetch_sub(src_size);
+                progress->work_so_far.fetch_sub(num_bytes_reported);
+            }
+        }
+        CloseHandle(dst_handle);
+    };
+
+    // returns false if the copy should stop because it was cancelled
+    auto report_progress = [&](u64 copied_up_to) noexcept {
+        if (progress == nullptr) {
+            return true;
+        }
+        copied_up_to = std::min(copied_up_to, src_size);
+        if (copied_up_to > num_bytes_reported) {
+            progress->work_so_far.fetch_add(copied_up_to - num_bytes_reported);
+            num_bytes_reported = copied_up_to;
+            global_state::wake_render_loop();
+        }
+        return !progress->cancellation_token.load();
+    };
+
+    DWORD bytes_returned = 0;
+
+    // block cloning requires the sparseness of both files to match, and a sparse copy obviously requires it
+    if (src_sparse && !DeviceIoControl(dst_handle, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &bytes_returned, nullptr)) {
+        return file_copy_strategy::none;
+    }
+
+    {
+        FILE_END_OF_FILE_INFO eof = {};
+        eof.EndOfFile.QuadPart = s64(src_size);
+        if (!SetFileInformationByHandle(dst_handle, FileEndOfFileInfo, &eof, sizeof(eof))) {
+            return file_copy_strategy::none;
+        }
+    }
+
+    if (strategy == file_copy_strategy::clone) {
+        DWORD sectors_per_cluster = 0, bytes_per_sector = 0, ignored_a = 0, ignored_b = 0;
+        {
+            wchar_t volume_path_utf16[MAX_PATH];
+            if (!GetVolumePathNameW(src_path_utf16, volume_path_utf16, lengthof(volume_path_utf16))) {
+                return file_copy_strategy::none;
+            }
+            if (!GetDiskFreeSpaceW(volume_path_utf16, &sectors_per_cluster, &bytes_per_sector, &ignored_a, &ignored_b)) {
+                return file_copy_strategy::none;
+            }
+        }
+
+        u64 const cluster_size = u64(sectors_per_cluster) * u64(bytes_per_sector);
+        u64 const clone_size = ((src_size + cluster_size - 1) / cluster_size) * cluster_size; // regions must end on a cluster boundary
+        u64 constexpr max_chunk_size = 1024ULL * 1024 * 1024; // a single request is limited to less than 4 GiB, a multiple of any cluster size
+
+        for (u64 offset = 0; offset < clone_size; offset += max_chunk_size) {
+            DUPLICATE_EXTENTS_DATA extents = {};
+            extents.FileHandle = src_handle;
+            extents.SourceFileOffset.QuadPart = s64(offset);
+            extents.TargetFileOffset.QuadPart = s64(offset);
+            extents.ByteCount.QuadPart = s64(std::min(max_chunk_size, clone_size - offset));
+
+            if (!DeviceIoControl(dst_handle, FSCTL_DUPLICATE_EXTENTS_TO_FILE, &extents, sizeof(extents), nullptr, 0, &bytes_returned, nullptr)) {
+                print_debug_msg("FAILED FSCTL_DUPLICATE_EXTENTS_TO_FILE, falling back to full copy");
+                return file_copy_strategy::none;
+            }
+            if (!report_progress(offset + u64(extents.ByteCount.QuadPart))) {
+                return file_copy_strategy::none;
+            }
+        }
+    }
+    else {
+        u64 constexpr chunk_size = 1024 * 1024;
+        auto buffer = std::make_unique<std::byte[]>(chunk_size);
+
+        FILE_ALLOCATED_RANGE_BUFFER query = {};
+        query.FileOffset.QuadPart = 0;
+        query.Length.QuadPart = s64(src_size);
+
+        FILE_ALLOCATED_RANGE_BUFFER ranges[64];
+
+        for (;;) {
+            BOOL done = DeviceIoControl(src_handle, FSCTL_QUERY_ALLOCATED_RANGES, &query, sizeof(query), ranges, sizeof(ranges), &bytes_returned, nullptr);
+            if (!done && GetLastError() != ERROR_MORE_DATA) {
+                return file_copy_strategy::none;
+            }
+
+            u64 num_ranges = bytes_returned / sizeof(FILE_ALLOCATED_RANGE_BUFFER);
+
+            for (u64 r = 0; r < num_ranges; ++r) {
+                u64 range_begin = u64(ranges[r].FileOffset.QuadPart);
+                u64 range_end = std::min(src_size, range_begin + u64(ranges[r].Length.QuadPart));
+
+                for (u64 offset = range_begin; offset < range_end; ) {
+                    DWORD to_read = DWORD(std::min(chunk_size, range_end - offset));
+                    DWORD num_read = 0;
+                    DWORD num_written = 0;
+
+                    OVERLAPPED read_at = {};
+                    read_at.Offset = DWORD(offset & 0xFFFF'FFFF);
+                    read_at.OffsetHigh = DWORD(offset >> 32);
+                    OVERLAPPED write_at = read_at;
+
+                    if (!ReadFile(src_handle, buffer.get(), to_read, &num_read, &read_at) || num_read == 0) {
+                        return file_copy_strategy::none;
+                    }
+                    if (!WriteFile(dst_handle, buffer.get(), num_read, &num_written, &write_at) || num_written != num_read) {
+                        return file_copy_strategy::none;
+                    }
+                    offset += num_read;
+
+                    if (!report_progress(offset)) {
+                        return file_copy_strategy::none;
+                    }
+                }
+            }
+
+            if (done || num_ranges == 0) {
+                break;
+            }
+
+            // ERROR_MORE_DATA, continue querying after the last range we were given
+            u64 next_offset = u64(ranges[num_ranges - 1].FileOffset.QuadPart) + u64(ranges[num_ranges - 1].Length.QuadPart);
+            query.FileOffset.QuadPart = s64(next_offset);
+            query.Length.QuadPart = s64(src_size - std::min(src_size, next_offset));
+        }
+    }
+
+    if (!SetFileTime(dst_handle, &src_info.ftCreationTime, &src_info.ftLastAccessTime, &src_info.ftLastWriteTime)) {
+        return file_copy_strategy::none;
+    }
+
+    {
+        FILE_BASIC_INFO basic = {};
+        if (GetFileInformationByHandleEx(dst_handle, FileBasicInfo, &basic, sizeof(basic))) {
+            // sparse is kept by FSCTL_SET_SPARSE, directory/reparse cannot apply here, the rest mirror the source
+            basic.FileAttributes = (src_info.dwFileAttributes & ~DWORD(FILE_ATTRIBUTE_SPARSE_FILE)) | (basic.FileAttributes & FILE_ATTRIBUTE_SPARSE_FILE);
+            SetFileInformationByHandle(dst_handle, FileBasicInfo, &basic, sizeof(basic));
+        }
+    }
+
+    (void) report_progress(src_size); // holes of a sparse copy count as copied
+
+    success = true;
+    return strategy;
+}
+
 /// @brief Performs a sequence of file operations.
 /// @param destination_directory_utf16 The destination of the operations. For example, the place where we are copying files to.
 /// @param paths_to_execute_utf16 Single string of absolute paths to execute an operation against. Each path must be separated by a newline.
@@ -1128,6 +1910,7 @@ void print_SIGDN_values(char const *func_label, char const *item_name, IShellIte
 /// @param init_done_cond Condition variable, signalled when `init_done` is set to true by this function.
 /// @param init_done Set to true after initialization is completed.
 /// @param init_error Output parameter, where to store initialization error message. If empty, initalization was successful.
+/// @param verify_copies Whether to compare the contents of each copied file against its source once it has been copied.
 void perform_file_operations(
     s32 dst_expl_id,
     std::wstring destination_directory_utf16,
@@ -1138,8 +1921,12 @@ void perform_file_operations(
     bool *init_done,
     std::string *init_error,
     char dir_sep_utf8,
-    s32 num_max_file_operations) noexcept
+    s32 num_max_file_operations,
+    bool verify_copies) noexcept
 {
+    SWAN_PROFILE_FUNCTION();
+    ++global_state::foreground_io_count();
+    SCOPE_EXIT { --global_state::foreground_io_count(); };
     assert(!destination_directory_utf16.empty());
 
     std::replace(destination_directory_utf16.begin(), destination_directory_utf16.end(), L'/', L'\\');
@@ -1215,6 +2002,14 @@ void perform_file_operations(
     prog_sink.dst_expl_cwd_when_operation_started = global_state::explorers()[dst_expl_id].cwd;
     prog_sink.dir_sep_utf8 = dir_sep_utf8;
     prog_sink.num_max_file_operations = num_max_file_operations;
+    prog_sink.verify_copies = verify_copies;
+    prog_sink.num_verifications_outstanding = std::make_shared<std::atomic<u64>>(0);
+    prog_sink.group_id = global_state::completed_file_operations_next_group_id();
+
+    // regular files being copied are attempted with `try_fast_copy_file` once the caller is released,
+    // whichever of them it cannot handle are attached to IFileOperation at that point
+    std::vector<std::wstring> fast_copy_candidates = {};
+    u64 num_attached = 0;
 
     // attach items (IShellItem) for deletion to IFileOperation
     {
@@ -1237,6 +2032,14 @@ void perform_file_operations(
 
             swan_path item_path_utf8 = path_create("");
 
+            if (op_type == file_operation_type::copy) {
+                DWORD attributes = GetFileAttributesW(full_path_to_exec_utf16.c_str());
+                if (attributes != INVALID_FILE_ATTRIBUTES && !(attributes & (FILE_ATTRIBUTE_DIRECTORY|FILE_ATTRIBUTE_REPARSE_POINT))) {
+                    fast_copy_candidates.push_back(full_path_to_exec_utf16);
+                    continue;
+                }
+            }
+
             IShellItem *to_exec = nullptr;
             result = SHCreateItemFromParsingName(full_path_to_exec_utf16.c_str(), nullptr, IID_PPV_ARGS(&to_exec));
             if (FAILED(result)) {
@@ -1292,6 +2095,7 @@ void perform_file_operations(
                     err << "IFileOperation::" << function << " [" << item_path_utf8.data() << "].";
                 }
             } else {
+                ++num_attached;
                 // WCOUT_IF_DEBUG("file_op->" << function << " [" << full_path_to_exec_utf16.c_str() << "]\n");
             }
         }
@@ -1301,8 +2105,6 @@ void perform_file_operations(
             errors.pop_back(); // remove trailing '\n'
             return set_init_error_and_notify(errors);
         }
-
-        prog_sink.group_id = global_state::completed_file_operations_calc_next_group_id();
     }
 
     DWORD cookie = {};
@@ -1314,6 +2116,70 @@ void perform_file_operations(
 
     set_init_error_and_notify(""); // init succeeded, no error
 
+    // the fast copy progress is shown in the File Operations window and only one paste reports to it at a time,
+    // pastes overlapping that one copy everything through IFileOperation, which has its own progress dialog
+    file_operation_progress *fast_copy_progress = nullptr;
+    if (!fast_copy_candidates.empty()) {
+        file_operation_progress &progress = global_state::fast_copy_progress();
+        bool expected = false;
+        if (progress.active.compare_exchange_strong(expected, true)) {
+            progress.work_total.store(0);
+            progress.work_so_far.store(0);
+            progress.cancellation_token.store(false);
+            fast_copy_progress = &progress;
+        }
+    }
+    SCOPE_EXIT { if (fast_copy_progress != nullptr) fast_copy_progress->active.store(false); };
+
+    fast_copy_volume_cache fast_copy_volumes = {};
+
+    for (auto const &src_path_utf16 : fast_copy_candidates) {
+        std::wstring dst_path_utf16 = destination_directory_utf16;
+        if (dst_path_utf16.back() != L'\\') {
+            dst_path_utf16.push_back(L'\\');
+        }
+        dst_path_utf16.append(PathFindFileNameW(src_path_utf16.c_str()));
+
+        file_copy_strategy strategy = file_copy_strategy::none;
+        if (fast_copy_progress != nullptr) {
+            strategy = try_fast_copy_file(src_path_utf16.c_str(), dst_path_utf16.c_str(), fast_copy_progress, &fast_copy_volumes);
+
+            if (fast_copy_progress->cancellation_token.load()) {
+                // only the remaining fast copies are dropped, moves, deletes and full copies already attached still go ahead
+                print_debug_msg("fast copy cancelled, %zu item(s) attached to IFileOperation still performed", num_attached);
+                break;
+            }
+        }
+
+        if (strategy != file_copy_strategy::none) {
+            prog_sink.push_completed_copy(src_path_utf16.c_str(), dst_path_utf16.c_str(), basic_dirent::kind::file, strategy);
+            continue;
+        }
+
+        // full copy by IFileOperation, which also takes care of renaming on collision
+        IShellItem *to_copy = nullptr;
+        result = SHCreateItemFromParsingName(src_path_utf16.c_str(), nullptr, IID_PPV_ARGS(&to_copy));
+        if (FAILED(result)) {
+            WCOUT_IF_DEBUG("FAILED: SHCreateItemFromParsingName [" << src_path_utf16.c_str() << "]\n");
+            continue;
+        }
+        SCOPE_EXIT { to_copy->Release(); };
+
+        result = file_op->CopyItem(to_copy, destination, nullptr, nullptr);
+        if (FAILED(result)) {
+            WCOUT_IF_DEBUG("FAILED: IFileOperation::CopyItem [" << src_path_utf16.c_str() << "]\n");
+            continue;
+        }
+        ++num_attached;
+    }
+
+    if (num_attached == 0) {
+        // everything was handled natively or cancelled, IFileOperation would fail with nothing to do
+        file_op->Unadvise(cookie);
+        prog_sink.FinishOperations(S_OK);
+        return;
+    }
+
     result = file_op->PerformOperations();
     if (FAILED(result)) {
         print_debug_msg("FAILED IFileOperation::PerformOperations, %s", _com_error(result).ErrorMessage());
@@ -1324,3 +2190,395 @@ void perform_file_operations(
         print_debug_msg("FAILED IFileOperation::Unadvise(%d), %s", cookie, _com_error(result).ErrorMessage());
     }
 }
+
+struct permanent_delete_node
+{
+    std::wstring path_utf16;
+    permanent_delete_node *parent;
+    std::atomic<u64> num_outstanding; // own scan + queued child directories + queued file batches
+    std::atomic_bool any_child_failed;
+};
+
+struct permanent_delete_task
+{
+    struct item
+    {
+        std::wstring name_utf16;
+        bool directory; // only reparse points end up here as directories, they are unlinked without following
+    };
+
+    permanent_delete_node *dir;
+    std::vector<item> items; // empty means scan `dir`
+};
+
+struct permanent_delete_state
+{
+    std::mutex mutex = {};
+    std::condition_variable cond = {};
+    std::vector<permanent_delete_task> pending = {};
+    std::deque<permanent_delete_node> nodes = {}; // deque for stable addresses
+    u64 num_in_flight = 0; // pending + currently executing, workers exit when this reaches 0
+
+    permanent_delete_node *root = nullptr; // the working directory, never deleted itself
+    explorer_file_op_progress_sink *prog_sink = nullptr;
+    std::atomic<u64> num_discovered = 0;
+    std::atomic<u64> num_deleted = 0;
+    std::atomic<u64> num_failed = 0;
+    std::atomic_bool cancelled = false;
+};
+
+/// Unlinks a file, an empty directory or a reparse point (not its target).
+static
+bool permanent_delete_entry(std::wstring const &full_path_utf16, bool directory) noexcept
+{
+    HANDLE handle = CreateFileW(full_path_utf16.c_str(),
+                                DELETE,
+                                FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE,
+                                NULL,
+                                OPEN_EXISTING,
+                                FILE_FLAG_BACKUP_SEMANTICS|FILE_FLAG_OPEN_REPARSE_POINT,
+                                NULL);
+
+    if (handle != INVALID_HANDLE_VALUE) {
+        // POSIX semantics remove the name immediately rather than when the last handle closes,
+        // so the parent can be removed right after its last child even if an indexer or antivirus still has the child open
+        FILE_DISPOSITION_INFO_EX disposition = {};
+        disposition.Flags = FILE_DISPOSITION_FLAG_DELETE|FILE_DISPOSITION_FLAG_POSIX_SEMANTICS|FILE_DISPOSITION_FLAG_IGNORE_READONLY_ATTRIBUTE;
+
+        BOOL unlinked = SetFileInformationByHandle(handle, FileDispositionInfoEx, &disposition, sizeof(disposition));
+        CloseHandle(handle);
+
+        if (unlinked) {
+            return true;
+        }
+    }
+
+    // FileDispositionInfoEx requires Windows 10 1809 and NTFS, fall back to the classic calls
+    if (directory) {
+        return RemoveDirectoryW(full_path_utf16.c_str());
+    }
+    if (DeleteFileW(full_path_utf16.c_str())) {
+        return true;
+    }
+    if (GetLastError() == ERROR_ACCESS_DENIED && SetFileAttributesW(full_path_utf16.c_str(), FILE_ATTRIBUTE_NORMAL)) {
+        return DeleteFileW(full_path_utf16.c_str());
+    }
+    return false;
+}
+
+static
+void permanent_delete_record(permanent_delete_state &state, std::wstring const &full_path_utf16, basic_dirent::kind obj_type) noexcept
+{
+    swan_path path_utf8 = path_create("");
+
+    if (utf16_to_utf8(full_path_utf16.c_str(), path_utf8.data(), path_utf8.max_size())) {
+        path_force_separator(path_utf8, state.prog_sink->dir_sep_utf8);
+        state.prog_sink->push_completed_delete(path_utf8.data(), "", obj_type);
+    }
+}
+
+/// Caller is responsible for counting the task in `num_outstanding` of the node it will complete.
+static
+void permanent_delete_enqueue(permanent_delete_state &state, permanent_delete_task &&task) noexcept
+{
+    {
+        std::scoped_lock lock(state.mutex);
+        state.pending.push_back(std::move(task));
+        ++state.num_in_flight;
+    }
+    state.cond.notify_one();
+}
+
+/// Called when one unit of work under `node` is done. The last one to finish removes the directory and propagates upwards,
+/// which is how directories get removed bottom-up without a separate pass.
+static
+void permanent_delete_complete(permanent_delete_state &state, permanent_delete_node *node) noexcept
+{
+    while (node != state.root && node->num_outstanding.fetch_sub(1) == 1) {
+        bool deleted = false;
+
+        if (!state.cancelled.load() && !node->any_child_failed.load()) {
+            deleted = permanent_delete_entry(node->path_utf16, true);
+
+            if (deleted) {
+                state.num_deleted.fetch_add(1);
+            } else {
+                state.num_failed.fetch_add(1);
+                print_debug_msg("FAILED permanent_delete_entry, %s", get_last_winapi_error().formatted_message.c_str());
+            }
+        }
+
+        if (!deleted) {
+            node->parent->any_child_failed.store(true);
+        }
+        else if (node->parent == state.root) {
+            permanent_delete_record(state, node->path_utf16, basic_dirent::kind::directory);
+        }
+
+        node = node->parent;
+    }
+}
+
+static
+void permanent_delete_items(permanent_delete_state &state, permanent_delete_node *dir, std::vector<permanent_delete_task::item> const &items) noexcept
+{
+    std::wstring full_path_utf16 = {};
+
+    for (auto const &item : items) {
+        if (state.cancelled.load()) {
+            return;
+        }
+
+        full_path_utf16 = dir->path_utf16;
+        full_path_utf16 += L'\\';
+        full_path_utf16 += item.name_utf16;
+
+        if (permanent_delete_entry(full_path_utf16, item.directory)) {
+            state.num_deleted.fetch_add(1);
+
+            if (dir == state.root) {
+                permanent_delete_record(state, full_path_utf16, item.directory ? basic_dirent::kind::symlink_to_directory : basic_dirent::kind::file);
+            }
+        } else {
+            state.num_failed.fetch_add(1);
+            dir->any_child_failed.store(true);
+        }
+    }
+}
+
+static
+void permanent_delete_scan(permanent_delete_state &state, permanent_delete_node *dir) noexcept
+{
+    constexpr u64 batch_size = 256; // files per task, lets several workers unlink the contents of one huge directory
+
+    std::wstring search_path_utf16 = dir->path_utf16 + L"\\*";
+
+    WIN32_FIND_DATAW find_data;
+    HANDLE find_handle = FindFirstFileExW(search_path_utf16.c_str(), FindExInfoBasic, &find_data, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+
+    if (find_handle == INVALID_HANDLE_VALUE) {
+        state.num_failed.fetch_add(1);
+        dir->any_child_failed.store(true);
+        return;
+    }
+    SCOPE_EXIT { FindClose(find_handle); };
+
+    std::vector<permanent_delete_task::item> batch = {};
+
+    do {
+        if (wcscmp(find_data.cFileName, L".") == 0 || wcscmp(find_data.cFileName, L"..") == 0) {
+            continue;
+        }
+
+        state.num_discovered.fetch_add(1);
+
+        bool directory = find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY;
+        bool reparse_point = find_data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT;
+
+        if (directory && !reparse_point) {
+            permanent_delete_node *child;
+            {
+                std::scoped_lock lock(state.mutex);
+                child = &state.nodes.emplace_back();
+            }
+            child->path_utf16 = dir->path_utf16 + L'\\' + find_data.cFileName;
+            child->parent = dir;
+            child->num_outstanding.store(1); // its own scan
+
+            dir->num_outstanding.fetch_add(1); // `child` is one unit of work under `dir` until it is removed
+            permanent_delete_enqueue(state, { child, {} });
+        }
+        else {
+            batch.push_back({ find_data.cFileName, directory });
+
+            if (batch.size() == batch_size) {
+                dir->num_outstanding.fetch_add(1);
+                permanent_delete_enqueue(state, { dir, std::move(batch) });
+                batch = {};
+            }
+        }
+    }
+    while (FindNextFileW(find_handle, &find_data) && !state.cancelled.load());
+
+    // the remainder is handled here rather than paying for another trip through the queue
+    permanent_delete_items(state, dir, batch);
+}
+
+static
+void permanent_delete_worker(permanent_delete_state &state) noexcept
+{
+    while (true) {
+        permanent_delete_task task;
+        {
+            std::unique_lock lock(state.mutex);
+            state.cond.wait(lock, [&]() noexcept { return !state.pending.empty() || state.num_in_flight == 0; });
+
+            if (state.pending.empty()) {
+                return;
+            }
+            // LIFO keeps the walk depth-first, so directories are finished (and their nodes idle) as early as possible
+            task = std::move(state.pending.back());
+            state.pending.pop_back();
+        }
+
+        if (!state.cancelled.load()) {
+            if (task.items.empty()) {
+                permanent_delete_scan(state, task.dir);
+            } else {
+                permanent_delete_items(state, task.dir, task.items);
+            }
+        }
+
+        permanent_delete_complete(state, task.dir);
+
+        u64 work_total = std::min(state.num_discovered.load(), u64(UINT_MAX));
+        u64 work_so_far = std::min(state.num_deleted.load() + state.num_failed.load(), u64(UINT_MAX));
+
+        if (FAILED(state.prog_sink->UpdateProgress(UINT(work_total), UINT(work_so_far)))) {
+            state.cancelled.store(true);
+        }
+
+        bool walk_over;
+        {
+            std::scoped_lock lock(state.mutex);
+            walk_over = --state.num_in_flight == 0;
+        }
+        if (walk_over) {
+            state.cond.notify_all();
+        }
+    }
+}
+
+/// Permanently deletes files and directory trees without going through IFileOperation, which is very slow for trees with many entries.
+/// Directories are scanned and their files unlinked by several workers, directories are removed bottom-up as they empty.
+/// Only top level items are recorded as completed file operations. Recycle bin deletes still go through IFileOperation.
+/// @param working_directory_utf16 Directory containing the items to delete.
+/// @param paths_to_delete_utf16 Newline separated names of the items to delete, relative to `working_directory_utf16`.
+void perform_permanent_delete(
+    std::wstring working_directory_utf16,
+    std::wstring paths_to_delete_utf16,
+    std::mutex *init_done_mutex,
+    std::condition_variable *init_done_cond,
+    bool *init_done,
+    std::string *init_error,
+    char dir_sep_utf8,
+    s32 num_max_file_operations) noexcept
+{
+    SWAN_PROFILE_FUNCTION();
+    ++global_state::foreground_io_count();
+    SCOPE_EXIT { --global_state::foreground_io_count(); };
+    assert(!working_directory_utf16.empty());
+
+    auto set_init_error_and_notify = [&](std::string const &err) noexcept {
+        std::unique_lock lock(*init_done_mutex);
+        *init_done = true;
+        *init_error = err;
+        init_done_cond->notify_one();
+    };
+
+    file_operation_progress &progress = global_state::permanent_delete_progress();
+    {
+        bool expected = false;
+        if (!progress.active.compare_exchange_strong(expected, true)) {
+            return set_init_error_and_notify("Another permanent delete is still in progress.");
+        }
+    }
+    SCOPE_EXIT { progress.active.store(false); };
+
+    progress.work_total.store(0);
+    progress.work_so_far.store(0);
+    progress.num_failed.store(0);
+    progress.cancellation_token.store(false);
+
+    std::replace(working_directory_utf16.begin(), working_directory_utf16.end(), L'/', L'\\');
+    if (working_directory_utf16.back() == L'\\') {
+        working_directory_utf16.pop_back();
+    }
+
+    explorer_file_op_progress_sink prog_sink = {};
+    prog_sink.contains_delete_operations = true;
+    prog_sink.dst_expl_id = -1;
+    prog_sink.dst_expl_cwd_when_operation_started = path_create("");
+    prog_sink.dir_sep_utf8 = dir_sep_utf8;
+    prog_sink.num_max_file_operations = num_max_file_operations;
+    prog_sink.verify_copies = false;
+    prog_sink.progress = &progress;
+
+    permanent_delete_state state = {};
+    state.prog_sink = &prog_sink;
+    state.root = &state.nodes.emplace_back();
+    state.root->path_utf16 = working_directory_utf16;
+    state.root->parent = nullptr;
+
+    {
+        auto items_to_delete = std::wstring_view(paths_to_delete_utf16.data()) | std::ranges::views::split('\n');
+        std::stringstream err = {};
+        std::vector<permanent_delete_task::item> top_level_items = {};
+        std::wstring full_path_utf16 = {};
+
+        for (auto item_utf16 : items_to_delete) {
+            std::wstring_view name_utf16(item_utf16.begin(), item_utf16.end());
+            if (name_utf16.empty()) {
+                continue;
+            }
+
+            full_path_utf16 = working_directory_utf16;
+            full_path_utf16 += L'\\';
+            full_path_utf16 += name_utf16;
+
+            DWORD attributes = GetFileAttributesW(full_path_utf16.c_str());
+
+            if (attributes == INVALID_FILE_ATTRIBUTES) {
+                swan_path item_path_utf8 = path_create("");
+
+                if (!utf16_to_utf8(full_path_utf16.c_str(), item_path_utf8.data(), item_path_utf8.size())) {
+                    err << "GetFileAttributesW and conversion of delete path from UTF-16 to UTF-8.\n";
+                } else {
+                    err << "File or directory is not accessible, maybe it is locked or has been moved/deleted? [" << item_path_utf8.data() << "]\n";
+                }
+                continue;
+            }
+
+            state.num_discovered.fetch_add(1);
+
+            bool directory = attributes & FILE_ATTRIBUTE_DIRECTORY;
+            bool reparse_point = attributes & FILE_ATTRIBUTE_REPARSE_POINT;
+
+            if (directory && !reparse_point) {
+                permanent_delete_node *node = &state.nodes.emplace_back();
+                node->path_utf16 = full_path_utf16;
+                node->parent = state.root;
+                node->num_outstanding.store(1);
+
+                permanent_delete_enqueue(state, { node, {} });
+            } else {
+                top_level_items.push_back({ std::wstring(name_utf16), directory });
+            }
+        }
+
+        std::string errors = err.str();
+        if (!errors.empty()) {
+            errors.pop_back(); // remove trailing '\n'
+            return set_init_error_and_notify(errors);
+        }
+
+        if (!top_level_items.empty()) {
+            permanent_delete_enqueue(state, { state.root, std::move(top_level_items) });
+        }
+
+        prog_sink.group_id = global_state::completed_file_operations_next_group_id();
+    }
+
+    set_init_error_and_notify(""); // init succeeded, no error
+
+    (void) prog_sink.StartOperations();
+
+    (void) run_parallel_workers(parallel_worker_count(), [&state](u64) noexcept { permanent_delete_worker(state); });
+
+    progress.num_failed.store(state.num_failed.load());
+
+    print_debug_msg("permanent delete: %zu deleted, %zu failed, %zu discovered, cancelled = %d",
+                    state.num_deleted.load(), state.num_failed.load(), state.num_discovered.load(), state.cancelled.load());
+
+    (void) prog_sink.FinishOperations(S_OK);
+}
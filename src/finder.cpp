@@ -2,139 +2,28 @@
 #include "data_types.hpp"
 #include "common_functions.hpp"
 #include "imgui_dependent_functions.hpp"
+#include "platform.hpp"
 
 namespace swan_finder
 {
     static swan_thread_pool_t g_thread_pool(1);
 }
 
-void traverse_directory_recursively(swan_path const &directory_path_utf8,
-                                    std::atomic<u64> &num_entries_checked,
-                                    progressive_task<std::vector<finder_window::match>> &search_task,
-                                    char const *search_value,
-                                    u64 search_value_len) noexcept
-{
-    wchar_t search_path_utf16[MAX_PATH];
-
-    if (!utf8_to_utf16(directory_path_utf8.data(), search_path_utf16, lengthof(search_path_utf16))) {
-        return;
-    }
-
-    if (search_path_utf16[wcslen(search_path_utf16) - 1] != L'\\') {
-        (void) StrCatW(search_path_utf16, L"\\");
-    }
-    (void) StrCatW(search_path_utf16, L"*");
-
-    WIN32_FIND_DATAW find_data;
-    HANDLE find_handle = FindFirstFileW(search_path_utf16, &find_data);
-    SCOPE_EXIT { FindClose(find_handle); };
-
-    if (find_handle == INVALID_HANDLE_VALUE) {
-        print_debug_msg("find_handle == INVALID_HANDLE_VALUE [%s]", directory_path_utf8.data());
-        return;
-    }
-
-    do {
-        if (search_task.cancellation_token.load() == true) {
-            return;
-        }
-
-        swan_path found_file_name = path_create("");
-
-        if (!utf16_to_utf8(find_data.cFileName, found_file_name.data(), found_file_name.size())) {
-            continue;
-        }
-
-        if (path_equals_exactly(found_file_name, ".") || path_equals_exactly(found_file_name, "..")) {
-            continue;
-        }
-
-        u64 num_entries_checked_ = num_entries_checked++;
-
-        bool is_directory = find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY;
-
-        char const *found_substr = strstr(found_file_name.data(), search_value);
-
-        finder_window::match match = {};
-
-        if (found_substr) {
-            match.highlight_start_idx = found_substr - found_file_name.data();
-            match.highlight_len = search_value_len;
-
-            match.basic.id = (u32)num_entries_checked_;
-            match.basic.size = two_u32_to_one_u64(find_data.nFileSizeLow, find_data.nFileSizeHigh);
-            match.basic.creation_time_raw = find_data.ftCreationTime;
-            match.basic.last_write_time_raw = find_data.ftLastWriteTime;
-
-            match.basic.path = directory_path_utf8;
-            if (!path_append(match.basic.path, found_file_name.data(), L'\\', true)) {
-                continue;
-            }
-
-            if (is_directory) {
-                match.basic.type = basic_dirent::kind::directory;
-            }
-            else if (path_ends_with(match.basic.path, ".lnk")) {
-                match.basic.type = basic_dirent::kind::symlink_ambiguous;
-
-                // TODO:
-            #if 0
-                if (finder.detailed_symlinks) {
-                    match.basic.type = basic_dirent::kind::invalid_symlink; // default value, if something fails below
-
-                    static std::wstring full_path_utf16 = {};
-                    full_path_utf16.clear();
-                    full_path_utf16.append(search_path_utf16);
-                    full_path_utf16.pop_back(); // remove '*'
-                    full_path_utf16.append(find_data.cFileName);
-
-                    // Load the shortcut
-                    HRESULT com_handle = s_persist_file_interface->Load(full_path_utf16.c_str(), STGM_READ);
-                    if (FAILED(com_handle)) {
-                        WCOUT_IF_DEBUG("FAILED IPersistFile::Load [" << full_path_utf16.c_str() << "]\n");
-                    }
-                    else {
-                        // Get the target path
-                        wchar_t target_path_utf16[MAX_PATH];
-                        com_handle = s_shell_link->GetPath(target_path_utf16, lengthof(target_path_utf16), NULL, SLGP_RAWPATH);
-                        if (FAILED(com_handle)) {
-                            WCOUT_IF_DEBUG("FAILED IShellLinkW::GetPath [" << full_path_utf16.c_str() << "]\n");
-                        }
-                        else {
-                            if      (PathIsDirectoryW(target_path_utf16)) entry.basic.type = basic_dirent::kind::symlink_to_directory;
-                            else if (PathFileExistsW(target_path_utf16))  entry.basic.type = basic_dirent::kind::symlink_to_file;
-                            else                                          entry.basic.type = basic_dirent::kind::invalid_symlink;
-                        }
-                    }
-                }
-            #endif
-            }
-            else {
-                match.basic.type = basic_dirent::kind::file;
-            }
-
-            std::scoped_lock lock(search_task.result_mutex);
-            search_task.result.push_back(match);
-        }
-
-        if (is_directory) {
-            swan_path sub_directory_utf8 = directory_path_utf8;
-            if (!path_append(sub_directory_utf8, found_file_name.data(), '\\', true, true)) {
-                return;
-            }
-            traverse_directory_recursively(sub_directory_utf8, num_entries_checked, search_task, search_value, search_value_len);
-        }
-    }
-    while (FindNextFileW(find_handle, &find_data));
-}
-
 void search_proc(progressive_task<std::vector<finder_window::match>> &search_task,
                  std::vector<finder_window::search_directory> search_directories,
                  std::atomic<u64> &num_entries_checked,
-                 std::array<char, 1024> search_value) noexcept
+                 std::array<char, 1024> search_value,
+                 bool detailed_symlinks) noexcept
 {
+    SWAN_PROFILE_THREAD_NAME("finder");
+    SWAN_PROFILE_FUNCTION();
+    ++global_state::foreground_io_count();
+    SCOPE_EXIT { --global_state::foreground_io_count(); };
     search_task.active_token.store(true);
-    SCOPE_EXIT { search_task.active_token.store(false); };
+    SCOPE_EXIT {
+        search_task.active_token.store(false);
+        global_state::wake_render_loop();
+    };
 
     u64 search_value_len = strlen(search_value.data());
 
@@ -142,7 +31,8 @@ void search_proc(progressive_task<std::vector<finder_window::match>> &search_tas
         swan_path search_dir_path_ut8_normalized = search_dir.path_utf8;
         path_force_separator(search_dir_path_ut8_normalized, L'\\');
 
-        traverse_directory_recursively(search_dir_path_ut8_normalized, num_entries_checked, search_task, search_value.data(), search_value_len);
+        traverse_directory_recursively(search_dir_path_ut8_normalized, num_entries_checked, search_task, search_value.data(), search_value_len, detailed_symlinks,
+                                       { global_state::wake_render_loop, shortcut_kind_resolve });
     }
 }
 
@@ -241,7 +131,7 @@ bool swan_windows::render_finder(finder_window &finder, bool &open, [[maybe_unus
                 finder.num_entries_checked.store(0);
 
                 swan_finder::g_thread_pool.push_task([&finder]() {
-                    search_proc(std::ref(finder.search_task), finder.search_directories, std::ref(finder.num_entries_checked), finder.search_value);
+                    search_proc(std::ref(finder.search_task), finder.search_directories, std::ref(finder.num_entries_checked), finder.search_value, finder.detailed_symlinks);
                 });
             }
         }
@@ -271,7 +161,7 @@ bool swan_windows::render_finder(finder_window &finder, bool &open, [[maybe_unus
             finder.num_entries_checked.store(0);
 
             swan_finder::g_thread_pool.push_task([&finder]() {
-                search_proc(std::ref(finder.search_task), finder.search_directories, std::ref(finder.num_entries_checked), finder.search_value);
+                search_proc(std::ref(finder.search_task), finder.search_directories, std::ref(finder.num_entries_checked), finder.search_value, finder.detailed_symlinks);
             });
         }
     }
@@ -292,6 +182,20 @@ bool swan_windows::render_finder(finder_window &finder, bool &open, [[maybe_unus
         // imgui::SetTooltip("Case sensitive: %s\n", expl.filter_case_sensitive ? "ON" : "OFF");
     }
 
+    imgui::SameLine();
+
+    {
+        imgui::ScopedDisable d(search_active);
+        imgui::ScopedStyle<f32> s(imgui::GetStyle().Alpha, finder.detailed_symlinks ? 1 : imgui::GetStyle().DisabledAlpha);
+
+        if (imgui::Button(ICON_LC_LINK_2 "## finder detailed_symlinks")) {
+            flip_bool(finder.detailed_symlinks);
+        }
+    }
+    if (imgui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+        imgui::SetTooltip("Classify shortcuts by target: %s\n(slower, loads every .lnk file found)", finder.detailed_symlinks ? "ON" : "OFF");
+    }
+
     {
         u64 num_entries_checked = finder.num_entries_checked.load();
         if (num_entries_checked > 0) {
@@ -0,0 +1,86 @@
+#include "core.hpp"
+#if !SWAN_HEADLESS
+#   include "imgui_dependent_functions.hpp"
+#endif
+
+void traverse_directory_recursively(swan_path const &directory_path_utf8,
+                                    std::atomic<u64> &num_entries_checked,
+                                    progressive_task<std::vector<finder_match>> &search_task,
+                                    char const *search_value,
+                                    u64 search_value_len,
+                                    bool detailed_symlinks,
+                                    finder_traversal_hooks const &hooks) noexcept
+{
+    SWAN_PROFILE_FUNCTION();
+
+    platform_directory_enumerator enumerator;
+    platform_dirent entry;
+
+    if (auto result = enumerator.open(directory_path_utf8.data()); !result.ok()) {
+        print_debug_msg("FAILED platform_directory_enumerator::open [%s] %s", directory_path_utf8.data(), platform_error_string(result.error_code).c_str());
+        return;
+    }
+
+    while (enumerator.next(entry)) {
+        if (search_task.cancellation_token.load() == true) {
+            return;
+        }
+
+        swan_path found_file_name = path_create(entry.name);
+
+        u64 num_entries_checked_ = num_entries_checked++;
+
+        if (num_entries_checked_ % 1024 == 0 && hooks.progress) {
+            hooks.progress(); // progress display
+        }
+
+        bool is_directory = entry.info.kind == platform_file_kind::directory || entry.info.kind == platform_file_kind::symlink_to_directory;
+
+        char const *found_substr = platform_find_substring(found_file_name.data(), search_value, true);
+
+        finder_match match = {};
+
+        if (found_substr) {
+            match.highlight_start_idx = found_substr - found_file_name.data();
+            match.highlight_len = search_value_len;
+
+            match.basic.id = (u32)num_entries_checked_;
+            match.basic.size = entry.info.size;
+            match.basic.creation_time_raw = entry.info.creation_time;
+            match.basic.last_write_time_raw = entry.info.last_write_time;
+
+            match.basic.path = directory_path_utf8;
+            if (!path_append(match.basic.path, found_file_name.data(), PLATFORM_DIR_SEPARATOR, true)) {
+                continue;
+            }
+
+            if (is_directory) {
+                match.basic.type = basic_dirent::kind::directory;
+            }
+            else if (path_ends_with(match.basic.path, ".lnk")) {
+                // already off the main thread, so resolving here only costs the search some time
+                match.basic.type = detailed_symlinks && hooks.resolve_shortcut ? hooks.resolve_shortcut(match.basic.path.data(), entry.info.last_write_time)
+                                                                               : basic_dirent::kind::symlink_ambiguous;
+            }
+            else {
+                match.basic.type = basic_dirent::kind::file;
+            }
+
+            {
+                std::scoped_lock lock(search_task.result_mutex);
+                search_task.result.push_back(match);
+            }
+            if (hooks.progress) {
+                hooks.progress();
+            }
+        }
+
+        if (is_directory) {
+            swan_path sub_directory_utf8 = directory_path_utf8;
+            if (!path_append(sub_directory_utf8, found_file_name.data(), PLATFORM_DIR_SEPARATOR, true, true)) {
+                return;
+            }
+            traverse_directory_recursively(sub_directory_utf8, num_entries_checked, search_task, search_value, search_value_len, detailed_symlinks, hooks);
+        }
+    }
+}
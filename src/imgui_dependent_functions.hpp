@@ -97,6 +97,7 @@ struct debug_log
 template <typename... Args>
 void print_debug_msg([[maybe_unused]] debug_log pack, [[maybe_unused]] Args&&... args) noexcept
 {
+    SWAN_PROFILE_FUNCTION();
     // https://stackoverflow.com/questions/57547273/how-to-use-source-location-in-a-variadic-template-function
 
     if (!debug_log::g_logging_enabled) {
@@ -106,7 +107,7 @@ void print_debug_msg([[maybe_unused]] debug_log pack, [[maybe_unused]] Args&&...
     u64 max_size = global_state::debug_log_size_limit_megabytes() * 1024 * 1024;
 
     auto formatted_message = make_str_static<4096>(pack.fmt, args...);
-    f64 imgui_time = imgui::GetTime();
+    f64 imgui_time = imgui::GetCurrentContext() ? imgui::GetTime() : 0; // messages may come from worker threads before the context exists
     s32 thread_id = GetCurrentThreadId();
     time_point_system_t system_time = get_time_system();
 
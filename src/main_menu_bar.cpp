@@ -114,6 +114,7 @@ void render_main_menu_bar(GLFWwindow *window, std::array<explorer_window, global
             // setting_change |= imgui::MenuItem(swan_windows::get_name(swan_windows::id::pinned), nullptr, &global_state::settings().show.pinned);
             setting_change |= imgui::MenuItem(swan_windows::get_name(swan_windows::id::file_operations), nullptr, &global_state::settings().show.file_operations);
             setting_change |= imgui::MenuItem(swan_windows::get_name(swan_windows::id::recent_files), nullptr, &global_state::settings().show.recent_files);
+            setting_change |= imgui::MenuItem(swan_windows::get_name(swan_windows::id::disk_usage), nullptr, &global_state::settings().show.disk_usage);
             setting_change |= imgui::MenuItem(swan_windows::get_name(swan_windows::id::analytics), nullptr, &global_state::settings().show.analytics);
             setting_change |= imgui::MenuItem(swan_windows::get_name(swan_windows::id::settings), nullptr, &global_state::settings().show.settings);
 
@@ -262,6 +263,15 @@ void render_main_menu_bar(GLFWwindow *window, std::array<explorer_window, global
 
             imgui::EndMenu();
         }
+        if (imgui::BeginMenu("[Tools]")) {
+            if (imgui::MenuItem(ICON_CI_MIRROR " Mirror Explorer 1 into Explorer 2")) {
+                swan_popup_modals::open_mirror(0, 1);
+            }
+            if (imgui::MenuItem(ICON_CI_MIRROR " Mirror Explorer 2 into Explorer 1")) {
+                swan_popup_modals::open_mirror(1, 0);
+            }
+            imgui::EndMenu();
+        }
 
         if (!global_state::file_op_cmd_buf().items.empty()) {
             imgui::ScopedStyle<f32> fpy2(imgui::GetStyle().FramePadding.y, fpy.m_original_value * .5f);
@@ -289,7 +299,7 @@ void render_main_menu_bar(GLFWwindow *window, std::array<explorer_window, global
         }
 
         if (setting_change) {
-            (void) global_state::settings().save_to_disk();
+            global_state::mark_dirty(persisted_file::settings);
         }
 
         imgui::EndMainMenuBar();
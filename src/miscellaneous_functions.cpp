@@ -4,56 +4,6 @@
 #include "imgui_dependent_functions.hpp"
 #include "path.hpp"
 
-std::initializer_list<basic_dirent::kind> const symlink_types = {
-    basic_dirent::kind::symlink_to_directory,
-    basic_dirent::kind::symlink_to_file,
-    basic_dirent::kind::symlink_ambiguous,
-    basic_dirent::kind::invalid_symlink
-};
-
-bool basic_dirent::is_path_dotdot()          const noexcept { return path_equals_exactly(path, ".."); }
-bool basic_dirent::is_dotdot_dir()           const noexcept { return type == kind::directory && path_equals_exactly(path, ".."); }
-bool basic_dirent::is_directory()            const noexcept { return type == kind::directory; }
-bool basic_dirent::is_symlink()              const noexcept { return one_of(type, symlink_types); }
-bool basic_dirent::is_symlink_to_file()      const noexcept { return type == kind::symlink_to_file; }
-bool basic_dirent::is_symlink_to_directory() const noexcept { return type == kind::symlink_to_directory; }
-bool basic_dirent::is_symlink_ambiguous()    const noexcept { return type == kind::symlink_ambiguous; }
-bool basic_dirent::is_file()                 const noexcept { return type == kind::file; }
-
-bool basic_dirent::is_symlink(kind t) noexcept { return one_of(t, symlink_types); }
-
-char const *basic_dirent::kind_cstr() const noexcept
-{
-    assert(this->type >= basic_dirent::kind::nil && this->type <= basic_dirent::kind::count);
-
-    switch (this->type) {
-        case basic_dirent::kind::directory:            return "directory";
-        case basic_dirent::kind::file:                 return "file";
-        case basic_dirent::kind::symlink_to_directory: return "symlink_to_directory";
-        case basic_dirent::kind::symlink_to_file:      return "symlink_to_file";
-        case basic_dirent::kind::symlink_ambiguous:    return "symlink_ambiguous";
-        case basic_dirent::kind::invalid_symlink:      return "invalid_symlink";
-        default: return "";
-    }
-}
-
-char const *basic_dirent::kind_description(basic_dirent::kind t) noexcept
-{
-    assert(t >= basic_dirent::kind::nil && t <= basic_dirent::kind::count);
-
-    switch (t) {
-        case basic_dirent::kind::nil:                  return "(Nil)";
-        case basic_dirent::kind::directory:            return "Directory";
-        case basic_dirent::kind::file:                 return "File";
-        case basic_dirent::kind::symlink_to_directory: return "Directory Link";
-        case basic_dirent::kind::symlink_to_file:      return "File Link";
-        case basic_dirent::kind::symlink_ambiguous:    return "Link";
-        case basic_dirent::kind::invalid_symlink:      return "Invalid Link";
-        case basic_dirent::kind::count:                return "(Count)";
-        default: return "";
-    }
-}
-
 char const *basic_dirent::kind_short_cstr() const noexcept
 {
     assert(this->type >= basic_dirent::kind::nil && this->type <= basic_dirent::kind::count);
@@ -722,6 +672,7 @@ ImVec4 compute_drive_usage_color(f32 fraction_used) noexcept
 
 std::pair<s64, ImVec2> load_icon_texture(char const *full_path_utf8, wchar_t const *full_path_utf16_provided, char const *debug_label) noexcept
 {
+    SWAN_PROFILE_FUNCTION();
     assert((full_path_utf8 || full_path_utf16_provided) && "Provide at least one parameter!");
 
     if (debug_label) print_debug_msg("load_icon_texture %s", debug_label);
@@ -808,14 +759,13 @@ void open_file_properties(char const *full_path_utf8) noexcept
 
 bool window_render_order_save_to_disk(std::array<swan_windows::id, (u64)swan_windows::id::count - 1> data) noexcept
 try {
-    std::filesystem::path full_path = global_state::execution_path() / "data\\window_render_order.txt";
-    std::ofstream iss(full_path);
-    if (!iss) return false;
+    std::ostringstream out;
 
     for (auto const &id : data) {
-        iss << (s32)id << ' ' << swan_windows::get_name(id) << '\n'; // include name for debugging
+        out << (s32)id << ' ' << swan_windows::get_name(id) << '\n'; // include name for debugging
     }
-    print_debug_msg("SUCCESS");
+
+    persistence_write(global_state::execution_path() / "data\\window_render_order.txt", std::move(out).str());
     return true;
 }
 catch (std::exception const &except) {
@@ -849,6 +799,7 @@ std::array<swan_windows::id, (u64)swan_windows::id::count - 1> window_render_ord
         swan_windows::id::icon_library,
         swan_windows::id::imgui_demo,
         swan_windows::id::imspinner_demo,
+        swan_windows::id::disk_usage,
     };
     try {
         std::filesystem::path full_path = global_state::execution_path() / "data\\window_render_order.txt";
@@ -9,6 +9,11 @@ namespace swan
     static std::filesystem::path    g_execution_path = {};
     static HWND                     g_hwnd = {};
     static std::vector<s64>         g_delete_icon_textures_queue = {};
+    static startup_timings          g_startup_timings = {};
+    static render_loop_stats        g_render_loop_stats = {};
+    static std::atomic_bool         g_render_loop_wake_pending = false;
+    static directory_listing_cache  g_directory_listing_cache = {};
+    static std::mutex               g_directory_listing_cache_mutex = {};
 };
 
 s32 &global_state::page_size() noexcept { return swan::g_page_size; }
@@ -22,3 +27,24 @@ std::filesystem::path &global_state::execution_path() noexcept { return swan::g_
 HWND &global_state::window_handle() noexcept { return swan::g_hwnd; }
 
 std::vector<s64> &global_state::delete_icon_textures_queue() noexcept { return swan::g_delete_icon_textures_queue; };
+
+startup_timings &global_state::startup_timings_get() noexcept { return swan::g_startup_timings; }
+
+render_loop_stats &global_state::render_loop_stats_get() noexcept { return swan::g_render_loop_stats; }
+
+global_state::listing_cache global_state::listing_cache_get() noexcept { return { &swan::g_directory_listing_cache, &swan::g_directory_listing_cache_mutex }; }
+
+/// Callable from any thread. Makes the render loop render a few frames even if it is idle, waiting for input.
+/// Wakes requested before the loop gets around to it collapse into one, so workers needn't throttle their calls.
+void global_state::wake_render_loop() noexcept
+{
+    if (!swan::g_render_loop_wake_pending.exchange(true)) {
+        glfwPostEmptyEvent();
+    }
+}
+
+/// For the render loop, whether `wake_render_loop` was called since the previous call.
+bool global_state::render_loop_consume_wake() noexcept
+{
+    return swan::g_render_loop_wake_pending.exchange(false);
+}
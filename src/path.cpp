@@ -1,5 +1,25 @@
-#include "stdafx.hpp"
-#include "path.hpp"
+#include <filesystem>
+
+#if defined(_WIN32)
+#   define NOMINMAX
+#   include <windows.h>
+#   include <shlwapi.h>
+#else
+#   include <strings.h>
+#endif
+
+#include "core.hpp"
+
+/// ASCII case insensitive comparison of the first `count` chars, like StrCmpNIA.
+static
+bool path_ascii_same_ignoring_case(char const *p1, char const *p2, u64 count) noexcept
+{
+#if defined(_WIN32)
+    return StrCmpNIA(p1, p2, (s32)count) == 0;
+#else
+    return strncasecmp(p1, p2, count) == 0;
+#endif
+}
 
 swan_path path_create(char const *data, u64 count) noexcept
 {
@@ -35,6 +55,75 @@ bool path_equals_exactly(swan_path const &p1, swan_path const &p2) noexcept
     return strcmp(p1.data(), p2.data()) == 0;
 }
 
+char fold_path_char(char ch) noexcept
+{
+    if (ch >= 'A' && ch <= 'Z') return char(ch - 'A' + 'a');
+    if (ch == '/') return '\\';
+    return ch;
+}
+
+u64 path_loose_hash(char const *path, u64 len) noexcept
+{
+    if (len == u64(-1)) {
+        len = strlen(path);
+    }
+    while (len > 0 && strchr("\\/", path[len-1])) {
+        --len;
+    }
+
+    u64 hash = 14695981039346656037ull; // FNV-1a
+    for (u64 i = 0; i < len; ++i) {
+        hash ^= u8(fold_path_char(path[i]));
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+u64 path_loose_hash_prefixes(char const *path, u64 *hashes, u64 *lens, u64 capacity) noexcept
+{
+    u64 count = 0;
+    u64 hash = 14695981039346656037ull; // FNV-1a, as `path_loose_hash`
+    u64 i = 0;
+
+    auto is_separator = [](char ch) noexcept { return ch == '\\' || ch == '/'; };
+
+    for (; path[i] != '\0'; ++i) {
+        // the hash so far is that of the prefix, which ends in no separator `path_loose_hash` would drop
+        if (is_separator(path[i]) && i > 0 && !is_separator(path[i-1]) && count < capacity) {
+            hashes[count] = hash;
+            lens[count] = i;
+            ++count;
+        }
+        hash ^= u8(fold_path_char(path[i]));
+        hash *= 1099511628211ull;
+    }
+
+    if (i > 0 && !is_separator(path[i-1]) && count < capacity) {
+        hashes[count] = hash;
+        lens[count] = i;
+        ++count;
+    }
+
+    return count;
+}
+
+bool path_loosely_inside(char const *path, char const *dir, u64 dir_len) noexcept
+{
+    if (dir_len == u64(-1)) {
+        dir_len = strlen(dir);
+    }
+    while (dir_len > 0 && strchr("\\/", dir[dir_len-1])) {
+        --dir_len;
+    }
+
+    for (u64 i = 0; i < dir_len; ++i) {
+        if (path[i] == '\0' || fold_path_char(path[i]) != fold_path_char(dir[i])) {
+            return false;
+        }
+    }
+    return dir_len > 0 && (path[dir_len] == '\\' || path[dir_len] == '/') && path[dir_len + 1] != '\0';
+}
+
 char path_pop_back(swan_path &path) noexcept
 {
     u64 len = path_length(path);
@@ -197,10 +286,10 @@ bool path_loosely_same(char const *p1, char const *p2, u64 p1_len, u64 p2_len) n
     assert(len_diff >= 0);
 
     if (len_diff == 0) {
-        return StrCmpNIA(p1, p2, (s32)std::min(p1_len, p2_len)) == 0;
+        return path_ascii_same_ignoring_case(p1, p2, std::min(p1_len, p2_len));
     }
     else {
-        bool same_beginning = StrCmpNIA(p1, p2, (s32)std::min(p1_len, p2_len)) == 0;
+        bool same_beginning = path_ascii_same_ignoring_case(p1, p2, std::min(p1_len, p2_len));
         bool all_rest_are_separators = {};
 
         if (p1_len > p2_len) { // p1 is longer one
@@ -1,7 +1,6 @@
 #pragma once
 
-#include "stdafx.hpp"
-#include "data_types.hpp"
+#include "primitives.hpp"
 
 struct swan_path; // Microsoft IntelliSense generates nonsensical errors without this declaration, despite the compiler not complaining.
 
@@ -40,6 +39,19 @@ bool path_loosely_same(char const *p1, char const *p2, u64 p1_len = u64(-1), u64
 
 bool path_equals_exactly(swan_path const &p1, swan_path const &p2) noexcept;
 
+/// ASCII lowercase, with '/' folded into '\\'. The normalization `path_loose_hash` and `path_loosely_inside` compare under.
+char fold_path_char(char ch) noexcept;
+
+/// Hash which ignores what `path_loosely_same` ignores (ASCII case, trailing separators), and treats '/' and '\\' as equal.
+u64 path_loose_hash(char const *path, u64 len = u64(-1)) noexcept;
+
+/// Whether `path` is inside directory `dir` (at any depth), compared like `path_loose_hash`.
+bool path_loosely_inside(char const *path, char const *dir, u64 dir_len = u64(-1)) noexcept;
+
+/// The `path_loose_hash` of each directory `path` is inside, outermost first, then of `path` itself, in one pass over `path`.
+/// Writes up to `capacity` hashes and the lengths of the prefixes they hash, returns how many.
+u64 path_loose_hash_prefixes(char const *path, u64 *hashes, u64 *lens, u64 capacity) noexcept;
+
 bool path_equals_exactly(swan_path const &p1, char const *p2) noexcept;
 
 swan_path path_squish_adjacent_separators(swan_path const &path) noexcept;
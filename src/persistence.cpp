@@ -0,0 +1,188 @@
+#include "stdafx.hpp"
+#include "data_types.hpp"
+#include "common_functions.hpp"
+#include "util.hpp"
+
+/// A dirty file is written once it has been left alone for this long...
+static s64 const PERSISTENCE_DEBOUNCE_MS = 250;
+/// ...or this long after it was first marked, if it keeps changing (e.g. while the window is being dragged around).
+static s64 const PERSISTENCE_MAX_DELAY_MS = 2000;
+
+struct persistence_dirty_state
+{
+    time_point_precise_t first_marked = {};
+    time_point_precise_t last_marked = {};
+    bool dirty = false;
+};
+
+struct persistence_write_request
+{
+    std::filesystem::path full_path;
+    std::string content;
+    bool append;
+};
+
+static std::mutex g_persistence_mutex = {};
+static std::condition_variable g_persistence_idle_cond = {};
+static std::array<persistence_dirty_state, (u64)persisted_file::count> g_persistence_dirty = {};
+static std::vector<persistence_write_request> g_persistence_pending_writes = {}; // at most one per file
+static bool g_persistence_writer_scheduled = false;
+
+void global_state::mark_dirty(persisted_file file) noexcept
+{
+    auto now = get_time_precise();
+
+    std::scoped_lock lock(g_persistence_mutex);
+
+    auto &state = g_persistence_dirty[(u64)file];
+    if (!state.dirty) {
+        state.first_marked = now;
+        state.dirty = true;
+    }
+    state.last_marked = now;
+}
+
+void global_state::mark_dirty(explorer_window const &expl) noexcept
+{
+    assert(expl.id >= 0 && expl.id < 4);
+    global_state::mark_dirty(persisted_file((u32)persisted_file::explorer_0 + u32(expl.id)));
+}
+
+static
+bool persistence_append_to_file(std::filesystem::path const &full_path, std::string_view content) noexcept
+{
+    HANDLE handle = CreateFileW(full_path.c_str(), FILE_APPEND_DATA, 0, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (handle == INVALID_HANDLE_VALUE) {
+        print_debug_msg("FAILED CreateFileW: %s", get_last_winapi_error().formatted_message.c_str());
+        return false;
+    }
+
+    DWORD num_written = 0;
+    BOOL written = WriteFile(handle, content.data(), DWORD(content.size()), &num_written, NULL) && num_written == content.size();
+    CloseHandle(handle);
+
+    return written;
+}
+
+/// Runs on the thread pool until no writes are pending. Only one runs at a time, so writes to a file land in order.
+static
+void persistence_writer() noexcept
+{
+    SWAN_PROFILE_FUNCTION();
+    (void) set_thread_priority(THREAD_PRIORITY_BELOW_NORMAL);
+    SCOPE_EXIT { (void) set_thread_priority(THREAD_PRIORITY_NORMAL); };
+
+    while (true) {
+        std::vector<persistence_write_request> writes = {};
+        {
+            std::scoped_lock lock(g_persistence_mutex);
+
+            if (g_persistence_pending_writes.empty()) {
+                g_persistence_writer_scheduled = false;
+                g_persistence_idle_cond.notify_all();
+                return;
+            }
+            writes.swap(g_persistence_pending_writes);
+        }
+
+        for (auto const &write : writes) {
+            auto start = get_time_precise();
+
+            bool success = write.append ? persistence_append_to_file(write.full_path, write.content)
+                                        : write_file_atomically(write.full_path, write.content);
+
+            print_debug_msg("%s %s %zu bytes to [%s] in %lld us", success ? "SUCCESS" : "FAILED", write.append ? "appended" : "wrote",
+                            write.content.size(), write.full_path.filename().string().c_str(), time_diff_us(start, get_time_precise()));
+        }
+    }
+}
+
+/// Queues `content` to be written to `full_path` by the background writer, replacing the whole file unless `append`.
+/// A write still queued for the same file is superseded by a replacing write, or extended by an appending one.
+void persistence_write(std::filesystem::path full_path, std::string content, bool append) noexcept
+try {
+    std::scoped_lock lock(g_persistence_mutex);
+
+    auto existing = std::find_if(g_persistence_pending_writes.begin(), g_persistence_pending_writes.end(),
+                                 [&](persistence_write_request const &write) noexcept { return write.full_path == full_path; });
+
+    if (existing == g_persistence_pending_writes.end()) {
+        g_persistence_pending_writes.push_back({ std::move(full_path), std::move(content), append });
+    }
+    else if (append) {
+        existing->content += content;
+    }
+    else {
+        existing->content = std::move(content);
+        existing->append = false;
+    }
+
+    if (!g_persistence_writer_scheduled) {
+        g_persistence_writer_scheduled = true;
+        global_state::thread_pool().push_task(persistence_writer);
+    }
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+/// Called once per frame on the main thread. Serializes every dirty file which is due, or all dirty files if `flush_all`,
+/// and hands them to the background writer. Serializing here means UI state needs no locking, and no disk I/O happens on this thread.
+void persistence_pump(std::array<swan_windows::id, (u64)swan_windows::id::count - 1> const &window_render_order, bool flush_all) noexcept
+{
+    std::array<bool, (u64)persisted_file::count> due = {};
+    {
+        auto now = get_time_precise();
+
+        std::scoped_lock lock(g_persistence_mutex);
+
+        for (u64 i = 0; i < g_persistence_dirty.size(); ++i) {
+            auto &state = g_persistence_dirty[i];
+
+            if (state.dirty && (flush_all
+                || time_diff_ms(state.last_marked, now) >= PERSISTENCE_DEBOUNCE_MS
+                || time_diff_ms(state.first_marked, now) >= PERSISTENCE_MAX_DELAY_MS))
+            {
+                due[i] = true;
+                state.dirty = false;
+            }
+        }
+    }
+
+    auto &explorers = global_state::explorers();
+
+    for (u64 i = 0; i < due.size(); ++i) {
+        if (!due[i]) {
+            continue;
+        }
+
+        switch (persisted_file(i)) {
+            case persisted_file::settings:                  (void) global_state::settings().save_to_disk(); break;
+            case persisted_file::pinned:                    (void) global_state::pinned_save_to_disk(); break;
+            case persisted_file::recent_files:              (void) global_state::recent_files_save_to_disk(nullptr); break;
+            case persisted_file::recent_files_latest:       (void) global_state::recent_files_save_latest_to_disk(nullptr); break;
+            case persisted_file::completed_file_operations: (void) global_state::completed_file_operations_save_to_disk(nullptr); break;
+            case persisted_file::explorer_0:                (void) explorers[0].save_to_disk(); break;
+            case persisted_file::explorer_1:                (void) explorers[1].save_to_disk(); break;
+            case persisted_file::explorer_2:                (void) explorers[2].save_to_disk(); break;
+            case persisted_file::explorer_3:                (void) explorers[3].save_to_disk(); break;
+            case persisted_file::window_render_order:       (void) window_render_order_save_to_disk(window_render_order); break;
+            case persisted_file::directory_jump:            (void) global_state::directory_jump_save_to_disk(); break;
+            case persisted_file::directory_sizes:           (void) global_state::directory_sizes_save_to_disk(flush_all); break;
+            default: break;
+        }
+    }
+}
+
+/// Writes everything dirty right away and blocks until it is on disk. For exit, and before stamping the state snapshot.
+void persistence_flush(std::array<swan_windows::id, (u64)swan_windows::id::count - 1> const &window_render_order) noexcept
+{
+    persistence_pump(window_render_order, true);
+
+    std::unique_lock lock(g_persistence_mutex);
+    g_persistence_idle_cond.wait(lock, []() noexcept { return !g_persistence_writer_scheduled; });
+}
@@ -157,7 +157,7 @@ std::pair<pinned_path *, bool> swan_windows::render_pinned(pinned_path *s_contex
                         print_debug_msg("%s change_element_position(pins, from:%zu, to:%zu)", reorder_success ? "SUCCESS" : "FAILED", from, to);
 
                         if (reorder_success) {
-                            (void) global_state::pinned_save_to_disk();
+                            global_state::mark_dirty(persisted_file::pinned);
                         }
                     }
                 }
@@ -195,8 +195,8 @@ std::pair<pinned_path *, bool> swan_windows::render_pinned(pinned_path *s_contex
 
     if (pin_to_delete_idx != npos) {
         pins.erase(pins.begin() + pin_to_delete_idx);
-        bool success = global_state::pinned_save_to_disk();
-        print_debug_msg("delete pins[%zu], global_state::pinned_save_to_disk: %d", pin_to_delete_idx, success);
+        global_state::mark_dirty(persisted_file::pinned);
+        print_debug_msg("delete pins[%zu]", pin_to_delete_idx);
     }
 
     return { nullptr, false };
@@ -259,13 +259,7 @@ u64 global_state::pinned_find_idx(swan_path const &path) noexcept
 
 bool global_state::pinned_save_to_disk() noexcept
 try {
-    std::filesystem::path full_path = global_state::execution_path() / "data\\pinned.txt";
-
-    std::ofstream out(full_path);
-
-    if (!out) {
-        return false;
-    }
+    std::ostringstream out;
 
     auto const &pins = global_state::pinned_get();
     for (auto const &pin : pins) {
@@ -280,7 +274,9 @@ try {
             << pin.path.data() << '\n';
     }
 
-    print_debug_msg("SUCCESS saved %zu items", pins.size());
+    persistence_write(global_state::execution_path() / "data\\pinned.txt", std::move(out).str());
+
+    print_debug_msg("SUCCESS serialized %zu items", pins.size());
     return true;
 }
 catch (...) {
@@ -0,0 +1,138 @@
+/*
+    Thin OS layer for what the core engines need from the filesystem: enumeration, stat, rename, copy, delete,
+    change notification and name collation. Paths are UTF-8 with the platform's separator.
+
+    Backends are platform_win32.cpp and platform_posix.cpp, each compiles to nothing on the other platform.
+    This header doesn't include <windows.h>, so code written against it builds with GCC/Clang on Linux too.
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "primitives.hpp"
+
+#if defined(_WIN32)
+    constexpr char PLATFORM_DIR_SEPARATOR = '\\';
+#else
+    constexpr char PLATFORM_DIR_SEPARATOR = '/';
+#endif
+
+enum class platform_file_kind : u8
+{
+    nil,
+    directory,
+    file,
+    symlink_to_directory,
+    symlink_to_file,
+    invalid_symlink,
+    other, // devices, sockets, pipes
+};
+
+/// 100 ns ticks since 1601-01-01 UTC, i.e. a FILETIME, on every platform so stored times don't depend on the OS.
+typedef u64 platform_file_time;
+
+struct platform_file_info
+{
+    u64 size = 0;
+    platform_file_time creation_time = 0; // 0 where the filesystem doesn't record it
+    platform_file_time last_write_time = 0;
+    platform_file_kind kind = platform_file_kind::nil;
+    bool hidden = false; // FILE_ATTRIBUTE_HIDDEN, or a leading dot on POSIX
+    bool reparse_point = false; // a Windows junction, mount point or other non-symlink reparse point, reported as what it looks like
+};
+
+struct platform_dirent
+{
+    platform_file_info info = {};
+    char const *name = nullptr; // UTF-8, valid until the next call to `platform_directory_enumerator::next`
+};
+
+/// `error_code` is GetLastError() on Windows and errno elsewhere, 0 on success.
+struct platform_result
+{
+    s32 error_code = 0;
+
+    bool ok() const noexcept { return this->error_code == 0; }
+};
+
+std::string platform_error_string(s32 error_code) noexcept;
+
+/// Lists a directory one entry at a time, without "." and, unless asked for, "..".
+class platform_directory_enumerator
+{
+public:
+    platform_directory_enumerator() noexcept = default;
+    ~platform_directory_enumerator() noexcept;
+
+    platform_directory_enumerator(platform_directory_enumerator const &) = delete;
+    platform_directory_enumerator &operator=(platform_directory_enumerator const &) = delete;
+
+    /// With `list_dotdot`, ".." is listed too wherever the directory has a parent, as explorers show it.
+    platform_result open(char const *directory_utf8, bool list_dotdot = false) noexcept;
+
+    /// False once the listing is exhausted, or an entry couldn't be read.
+    bool next(platform_dirent &out) noexcept;
+
+    void close() noexcept;
+
+private:
+    void *m_handle = nullptr; // FindFirstFileExW handle, or DIR *
+    bool m_first_pending = false; // FindFirstFileExW already returned the first entry
+    bool m_list_dotdot = false;
+    std::array<char, 1024> m_name = {};
+    alignas(8) std::array<std::byte, 600> m_find_data = {}; // WIN32_FIND_DATAW, opaque to keep <windows.h> out of this header
+};
+
+/// Non-blocking change notification for the entries of one directory (not its subdirectories).
+class platform_directory_watcher
+{
+public:
+    platform_directory_watcher() noexcept = default;
+    ~platform_directory_watcher() noexcept;
+
+    platform_directory_watcher(platform_directory_watcher const &) = delete;
+    platform_directory_watcher &operator=(platform_directory_watcher const &) = delete;
+
+    /// Stops watching whatever was watched before.
+    platform_result watch(char const *directory_utf8) noexcept;
+
+    /// True if an entry was added, removed, renamed or written since the previous call (or `watch`). Never blocks.
+    bool changed() noexcept;
+
+    void stop() noexcept;
+
+private:
+    intptr_t m_handle = -1; // change notification HANDLE, or inotify fd
+    s32 m_watch_descriptor = -1;
+    platform_file_time m_last_write_time = 0; // polling fallback where inotify is unavailable
+    std::string m_directory = {};
+};
+
+platform_result platform_stat(char const *path_utf8, platform_file_info &out, bool follow_symlinks = true) noexcept;
+
+/// Identifies a file or directory on its volume for as long as it exists, whatever it's renamed to: the NTFS file index, or the inode.
+platform_result platform_file_id(char const *path_utf8, u64 &out) noexcept;
+
+/// Fails if `to_utf8` exists, rather than replacing it.
+platform_result platform_rename(char const *from_utf8, char const *to_utf8) noexcept;
+
+platform_result platform_copy_file(char const *from_utf8, char const *to_utf8, bool overwrite) noexcept;
+
+/// Deletes a file, a symlink (not its target) or an empty directory.
+platform_result platform_delete(char const *path_utf8) noexcept;
+
+platform_result platform_create_directory(char const *path_utf8) noexcept;
+
+/// Case-insensitive ordering of names, as the platform's file manager sorts them.
+/// lstrcmpiA on Windows, ASCII case folding elsewhere.
+s32 platform_compare_names(char const *a, char const *b) noexcept;
+
+/// First occurrence of `needle` in `haystack`, nullptr if none. ASCII case folding when not `case_sensitive`.
+char const *platform_find_substring(char const *haystack, char const *needle, bool case_sensitive) noexcept;
+
+/// Runs the platform layer's tests, creating and removing files under `scratch_directory_utf8`. See tests_platform.cpp.
+void run_platform_tests(char const *scratch_directory_utf8) noexcept;
@@ -0,0 +1,383 @@
+#if !defined(_WIN32)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#   include <sys/inotify.h>
+#endif
+
+#include "platform.hpp"
+
+static
+platform_file_time platform_timespec_to_file_time(timespec const &ts) noexcept
+{
+    s64 const SECONDS_1601_TO_1970 = 11'644'473'600;
+
+    if (ts.tv_sec < -SECONDS_1601_TO_1970) {
+        return 0;
+    }
+    return u64(ts.tv_sec + SECONDS_1601_TO_1970) * 10'000'000 + u64(ts.tv_nsec) / 100;
+}
+
+static
+timespec const &platform_stat_mtime(struct stat const &st) noexcept
+{
+#if defined(__APPLE__)
+    return st.st_mtimespec;
+#else
+    return st.st_mtim;
+#endif
+}
+
+static
+platform_file_kind platform_mode_to_kind(mode_t mode) noexcept
+{
+    if (S_ISDIR(mode)) return platform_file_kind::directory;
+    if (S_ISREG(mode)) return platform_file_kind::file;
+    return platform_file_kind::other;
+}
+
+static
+void platform_fill_info(struct stat const &st, platform_file_info &out) noexcept
+{
+    out.size = S_ISREG(st.st_mode) ? u64(st.st_size) : 0;
+    out.creation_time = 0;
+    out.last_write_time = platform_timespec_to_file_time(platform_stat_mtime(st));
+    out.kind = platform_mode_to_kind(st.st_mode);
+}
+
+/// Fills `out` for the entry `name` relative to `dir_fd`, classifying symlinks by what they point to.
+/// Size and times are the link's own unless `follow_symlinks`.
+static
+platform_result platform_stat_at(s32 dir_fd, char const *name, platform_file_info &out, bool follow_symlinks) noexcept
+{
+    struct stat st;
+
+    if (fstatat(dir_fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+        return { errno };
+    }
+
+    platform_fill_info(st, out);
+
+    if (S_ISLNK(st.st_mode)) {
+        struct stat target;
+
+        if (fstatat(dir_fd, name, &target, 0) != 0) {
+            out.kind = platform_file_kind::invalid_symlink;
+        } else {
+            if (follow_symlinks) {
+                platform_fill_info(target, out);
+            }
+            out.kind = S_ISDIR(target.st_mode) ? platform_file_kind::symlink_to_directory : platform_file_kind::symlink_to_file;
+        }
+    }
+
+    char const *file_name = strrchr(name, '/');
+    file_name = file_name ? file_name + 1 : name;
+    out.hidden = file_name[0] == '.';
+
+    return {};
+}
+
+std::string platform_error_string(s32 error_code) noexcept
+try {
+    return std::strerror(error_code);
+}
+catch (...) {
+    return {};
+}
+
+platform_directory_enumerator::~platform_directory_enumerator() noexcept
+{
+    this->close();
+}
+
+platform_result platform_directory_enumerator::open(char const *directory_utf8, bool list_dotdot) noexcept
+{
+    this->close();
+
+    DIR *dir = opendir(directory_utf8);
+    if (!dir) {
+        return { errno };
+    }
+    m_handle = dir;
+    m_list_dotdot = list_dotdot && strspn(directory_utf8, "/") != strlen(directory_utf8); // the root's ".." is itself
+
+    return {};
+}
+
+bool platform_directory_enumerator::next(platform_dirent &out) noexcept
+{
+    auto dir = static_cast<DIR *>(m_handle);
+    if (!dir) {
+        return false;
+    }
+
+    while (dirent *entry = readdir(dir)) {
+        if (strcmp(entry->d_name, ".") == 0 || (!m_list_dotdot && strcmp(entry->d_name, "..") == 0)) {
+            continue;
+        }
+
+        m_name[0] = '\0';
+        strncat(m_name.data(), entry->d_name, m_name.size() - 1);
+
+        out = {};
+        out.name = m_name.data();
+
+        if (!platform_stat_at(dirfd(dir), entry->d_name, out.info, false).ok()) {
+            // removed since readdir, or no permission to stat, report what readdir knows
+            out.info.kind = entry->d_type == DT_DIR ? platform_file_kind::directory : platform_file_kind::file;
+            out.info.hidden = entry->d_name[0] == '.';
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+void platform_directory_enumerator::close() noexcept
+{
+    if (m_handle) {
+        closedir(static_cast<DIR *>(m_handle));
+        m_handle = nullptr;
+    }
+}
+
+platform_directory_watcher::~platform_directory_watcher() noexcept
+{
+    this->stop();
+}
+
+platform_result platform_directory_watcher::watch(char const *directory_utf8) noexcept
+try {
+    this->stop();
+
+    m_directory = directory_utf8;
+
+#if defined(__linux__)
+    s32 fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        return { errno };
+    }
+
+    u32 mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_MODIFY | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF;
+    s32 wd = inotify_add_watch(fd, directory_utf8, mask);
+    if (wd < 0) {
+        s32 error_code = errno;
+        ::close(fd);
+        return { error_code };
+    }
+
+    m_handle = fd;
+    m_watch_descriptor = wd;
+#else
+    platform_file_info info = {};
+    auto result = platform_stat(directory_utf8, info);
+    if (!result.ok()) {
+        return result;
+    }
+    m_last_write_time = info.last_write_time;
+#endif
+
+    return {};
+}
+catch (...) {
+    return { ENOMEM };
+}
+
+bool platform_directory_watcher::changed() noexcept
+{
+#if defined(__linux__)
+    if (m_handle < 0) {
+        return false;
+    }
+
+    bool any_events = false;
+    alignas(inotify_event) char buffer[4096];
+
+    while (read(s32(m_handle), buffer, sizeof(buffer)) > 0) {
+        any_events = true; // only whether something happened matters, not what
+    }
+
+    return any_events;
+#else
+    // directory mtime changes when entries are added, removed or renamed, not when a file is written
+    platform_file_info info = {};
+    if (m_directory.empty() || !platform_stat(m_directory.c_str(), info).ok()) {
+        return false;
+    }
+    bool changed = info.last_write_time != m_last_write_time;
+    m_last_write_time = info.last_write_time;
+    return changed;
+#endif
+}
+
+void platform_directory_watcher::stop() noexcept
+{
+#if defined(__linux__)
+    if (m_handle >= 0) {
+        ::close(s32(m_handle));
+    }
+#endif
+    m_handle = -1;
+    m_watch_descriptor = -1;
+    m_last_write_time = 0;
+    m_directory.clear();
+}
+
+platform_result platform_stat(char const *path_utf8, platform_file_info &out, bool follow_symlinks) noexcept
+{
+    return platform_stat_at(AT_FDCWD, path_utf8, out, follow_symlinks);
+}
+
+platform_result platform_file_id(char const *path_utf8, u64 &out) noexcept
+{
+    struct stat st;
+    if (stat(path_utf8, &st) != 0) {
+        return { errno };
+    }
+    out = u64(st.st_ino);
+    return {};
+}
+
+platform_result platform_rename(char const *from_utf8, char const *to_utf8) noexcept
+{
+#if defined(__linux__) && defined(RENAME_NOREPLACE)
+    if (renameat2(AT_FDCWD, from_utf8, AT_FDCWD, to_utf8, RENAME_NOREPLACE) == 0) {
+        return {};
+    }
+    if (errno != EINVAL && errno != ENOSYS) {
+        return { errno };
+    }
+    // filesystem without RENAME_NOREPLACE support, fall through to the racy check
+#endif
+
+    struct stat st;
+    if (lstat(to_utf8, &st) == 0) {
+        return { EEXIST };
+    }
+    if (rename(from_utf8, to_utf8) != 0) {
+        return { errno };
+    }
+    return {};
+}
+
+platform_result platform_copy_file(char const *from_utf8, char const *to_utf8, bool overwrite) noexcept
+{
+    s32 from_fd = ::open(from_utf8, O_RDONLY | O_CLOEXEC);
+    if (from_fd < 0) {
+        return { errno };
+    }
+
+    struct stat st;
+    if (fstat(from_fd, &st) != 0) {
+        s32 error_code = errno;
+        ::close(from_fd);
+        return { error_code };
+    }
+
+    s32 to_fd = ::open(to_utf8, O_WRONLY | O_CREAT | O_CLOEXEC | (overwrite ? O_TRUNC : O_EXCL), st.st_mode & 0777);
+    if (to_fd < 0) {
+        s32 error_code = errno;
+        ::close(from_fd);
+        return { error_code };
+    }
+
+    s32 error_code = 0;
+    u64 remaining = u64(st.st_size);
+
+#if defined(__linux__)
+    while (remaining > 0) {
+        ssize_t copied = copy_file_range(from_fd, nullptr, to_fd, nullptr, remaining, 0);
+        if (copied <= 0) {
+            break; // unsupported across these filesystems, or an error the read/write loop will report
+        }
+        remaining -= u64(copied);
+    }
+#endif
+
+    if (remaining > 0) {
+        static thread_local std::array<char, 256 * 1024> s_buffer;
+
+        while (true) {
+            ssize_t num_read = read(from_fd, s_buffer.data(), s_buffer.size());
+            if (num_read < 0) {
+                if (errno == EINTR) continue;
+                error_code = errno;
+                break;
+            }
+            if (num_read == 0) {
+                break;
+            }
+            for (ssize_t written = 0; written < num_read; ) {
+                ssize_t n = write(to_fd, s_buffer.data() + written, size_t(num_read - written));
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    error_code = errno;
+                    break;
+                }
+                written += n;
+            }
+            if (error_code != 0) {
+                break;
+            }
+        }
+    }
+
+    if (error_code == 0) {
+        // keep the modification time like CopyFileW does
+        timespec times[2] = { st.st_atim, st.st_mtim };
+        (void) futimens(to_fd, times);
+    }
+
+    ::close(from_fd);
+    if (::close(to_fd) != 0 && error_code == 0) {
+        error_code = errno;
+    }
+    if (error_code != 0) {
+        (void) unlink(to_utf8);
+    }
+
+    return { error_code };
+}
+
+platform_result platform_delete(char const *path_utf8) noexcept
+{
+    struct stat st;
+    if (lstat(path_utf8, &st) != 0) {
+        return { errno };
+    }
+    if ((S_ISDIR(st.st_mode) ? rmdir(path_utf8) : unlink(path_utf8)) != 0) {
+        return { errno };
+    }
+    return {};
+}
+
+platform_result platform_create_directory(char const *path_utf8) noexcept
+{
+    if (mkdir(path_utf8, 0777) != 0) {
+        return { errno };
+    }
+    return {};
+}
+
+s32 platform_compare_names(char const *a, char const *b) noexcept
+{
+    return strcasecmp(a, b);
+}
+
+char const *platform_find_substring(char const *haystack, char const *needle, bool case_sensitive) noexcept
+{
+    return case_sensitive ? strstr(haystack, needle) : strcasestr(haystack, needle);
+}
+
+#endif // !defined(_WIN32)
@@ -0,0 +1,383 @@
+#if defined(_WIN32)
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+#define NOMINMAX
+#include <windows.h>
+#include <shlwapi.h>
+
+#include "platform.hpp"
+#include "util.hpp"
+
+static_assert(sizeof(WIN32_FIND_DATAW) <= sizeof(std::array<std::byte, 600>));
+static_assert(alignof(WIN32_FIND_DATAW) <= 8);
+
+typedef std::array<wchar_t, 2048> platform_utf16_path;
+
+static
+platform_file_time platform_filetime_to_file_time(FILETIME const &ft) noexcept
+{
+    return two_u32_to_one_u64(ft.dwLowDateTime, ft.dwHighDateTime);
+}
+
+static
+platform_file_kind platform_attributes_to_kind(DWORD attributes, DWORD reparse_tag) noexcept
+{
+    bool is_directory = attributes & FILE_ATTRIBUTE_DIRECTORY;
+
+    if ((attributes & FILE_ATTRIBUTE_REPARSE_POINT) && reparse_tag == IO_REPARSE_TAG_SYMLINK) {
+        return is_directory ? platform_file_kind::symlink_to_directory : platform_file_kind::symlink_to_file;
+    }
+    if (is_directory) return platform_file_kind::directory;
+    if (attributes & FILE_ATTRIBUTE_DEVICE) return platform_file_kind::other;
+    return platform_file_kind::file;
+}
+
+static
+platform_result platform_last_error() noexcept
+{
+    return { s32(GetLastError()) };
+}
+
+std::string platform_error_string(s32 error_code) noexcept
+try {
+    if (error_code == 0) {
+        return "No error.";
+    }
+
+    LPSTR buffer = nullptr;
+    DWORD buffer_size = FormatMessageA(
+        FORMAT_MESSAGE_ALLOCATE_BUFFER|FORMAT_MESSAGE_FROM_SYSTEM|FORMAT_MESSAGE_IGNORE_INSERTS,
+        nullptr,
+        DWORD(error_code),
+        MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
+        reinterpret_cast<LPSTR>(&buffer),
+        0,
+        nullptr
+    );
+
+    if (buffer_size == 0) {
+        return "Error formatting message.";
+    }
+
+    std::string message(buffer, buffer + buffer_size);
+    LocalFree(buffer);
+
+    while (!message.empty() && (message.back() == '\r' || message.back() == '\n')) {
+        message.pop_back();
+    }
+
+    return message;
+}
+catch (...) {
+    return {};
+}
+
+platform_directory_enumerator::~platform_directory_enumerator() noexcept
+{
+    this->close();
+}
+
+platform_result platform_directory_enumerator::open(char const *directory_utf8, bool list_dotdot) noexcept
+{
+    this->close();
+
+    platform_utf16_path search_path_utf16;
+    s32 written = utf8_to_utf16(directory_utf8, search_path_utf16.data(), search_path_utf16.size() - 2);
+    if (written == 0) {
+        return { ERROR_INVALID_NAME };
+    }
+
+    // `written` includes the NUL terminator
+    wchar_t *end = search_path_utf16.data() + written - 1;
+    if (end > search_path_utf16.data() && end[-1] != L'\\' && end[-1] != L'/') {
+        *end++ = L'\\';
+    }
+    *end++ = L'*';
+    *end = L'\0';
+
+    auto find_data = reinterpret_cast<WIN32_FIND_DATAW *>(m_find_data.data());
+
+    HANDLE find_handle = FindFirstFileExW(search_path_utf16.data(), FindExInfoBasic, find_data, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+    if (find_handle == INVALID_HANDLE_VALUE) {
+        return platform_last_error();
+    }
+
+    m_handle = find_handle;
+    m_first_pending = true;
+    m_list_dotdot = list_dotdot; // FindFirstFileExW lists ".." wherever there is a parent
+
+    return {};
+}
+
+bool platform_directory_enumerator::next(platform_dirent &out) noexcept
+{
+    if (!m_handle) {
+        return false;
+    }
+
+    auto find_data = reinterpret_cast<WIN32_FIND_DATAW *>(m_find_data.data());
+
+    while (true) {
+        if (m_first_pending) {
+            m_first_pending = false;
+        }
+        else if (!FindNextFileW(m_handle, find_data)) {
+            return false;
+        }
+
+        if (wcscmp(find_data->cFileName, L".") == 0 || (!m_list_dotdot && wcscmp(find_data->cFileName, L"..") == 0)) {
+            continue;
+        }
+
+        if (utf16_to_utf8(find_data->cFileName, m_name.data(), m_name.size()) == 0) {
+            continue;
+        }
+
+        out = {};
+        out.name = m_name.data();
+        out.info.size = two_u32_to_one_u64(find_data->nFileSizeLow, find_data->nFileSizeHigh);
+        out.info.creation_time = platform_filetime_to_file_time(find_data->ftCreationTime);
+        out.info.last_write_time = platform_filetime_to_file_time(find_data->ftLastWriteTime);
+        out.info.kind = platform_attributes_to_kind(find_data->dwFileAttributes, find_data->dwReserved0);
+        out.info.hidden = find_data->dwFileAttributes & FILE_ATTRIBUTE_HIDDEN;
+        out.info.reparse_point = (find_data->dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) && find_data->dwReserved0 != IO_REPARSE_TAG_SYMLINK;
+
+        return true;
+    }
+}
+
+void platform_directory_enumerator::close() noexcept
+{
+    if (m_handle) {
+        FindClose(m_handle);
+        m_handle = nullptr;
+    }
+    m_first_pending = false;
+}
+
+platform_directory_watcher::~platform_directory_watcher() noexcept
+{
+    this->stop();
+}
+
+platform_result platform_directory_watcher::watch(char const *directory_utf8) noexcept
+try {
+    this->stop();
+
+    platform_utf16_path directory_utf16;
+    if (utf8_to_utf16(directory_utf8, directory_utf16.data(), directory_utf16.size()) == 0) {
+        return { ERROR_INVALID_NAME };
+    }
+
+    DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME|FILE_NOTIFY_CHANGE_DIR_NAME|FILE_NOTIFY_CHANGE_SIZE|FILE_NOTIFY_CHANGE_LAST_WRITE|FILE_NOTIFY_CHANGE_ATTRIBUTES;
+
+    HANDLE change_handle = FindFirstChangeNotificationW(directory_utf16.data(), false, filter);
+    if (change_handle == INVALID_HANDLE_VALUE) {
+        return platform_last_error();
+    }
+
+    m_handle = reinterpret_cast<intptr_t>(change_handle);
+    m_directory = directory_utf8;
+
+    return {};
+}
+catch (...) {
+    return { ERROR_OUTOFMEMORY };
+}
+
+bool platform_directory_watcher::changed() noexcept
+{
+    if (m_handle == -1) {
+        return false;
+    }
+
+    auto change_handle = reinterpret_cast<HANDLE>(m_handle);
+    bool any_events = false;
+
+    // drain every signal queued since the last call, re-arming after each
+    while (WaitForSingleObject(change_handle, 0) == WAIT_OBJECT_0) {
+        any_events = true;
+        if (!FindNextChangeNotification(change_handle)) {
+            break;
+        }
+    }
+
+    return any_events;
+}
+
+void platform_directory_watcher::stop() noexcept
+{
+    if (m_handle != -1) {
+        FindCloseChangeNotification(reinterpret_cast<HANDLE>(m_handle));
+    }
+    m_handle = -1;
+    m_watch_descriptor = -1;
+    m_last_write_time = 0;
+    m_directory.clear();
+}
+
+platform_result platform_stat(char const *path_utf8, platform_file_info &out, bool follow_symlinks) noexcept
+{
+    platform_utf16_path path_utf16;
+    if (utf8_to_utf16(path_utf8, path_utf16.data(), path_utf16.size()) == 0) {
+        return { ERROR_INVALID_NAME };
+    }
+
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+    if (!GetFileAttributesExW(path_utf16.data(), GetFileExInfoStandard, &attributes)) {
+        return platform_last_error();
+    }
+
+    out = {};
+    out.size = two_u32_to_one_u64(attributes.nFileSizeLow, attributes.nFileSizeHigh);
+    out.creation_time = platform_filetime_to_file_time(attributes.ftCreationTime);
+    out.last_write_time = platform_filetime_to_file_time(attributes.ftLastWriteTime);
+    out.kind = platform_attributes_to_kind(attributes.dwFileAttributes, 0);
+    out.hidden = attributes.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN;
+
+    if (!(attributes.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)) {
+        return {};
+    }
+
+    // GetFileAttributesExW doesn't give the reparse tag, FindFirstFileW does
+    {
+        WIN32_FIND_DATAW find_data;
+        HANDLE find_handle = FindFirstFileW(path_utf16.data(), &find_data);
+        if (find_handle == INVALID_HANDLE_VALUE) {
+            return {};
+        }
+        FindClose(find_handle);
+        if (find_data.dwReserved0 != IO_REPARSE_TAG_SYMLINK) {
+            out.reparse_point = true; // junctions, cloud placeholders etc. are reported as what they look like
+            return {};
+        }
+    }
+
+    bool is_directory = attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY;
+
+    HANDLE target = CreateFileW(path_utf16.data(), FILE_READ_ATTRIBUTES, FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (target == INVALID_HANDLE_VALUE) {
+        out.kind = platform_file_kind::invalid_symlink;
+        return {};
+    }
+    SCOPE_EXIT { CloseHandle(target); };
+
+    BY_HANDLE_FILE_INFORMATION target_info;
+    if (!GetFileInformationByHandle(target, &target_info)) {
+        out.kind = platform_file_kind::invalid_symlink;
+        return {};
+    }
+
+    if (follow_symlinks) {
+        out.size = two_u32_to_one_u64(target_info.nFileSizeLow, target_info.nFileSizeHigh);
+        out.creation_time = platform_filetime_to_file_time(target_info.ftCreationTime);
+        out.last_write_time = platform_filetime_to_file_time(target_info.ftLastWriteTime);
+    }
+    out.kind = is_directory ? platform_file_kind::symlink_to_directory : platform_file_kind::symlink_to_file;
+
+    return {};
+}
+
+platform_result platform_file_id(char const *path_utf8, u64 &out) noexcept
+{
+    platform_utf16_path path_utf16;
+    if (utf8_to_utf16(path_utf8, path_utf16.data(), path_utf16.size()) == 0) {
+        return { ERROR_INVALID_NAME };
+    }
+
+    // FILE_FLAG_BACKUP_SEMANTICS to open directories, no access rights beyond attributes so it works on files in use
+    HANDLE handle = CreateFileW(path_utf16.data(), FILE_READ_ATTRIBUTES, FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return platform_last_error();
+    }
+    SCOPE_EXIT { CloseHandle(handle); };
+
+    BY_HANDLE_FILE_INFORMATION info;
+    if (!GetFileInformationByHandle(handle, &info)) {
+        return platform_last_error();
+    }
+
+    out = two_u32_to_one_u64(info.nFileIndexLow, info.nFileIndexHigh);
+    return {};
+}
+
+platform_result platform_rename(char const *from_utf8, char const *to_utf8) noexcept
+{
+    platform_utf16_path from_utf16, to_utf16;
+    if (utf8_to_utf16(from_utf8, from_utf16.data(), from_utf16.size()) == 0 ||
+        utf8_to_utf16(to_utf8, to_utf16.data(), to_utf16.size()) == 0)
+    {
+        return { ERROR_INVALID_NAME };
+    }
+
+    // no MOVEFILE_REPLACE_EXISTING, so an existing target is an error
+    if (!MoveFileExW(from_utf16.data(), to_utf16.data(), 0)) {
+        return platform_last_error();
+    }
+    return {};
+}
+
+platform_result platform_copy_file(char const *from_utf8, char const *to_utf8, bool overwrite) noexcept
+{
+    platform_utf16_path from_utf16, to_utf16;
+    if (utf8_to_utf16(from_utf8, from_utf16.data(), from_utf16.size()) == 0 ||
+        utf8_to_utf16(to_utf8, to_utf16.data(), to_utf16.size()) == 0)
+    {
+        return { ERROR_INVALID_NAME };
+    }
+
+    if (!CopyFileW(from_utf16.data(), to_utf16.data(), !overwrite)) {
+        return platform_last_error();
+    }
+    return {};
+}
+
+platform_result platform_delete(char const *path_utf8) noexcept
+{
+    platform_utf16_path path_utf16;
+    if (utf8_to_utf16(path_utf8, path_utf16.data(), path_utf16.size()) == 0) {
+        return { ERROR_INVALID_NAME };
+    }
+
+    DWORD attributes = GetFileAttributesW(path_utf16.data());
+    if (attributes == INVALID_FILE_ATTRIBUTES) {
+        return platform_last_error();
+    }
+
+    // a directory symlink is removed with RemoveDirectoryW, which leaves its target alone
+    bool success = (attributes & FILE_ATTRIBUTE_DIRECTORY) ? RemoveDirectoryW(path_utf16.data()) : DeleteFileW(path_utf16.data());
+    if (!success) {
+        return platform_last_error();
+    }
+    return {};
+}
+
+platform_result platform_create_directory(char const *path_utf8) noexcept
+{
+    platform_utf16_path path_utf16;
+    if (utf8_to_utf16(path_utf8, path_utf16.data(), path_utf16.size()) == 0) {
+        return { ERROR_INVALID_NAME };
+    }
+
+    if (!CreateDirectoryW(path_utf16.data(), nullptr)) {
+        return platform_last_error();
+    }
+    return {};
+}
+
+s32 platform_compare_names(char const *a, char const *b) noexcept
+{
+    return lstrcmpiA(a, b);
+}
+
+char const *platform_find_substring(char const *haystack, char const *needle, bool case_sensitive) noexcept
+{
+    return case_sensitive ? StrStrA(haystack, needle) : StrStrIA(haystack, needle);
+}
+
+#endif // defined(_WIN32)
@@ -17,6 +17,9 @@ namespace bulk_rename_modal_global_state
     static swan_path                            g_cwd = {};
     static bool                                 g_open = false;
     static bool                                 g_obj_types_present[num_obj_types] = {};
+    static std::vector<std::string>             g_untouched_name_keys = {}; // cwd entries not being renamed
+    static bulk_rename_collision_index          g_collisions = {};
+    static bulk_rename_journal                  g_journal = {};
 }
 
 struct transaction_counters
@@ -36,6 +39,7 @@ void swan_popup_modals::open_bulk_rename(explorer_window &expl_opened_from, std:
     memset(g_obj_types_present, false, num_obj_types);
 
     g_transforms.clear();
+    g_untouched_name_keys.clear();
 
     for (auto const &dirent : expl_opened_from.cwd_entries) {
         if (dirent.selected) {
@@ -43,57 +47,202 @@ void swan_popup_modals::open_bulk_rename(explorer_window &expl_opened_from, std:
             g_transforms.emplace_back(&dirent.basic, dirent.basic.path.data());
             g_obj_types_present[(u64)dirent.basic.type] = true;
         }
+        else if (!dirent.basic.is_path_dotdot()) {
+            g_untouched_name_keys.push_back(bulk_rename_collision_index::key(dirent.basic.path.data()));
+        }
     }
+
+    g_collisions.rebuild(g_untouched_name_keys, g_transforms);
+}
+
+/// Points recent files at the new names of everything renamed: files through the recent files index, directories in one
+/// pass over the recent files for all of them.
+static
+void update_recent_files(std::vector<bulk_rename_transform> const &transforms, swan_path const &renames_parent_path) noexcept
+try {
+    char dir_sep_utf8 = global_state::settings().dir_separator_utf8;
+    auto recent_files = global_state::recent_files_get();
+    u64 num_updated = 0;
+    std::vector<recent_files_directory_change> renamed_directories = {};
+
+    std::scoped_lock recent_files_lock(*recent_files.mutex);
+
+    for (auto const &transform : transforms) {
+        if (transform.stat.load() != bulk_rename_transform::status::execute_success) {
+            continue;
+        }
+
+        swan_path old_path = renames_parent_path;
+        swan_path new_path = renames_parent_path;
+
+        if (path_append(old_path, transform.before.data(), dir_sep_utf8, true) && path_append(new_path, transform.after.data(), dir_sep_utf8, true)) {
+            if (transform.obj_type == basic_dirent::kind::directory) {
+                renamed_directories.push_back({ old_path.data(), new_path.data(), "", false });
+            } else {
+                num_updated += global_state::recent_files_path_changed(old_path.data(), new_path.data(), false, &recent_files_lock);
+            }
+        }
+    }
+
+    num_updated += global_state::recent_files_directories_changed(renamed_directories, &recent_files_lock);
+
+    if (num_updated > 0) {
+        global_state::mark_dirty(persisted_file::recent_files);
+    }
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
 }
 
-struct path_comparator
+std::string bulk_rename_temp_name(u32 transform_idx) noexcept
 {
-    char dir_sep_utf8;
-    swan_path bulk_rename_parent_dir;
+    return make_str("~swan-bulk-rename-%lu-%u.tmp", GetCurrentProcessId(), transform_idx);
+}
 
-    bool operator()(bulk_rename_transform const &lhs, recent_file const &rhs) const noexcept
-    {
-        swan_path lhs_full_path = bulk_rename_parent_dir;
-        [[maybe_unused]] bool success = path_append(lhs_full_path, lhs.before.data(), dir_sep_utf8, true);
-        assert(success);
-        return strcmp(lhs_full_path.data(), rhs.path.data()) < 0;
+/// Moves the source name of `transform` to a temporary name in the same directory, or the temporary name to its target name.
+static
+std::string rename_through_temp(
+    bulk_rename_transform const &transform,
+    u32 transform_idx,
+    wchar_t const *working_directory,
+    bool reverse,
+    bool into_temp,
+    std::wstring &full_name,
+    std::wstring &temp_name) noexcept
+try {
+    swan_path const &name_utf8 = (into_temp != reverse) ? transform.before : transform.after;
+
+    wchar_t name_utf16[MAX_PATH];
+    if (!utf8_to_utf16(name_utf8.data(), name_utf16, lengthof(name_utf16))) {
+        return make_str("Failed to convert [%s] from UTF-8 to UTF-16.", name_utf8.data());
     }
-    bool operator()(recent_file const &lhs, bulk_rename_transform const &rhs) const noexcept
-    {
-        swan_path rhs_full_path = bulk_rename_parent_dir;
-        [[maybe_unused]] bool success = path_append(rhs_full_path, rhs.before.data(), dir_sep_utf8, true);
-        assert(success);
-        return strcmp(lhs.path.data(), rhs_full_path.data()) < 0;
+
+    full_name = working_directory;
+    full_name += name_utf16;
+
+    temp_name = working_directory;
+    for (char ch : bulk_rename_temp_name(transform_idx)) {
+        temp_name += wchar_t(ch); // ASCII
     }
-};
 
+    bool success = into_temp ? MoveFileW(full_name.c_str(), temp_name.c_str())
+                             : MoveFileW(temp_name.c_str(), full_name.c_str());
+    if (success) {
+        return "";
+    }
+
+    std::string error = get_last_winapi_error().formatted_message;
+    if (!into_temp) {
+        swan_path temp_name_utf8;
+        if (utf16_to_utf8(temp_name.c_str(), temp_name_utf8.data(), temp_name_utf8.max_size())) {
+            error += make_str(" Left as [%s].", path_find_filename(temp_name_utf8.data()));
+        }
+    }
+    return error;
+}
+catch (std::exception const &except) {
+    return except.what();
+}
+catch (...) {
+    return "Exception, catch (...)";
+}
+
+/// Runs the jobs of `plan` across worker threads, the steps within a job in order.
+/// Sets the status (and error) of every transform it touches and counts them into `counters`, and into `journal` if not null.
 static
-void update_recent_files(std::vector<bulk_rename_transform> &transforms, swan_path const &renames_parent_path) noexcept
+void execute_bulk_rename_plan(
+    std::vector<bulk_rename_transform> &transforms,
+    bulk_rename_plan const &plan,
+    std::wstring const &working_directory,
+    bool reverse,
+    bool reset_names,
+    std::atomic_bool const &cancellation_token,
+    transaction_counters &counters,
+    bulk_rename_journal *journal) noexcept
 {
-    std::sort(transforms.begin(), transforms.end(), [](bulk_rename_transform const &lhs, bulk_rename_transform const &rhs) noexcept {
-        return strcmp(lhs.before.data(), rhs.before.data()) < 0;
-    });
+    using status_t = bulk_rename_transform::status;
+    using step_kind = bulk_rename_plan::step_kind;
 
-    path_comparator comparator = { global_state::settings().dir_separator_utf8, renames_parent_path };
+    std::atomic<u64> next_job_idx = 0;
 
-    auto recent_files = global_state::recent_files_get();
-    {
-        std::scoped_lock recent_files_lock(*recent_files.mutex);
+    auto record_outcome = [&](bulk_rename_transform &transform, u32 transform_idx, std::string &&error) noexcept {
+        if (journal != nullptr) {
+            journal->record(error.empty() ? 'D' : 'F', transform_idx);
+        }
+        if (!error.empty()) {
+            transform.stat.store(reverse ? status_t::revert_failed : status_t::execute_failed);
+            transform.error = std::move(error);
+            ++counters.num_failed;
+        }
+        else if (!reverse) {
+            transform.stat.store(status_t::execute_success);
+            ++counters.num_completed;
+        }
+        else {
+            if (reset_names) {
+                transform.after = transform.before;
+                transform.stat.store(status_t::name_unchanged);
+            } else {
+                transform.stat.store(status_t::ready);
+            }
+            ++counters.num_completed;
+        }
+    };
+
+    auto worker = [&]() noexcept {
+        std::wstring before, after;
+
+        try {
+            for (u64 job_idx = next_job_idx.fetch_add(1); job_idx < plan.jobs.size(); job_idx = next_job_idx.fetch_add(1)) {
+                bool holding_temp = false;
 
-        for (auto &rf : *recent_files.container) {
-            auto range = std::equal_range(transforms.begin(), transforms.end(), rf, comparator);
+                for (auto const &step : plan.jobs[job_idx]) {
+                    // never stop while a transform is parked under a temporary name
+                    if (!holding_temp && cancellation_token.load() == true) {
+                        break;
+                    }
 
-            if (range.first != transforms.end()) {
-                bulk_rename_transform const &matching_rnm = *range.first;
-                swan_path rf_new_full_path = comparator.bulk_rename_parent_dir;
-                if (path_append(rf_new_full_path, matching_rnm.after.data(), comparator.dir_sep_utf8, true)) {
-                    rf.path = rf_new_full_path;
+                    auto &transform = transforms[step.transform_idx];
+
+                    switch (step.kind) {
+                        case step_kind::direct: {
+                            std::string error = reverse ? transform.revert(working_directory.c_str(), before, after)
+                                                        : transform.execute(working_directory.c_str(), before, after);
+                            record_outcome(transform, step.transform_idx, std::move(error));
+                            break;
+                        }
+                        case step_kind::to_temp: {
+                            std::string error = rename_through_temp(transform, step.transform_idx, working_directory.c_str(), reverse, true, before, after);
+                            if (error.empty()) {
+                                holding_temp = true;
+                                if (journal != nullptr) journal->record('P', step.transform_idx);
+                            } else {
+                                record_outcome(transform, step.transform_idx, std::move(error));
+                            }
+                            break;
+                        }
+                        case step_kind::from_temp: {
+                            if (holding_temp) {
+                                holding_temp = false;
+                                record_outcome(transform, step.transform_idx, rename_through_temp(transform, step.transform_idx, working_directory.c_str(), reverse, false, before, after));
+                            }
+                            break;
+                        }
+                    }
                 }
             }
         }
-    }
+        catch (std::exception const &except) {
+            print_debug_msg("FAILED catch(std::exception) %s", except.what());
+        }
+        catch (...) {
+            print_debug_msg("FAILED catch(...)");
+        }
+    };
+
+    u64 num_workers = run_parallel_workers(parallel_worker_count(plan.jobs.size()), [&worker](u64) noexcept { worker(); });
 
-    (void) global_state::recent_files_save_to_disk(nullptr);
+    print_debug_msg("bulk rename: %zu jobs, %zu steps, %zu cycles, %zu workers", plan.jobs.size(), plan.num_steps, plan.num_cycles, num_workers);
 }
 
 enum class modal_state : s32 {
@@ -257,11 +406,11 @@ std::pair<bool, u64> render_import_button(bool transact_active, bool export_trig
 
     if (imgui::Button(ICON_LC_CLIPBOARD " Import" "## bulk rename")) {
         char const *clipboard = imgui::GetClipboardText();
-        std::vector<swan_path> transforms_after = {};
-        auto [success, text_sanitized, num_lines] = bulk_rename_parse_text_import(clipboard, transforms_after, transforms.size() - 1, s_errors);
+        std::vector<swan_path> transforms_after = {}; // a swan_path per transform adds up, don't hold on to it between imports
+        auto [success, num_chars, num_lines] = bulk_rename_parse_text_import(clipboard, transforms_after, transforms.size() - 1, s_errors);
 
         s_clipboard_num_lines = num_lines;
-        s_clipboard_num_chars = text_sanitized.size();
+        s_clipboard_num_chars = num_chars;
 
         if (success) {
             for (u64 i = 0; i < transforms_after.size(); ++i) {
@@ -319,6 +468,96 @@ bool render_transaction_progress_indicator(transaction_counters const &counters)
     return true;
 }
 
+struct pattern_input_result
+{
+    bool applied;
+    u64 num_applied;
+};
+
+/// Pattern row: recompiles and reapplies the pattern to the shown (not filtered) transforms whenever it or the counter changes.
+static
+pattern_input_result render_pattern_input(bool transact_active,
+                                          std::vector<bulk_rename_transform>::iterator first_transform,
+                                          std::vector<bulk_rename_transform>::iterator last_transform) noexcept
+{
+    static char s_pattern_utf8[512] = "<name><dotext>";
+    static s64 s_counter_start = 1;
+    static s64 s_counter_step = 1;
+    static bool s_squish_adjacent_spaces = false;
+    static bulk_rename_compile_pattern_result s_compiled = {};
+    static bulk_rename_preview s_preview = {};
+    static std::string s_status = {};
+
+    pattern_input_result retval = {};
+
+    imgui::ScopedDisable d(transact_active);
+
+    bool edited = false;
+    {
+        imgui::ScopedItemWidth w(imgui::CalcTextSize("X").x * 40);
+        edited |= imgui::InputTextWithHint("## bulk_rename pattern", "<name> <ext> <dotext> <counter:N> <size> <first,last>", s_pattern_utf8, lengthof(s_pattern_utf8));
+    }
+    if (imgui::IsItemHovered({}, .5f)) {
+        imgui::SetTooltip("Pattern applied to every shown row as you type.\n"
+                          "<name> name without extension, <ext> extension, <dotext> extension with dot,\n"
+                          "<counter> or <counter:N> zero padded to N digits, <size> size in bytes,\n"
+                          "<first,last> characters of the original name (either end may be omitted).");
+    }
+
+    imgui::SameLineSpaced(1);
+    {
+        imgui::ScopedItemWidth w(imgui::CalcTextSize("X").x * 8);
+        s64 const step_fast = 10;
+        edited |= imgui::InputScalar("Start## bulk_rename counter", ImGuiDataType_S64, &s_counter_start);
+        imgui::SameLineSpaced(1);
+        edited |= imgui::InputScalar("Step## bulk_rename counter", ImGuiDataType_S64, &s_counter_step, nullptr, &step_fast);
+    }
+    imgui::SameLineSpaced(1);
+    edited |= imgui::Checkbox("Compress spaces## bulk_rename pattern", &s_squish_adjacent_spaces);
+    if (imgui::IsItemHovered({}, .5f)) imgui::SetTooltip("Runs of spaces typed into the pattern become a single space.");
+
+    if (edited && !transact_active) {
+        s_compiled = bulk_rename_compile_pattern(s_pattern_utf8, s_squish_adjacent_spaces);
+
+        if (!s_compiled.success) {
+            s_status = s_compiled.error.data();
+        }
+        else {
+            std::span<bulk_rename_transform const> shown(&*first_transform, u64(std::distance(first_transform, last_transform)));
+            bulk_rename_apply_pattern(s_compiled.pattern, shown, s_counter_start, s_counter_step, s_preview);
+
+            for (u64 i = 0; i < shown.size(); ++i) {
+                auto &transform = *(first_transform + s64(i));
+                if (s_preview.problems[i] != bulk_rename_preview::problem::none || transform.stat.load() == bulk_rename_transform::status::execute_success) {
+                    continue;
+                }
+                transform.after = path_create(s_preview.name(i));
+                transform.stat.store(bulk_rename_transform::status::name_unchanged);
+                ++retval.num_applied;
+            }
+            retval.applied = true;
+
+            s_status.clear();
+            if (s_preview.num_problems > 0) {
+                s_status += make_str("%zu row%s left unchanged (empty, too long, bad slice or trailing dot). ",
+                                     s_preview.num_problems, s_preview.num_problems == 1 ? "" : "s");
+            }
+            if (s_preview.num_collisions > 0) {
+                s_status += make_str("%zu duplicate name%s, e.g. [%s].",
+                                     s_preview.num_collisions, s_preview.num_collisions == 1 ? "" : "s", s_preview.name(s_preview.first_collision_idx));
+            }
+        }
+
+    }
+
+    if (!s_status.empty()) {
+        imgui::SameLineSpaced(1);
+        imgui::TextColored(s_compiled.success ? warning_color() : error_color(), "%s", s_status.c_str());
+    }
+
+    return retval;
+}
+
 enum bulk_rename_table_col_id : s32
 {
     bulk_rename_table_col_id_index,
@@ -712,6 +951,8 @@ render_table_result render_table(
                 if (after_edited) {
                     using status_t = bulk_rename_transform::status;
 
+                    bulk_rename_modal_global_state::g_collisions.update(transform);
+
                     if (cstr_empty(transform.after.data())) {
                         transform.stat.store(status_t::error_name_empty);
                     }
@@ -792,6 +1033,14 @@ render_table_result render_table(
                         break;
                 };
 
+                if (one_of(status, { bulk_rename_transform::status::ready, bulk_rename_transform::status::name_unchanged })
+                    && bulk_rename_modal_global_state::g_collisions.conflicts(transform))
+                {
+                    status_color = error_color();
+                    status_icon = ICON_CI_WARNING;
+                    status_tooltip = "Name conflicts with another entry in this directory";
+                }
+
                 imgui::TextColored(status_color, status_icon);
 
                 if (imgui::IsItemHovered({}, .5f)) {
@@ -838,6 +1087,11 @@ void swan_popup_modals::render_bulk_rename() noexcept
         g_transforms.clear();
         g_on_rename_callback = {};
         memset(g_obj_types_present, false, num_obj_types);
+        g_untouched_name_keys.clear();
+        g_collisions = {};
+        if (g_journal.file != INVALID_HANDLE_VALUE) {
+            g_journal.commit();
+        }
 
         s_informational_msg.clear();
         s_exported = false;
@@ -867,6 +1121,8 @@ void swan_popup_modals::render_bulk_rename() noexcept
         memset(s_obj_type_filters, true, num_obj_types);
         memset(s_status_filters, true, num_status_types);
         s_filtered_transforms_partition_iter = g_transforms.end();
+
+        g_collisions.rebuild(g_untouched_name_keys, g_transforms);
     };
 
     if (imgui::IsWindowAppearing()) {
@@ -874,6 +1130,7 @@ void swan_popup_modals::render_bulk_rename() noexcept
     }
 
     auto execute_task = [](std::vector<bulk_rename_transform> &transforms, swan_path working_directory_utf8, bool selected_only) noexcept {
+        SWAN_PROFILE_ZONE("bulk_rename_execute");
         s_transaction_task.started.store(true);
         s_transaction_task.active_token.store(true);
         SCOPE_EXIT { s_transaction_task.active_token.store(false); };
@@ -887,36 +1144,17 @@ void swan_popup_modals::render_bulk_rename() noexcept
         std::replace(working_directory.begin(), working_directory.end(), L'/', L'\\');
         if (!working_directory.ends_with(L'\\')) working_directory += L'\\';
 
-        std::wstring before, after;
-
-        try {
-            for (u64 i = 0; i < transforms.size(); ++i) {
-                if (s_transaction_task.cancellation_token.load() == true) {
-                    break;
-                }
-                auto &transform = transforms[i];
-
-                if ((selected_only && !transform.selected) || transform.stat.load() != bulk_rename_transform::status::ready) {
-                    continue;
-                }
-
-                std::string error = transform.execute(working_directory.c_str(), before, after);
+        bulk_rename_plan plan = bulk_rename_build_plan(transforms, false, selected_only);
 
-                if (error.empty()) {
-                    transform.stat.store(bulk_rename_transform::status::execute_success);
-                    ++s_transaction_counters.num_completed;
-                } else {
-                    transform.stat.store(bulk_rename_transform::status::execute_failed);
-                    transform.error = std::move(error);
-                    ++s_transaction_counters.num_failed;
-                }
-            }
-        }
-        catch (std::exception const &except) {
-            print_debug_msg("FAILED catch(std::exception) %s", except.what());
+        if (g_journal.file == INVALID_HANDLE_VALUE) {
+            (void) g_journal.open(working_directory_utf8);
         }
-        catch (...) {
-            print_debug_msg("FAILED catch(...)");
+        bool journaled = g_journal.begin_transaction(transforms, plan, false);
+
+        execute_bulk_rename_plan(transforms, plan, working_directory, false, false, s_transaction_task.cancellation_token, s_transaction_counters,
+                                 journaled ? &g_journal : nullptr);
+        if (journaled) {
+            g_journal.end_transaction();
         }
     };
 
@@ -943,6 +1181,7 @@ void swan_popup_modals::render_bulk_rename() noexcept
     };
 
     auto revert_task = [](std::vector<bulk_rename_transform> &transforms, swan_path working_directory_utf8, bool reset_names, bool selected_only) noexcept {
+        SWAN_PROFILE_ZONE("bulk_rename_revert");
         s_transaction_task.started.store(true);
         s_transaction_task.active_token.store(true);
         SCOPE_EXIT { s_transaction_task.active_token.store(false); };
@@ -956,41 +1195,17 @@ void swan_popup_modals::render_bulk_rename() noexcept
         std::replace(working_directory.begin(), working_directory.end(), L'/', L'\\');
         if (!working_directory.ends_with(L'\\')) working_directory += L'\\';
 
-        std::wstring before, after;
+        bulk_rename_plan plan = bulk_rename_build_plan(transforms, true, selected_only);
 
-        try {
-            for (u64 i = 0; i < transforms.size(); ++i) {
-                if (s_transaction_task.cancellation_token.load() == true) {
-                    break;
-                }
-                auto &transform = transforms[i];
-
-                if ((selected_only && !transform.selected) || transform.stat.load() != bulk_rename_transform::status::execute_success) {
-                    continue;
-                }
-
-                std::string error = transform.revert(working_directory.c_str(), before, after);
-
-                if (error.empty()) {
-                    if (reset_names) {
-                        transform.after = transform.before;
-                        transform.stat.store(bulk_rename_transform::status::name_unchanged);
-                    } else {
-                        transform.stat.store(bulk_rename_transform::status::ready);
-                    }
-                    ++s_transaction_counters.num_completed;
-                } else {
-                    transform.stat.store(bulk_rename_transform::status::revert_failed);
-                    transform.error = std::move(error);
-                    ++s_transaction_counters.num_failed;
-                }
-            }
+        if (g_journal.file == INVALID_HANDLE_VALUE) {
+            (void) g_journal.open(working_directory_utf8);
         }
-        catch (std::exception const &except) {
-            print_debug_msg("FAILED catch(std::exception) %s", except.what());
-        }
-        catch (...) {
-            print_debug_msg("FAILED catch(...)");
+        bool journaled = g_journal.begin_transaction(transforms, plan, true);
+
+        execute_bulk_rename_plan(transforms, plan, working_directory, true, reset_names, s_transaction_task.cancellation_token, s_transaction_counters,
+                                 journaled ? &g_journal : nullptr);
+        if (journaled) {
+            g_journal.end_transaction();
         }
     };
 
@@ -1020,8 +1235,8 @@ void swan_popup_modals::render_bulk_rename() noexcept
 
     bool exec_all_button_pressed;
     {
-        bool disabled_condition = g_transforms.empty() || s_transaction_task.active_token.load() == true || s_empty_inputs;
-        bool cross_out_condition = s_empty_inputs;
+        bool disabled_condition = g_transforms.empty() || s_transaction_task.active_token.load() == true || s_empty_inputs || g_collisions.num_conflicting > 0;
+        bool cross_out_condition = s_empty_inputs || g_collisions.num_conflicting > 0;
         exec_all_button_pressed = render_execute_all_button(disabled_condition, cross_out_condition);
     }
     if (exec_all_button_pressed) {
@@ -1085,6 +1300,12 @@ void swan_popup_modals::render_bulk_rename() noexcept
         cleanup_and_close_popup();
     }
 
+    auto pattern = render_pattern_input(transact_active, g_transforms.begin(), s_filtered_transforms_partition_iter);
+    if (pattern.applied) {
+        s_empty_inputs = false;
+        s_informational_msg = make_str(ICON_LC_MESSAGE_SQUARE_MORE " Pattern applied to %zu rows", pattern.num_applied);
+    }
+
     auto table = render_table(
         transact_active,
         g_transforms,
@@ -1133,6 +1354,14 @@ void swan_popup_modals::render_bulk_rename() noexcept
             imgui::SameLineSpaced(2);
         }
 
+        if (g_collisions.num_conflicting > 0) {
+            imgui::TextColored(error_color(), ICON_CI_WARNING " %zu", g_collisions.num_conflicting);
+            if (imgui::IsItemHovered({}, 1)) {
+                imgui::SetTooltip("%zu names conflict with another name in this directory, resolve before executing", g_collisions.num_conflicting);
+            }
+            imgui::SameLineSpaced(2);
+        }
+
         if (!s_informational_msg.empty()) {
             imgui::TextUnformatted(s_informational_msg.c_str());
 
@@ -1147,8 +1376,19 @@ void swan_popup_modals::render_bulk_rename() noexcept
         }
     }
 
-    if (imported || reset_all_button_pressed || table.any_after_text_edited) {
-        print_debug_msg("Change made (%d %d %d), updating s_last_edit_time", imported, reset_all_button_pressed, table.any_after_text_edited);
+    // bulk changes to `after` values recount everything, single edits were already counted by the table
+    {
+        static bool s_transact_active_last_frame = false;
+        bool transact_just_finished = s_transact_active_last_frame && !transact_active;
+        s_transact_active_last_frame = transact_active;
+
+        if (imported || pattern.applied || transact_just_finished) {
+            g_collisions.rebuild(g_untouched_name_keys, g_transforms);
+        }
+    }
+
+    if (imported || reset_all_button_pressed || table.any_after_text_edited || pattern.applied) {
+        print_debug_msg("Change made (%d %d %d %d), updating s_last_edit_time", imported, reset_all_button_pressed, table.any_after_text_edited, pattern.applied);
         s_last_edit_time = get_time_precise();
     }
 
@@ -1163,187 +1403,378 @@ void swan_popup_modals::render_bulk_rename() noexcept
     imgui::EndPopup();
 }
 
-bulk_rename_transform &bulk_rename_transform::operator=(bulk_rename_transform const &other) noexcept // for emplace_back
+std::string do_transform(bulk_rename_transform const &transform, wchar_t const *working_directory, std::wstring &old_name, std::wstring &new_name, bool reverse) noexcept
 {
-    this->last_updated_time = other.last_updated_time;
-    this->stat = other.stat.load();
-    this->obj_type = other.obj_type;
-    this->before = other.before;
-    this->after = other.after;
-    this->error = other.error;
-    return *this;
+    constexpr u64 utf16_buflen = MAX_PATH;
+    wchar_t before_utf16[utf16_buflen];
+    wchar_t after_utf16[utf16_buflen];
+
+    for (auto const [name_utf8, name_utf16, builder] : { std::make_tuple(&transform.before, before_utf16, &old_name),
+                                                         std::make_tuple(&transform.after, after_utf16, &new_name) }
+    ) {
+        if (!utf8_to_utf16(name_utf8->data(), name_utf16, utf16_buflen)) {
+            return make_str("Failed to convert [%s] from UTF-8 to UTF-16.", name_utf8->data());
+        }
+        assert(working_directory[wcslen(working_directory)-1] == L'\\');
+        *builder = working_directory;
+        *builder += name_utf16;
+    }
+
+    bool success;
+    if (reverse) {
+        success = MoveFileW(new_name.c_str(), old_name.c_str());
+    } else {
+        success = MoveFileW(old_name.c_str(), new_name.c_str());
+    }
+    return success ? "" : get_last_winapi_error().formatted_message;
 }
 
-bulk_rename_transform::bulk_rename_transform(const bulk_rename_transform &other) noexcept // for emplace_back
-    : last_updated_time(other.last_updated_time)
-    , stat(other.stat.load())
-    , obj_type(other.obj_type)
-    , before(other.before)
-    , after(other.after)
-    , error(other.error)
-{
+std::string bulk_rename_transform::execute(wchar_t const *working_directory, std::wstring &buffer_before, std::wstring &buffer_after) const noexcept
+try {
+    assert(this->stat.load() == status::ready);
+    return do_transform(*this, working_directory, buffer_before, buffer_after, false);
+}
+catch (std::exception const &except) {
+    return except.what();
+}
+catch (...) {
+    return "Exception, catch (...)";
 }
 
-bulk_rename_transform::bulk_rename_transform(basic_dirent const *before, char const *after) noexcept
-    : before(path_create(before->path.data()))
-    , after(path_create(after))
-    , obj_type(before->type)
-    , stat(bulk_rename_transform::status::name_unchanged)
-{
+std::string bulk_rename_transform::revert(wchar_t const *working_directory, std::wstring &buffer_before, std::wstring &buffer_after) const noexcept
+try {
+    assert(this->stat.load() == status::execute_success);
+    return do_transform(*this, working_directory, buffer_before, buffer_after, true);
+}
+catch (std::exception const &except) {
+    return except.what();
+}
+catch (...) {
+    return "Exception, catch (...)";
 }
 
-bulk_rename_transform::bulk_rename_transform(basic_dirent::kind obj_type, char const *before, char const *after) noexcept
-    : obj_type(obj_type)
-    , before(path_create(before))
-    , after(path_create(after))
-    , stat(bulk_rename_transform::status::name_unchanged)
-{
+std::filesystem::path bulk_rename_journal_path() noexcept
+try {
+    return global_state::execution_path() / "data\\bulk_rename_journal.txt";
+}
+catch (...) {
+    return {};
 }
 
-bool bulk_rename_transform::operator!=(bulk_rename_transform const &other) const noexcept // for ntest
+static
+void journal_append_str(std::string &out, char const *str) noexcept(false)
 {
-    return this->before != other.before || !path_equals_exactly(this->after, other.after);
+    out += std::to_string(strlen(str));
+    out += ' ';
+    out += str;
 }
 
-std::ostream& operator<<(std::ostream &os, bulk_rename_transform const &r) // for ntest
+static
+void journal_append_outcome(std::string &out, char outcome, u32 transform_idx) noexcept(false)
 {
-    return os << "(" << (s32)r.obj_type << ") [" << r.before.data() << "]->[" << r.after.data() << ']';
+    out += outcome;
+    out += ' ';
+    out += std::to_string(transform_idx);
+    out += '\n';
 }
 
-std::tuple<bool, std::string, u64> bulk_rename_parse_text_import(
-    char const *text_input,
-    std::vector<swan_path> &transforms_after,
-    u64 max_idx,
-    std::vector<std::string> &errors) noexcept
+/// Appends the buffered text to the file, caller must hold `this->mutex`.
+bool bulk_rename_journal::write_buffer(bool sync) noexcept
 {
-    errors.clear();
+    SCOPE_EXIT {
+        this->buffer.clear();
+        this->num_outcomes_buffered = 0;
+    };
 
-    std::string text_sanitized = text_input;
-    text_sanitized.erase(std::remove(text_sanitized.begin(), text_sanitized.end(), '\r'), text_sanitized.end());
-    u64 num_lines = 1 + std::count(text_sanitized.begin(), text_sanitized.end(), '\n');
+    if (this->file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
 
-    {
-        u64 max_num_lines = max_idx + 1;
-        if (num_lines > max_num_lines) {
-            errors.emplace_back(make_str("Tried to import %zu lines, expected max %zu lines", num_lines, max_num_lines));
-            return { false, text_sanitized, num_lines };
-        }
+    DWORD num_written = 0;
+    bool success = WriteFile(this->file, this->buffer.data(), DWORD(this->buffer.size()), &num_written, nullptr)
+                && num_written == this->buffer.size();
+
+    if (success && sync) {
+        success = FlushFileBuffers(this->file);
+    }
+    if (!success) {
+        print_debug_msg("FAILED to write bulk rename journal, %s", get_last_winapi_error().formatted_message.c_str());
     }
+    return success;
+}
 
-    bool success = true;
-    transforms_after.resize(num_lines);
-    errors = {};
+bool bulk_rename_journal::open(swan_path const &working_directory) noexcept
+try {
+    std::scoped_lock lock(this->mutex);
+    assert(this->file == INVALID_HANDLE_VALUE);
 
-    char const *valid_line_syntax = "\\[[0-9]{1,}\\] .{1,}";
-    static std::regex const s_valid_line_regex(valid_line_syntax);
+    std::filesystem::path full_path = bulk_rename_journal_path();
 
-    char const *line = strtok(text_sanitized.data(), "\n");
+    this->file = CreateFileW(full_path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (this->file == INVALID_HANDLE_VALUE) {
+        print_debug_msg("FAILED to open bulk rename journal, %s", get_last_winapi_error().formatted_message.c_str());
+        return false;
+    }
 
-    for (u64 line_num = 1; line != nullptr; ++line_num, line = strtok(nullptr, "\n")) {
-        if (cstr_empty(line)) {
-            continue;
-        }
-        std::string_view line_vw(line, strlen(line));
+    // sessions the user chose not to revert yet are kept, we append after them
+    LARGE_INTEGER file_size = {};
+    this->had_leftovers = GetFileSizeEx(this->file, &file_size) && file_size.QuadPart > 0;
+    (void) SetFilePointerEx(this->file, LARGE_INTEGER{}, nullptr, FILE_END);
 
-        if (!std::regex_match(line_vw.begin(), line_vw.end(), s_valid_line_regex)) {
-            success = false;
-            errors.emplace_back(make_str("Line %zu, syntax did not regex_match /%s/", line_num, valid_line_syntax));
-            continue;
-        }
+    this->buffer.clear();
+    if (!this->had_leftovers) {
+        this->buffer += "swan_bulk_rename_journal 1\n";
+    }
+    this->buffer += "W ";
+    journal_append_str(this->buffer, working_directory.data());
+    this->buffer += '\n';
 
-        assert(line[0] == '[');
+    return this->write_buffer(true);
+}
+catch (...) {
+    return false;
+}
 
-        char *parsed_idx_end;
-        u64 parsed_idx = strtoull(line + 1, &parsed_idx_end, 10);
-        assert(*parsed_idx_end == ']');
-        char const *cparsed_idx_end = parsed_idx_end;
+bool bulk_rename_journal::begin_transaction(std::vector<bulk_rename_transform> const &transforms, bulk_rename_plan const &plan, bool reverse) noexcept
+try {
+    using step_kind = bulk_rename_plan::step_kind;
 
-        if (parsed_idx > max_idx) {
-            success = false;
-            errors.emplace_back(make_str("Line %zu, parsed index [%zu] exceeded max of %zu", line_num, parsed_idx, max_idx));
-            continue;
-        }
+    std::scoped_lock lock(this->mutex);
 
-        u64 prefix_len = std::distance(line, cparsed_idx_end) + strlen("] ");
-        assert(prefix_len >= 4); // at minimum "[N] "
+    if (this->file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
 
-        char const *name = line + prefix_len;
-        std::string_view name_vw(name);
+    u64 num_items = 0;
+    for (auto const &job : plan.jobs) {
+        num_items += std::count_if(job.begin(), job.end(), [](bulk_rename_plan::step const &s) noexcept { return s.kind != step_kind::from_temp; });
+    }
 
-        if (name_vw.ends_with(".")) {
-            success = false;
-            errors.emplace_back(make_str("Line %zu, name ends with [.] character", line_num));
-            continue;
-        }
+    this->buffer += "B ";
+    this->buffer += std::to_string(num_items);
+    this->buffer += '\n';
 
-        {
-            char const *illegal_ch = nullptr;
-
-            for (auto const &ch : name_vw) {
-                illegal_ch = strchr("<>:\"/\\|?*", ch);
-                if (illegal_ch) {
-                    success = false;
-                    errors.emplace_back(make_str("Line %zu, name contains illegal character [%c]", line_num, *illegal_ch));
-                    break;
-                }
-            }
-            if (illegal_ch) {
+    for (auto const &job : plan.jobs) {
+        for (auto const &step : job) {
+            if (step.kind == step_kind::from_temp) {
                 continue;
             }
+            auto const &transform = transforms[step.transform_idx];
+
+            this->buffer += "I ";
+            this->buffer += std::to_string(step.transform_idx);
+            this->buffer += ' ';
+            journal_append_str(this->buffer, (reverse ? transform.after : transform.before).data());
+            this->buffer += ' ';
+            journal_append_str(this->buffer, (reverse ? transform.before : transform.after).data());
+            this->buffer += ' ';
+            journal_append_str(this->buffer, bulk_rename_temp_name(step.transform_idx).c_str());
+            this->buffer += '\n';
         }
+    }
+
+    for (auto const &job : plan.jobs) {
+        this->buffer += "J ";
+        this->buffer += std::to_string(job.size());
+        for (auto const &step : job) {
+            this->buffer += ' ';
+            this->buffer += std::to_string(step.transform_idx);
+            this->buffer += "dtf"[u64(step.kind)];
+        }
+        this->buffer += '\n';
+    }
 
-        transforms_after[parsed_idx] = path_create(name);
+    // nothing is renamed until every item is on disk
+    return this->write_buffer(true);
+}
+catch (...) {
+    return false;
+}
+
+void bulk_rename_journal::record(char outcome, u32 transform_idx) noexcept
+try {
+    std::scoped_lock lock(this->mutex);
+
+    journal_append_outcome(this->buffer, outcome, transform_idx);
+
+    // a completed cycle has the same names on disk as one which never started, so parking is never left to inference
+    if (++this->num_outcomes_buffered >= bulk_rename_journal::outcomes_per_flush || outcome == 'P') {
+        (void) this->write_buffer(true);
     }
+}
+catch (...) {
+}
 
-    return { success, text_sanitized, num_lines };
+void bulk_rename_journal::end_transaction() noexcept
+try {
+    std::scoped_lock lock(this->mutex);
+
+    this->buffer += "E\n";
+    (void) this->write_buffer(true);
+}
+catch (...) {
 }
 
-std::string do_transform(bulk_rename_transform const &transform, wchar_t const *working_directory, std::wstring &old_name, std::wstring &new_name, bool reverse) noexcept
-{
-    constexpr u64 utf16_buflen = MAX_PATH;
-    wchar_t before_utf16[utf16_buflen];
-    wchar_t after_utf16[utf16_buflen];
+void bulk_rename_journal::commit() noexcept
+try {
+    std::scoped_lock lock(this->mutex);
 
-    for (auto const [name_utf8, name_utf16, builder] : { std::make_tuple(&transform.before, before_utf16, &old_name),
-                                                         std::make_tuple(&transform.after, after_utf16, &new_name) }
-    ) {
-        if (!utf8_to_utf16(name_utf8->data(), name_utf16, utf16_buflen)) {
-            return make_str("Failed to convert [%s] from UTF-8 to UTF-16.", name_utf8->data());
+    this->buffer += "C\n";
+    (void) this->write_buffer(true);
+
+    CloseHandle(this->file);
+    this->file = INVALID_HANDLE_VALUE;
+
+    if (!this->had_leftovers) {
+        (void) DeleteFileW(bulk_rename_journal_path().c_str());
+    }
+    this->had_leftovers = false;
+}
+catch (...) {
+}
+
+std::tuple<u64, u64, bool> bulk_rename_revert_interrupted(std::vector<bulk_rename_recovery> &recoveries) noexcept
+try {
+    using status_t = bulk_rename_transform::status;
+
+    u64 num_reverted = 0;
+    u64 num_failed = 0;
+    std::string remaining = {};
+
+    for (auto &recovery : recoveries) {
+        wchar_t working_directory_utf16[MAX_PATH];
+        if (utf8_to_utf16(recovery.working_directory.data(), working_directory_utf16, lengthof(working_directory_utf16))) {
+            std::wstring working_directory = working_directory_utf16;
+            std::replace(working_directory.begin(), working_directory.end(), L'/', L'\\');
+            if (!working_directory.ends_with(L'\\')) working_directory += L'\\';
+
+            bulk_rename_plan plan = bulk_rename_build_plan(recovery.transforms, true, false);
+            std::atomic_bool never_cancelled = false;
+            transaction_counters counters = {};
+
+            execute_bulk_rename_plan(recovery.transforms, plan, working_directory, true, true, never_cancelled, counters, nullptr);
+        }
+
+        // a reverted transform has its names reset, anything else is written back to the journal as still renamed
+        u64 num_remaining = 0;
+        std::string remaining_items = {};
+        std::string remaining_outcomes = {};
+
+        for (auto const &transform : recovery.transforms) {
+            if (transform.stat.load() == status_t::name_unchanged) {
+                ++num_reverted;
+                continue;
+            }
+            print_debug_msg("FAILED to revert [%s] -> [%s], %s", transform.after.data(), transform.before.data(), transform.error.c_str());
+
+            remaining_items += "I ";
+            remaining_items += std::to_string(num_remaining);
+            remaining_items += ' ';
+            journal_append_str(remaining_items, transform.before.data());
+            remaining_items += ' ';
+            journal_append_str(remaining_items, transform.after.data());
+            remaining_items += " 0 \n";
+            journal_append_outcome(remaining_outcomes, 'D', u32(num_remaining));
+            ++num_remaining;
+        }
+
+        if (num_remaining > 0) {
+            remaining += "W ";
+            journal_append_str(remaining, recovery.working_directory.data());
+            remaining += "\nB ";
+            remaining += std::to_string(num_remaining);
+            remaining += '\n';
+            remaining += remaining_items;
+            for (u64 i = 0; i < num_remaining; ++i) {
+                remaining += "J 1 ";
+                remaining += std::to_string(i);
+                remaining += "d\n";
+            }
+            remaining += remaining_outcomes;
+            remaining += "E\n";
+            num_failed += num_remaining;
         }
-        assert(working_directory[wcslen(working_directory)-1] == L'\\');
-        *builder = working_directory;
-        *builder += name_utf16;
     }
 
-    bool success;
-    if (reverse) {
-        success = MoveFileW(new_name.c_str(), old_name.c_str());
+    std::filesystem::path full_path = bulk_rename_journal_path();
+    bool journal_updated;
+
+    if (remaining.empty()) {
+        journal_updated = DeleteFileW(full_path.c_str()) || GetLastError() == ERROR_FILE_NOT_FOUND;
     } else {
-        success = MoveFileW(old_name.c_str(), new_name.c_str());
+        // atomically, if this fails the old journal is still whole and everything is offered again next startup
+        journal_updated = write_file_atomically(full_path, "swan_bulk_rename_journal 1\n" + remaining);
+    }
+    if (!journal_updated) {
+        print_debug_msg("FAILED to update bulk rename journal [%s]", full_path.generic_string().c_str());
     }
-    return success ? "" : get_last_winapi_error().formatted_message;
-}
 
-std::string bulk_rename_transform::execute(wchar_t const *working_directory, std::wstring &buffer_before, std::wstring &buffer_after) const noexcept
-try {
-    assert(this->stat.load() == status::ready);
-    return do_transform(*this, working_directory, buffer_before, buffer_after, false);
+    print_debug_msg("reverted %zu interrupted bulk renames, %zu failed", num_reverted, num_failed);
+    return { num_reverted, num_failed, journal_updated };
 }
 catch (std::exception const &except) {
-    return except.what();
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+    return { 0, 0, false };
 }
 catch (...) {
-    return "Exception, catch (...)";
+    print_debug_msg("FAILED catch(...)");
+    return { 0, 0, false };
 }
 
-std::string bulk_rename_transform::revert(wchar_t const *working_directory, std::wstring &buffer_before, std::wstring &buffer_after) const noexcept
+void bulk_rename_offer_revert_of_interrupted() noexcept
 try {
-    assert(this->stat.load() == status::execute_success);
-    return do_transform(*this, working_directory, buffer_before, buffer_after, true);
+    std::filesystem::path full_path = bulk_rename_journal_path();
+
+    std::string journal = {};
+    {
+        std::ifstream in(full_path, std::ios::binary);
+        if (!in) {
+            return;
+        }
+        journal.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    std::vector<bulk_rename_recovery> recoveries = bulk_rename_journal_replay(journal, true);
+
+    if (recoveries.empty()) {
+        // every session was closed normally or nothing stayed renamed
+        (void) DeleteFileW(full_path.c_str());
+        return;
+    }
+
+    u64 num_items = 0;
+    for (auto const &recovery : recoveries) {
+        num_items += recovery.transforms.size();
+    }
+
+    std::string message = make_str("Swan exited unexpectedly during a bulk rename, %zu item%s in [%s]%s still %s the new name. "
+                                   "Revert to the original name%s? If not, you will be asked again next startup.",
+                                   num_items, pluralized(num_items, "", "s"), recoveries.front().working_directory.data(),
+                                   recoveries.size() > 1 ? make_str(" and %zu other directories", recoveries.size() - 1).c_str() : "",
+                                   pluralized(num_items, "has", "have"), pluralized(num_items, "", "s"));
+
+    imgui::OpenConfirmationModalWithCallback(
+        /* confirmation_id  = */ swan_id_confirm_bulk_rename_revert_interrupted,
+        /* confirmation_msg = */ message.c_str(),
+        /* on_yes_callback  = */
+        [recoveries]() mutable noexcept {
+            auto [num_reverted, num_failed, journal_updated] = bulk_rename_revert_interrupted(recoveries);
+            char const *action = "Revert interrupted bulk rename.";
+
+            if (num_failed > 0) {
+                std::string failed = make_str("%zu of %zu items failed to revert, you will be asked again next startup.", num_failed, num_reverted + num_failed);
+                swan_popup_modals::open_error(action, failed.c_str());
+            }
+            else if (!journal_updated) {
+                swan_popup_modals::open_error(action, "Everything was reverted, but the journal could not be updated, so you may be asked again next startup.");
+            }
+        },
+        /* confirmation_enabled = */ nullptr
+    );
 }
 catch (std::exception const &except) {
-    return except.what();
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
 }
 catch (...) {
-    return "Exception, catch (...)";
+    print_debug_msg("FAILED catch(...)");
 }
@@ -90,7 +90,7 @@ void swan_popup_modals::render_edit_pin() noexcept
         g_target_pin->label = s_label_input;
         g_target_pin->path = path;
 
-        (void) global_state::pinned_save_to_disk();
+        global_state::mark_dirty(persisted_file::pinned);
     };
 
     if (imgui::Button("Save" "## pin") && !cstr_empty(s_path_input.data()) && !cstr_empty(s_label_input)) {
@@ -0,0 +1,757 @@
+#include "stdafx.hpp"
+#include "common_functions.hpp"
+#include "imgui_dependent_functions.hpp"
+#include "imgui_extension.hpp"
+
+namespace mirror_modal_global_state
+{
+    static bool                             g_open = false;
+    static s32                              g_src_expl_id = -1;
+    static s32                              g_dst_expl_id = -1;
+    static progressive_task<mirror_plan>    g_scan_task = {};
+    static std::atomic<u64>                 g_num_entries_compared = 0;
+    static std::mutex                       g_init_done_mutex = {};
+    static std::condition_variable          g_init_done_cond = {};
+}
+
+struct mirror_listing_entry
+{
+    u64 size;
+    u64 last_write_time;
+    std::wstring name;
+    bool directory;
+    bool reparse_point;
+};
+
+struct mirror_walk_state
+{
+    std::mutex mutex = {};
+    std::condition_variable cond = {};
+    std::vector<std::wstring> pending = {}; // relative paths of directories which exist on both sides
+    u64 num_in_flight = 0; // pending + currently being diffed, the walk is over when this reaches 0
+};
+
+/// NTFS names are case-insensitive, so are the merge keys. Returns <0, 0, >0 like strcmp.
+static
+s32 mirror_compare_names(std::wstring const &lhs, std::wstring const &rhs) noexcept
+{
+    return CompareStringOrdinal(lhs.c_str(), s32(lhs.size()), rhs.c_str(), s32(rhs.size()), TRUE) - CSTR_EQUAL;
+}
+
+static
+basic_dirent::kind mirror_derive_kind(mirror_listing_entry const &e) noexcept
+{
+    if (e.directory) {
+        return e.reparse_point ? basic_dirent::kind::symlink_to_directory : basic_dirent::kind::directory;
+    }
+    if (e.name.ends_with(L".lnk")) {
+        return basic_dirent::kind::symlink_ambiguous;
+    }
+    return basic_dirent::kind::file;
+}
+
+/// Lists a directory sorted by `mirror_compare_names`. Returns false if the directory could not be opened.
+static
+bool mirror_list_directory(std::wstring const &directory_utf16, std::vector<mirror_listing_entry> &out) noexcept
+{
+    out.clear();
+
+    std::wstring search_path_utf16 = directory_utf16;
+    if (!search_path_utf16.ends_with(L'\\')) {
+        search_path_utf16 += L'\\';
+    }
+    search_path_utf16 += L'*';
+
+    WIN32_FIND_DATAW find_data;
+    // FindExInfoBasic skips the short name lookup, large fetch batches entries per syscall; both matter for big trees
+    HANDLE find_handle = FindFirstFileExW(search_path_utf16.c_str(), FindExInfoBasic, &find_data, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+
+    if (find_handle == INVALID_HANDLE_VALUE) {
+        return GetLastError() == ERROR_FILE_NOT_FOUND; // empty drive root
+    }
+    SCOPE_EXIT { FindClose(find_handle); };
+
+    do {
+        if (wcscmp(find_data.cFileName, L".") == 0 || wcscmp(find_data.cFileName, L"..") == 0) {
+            continue;
+        }
+
+        mirror_listing_entry entry;
+        entry.size = two_u32_to_one_u64(find_data.nFileSizeLow, find_data.nFileSizeHigh);
+        entry.last_write_time = two_u32_to_one_u64(find_data.ftLastWriteTime.dwLowDateTime, find_data.ftLastWriteTime.dwHighDateTime);
+        entry.name = find_data.cFileName;
+        entry.directory = find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY;
+        entry.reparse_point = find_data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT;
+
+        out.push_back(std::move(entry));
+    }
+    while (FindNextFileW(find_handle, &find_data));
+
+    std::sort(out.begin(), out.end(), [](mirror_listing_entry const &lhs, mirror_listing_entry const &rhs) noexcept {
+        return mirror_compare_names(lhs.name, rhs.name) < 0;
+    });
+
+    return true;
+}
+
+static
+void mirror_push_error(mirror_plan &plan, char const *action, std::wstring const &path_utf16) noexcept
+{
+    swan_path path_utf8 = path_create("");
+    (void) utf16_to_utf8(path_utf16.c_str(), path_utf8.data(), path_utf8.max_size());
+    plan.errors.push_back(make_str("%s [%s].", action, path_utf8.data()));
+}
+
+static
+void mirror_push_entry(mirror_plan &plan, mirror_plan::action act, mirror_listing_entry const *src, mirror_listing_entry const *dst, std::wstring relative_path_utf16) noexcept
+{
+    mirror_plan::entry entry;
+    entry.src_size = src ? src->size : 0;
+    entry.dst_size = dst ? dst->size : 0;
+    entry.act = act;
+    entry.type = mirror_derive_kind(src ? *src : *dst);
+    entry.relative_path_utf16 = std::move(relative_path_utf16);
+
+    switch (act) {
+        case mirror_plan::action::copy:   ++plan.num_copies;   plan.num_bytes_to_copy += entry.src_size; break;
+        case mirror_plan::action::update: ++plan.num_updates;  plan.num_bytes_to_copy += entry.src_size; break;
+        case mirror_plan::action::del:    ++plan.num_deletes;  break;
+    }
+
+    plan.entries.push_back(std::move(entry));
+}
+
+static
+bool mirror_files_differ(
+    mirror_listing_entry const &src,
+    mirror_listing_entry const &dst,
+    std::wstring const &src_path_utf16,
+    std::wstring const &dst_path_utf16,
+    mirror_plan::options options,
+    std::atomic_bool const &cancellation_token,
+    mirror_plan &plan) noexcept
+{
+    if (src.size != dst.size) {
+        return true;
+    }
+
+    if (options.compare_contents) {
+        file_hash_result src_hash = hash_file_contents(src_path_utf16.c_str(), &cancellation_token);
+        file_hash_result dst_hash = hash_file_contents(dst_path_utf16.c_str(), &cancellation_token);
+
+        if (!src_hash.success || !dst_hash.success) {
+            if (!cancellation_token.load()) {
+                mirror_push_error(plan, "Failed to compare contents of", src_path_utf16);
+            }
+            return false;
+        }
+        return src_hash.hash != dst_hash.hash;
+    }
+
+    // copies keep their last write time, so any difference means one side was modified.
+    // allow 2 seconds of slack, that is the resolution of FAT timestamps.
+    constexpr u64 slack = 2 * 10'000'000; // FILETIME ticks are 100ns
+    u64 delta = src.last_write_time > dst.last_write_time ? src.last_write_time - dst.last_write_time : dst.last_write_time - src.last_write_time;
+
+    return delta > slack;
+}
+
+/// Merge-joins the sorted listings of one directory on both sides. Directories present on both sides are appended
+/// to `sub_directories` to be diffed later, everything else resolves to at most two plan entries.
+static
+void mirror_diff_directory(
+    std::wstring const &relative_dir_utf16,
+    std::wstring const &src_root_utf16,
+    std::wstring const &dst_root_utf16,
+    mirror_plan::options options,
+    std::atomic_bool const &cancellation_token,
+    std::atomic<u64> &num_entries_compared,
+    std::vector<mirror_listing_entry> &src_listing,
+    std::vector<mirror_listing_entry> &dst_listing,
+    std::vector<std::wstring> &sub_directories,
+    mirror_plan &plan) noexcept
+{
+    auto join = [](std::wstring const &parent, std::wstring const &child) noexcept {
+        std::wstring retval = parent;
+        if (!retval.empty() && !retval.ends_with(L'\\')) {
+            retval += L'\\';
+        }
+        retval += child;
+        return retval;
+    };
+
+    std::wstring src_dir_utf16 = join(src_root_utf16, relative_dir_utf16);
+    std::wstring dst_dir_utf16 = join(dst_root_utf16, relative_dir_utf16);
+
+    if (!mirror_list_directory(src_dir_utf16, src_listing)) {
+        return mirror_push_error(plan, "Failed to list", src_dir_utf16);
+    }
+    if (!mirror_list_directory(dst_dir_utf16, dst_listing)) {
+        return mirror_push_error(plan, "Failed to list", dst_dir_utf16);
+    }
+
+    u64 i = 0, j = 0;
+
+    while (i < src_listing.size() || j < dst_listing.size()) {
+        if (cancellation_token.load()) {
+            return;
+        }
+
+        s32 cmp = i == src_listing.size() ? 1
+                : j == dst_listing.size() ? -1
+                : mirror_compare_names(src_listing[i].name, dst_listing[j].name);
+
+        if (cmp < 0) {
+            auto const &src = src_listing[i++];
+            mirror_push_entry(plan, mirror_plan::action::copy, &src, nullptr, join(relative_dir_utf16, src.name));
+        }
+        else if (cmp > 0) {
+            auto const &dst = dst_listing[j++];
+            if (options.delete_extras) {
+                mirror_push_entry(plan, mirror_plan::action::del, nullptr, &dst, join(relative_dir_utf16, dst.name));
+            }
+        }
+        else {
+            auto const &src = src_listing[i++];
+            auto const &dst = dst_listing[j++];
+
+            if (src.directory != dst.directory) {
+                // file replaced by directory or vice versa, the old one has to go regardless of `delete_extras`
+                mirror_push_entry(plan, mirror_plan::action::del, nullptr, &dst, join(relative_dir_utf16, dst.name));
+                mirror_push_entry(plan, mirror_plan::action::copy, &src, nullptr, join(relative_dir_utf16, src.name));
+            }
+            else if (src.directory) {
+                if (!src.reparse_point && !dst.reparse_point) {
+                    sub_directories.push_back(join(relative_dir_utf16, src.name));
+                }
+            }
+            else if (mirror_files_differ(src, dst, join(src_dir_utf16, src.name), join(dst_dir_utf16, dst.name), options, cancellation_token, plan)) {
+                mirror_push_entry(plan, mirror_plan::action::update, &src, &dst, join(relative_dir_utf16, src.name));
+            }
+        }
+
+        num_entries_compared.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+static
+void mirror_walk_worker(
+    mirror_walk_state &walk,
+    mirror_plan &plan,
+    std::wstring const &src_root_utf16,
+    std::wstring const &dst_root_utf16,
+    mirror_plan::options options,
+    std::atomic_bool const &cancellation_token,
+    std::atomic<u64> &num_entries_compared) noexcept
+{
+    // reused between directories to avoid reallocating per directory
+    std::vector<mirror_listing_entry> src_listing = {};
+    std::vector<mirror_listing_entry> dst_listing = {};
+    std::vector<std::wstring> sub_directories = {};
+
+    while (true) {
+        std::wstring relative_dir_utf16;
+        {
+            std::unique_lock lock(walk.mutex);
+            walk.cond.wait(lock, [&]() noexcept { return !walk.pending.empty() || walk.num_in_flight == 0; });
+
+            if (walk.pending.empty()) {
+                return;
+            }
+            relative_dir_utf16 = std::move(walk.pending.back());
+            walk.pending.pop_back();
+        }
+
+        sub_directories.clear();
+
+        if (!cancellation_token.load()) {
+            mirror_diff_directory(relative_dir_utf16, src_root_utf16, dst_root_utf16, options, cancellation_token, num_entries_compared,
+                                  src_listing, dst_listing, sub_directories, plan);
+        }
+
+        bool walk_over;
+        {
+            std::scoped_lock lock(walk.mutex);
+            walk.num_in_flight += sub_directories.size();
+            walk.num_in_flight -= 1;
+            walk_over = walk.num_in_flight == 0;
+
+            for (auto &sub_dir : sub_directories) {
+                walk.pending.push_back(std::move(sub_dir));
+            }
+        }
+
+        if (walk_over) {
+            walk.cond.notify_all();
+        } else {
+            for (u64 k = 0; k < sub_directories.size(); ++k) walk.cond.notify_one();
+        }
+    }
+}
+
+/// Walks `src_root_utf16` and `dst_root_utf16` in lockstep on several threads and stores the resulting plan in `task.result`.
+/// Directories are the unit of work: each worker diffs one directory pair at a time and queues the common subdirectories it finds.
+void build_mirror_plan(
+    progressive_task<mirror_plan> &task,
+    std::wstring src_root_utf16,
+    std::wstring dst_root_utf16,
+    mirror_plan::options options,
+    std::atomic<u64> &num_entries_compared) noexcept
+{
+    SWAN_PROFILE_FUNCTION();
+    ++global_state::foreground_io_count();
+    SCOPE_EXIT { --global_state::foreground_io_count(); };
+    task.active_token.store(true);
+    SCOPE_EXIT { task.active_token.store(false); };
+
+    std::replace(src_root_utf16.begin(), src_root_utf16.end(), L'/', L'\\');
+    std::replace(dst_root_utf16.begin(), dst_root_utf16.end(), L'/', L'\\');
+
+    mirror_walk_state walk = {};
+    walk.pending.push_back(L"");
+    walk.num_in_flight = 1;
+
+    std::vector<mirror_plan> plans(parallel_worker_count()); // one per worker, merged below
+
+    (void) run_parallel_workers(plans.size(), [&](u64 worker_idx) noexcept {
+        mirror_walk_worker(walk, plans[worker_idx], src_root_utf16, dst_root_utf16, options, task.cancellation_token, num_entries_compared);
+    });
+
+    mirror_plan merged = {};
+
+    for (auto &plan : plans) {
+        merged.num_bytes_to_copy += plan.num_bytes_to_copy;
+        merged.num_copies += plan.num_copies;
+        merged.num_updates += plan.num_updates;
+        merged.num_deletes += plan.num_deletes;
+        std::move(plan.entries.begin(), plan.entries.end(), std::back_inserter(merged.entries));
+        std::move(plan.errors.begin(), plan.errors.end(), std::back_inserter(merged.errors));
+    }
+
+    // order of execution: a delete must precede the copy which takes its place (file replaced by directory or vice versa)
+    std::sort(merged.entries.begin(), merged.entries.end(), [](mirror_plan::entry const &lhs, mirror_plan::entry const &rhs) noexcept {
+        s32 cmp = mirror_compare_names(lhs.relative_path_utf16, rhs.relative_path_utf16);
+        if (cmp != 0) return cmp < 0;
+        return lhs.act == mirror_plan::action::del && rhs.act != mirror_plan::action::del;
+    });
+
+    print_debug_msg("mirror plan: %zu copies, %zu updates, %zu deletes, %zu errors, %zu entries compared",
+                    merged.num_copies, merged.num_updates, merged.num_deletes, merged.errors.size(), num_entries_compared.load());
+
+    std::scoped_lock lock(task.result_mutex);
+    task.result = std::move(merged);
+}
+
+/// Executes a mirror plan through IFileOperation. Unlike `perform_file_operations`, collisions overwrite
+/// (that is the point of an update) and every entry has its own destination directory.
+void perform_mirror_plan(
+    s32 dst_expl_id,
+    std::wstring src_root_utf16,
+    std::wstring dst_root_utf16,
+    std::vector<mirror_plan::entry> entries,
+    std::mutex *init_done_mutex,
+    std::condition_variable *init_done_cond,
+    bool *init_done,
+    std::string *init_error,
+    char dir_sep_utf8,
+    s32 num_max_file_operations) noexcept
+{
+    SWAN_PROFILE_FUNCTION();
+    ++global_state::foreground_io_count();
+    SCOPE_EXIT { --global_state::foreground_io_count(); };
+    std::replace(src_root_utf16.begin(), src_root_utf16.end(), L'/', L'\\');
+    std::replace(dst_root_utf16.begin(), dst_root_utf16.end(), L'/', L'\\');
+
+    if (!src_root_utf16.ends_with(L'\\')) src_root_utf16 += L'\\';
+    if (!dst_root_utf16.ends_with(L'\\')) dst_root_utf16 += L'\\';
+
+    auto set_init_error_and_notify = [&](std::string const &err) noexcept {
+        std::unique_lock lock(*init_done_mutex);
+        *init_done = true;
+        *init_error = err;
+        init_done_cond->notify_one();
+    };
+
+    HRESULT result = {};
+
+    result = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+    if (FAILED(result)) {
+        return set_init_error_and_notify(make_str("CoInitializeEx(COINIT_APARTMENTTHREADED), %s", _com_error(result).ErrorMessage()));
+    }
+    SCOPE_EXIT { CoUninitialize(); };
+
+    IFileOperation *file_op = nullptr;
+
+    result = CoCreateInstance(CLSID_FileOperation, nullptr, CLSCTX_ALL, IID_PPV_ARGS(&file_op));
+    if (FAILED(result)) {
+        return set_init_error_and_notify(make_str("CoCreateInstance(CLSID_FileOperation), %s", _com_error(result).ErrorMessage()));
+    }
+    SCOPE_EXIT { file_op->Release(); };
+
+    result = file_op->SetOperationFlags(FOF_NOCONFIRMATION | FOF_NOCONFIRMMKDIR | FOF_ALLOWUNDO);
+    if (FAILED(result)) {
+        return set_init_error_and_notify(make_str("IFileOperation::SetOperationFlags, %s", _com_error(result).ErrorMessage()));
+    }
+
+    explorer_file_op_progress_sink prog_sink = {};
+    prog_sink.dst_expl_id = dst_expl_id;
+    prog_sink.dst_expl_cwd_when_operation_started = global_state::explorers()[dst_expl_id].cwd;
+    prog_sink.dir_sep_utf8 = dir_sep_utf8;
+    prog_sink.num_max_file_operations = num_max_file_operations;
+    prog_sink.verify_copies = false;
+
+    {
+        std::stringstream err = {};
+        std::wstring full_path_utf16 = {};
+        std::wstring parent_path_utf16 = {};
+
+        // entries are sorted by path, so consecutive copies usually share a destination directory
+        std::wstring cached_parent_path_utf16 = {};
+        IShellItem *cached_parent = nullptr;
+        SCOPE_EXIT { if (cached_parent) cached_parent->Release(); };
+
+        auto report = [&](char const *what, std::wstring const &path_utf16) noexcept {
+            swan_path path_utf8 = path_create("");
+            if (!utf16_to_utf8(path_utf16.c_str(), path_utf8.data(), path_utf8.max_size())) {
+                err << what << " and conversion of path from UTF-16 to UTF-8.\n";
+            } else {
+                err << what << " [" << path_utf8.data() << "].\n";
+            }
+        };
+
+        for (auto const &entry : entries) {
+            if (entry.act == mirror_plan::action::del) {
+                full_path_utf16 = dst_root_utf16 + entry.relative_path_utf16;
+
+                IShellItem *to_delete = nullptr;
+                if (FAILED(SHCreateItemFromParsingName(full_path_utf16.c_str(), nullptr, IID_PPV_ARGS(&to_delete)))) {
+                    report("SHCreateItemFromParsingName failed for", full_path_utf16);
+                    continue;
+                }
+                SCOPE_EXIT { to_delete->Release(); };
+
+                if (FAILED(file_op->DeleteItem(to_delete, nullptr))) {
+                    report("IFileOperation::DeleteItem", full_path_utf16);
+                }
+                prog_sink.contains_delete_operations = true;
+                continue;
+            }
+
+            full_path_utf16 = src_root_utf16 + entry.relative_path_utf16;
+
+            u64 last_sep = entry.relative_path_utf16.find_last_of(L'\\');
+            parent_path_utf16 = dst_root_utf16;
+            if (last_sep != std::wstring::npos) {
+                parent_path_utf16.append(entry.relative_path_utf16, 0, last_sep);
+            }
+
+            if (cached_parent == nullptr || parent_path_utf16 != cached_parent_path_utf16) {
+                if (cached_parent) {
+                    cached_parent->Release();
+                    cached_parent = nullptr;
+                }
+                if (FAILED(SHCreateItemFromParsingName(parent_path_utf16.c_str(), nullptr, IID_PPV_ARGS(&cached_parent)))) {
+                    cached_parent = nullptr;
+                    report("SHCreateItemFromParsingName failed for", parent_path_utf16);
+                    continue;
+                }
+                cached_parent_path_utf16 = parent_path_utf16;
+            }
+
+            IShellItem *to_copy = nullptr;
+            if (FAILED(SHCreateItemFromParsingName(full_path_utf16.c_str(), nullptr, IID_PPV_ARGS(&to_copy)))) {
+                report("SHCreateItemFromParsingName failed for", full_path_utf16);
+                continue;
+            }
+            SCOPE_EXIT { to_copy->Release(); };
+
+            if (FAILED(file_op->CopyItem(to_copy, cached_parent, nullptr, nullptr))) {
+                report("IFileOperation::CopyItem", full_path_utf16);
+            }
+        }
+
+        std::string errors = err.str();
+        if (!errors.empty()) {
+            errors.pop_back(); // remove trailing '\n'
+            return set_init_error_and_notify(errors);
+        }
+
+        prog_sink.group_id = global_state::completed_file_operations_next_group_id();
+    }
+
+    DWORD cookie = {};
+    result = file_op->Advise(&prog_sink, &cookie);
+    if (FAILED(result)) {
+        return set_init_error_and_notify(make_str("IFileOperation::Advise, %s", _com_error(result).ErrorMessage()));
+    }
+
+    set_init_error_and_notify(""); // init succeeded, no error
+
+    result = file_op->PerformOperations();
+    if (FAILED(result)) {
+        print_debug_msg("FAILED IFileOperation::PerformOperations, %s", _com_error(result).ErrorMessage());
+    }
+
+    result = file_op->Unadvise(cookie);
+    if (FAILED(result)) {
+        print_debug_msg("FAILED IFileOperation::Unadvise(%d), %s", cookie, _com_error(result).ErrorMessage());
+    }
+}
+
+void swan_popup_modals::open_mirror(s32 src_expl_id, s32 dst_expl_id) noexcept
+{
+    using namespace mirror_modal_global_state;
+
+    assert(src_expl_id != dst_expl_id);
+
+    g_open = true;
+    g_src_expl_id = src_expl_id;
+    g_dst_expl_id = dst_expl_id;
+}
+
+void swan_popup_modals::render_mirror() noexcept
+{
+    using namespace mirror_modal_global_state;
+
+    if (g_open) {
+        imgui::OpenPopup(swan_popup_modals::label_mirror);
+        center_window_and_set_size_when_appearing(1100, 650);
+    }
+    if (!imgui::BeginPopupModal(swan_popup_modals::label_mirror, nullptr)) {
+        return;
+    }
+
+    static mirror_plan::options s_options = {};
+    static mirror_plan::options s_scanned_options = {};
+    static swan_path s_scanned_src = path_create("");
+    static swan_path s_scanned_dst = path_create("");
+    static std::wstring s_scanned_src_utf16 = {};
+    static std::wstring s_scanned_dst_utf16 = {};
+    static bool s_scan_requested = false;
+    static std::string s_err_msg = {};
+
+    auto &src_expl = global_state::explorers()[g_src_expl_id];
+    auto &dst_expl = global_state::explorers()[g_dst_expl_id];
+
+    bool scanning = g_scan_task.active_token.load();
+
+    // caller must hold `g_scan_task.result_mutex` and not be scanning
+    auto cleanup_and_close_popup = [&]() noexcept {
+        g_open = false;
+        g_src_expl_id = -1;
+        g_dst_expl_id = -1;
+
+        s_scan_requested = false;
+        s_err_msg.clear();
+        g_scan_task.result = {};
+
+        imgui::CloseCurrentPopup();
+    };
+
+    // a plan is only good for the directories and options it was made with
+    bool plan_stale = !path_loosely_same(s_scanned_src, src_expl.cwd)
+                   || !path_loosely_same(s_scanned_dst, dst_expl.cwd)
+                   || s_scanned_options.delete_extras != s_options.delete_extras
+                   || s_scanned_options.compare_contents != s_options.compare_contents;
+
+    bool plan_ready = s_scan_requested && !scanning && !plan_stale && !g_scan_task.cancellation_token.load();
+
+    imgui::AlignTextToFramePadding();
+    imgui::TextUnformatted("From");
+    imgui::SameLine();
+    render_path_with_stylish_separators(src_expl.cwd.data(), basic_dirent::kind::directory);
+
+    imgui::AlignTextToFramePadding();
+    imgui::TextUnformatted("Into");
+    imgui::SameLine();
+    render_path_with_stylish_separators(dst_expl.cwd.data(), basic_dirent::kind::directory);
+
+    {
+        imgui::ScopedDisable d(scanning);
+
+        imgui::Checkbox("Delete extras", &s_options.delete_extras);
+        if (imgui::IsItemHovered({}, 1)) imgui::SetTooltip("Recycle files and directories which exist in the destination but not in the source.");
+
+        imgui::SameLineSpaced(1);
+
+        imgui::Checkbox("Compare contents", &s_options.compare_contents);
+        if (imgui::IsItemHovered({}, 1)) imgui::SetTooltip("Hash files of equal size instead of comparing last write times.\nSlow, reads every file on both sides.");
+    }
+
+    imgui::SameLineSpaced(2);
+
+    if (scanning) {
+        if (imgui::Button(ICON_CI_DEBUG_STOP " Cancel")) {
+            g_scan_task.cancellation_token.store(true);
+        }
+        imgui::SameLineSpaced(1);
+        ImSpinner::SpinnerBlocks("Spinner", 15.f/2.f, 5, imgui::GetStyleColorVec4(ImGuiCol_Text), imgui::GetStyleColorVec4(ImGuiCol_TextDisabled), 15);
+        imgui::SameLine();
+        imgui::Text("%zu compared", g_num_entries_compared.load());
+    }
+    else {
+        bool cannot_scan = path_is_empty(src_expl.cwd) || path_is_empty(dst_expl.cwd) || path_loosely_same(src_expl.cwd, dst_expl.cwd);
+        imgui::ScopedDisable d(cannot_scan);
+
+        if (imgui::Button(ICON_CI_DIFF " Compare")) {
+            // a UTF-16 path has no more code units than its UTF-8 has bytes, so these hold anything a swan_path can
+            std::wstring src_utf16(src_expl.cwd.max_size(), L'\0');
+            std::wstring dst_utf16(dst_expl.cwd.max_size(), L'\0');
+
+            s_err_msg.clear();
+
+            if (!utf8_to_utf16(src_expl.cwd.data(), src_utf16.data(), src_utf16.size()) || !utf8_to_utf16(dst_expl.cwd.data(), dst_utf16.data(), dst_utf16.size())) {
+                s_err_msg = "Conversion of directory path from UTF-8 to UTF-16.";
+            }
+            else {
+                src_utf16.resize(wcslen(src_utf16.c_str()));
+                dst_utf16.resize(wcslen(dst_utf16.c_str()));
+
+                s_scan_requested = true;
+                s_scanned_options = s_options;
+                s_scanned_src = src_expl.cwd;
+                s_scanned_dst = dst_expl.cwd;
+                s_scanned_src_utf16 = src_utf16;
+                s_scanned_dst_utf16 = dst_utf16;
+                g_num_entries_compared.store(0);
+                g_scan_task.cancellation_token.store(false);
+                g_scan_task.active_token.store(true); // set here too so the next frame doesn't mistake an unstarted scan for a finished one
+
+                global_state::thread_pool().push_task(build_mirror_plan, std::ref(g_scan_task), src_utf16, dst_utf16,
+                                                      s_options, std::ref(g_num_entries_compared));
+            }
+        }
+        if (cannot_scan && imgui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled)) {
+            imgui::SetTooltip("Both explorers must be in a directory, and not the same one.");
+        }
+    }
+
+    imgui::Spacing();
+    imgui::Separator();
+    imgui::Spacing();
+
+    std::scoped_lock lock(g_scan_task.result_mutex);
+    mirror_plan const &plan = g_scan_task.result;
+
+    if (plan_ready) {
+        auto bytes = format_file_size(plan.num_bytes_to_copy, global_state::settings().size_unit_multiplier);
+
+        imgui::TextColored(success_color(), ICON_CI_DIFF_ADDED " %zu", plan.num_copies);
+        imgui::SameLineSpaced(1);
+        imgui::TextColored(warning_lite_color(), ICON_CI_DIFF_MODIFIED " %zu", plan.num_updates);
+        imgui::SameLineSpaced(1);
+        imgui::TextColored(error_color(), ICON_CI_DIFF_REMOVED " %zu", plan.num_deletes);
+        imgui::SameLineSpaced(1);
+        imgui::Text("%s to copy, %zu entries compared", bytes.data(), g_num_entries_compared.load());
+
+        if (plan.entries.empty() && plan.errors.empty()) {
+            imgui::TextColored(success_color(), ICON_CI_PASS " Destination is already in sync.");
+        }
+        for (auto const &err : plan.errors) {
+            imgui::TextColored(error_color(), "Error: %s", err.c_str());
+        }
+    }
+    else if (s_scan_requested && plan_stale && !scanning) {
+        imgui::TextColored(warning_color(), "Directories or options changed since the last comparison, compare again.");
+    }
+
+    if (!s_err_msg.empty()) {
+        imgui::TextColored(error_color(), "Error: %s", s_err_msg.c_str());
+    }
+
+    ImVec2 table_size = imgui::GetContentRegionAvail();
+    table_size.y -= imgui::GetFrameHeightWithSpacing() + imgui::GetStyle().ItemSpacing.y;
+
+    if (plan_ready && !plan.entries.empty() && imgui::BeginTable("mirror_plan", 4, ImGuiTableFlags_ScrollY|ImGuiTableFlags_SizingStretchProp|ImGuiTableFlags_BordersInnerV, table_size)) {
+        imgui::TableSetupColumn("##action", ImGuiTableColumnFlags_WidthFixed);
+        imgui::TableSetupColumn("Path", ImGuiTableColumnFlags_WidthStretch);
+        imgui::TableSetupColumn("Source size", ImGuiTableColumnFlags_WidthFixed);
+        imgui::TableSetupColumn("Destination size", ImGuiTableColumnFlags_WidthFixed);
+        imgui::TableSetupScrollFreeze(0, 1);
+        imgui::TableHeadersRow();
+
+        ImGuiListClipper clipper;
+        assert(plan.entries.size() <= (u64)INT32_MAX);
+        clipper.Begin(s32(plan.entries.size()));
+
+        swan_path path_utf8;
+
+        while (clipper.Step())
+        for (u64 i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
+            auto const &entry = plan.entries[i];
+
+            imgui::TableNextColumn();
+            switch (entry.act) {
+                case mirror_plan::action::copy:   imgui::TextColored(success_color(), ICON_CI_DIFF_ADDED); break;
+                case mirror_plan::action::update: imgui::TextColored(warning_lite_color(), ICON_CI_DIFF_MODIFIED); break;
+                case mirror_plan::action::del:    imgui::TextColored(error_color(), ICON_CI_DIFF_REMOVED); break;
+            }
+
+            imgui::TableNextColumn();
+            if (!utf16_to_utf8(entry.relative_path_utf16.c_str(), path_utf8.data(), path_utf8.max_size())) {
+                path_utf8 = path_create("?");
+            }
+            path_force_separator(path_utf8, global_state::settings().dir_separator_utf8);
+            render_path_with_stylish_separators(path_utf8.data(), entry.type);
+
+            imgui::TableNextColumn();
+            if (entry.act != mirror_plan::action::del && entry.type != basic_dirent::kind::directory) {
+                imgui::TextUnformatted(format_file_size(entry.src_size, global_state::settings().size_unit_multiplier).data());
+            }
+
+            imgui::TableNextColumn();
+            if (entry.act != mirror_plan::action::copy && entry.type != basic_dirent::kind::directory) {
+                imgui::TextUnformatted(format_file_size(entry.dst_size, global_state::settings().size_unit_multiplier).data());
+            }
+        }
+
+        imgui::EndTable();
+    }
+    else {
+        imgui::Dummy(table_size);
+    }
+
+    {
+        imgui::ScopedDisable d(!plan_ready || plan.entries.empty());
+
+        if (imgui::Button(ICON_CI_MIRROR " Mirror")) {
+            bool init_done = false;
+            std::string init_error = {};
+
+            global_state::thread_pool().push_task(perform_mirror_plan,
+                g_dst_expl_id,
+                s_scanned_src_utf16,
+                s_scanned_dst_utf16,
+                plan.entries,
+                &g_init_done_mutex,
+                &g_init_done_cond,
+                &init_done,
+                &init_error,
+                global_state::settings().dir_separator_utf8,
+                global_state::settings().num_max_file_operations);
+
+            {
+                std::unique_lock init_lock(g_init_done_mutex);
+                g_init_done_cond.wait(init_lock, [&]() noexcept { return init_done; });
+            }
+
+            if (init_error.empty()) {
+                cleanup_and_close_popup();
+            } else {
+                s_err_msg = init_error;
+            }
+        }
+    }
+
+    imgui::SameLine();
+
+    if (imgui::Button("Close") || (imgui::IsWindowFocused() && imgui::IsKeyPressed(ImGuiKey_Escape))) {
+        if (scanning) {
+            g_scan_task.cancellation_token.store(true);
+        } else {
+            cleanup_and_close_popup();
+        }
+    }
+
+    imgui::EndPopup();
+}
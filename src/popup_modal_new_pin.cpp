@@ -97,7 +97,7 @@ void swan_popup_modals::render_new_pin() noexcept
 
         global_state::pinned_add(s_color_input, s_label_input, path, '\\');
 
-        (void) global_state::pinned_save_to_disk();
+        global_state::mark_dirty(persisted_file::pinned);
 
         cleanup_and_close_popup();
     }
@@ -130,9 +130,9 @@ void swan_popup_modals::render_single_rename() noexcept
             auto &pins = global_state::pinned_get();
             bool pins_updated = false;
             auto recent_files = global_state::recent_files_get();
-            bool recent_files_updated = false;
+            bool is_directory = PathIsDirectoryW(new_path_utf16.c_str());
 
-            if (PathIsDirectoryW(new_path_utf16.c_str())) {
+            if (is_directory) {
                 char const *old_path = old_path_utf8.data();
                 char const *new_path = new_path_utf8.data();
                 u64 old_path_len = path_length(old_path_utf8);
@@ -159,43 +159,18 @@ void swan_popup_modals::render_single_rename() noexcept
                         }
                     }
                 }
-
-                std::scoped_lock recent_files_lock(*recent_files.mutex);
-
-                for (auto &rf : *recent_files.container) {
-                    u64 rf_path_len = path_length(rf.path);
-                    char const *rf_path = rf.path.data();
-
-                    if (0 == StrCmpNIA(rf_path, old_path, (s32)std::min(rf_path_len, old_path_len))) {
-                        char const *rf_name = path_cfind_filename(rf_path);
-                        swan_path updated_rf_path = path_create(new_path);
-                        if (path_append(updated_rf_path, rf_name, dir_sep_utf8, true)) {
-                            rf.path = updated_rf_path;
-                            print_debug_msg("Match! (%zu) rf:[%s] o:[%s] n:[%s] u:[%s]",
-                                std::min(rf_path_len, old_path_len), rf_path, old_path, new_path, updated_rf_path.data());
-                            recent_files_updated = true;
-                        }
-                    }
-                }
             }
-            else {
-                std::scoped_lock recent_files_lock(*recent_files.mutex);
 
-                for (auto &rf : *recent_files.container) {
-                    if (path_loosely_same(rf.path, old_path_utf8)) {
-                        rf.path = new_path_utf8;
-                        recent_files_updated = true;
-                        break;
-                    }
-                }
+            {
+                std::scoped_lock recent_files_lock(*recent_files.mutex);
 
-                if (recent_files_updated) {
-                    (void) global_state::recent_files_save_to_disk(&recent_files_lock);
+                if (global_state::recent_files_path_changed(old_path_utf8.data(), new_path_utf8.data(), is_directory, &recent_files_lock) > 0) {
+                    global_state::mark_dirty(persisted_file::recent_files);
                 }
             }
 
             if (pins_updated) {
-                (void) global_state::pinned_save_to_disk();
+                global_state::mark_dirty(persisted_file::pinned);
             }
 
             g_on_rename_callback();
@@ -0,0 +1,186 @@
+#include "stdafx.hpp"
+#include "data_types.hpp"
+#include "common_functions.hpp"
+#include "imgui_dependent_functions.hpp"
+
+/*
+    Prefetcher: enumerates the directories an explorer is likely to open next into directory_listing_cache, so opening one
+    paints from the cache. Requests come from the main thread (see `prefetch_likely_next_directories` in explorer.cpp),
+    one worker drains them at background CPU and I/O priority, and holds off while the user is waiting on their own I/O.
+*/
+
+namespace swan_prefetch
+{
+    static swan_thread_pool_t g_thread_pool(1);
+
+    static u64 const MAX_QUEUED = 16;
+    static u64 const MAX_ENTRIES_PER_DIRECTORY = 4096; // bigger directories aren't cached, for bounded memory and I/O per request
+    static u64 const PAUSE_BETWEEN_DIRECTORIES_MS = 10;
+    static u64 const BACKOFF_POLL_MS = 250;
+
+    static std::mutex g_queue_mutex = {};
+    static std::deque<swan_path> g_queue = {};
+    static bool g_worker_scheduled = false; // guarded by `g_queue_mutex`
+
+    static prefetch_stats g_stats = {};
+    static std::atomic<s32> g_foreground_io_count = 0;
+}
+
+prefetch_stats &global_state::prefetch_stats_get() noexcept { return swan_prefetch::g_stats; }
+std::atomic<s32> &global_state::foreground_io_count() noexcept { return swan_prefetch::g_foreground_io_count; }
+
+/// Network drives are slow to list and removable or optical ones may need to spin up, only ever list those on request.
+static
+bool prefetch_drive_allowed(swan_path const &directory) noexcept
+{
+    if (directory[0] == '\0' || directory[1] != ':') {
+        return false; // UNC paths, or not absolute
+    }
+
+    wchar_t root[] = { wchar_t(directory[0]), L':', L'\\', L'\0' };
+    UINT drive_type = GetDriveTypeW(root);
+
+    return drive_type == DRIVE_FIXED || drive_type == DRIVE_RAMDISK;
+}
+
+static
+void prefetch_worker() noexcept
+{
+    SWAN_PROFILE_THREAD_NAME("prefetch");
+    SWAN_PROFILE_FUNCTION();
+
+    using namespace swan_prefetch;
+
+    static thread_local bool s_initialized = false;
+
+    if (!s_initialized) {
+        s_initialized = true;
+
+        // lowers the thread's I/O and memory priority along with its CPU priority
+        if (!SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN)) {
+            print_debug_msg("FAILED SetThreadPriority(THREAD_MODE_BACKGROUND_BEGIN): %s", get_last_winapi_error().formatted_message.c_str());
+        }
+    }
+
+    static directory_listing_cache::listing s_listing = {};
+
+    while (true) {
+        swan_path directory;
+        {
+            std::scoped_lock lock(g_queue_mutex);
+
+            if (g_queue.empty()) {
+                g_worker_scheduled = false;
+                return;
+            }
+            directory = g_queue.front();
+            g_queue.pop_front();
+        }
+
+        if (g_foreground_io_count.load() > 0) {
+            ++g_stats.num_backoffs;
+            do {
+                std::this_thread::sleep_for(std::chrono::milliseconds(BACKOFF_POLL_MS));
+            }
+            while (g_foreground_io_count.load() > 0);
+        }
+
+        u64 directory_key = path_loose_hash(directory.data());
+        {
+            auto listing_cache = global_state::listing_cache_get();
+            std::scoped_lock lock(*listing_cache.mutex);
+
+            if (listing_cache.container->contains(directory_key)) {
+                ++g_stats.num_already_cached;
+                continue;
+            }
+        }
+
+        if (!prefetch_drive_allowed(directory)) {
+            ++g_stats.num_skipped_drive;
+            continue;
+        }
+
+        auto result = directory_listing_enumerate(directory.data(), MAX_ENTRIES_PER_DIRECTORY, s_listing, shortcut_kind_find_cached);
+
+        if (result == directory_listing_enumerate_result::too_many_entries) {
+            ++g_stats.num_too_large;
+        }
+        else if (result != directory_listing_enumerate_result::success || s_listing.directory_write_time == 0) {
+            ++g_stats.num_failed;
+        }
+        else {
+            ++g_stats.num_enumerated;
+            s_listing.prefetched_unused = true;
+
+            // already at background priority, so classify shortcuts here rather than leave them for the explorer to defer
+            for (auto &entry : s_listing.entries) {
+                if (entry.type == basic_dirent::kind::symlink_ambiguous) {
+                    swan_path lnk_path = directory;
+                    auto name = s_listing.name(entry);
+                    if (path_append(lnk_path, std::string(name).c_str(), '\\', true)) {
+                        entry.type = shortcut_kind_resolve(lnk_path.data(), entry.last_write_time_raw);
+                    }
+                }
+            }
+
+            auto listing_cache = global_state::listing_cache_get();
+            std::scoped_lock lock(*listing_cache.mutex);
+
+            // an explorer may have enumerated it meanwhile, its listing is at least as fresh
+            if (!listing_cache.container->contains(directory_key)) {
+                listing_cache.container->store(directory_listing_cache::listing(s_listing));
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(PAUSE_BETWEEN_DIRECTORIES_MS));
+    }
+}
+
+void prefetch_directories(std::vector<swan_path> const &candidates, bool urgent) noexcept
+try {
+    using namespace swan_prefetch;
+
+    if (candidates.empty()) {
+        return;
+    }
+
+    std::scoped_lock lock(g_queue_mutex);
+
+    auto queued_already = [&](swan_path const &candidate) noexcept {
+        return std::any_of(g_queue.begin(), g_queue.end(), [&](swan_path const &queued) noexcept { return path_loosely_same(queued, candidate); });
+    };
+
+    if (urgent) {
+        // reversed so that the candidates end up at the front in the order given
+        for (auto candidate = candidates.rbegin(); candidate != candidates.rend(); ++candidate) {
+            std::erase_if(g_queue, [&](swan_path const &queued) noexcept { return path_loosely_same(queued, *candidate); });
+            g_queue.push_front(*candidate);
+        }
+    }
+    else {
+        g_stats.num_superseded += g_queue.size();
+        g_queue.clear();
+
+        for (auto const &candidate : candidates) {
+            if (!queued_already(candidate)) {
+                g_queue.push_back(candidate);
+            }
+        }
+    }
+
+    while (g_queue.size() > MAX_QUEUED) {
+        ++g_stats.num_superseded;
+        g_queue.pop_back();
+    }
+
+    g_stats.num_requested += candidates.size();
+
+    if (!g_worker_scheduled) {
+        g_worker_scheduled = true;
+        g_thread_pool.push_task(prefetch_worker);
+    }
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
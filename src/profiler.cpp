@@ -0,0 +1,461 @@
+#include "stdafx.hpp"
+#include "data_types.hpp"
+#include "common_functions.hpp"
+#include "imgui_dependent_functions.hpp"
+
+#if SWAN_PROFILER
+
+/// Single producer (its thread), single consumer (the main thread in `profiler_frame_end`).
+/// An event is two words: start, and duration << 24 | depth << 16 | zone id. Slots are atomics so a slot being overwritten
+/// while it is read is a detectable race rather than undefined behaviour, see `profiler_drain`.
+struct profiler_thread_ring
+{
+    static u64 const CAPACITY = 1 << 14;
+
+    std::array<std::atomic<u64>, CAPACITY * 2> slots = {};
+    std::atomic<u64> write_count = 0; // events ever written
+    u64 read_count = 0; // events ever drained, only touched by the consumer
+    std::atomic_bool in_use = false; // false once its thread exited, the next new thread takes it over
+    char name[32] = {};
+};
+
+static u64 const PROFILER_MAX_THREADS = 256;
+static u64 const PROFILER_MAX_ZONES = 1024;
+
+static std::mutex g_profiler_mutex = {}; // registering zones and claiming rings, never taken on the recording path
+static std::array<char const *, PROFILER_MAX_ZONES> g_profiler_zone_names = {};
+static std::atomic<u32> g_profiler_num_zones = 0;
+static std::array<profiler_thread_ring *, PROFILER_MAX_THREADS> g_profiler_rings = {};
+static std::atomic<u32> g_profiler_num_rings = 0;
+
+// main thread only
+struct profiler_zone_stats
+{
+    circular_buffer<f32> samples_us = circular_buffer<f32>(profiler_zone_summary::NUM_SAMPLES);
+    u64 num_calls_total = 0;
+    u32 num_calls_last_frame = 0;
+    f64 total_us_last_frame = 0;
+};
+static std::vector<profiler_zone_stats> g_profiler_zone_stats = {};
+static profiler_frame g_profiler_last_frame = {};
+static u64 g_profiler_frame_start_ns = 0;
+static u64 g_profiler_num_events_dropped = 0;
+static bool g_profiler_paused = false;
+static u64 g_profiler_history_ns = u64(profiler_history::DEFAULT_SECONDS) * 1'000'000'000;
+static circular_buffer<profiler_event> g_profiler_history = circular_buffer<profiler_event>(profiler_history::MAX_EVENTS);
+
+struct profiler_thread_lease
+{
+    profiler_thread_ring *ring = nullptr;
+    u32 ring_idx = 0;
+    bool attempted = false;
+
+    ~profiler_thread_lease() noexcept
+    {
+        if (this->ring) {
+            this->ring->in_use.store(false, std::memory_order_release);
+        }
+    }
+};
+static thread_local profiler_thread_lease t_profiler_lease = {};
+static thread_local u32 t_profiler_depth = 0;
+
+/// Ring of the calling thread, claimed on first use. Nullptr if all `PROFILER_MAX_THREADS` are taken.
+static
+profiler_thread_ring *profiler_thread_ring_get() noexcept
+try {
+    auto &lease = t_profiler_lease;
+
+    if (lease.ring || lease.attempted) {
+        return lease.ring;
+    }
+    lease.attempted = true;
+
+    std::scoped_lock lock(g_profiler_mutex);
+
+    u32 num_rings = g_profiler_num_rings.load(std::memory_order_relaxed);
+
+    for (u32 i = 0; i < num_rings; ++i) {
+        bool expected = false;
+        if (g_profiler_rings[i]->in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            lease.ring = g_profiler_rings[i];
+            lease.ring_idx = i;
+            break;
+        }
+    }
+
+    if (!lease.ring && num_rings < PROFILER_MAX_THREADS) {
+        auto ring = new profiler_thread_ring();
+        ring->in_use.store(true, std::memory_order_relaxed);
+        g_profiler_rings[num_rings] = ring;
+        g_profiler_num_rings.store(num_rings + 1, std::memory_order_release);
+        lease.ring = ring;
+        lease.ring_idx = num_rings;
+    }
+
+    if (lease.ring) {
+        snprintf(lease.ring->name, lengthof(lease.ring->name), "thread %lu", GetCurrentThreadId());
+    }
+
+    return lease.ring;
+}
+catch (...) {
+    return nullptr;
+}
+
+u64 profiler_now_ns() noexcept
+{
+    return u64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// Id for zones named `name`, the same for every call site using that name. `name` must outlive the program (a literal).
+u32 profiler_register_zone(char const *name) noexcept
+{
+    std::scoped_lock lock(g_profiler_mutex);
+
+    u32 num_zones = g_profiler_num_zones.load(std::memory_order_relaxed);
+
+    for (u32 i = 0; i < num_zones; ++i) {
+        if (strcmp(g_profiler_zone_names[i], name) == 0) {
+            return i;
+        }
+    }
+
+    if (num_zones == PROFILER_MAX_ZONES) {
+        return PROFILER_MAX_ZONES - 1; // lumped together with the last zone rather than lost
+    }
+
+    g_profiler_zone_names[num_zones] = name;
+    g_profiler_num_zones.store(num_zones + 1, std::memory_order_release);
+
+    return num_zones;
+}
+
+char const *profiler_zone_name(u32 zone_id) noexcept
+{
+    return zone_id < g_profiler_num_zones.load(std::memory_order_acquire) ? g_profiler_zone_names[zone_id] : "?";
+}
+
+void profiler_set_thread_name(char const *name) noexcept
+{
+    if (auto ring = profiler_thread_ring_get()) {
+        cstr_clear(ring->name);
+        strncat(ring->name, name, lengthof(ring->name) - 1);
+    }
+}
+
+char const *profiler_thread_name(u32 thread_idx) noexcept
+{
+    return thread_idx < g_profiler_num_rings.load(std::memory_order_acquire) ? g_profiler_rings[thread_idx]->name : "?";
+}
+
+profiler_scope::profiler_scope(u32 zone_id) noexcept
+    : m_start_ns(profiler_now_ns())
+    , m_zone_id(zone_id)
+    , m_depth(t_profiler_depth++)
+{
+}
+
+profiler_scope::~profiler_scope() noexcept
+{
+    --t_profiler_depth;
+
+    auto ring = profiler_thread_ring_get();
+    if (!ring) {
+        return;
+    }
+
+    u64 duration_ns = std::min(profiler_now_ns() - m_start_ns, (u64(1) << 40) - 1);
+    u64 packed = (duration_ns << 24) | (u64(std::min(m_depth, u32(UINT8_MAX))) << 16) | u64(m_zone_id & UINT16_MAX);
+
+    u64 idx = ring->write_count.load(std::memory_order_relaxed);
+    u64 slot = (idx % profiler_thread_ring::CAPACITY) * 2;
+
+    ring->slots[slot + 0].store(m_start_ns, std::memory_order_relaxed);
+    ring->slots[slot + 1].store(packed, std::memory_order_relaxed);
+    ring->write_count.store(idx + 1, std::memory_order_release);
+}
+
+/// Appends the events recorded since the previous drain by every thread to `out`.
+/// Events overwritten before they were drained, or while being drained, are counted as dropped.
+static
+void profiler_drain(std::vector<profiler_event> &out) noexcept
+try {
+    u32 num_rings = g_profiler_num_rings.load(std::memory_order_acquire);
+
+    for (u32 ring_idx = 0; ring_idx < num_rings; ++ring_idx) {
+        auto ring = g_profiler_rings[ring_idx];
+        auto const CAPACITY = profiler_thread_ring::CAPACITY;
+
+        u64 write_count = ring->write_count.load(std::memory_order_acquire);
+        u64 read_count = ring->read_count;
+
+        if (write_count - read_count > CAPACITY) {
+            g_profiler_num_events_dropped += write_count - read_count - CAPACITY;
+            read_count = write_count - CAPACITY;
+        }
+
+        u64 first_out = out.size();
+
+        for (u64 i = read_count; i < write_count; ++i) {
+            u64 slot = (i % CAPACITY) * 2;
+            u64 start_ns = ring->slots[slot + 0].load(std::memory_order_relaxed);
+            u64 packed = ring->slots[slot + 1].load(std::memory_order_relaxed);
+
+            out.push_back({ start_ns, packed >> 24, u32(packed & UINT16_MAX), u16((packed >> 16) & UINT8_MAX), u16(ring_idx) });
+        }
+
+        // the producer may have lapped us while we were copying, discard whatever it could have overwritten.
+        // It may also be in the middle of writing event `write_count_after`, whose slot holds event `write_count_after - CAPACITY`
+        std::atomic_thread_fence(std::memory_order_acquire);
+        u64 write_count_after = ring->write_count.load(std::memory_order_relaxed);
+
+        if (write_count_after >= read_count + CAPACITY) {
+            u64 num_torn = std::min(write_count_after - CAPACITY - read_count + 1, write_count - read_count);
+            out.erase(out.begin() + s64(first_out), out.begin() + s64(first_out + num_torn));
+            g_profiler_num_events_dropped += num_torn;
+        }
+
+        ring->read_count = write_count;
+    }
+}
+catch (...) {
+}
+
+void profiler_frame_begin() noexcept
+{
+    g_profiler_frame_start_ns = profiler_now_ns();
+}
+
+void profiler_frame_end() noexcept
+try {
+    u64 frame_end_ns = profiler_now_ns();
+
+    static std::vector<profiler_event> s_drained = {};
+    s_drained.clear();
+    profiler_drain(s_drained);
+
+    g_profiler_zone_stats.resize(g_profiler_num_zones.load(std::memory_order_acquire));
+
+    for (auto &stats : g_profiler_zone_stats) {
+        stats.num_calls_last_frame = 0;
+        stats.total_us_last_frame = 0;
+    }
+
+    for (auto const &event : s_drained) {
+        auto &stats = g_profiler_zone_stats[event.zone_id];
+        f64 duration_us = f64(event.duration_ns) / 1000.0;
+
+        stats.samples_us.push_back(f32(duration_us));
+        ++stats.num_calls_total;
+
+        if (event.start_ns >= g_profiler_frame_start_ns) {
+            ++stats.num_calls_last_frame;
+            stats.total_us_last_frame += duration_us;
+        }
+    }
+
+    {
+        auto &history = g_profiler_history;
+
+        for (auto const &event : s_drained) {
+            history.push_back(event); // overwrites the oldest when full
+        }
+        while (!history.empty() && history.front().start_ns + history.front().duration_ns + g_profiler_history_ns < frame_end_ns) {
+            history.pop_front();
+        }
+    }
+
+    if (!g_profiler_paused) {
+        auto &frame = g_profiler_last_frame;
+
+        frame.start_ns = g_profiler_frame_start_ns;
+        frame.end_ns = frame_end_ns;
+        frame.events.clear();
+
+        std::copy_if(s_drained.begin(), s_drained.end(), std::back_inserter(frame.events), [&](profiler_event const &e) noexcept {
+            return e.start_ns + e.duration_ns > frame.start_ns && e.start_ns < frame.end_ns;
+        });
+        std::stable_sort(frame.events.begin(), frame.events.end(), [](profiler_event const &a, profiler_event const &b) noexcept {
+            return a.thread_idx != b.thread_idx ? a.thread_idx < b.thread_idx : a.start_ns < b.start_ns;
+        });
+    }
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+profiler_frame const &profiler_last_frame() noexcept
+{
+    return g_profiler_last_frame;
+}
+
+/// Zones called at least once, busiest in the last frame first.
+std::vector<profiler_zone_summary> profiler_zone_summaries() noexcept
+try {
+    std::vector<profiler_zone_summary> summaries = {};
+    std::vector<f32> sorted = {};
+
+    for (u32 zone_id = 0; zone_id < u32(g_profiler_zone_stats.size()); ++zone_id) {
+        auto const &stats = g_profiler_zone_stats[zone_id];
+
+        if (stats.samples_us.empty()) {
+            continue;
+        }
+
+        sorted.assign(stats.samples_us.begin(), stats.samples_us.end());
+        std::sort(sorted.begin(), sorted.end());
+
+        auto percentile = [&](f64 p) noexcept { return f64(sorted[u64(p * f64(sorted.size() - 1) + 0.5)]); };
+
+        summaries.push_back({
+            .name = profiler_zone_name(zone_id),
+            .num_calls_total = stats.num_calls_total,
+            .num_calls_last_frame = stats.num_calls_last_frame,
+            .total_us_last_frame = stats.total_us_last_frame,
+            .p50_us = percentile(0.50),
+            .p95_us = percentile(0.95),
+            .p99_us = percentile(0.99),
+        });
+    }
+
+    std::stable_sort(summaries.begin(), summaries.end(), [](profiler_zone_summary const &a, profiler_zone_summary const &b) noexcept {
+        return a.total_us_last_frame > b.total_us_last_frame;
+    });
+
+    return summaries;
+}
+catch (...) {
+    return {};
+}
+
+bool &profiler_paused() noexcept
+{
+    return g_profiler_paused;
+}
+
+u64 profiler_num_events_dropped() noexcept
+{
+    return g_profiler_num_events_dropped;
+}
+
+u32 profiler_history_seconds() noexcept
+{
+    return u32(g_profiler_history_ns / 1'000'000'000);
+}
+
+void profiler_set_history_seconds(u32 seconds) noexcept
+{
+    g_profiler_history_ns = u64(std::clamp(seconds, u32(1), profiler_history::MAX_SECONDS)) * 1'000'000'000;
+}
+
+profiler_history profiler_history_copy() noexcept
+try {
+    profiler_history history = {};
+
+    history.events.assign(g_profiler_history.begin(), g_profiler_history.end());
+
+    u32 num_rings = g_profiler_num_rings.load(std::memory_order_acquire);
+    for (u32 i = 0; i < num_rings; ++i) {
+        history.thread_names.emplace_back(profiler_thread_name(i));
+    }
+
+    u32 num_zones = g_profiler_num_zones.load(std::memory_order_acquire);
+    for (u32 i = 0; i < num_zones; ++i) {
+        history.zone_names.emplace_back(profiler_zone_name(i));
+    }
+
+    return history;
+}
+catch (...) {
+    return {};
+}
+
+static
+void profiler_append_json_string(std::string &out, char const *str) noexcept
+{
+    out += '"';
+    for (char const *ch = str; *ch != '\0'; ++ch) {
+        if (*ch == '"' || *ch == '\\') {
+            out += '\\';
+        }
+        if (u8(*ch) >= 0x20) {
+            out += *ch;
+        }
+    }
+    out += '"';
+}
+
+/// Chrome Trace Event Format, a "X" (complete) event per zone and a "M" (metadata) event naming each thread.
+/// Timestamps are microseconds relative to the earliest event. Opens in ui.perfetto.dev and chrome://tracing.
+std::string profiler_format_chrome_trace(profiler_history const &history) noexcept
+try {
+    std::string out = {};
+    out.reserve(128 + history.events.size() * 96);
+
+    u64 base_ns = UINT64_MAX;
+    for (auto const &event : history.events) {
+        base_ns = std::min(base_ns, event.start_ns);
+    }
+
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    char buffer[128];
+    bool first = true;
+
+    for (u64 i = 0; i < history.thread_names.size(); ++i) {
+        snprintf(buffer, lengthof(buffer), "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"name\":\"thread_name\",\"args\":{\"name\":", first ? "" : ",\n", i);
+        out += buffer;
+        profiler_append_json_string(out, history.thread_names[i].c_str());
+        out += "}}";
+        first = false;
+    }
+
+    for (auto const &event : history.events) {
+        char const *zone_name = event.zone_id < history.zone_names.size() ? history.zone_names[event.zone_id].c_str() : "?";
+
+        out += first ? "" : ",\n";
+        out += "{\"ph\":\"X\",\"pid\":1,\"name\":";
+        profiler_append_json_string(out, zone_name);
+        snprintf(buffer, lengthof(buffer), ",\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                 u32(event.thread_idx), f64(event.start_ns - base_ns) / 1000.0, f64(event.duration_ns) / 1000.0);
+        out += buffer;
+        first = false;
+    }
+
+    out += "\n]}\n";
+
+    return out;
+}
+catch (...) {
+    return {};
+}
+
+/// Snapshots the history on the calling thread, formats and writes it on the thread pool.
+void profiler_export_chrome_trace(std::filesystem::path file_path) noexcept
+try {
+    global_state::thread_pool().push_task([](profiler_history const &history, std::filesystem::path const &file_path) noexcept {
+        SWAN_PROFILE_ZONE("profiler_export_chrome_trace");
+
+        std::string trace = profiler_format_chrome_trace(history);
+        std::error_code ec = {};
+        std::filesystem::create_directories(file_path.parent_path(), ec);
+
+        if (!trace.empty() && write_file_atomically(file_path, trace)) {
+            print_debug_msg("Exported %zu profiler zones to [%s]", history.events.size(), file_path.string().c_str());
+        } else {
+            print_debug_msg("FAILED to export profiler zones to [%s]", file_path.string().c_str());
+        }
+    }, profiler_history_copy(), std::move(file_path));
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+#endif // SWAN_PROFILER
@@ -0,0 +1,137 @@
+/*
+    Hierarchical frame profiler.
+
+    Named zones are opened with SWAN_PROFILE_ZONE("name") and closed at the end of the enclosing scope, they nest.
+    Every thread records into a ring of its own which no other thread writes, the main thread drains all of them
+    once per frame (SWAN_PROFILE_FRAME_END) without taking a lock. It keeps the latest frame's zones for the flame view
+    in the analytics window, and a rolling window of durations per zone for percentiles.
+
+    Drained zones are also kept for the last few seconds (profiler_history) so they can be exported as a Chrome trace,
+    on demand from the analytics window or once after the first frame with the --trace-startup command line flag.
+
+    Define SWAN_PROFILER as 0 to compile all of it out, the macros then expand to nothing.
+*/
+
+#pragma once
+
+#include "stdafx.hpp"
+
+#ifndef SWAN_PROFILER
+#   define SWAN_PROFILER 1
+#endif
+
+#if SWAN_PROFILER
+
+struct profiler_event
+{
+    u64 start_ns; // std::chrono::steady_clock
+    u64 duration_ns;
+    u32 zone_id;
+    u16 depth; // 0 for a zone with no enclosing zone on its thread
+    u16 thread_idx;
+};
+
+/// Zones recorded between SWAN_PROFILE_FRAME_BEGIN and SWAN_PROFILE_FRAME_END, ordered by thread then start.
+/// Includes zones of other threads which overlap the frame and ended before it did.
+struct profiler_frame
+{
+    u64 start_ns = 0;
+    u64 end_ns = 0;
+    std::vector<profiler_event> events = {};
+};
+
+struct profiler_zone_summary
+{
+    char const *name;
+    u64 num_calls_total;
+    u32 num_calls_last_frame;
+    f64 total_us_last_frame;
+    f64 p50_us; // over the latest `profiler_zone_summary::NUM_SAMPLES` calls
+    f64 p95_us;
+    f64 p99_us;
+
+    static u64 const NUM_SAMPLES = 1024;
+};
+
+/// Everything drained in the last `profiler_history_seconds()`, for exporting.
+struct profiler_history
+{
+    std::vector<profiler_event> events = {};
+    std::vector<std::string> thread_names = {}; // indexed by profiler_event::thread_idx
+    std::vector<std::string> zone_names = {}; // indexed by profiler_event::zone_id
+
+    static u32 const DEFAULT_SECONDS = 10;
+    static u32 const MAX_SECONDS = 600;
+    static u64 const MAX_EVENTS = 1 << 18; // beyond this the oldest events go first, regardless of age
+};
+
+/// Records the time spent in the enclosing scope as a zone. Use through SWAN_PROFILE_ZONE.
+class profiler_scope
+{
+public:
+    explicit profiler_scope(u32 zone_id) noexcept;
+    ~profiler_scope() noexcept;
+
+    profiler_scope(profiler_scope const &) = delete;
+    profiler_scope &operator=(profiler_scope const &) = delete;
+
+private:
+    u64 m_start_ns;
+    u32 m_zone_id;
+    u32 m_depth;
+};
+
+u64 profiler_now_ns() noexcept;
+
+u32 profiler_register_zone(char const *name) noexcept;
+
+char const *profiler_zone_name(u32 zone_id) noexcept;
+
+void profiler_set_thread_name(char const *name) noexcept;
+
+char const *profiler_thread_name(u32 thread_idx) noexcept;
+
+void profiler_frame_begin() noexcept;
+
+void profiler_frame_end() noexcept;
+
+profiler_frame const &profiler_last_frame() noexcept;
+
+std::vector<profiler_zone_summary> profiler_zone_summaries() noexcept;
+
+/// While paused the latest frame stays in the flame view, zones are still recorded and counted.
+bool &profiler_paused() noexcept;
+
+u64 profiler_num_events_dropped() noexcept;
+
+u32 profiler_history_seconds() noexcept;
+
+void profiler_set_history_seconds(u32 seconds) noexcept;
+
+profiler_history profiler_history_copy() noexcept;
+
+std::string profiler_format_chrome_trace(profiler_history const &history) noexcept;
+
+void profiler_export_chrome_trace(std::filesystem::path file_path) noexcept;
+
+#define SWAN_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SWAN_PROFILE_CONCAT(a, b) SWAN_PROFILE_CONCAT_IMPL(a, b)
+
+#define SWAN_PROFILE_ZONE(name) \
+    static u32 const SWAN_PROFILE_CONCAT(swan_profile_zone_id_, __LINE__) = profiler_register_zone(name); \
+    profiler_scope SWAN_PROFILE_CONCAT(swan_profile_scope_, __LINE__)(SWAN_PROFILE_CONCAT(swan_profile_zone_id_, __LINE__))
+
+#define SWAN_PROFILE_FUNCTION()         SWAN_PROFILE_ZONE(__func__)
+#define SWAN_PROFILE_THREAD_NAME(name)  profiler_set_thread_name(name)
+#define SWAN_PROFILE_FRAME_BEGIN()      profiler_frame_begin()
+#define SWAN_PROFILE_FRAME_END()        profiler_frame_end()
+
+#else
+
+#define SWAN_PROFILE_ZONE(name)         ((void)0)
+#define SWAN_PROFILE_FUNCTION()         ((void)0)
+#define SWAN_PROFILE_THREAD_NAME(name)  ((void)0)
+#define SWAN_PROFILE_FRAME_BEGIN()      ((void)0)
+#define SWAN_PROFILE_FRAME_END()        ((void)0)
+
+#endif // SWAN_PROFILER
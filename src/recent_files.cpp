@@ -4,119 +4,479 @@
 #include "imgui_dependent_functions.hpp"
 #include "path.hpp"
 
-static std::deque<recent_file> g_recent_files(global_constants::MAX_RECENT_FILES);
+static std::list<recent_file> g_recent_files = {};
 static std::mutex g_recent_files_mutex = {};
 
+// `path_key` -> entry. Every entry is indexed and no two entries share a key, which together with the list ordered by recency
+// makes an LRU: finding, touching (splice to front), adding and removing an entry are O(1) regardless of how many are kept.
+static std::unordered_map<u64, std::list<recent_file>::iterator> g_recent_files_index = {};
+
+// lines in data\recent_files.txt, touching an entry appends a line rather than rewriting the file
+static u64 g_recent_files_num_lines_on_disk = 0;
+
+// entries moved to the front since data\recent_files.txt was last written, appended by the next `recent_files_save_latest_to_disk`
+static u64 g_recent_files_num_touched_since_save = 0;
+
+// icons of entries forgotten off the main thread, deleted by the next render
+static std::vector<s64> g_recent_files_orphaned_icons = {};
+
+// entries of files deleted into the recycle bin this session, keyed by the `path_loose_hash` of their recycle bin path
+// (which is what `path` holds while they are here), put back in place by undelete
+static std::unordered_map<u64, recent_file> g_recent_files_recycled = {};
+
 global_state::recent_files global_state::recent_files_get() noexcept { return { &g_recent_files, &g_recent_files_mutex }; }
 
 void erase(global_state::recent_files &obj,
-           std::deque<recent_file>::iterator first,
-           std::deque<recent_file>::iterator last,
+           std::list<recent_file>::iterator first,
+           std::list<recent_file>::iterator last,
            bool perform_delete_icon_texture) noexcept
 {
-    if (perform_delete_icon_texture) {
-        for (auto iter = first; iter != last; ++iter) {
-            if (iter->icon_GLtexID > 0) delete_icon_texture(iter->icon_GLtexID, "recent_file");
+    for (auto iter = first; iter != last; ++iter) {
+        if (perform_delete_icon_texture && iter->icon_GLtexID > 0) {
+            delete_icon_texture(iter->icon_GLtexID, "recent_file");
+        }
+        if (obj.container == &g_recent_files) {
+            auto found = g_recent_files_index.find(iter->path_key);
+            if (found != g_recent_files_index.end() && found->second == iter) {
+                g_recent_files_index.erase(found);
+            }
         }
     }
     obj.container->erase(first, last);
 }
 
-void global_state::recent_files_update(char const *action, char const *full_path) noexcept
+/// Caller must hold `g_recent_files_mutex`.
+static
+std::list<recent_file>::iterator recent_files_index_find(u64 path_key) noexcept
 {
-    // u64 recent_file_idx = global_state::recent_files_find_idx(full_path);
+    auto found = g_recent_files_index.find(path_key);
+    return found == g_recent_files_index.end() ? g_recent_files.end() : found->second;
+}
 
-    // if (recent_file_idx == u64(-1)) {
-    //     global_state::recent_files_add(action, full_path);
-    // }
-    // else { // already in recent
-    //     global_state::recent_files_move_to_front(recent_file_idx, action);
-    // }
+/// Caller must hold `g_recent_files_mutex`. Safe off the main thread, icons are deleted by the next render.
+static
+void recent_files_forget(std::list<recent_file>::iterator first, std::list<recent_file>::iterator last) noexcept
+{
+    for (auto iter = first; iter != last; ++iter) {
+        if (iter->icon_GLtexID > 0) g_recent_files_orphaned_icons.push_back(iter->icon_GLtexID);
+    }
+    auto recent_files = global_state::recent_files_get();
+    erase(recent_files, first, last, false);
+}
 
-    global_state::recent_files_add(action, full_path);
-    auto [rf_container, rf_mutex] = global_state::recent_files_get();
-    {
-        std::scoped_lock rf_lock(*rf_mutex);
-        recent_files_reorder_and_dedupe(*rf_container);
+/// Caller must hold `g_recent_files_mutex`.
+static
+void recent_files_forget(std::list<recent_file>::iterator target) noexcept
+{
+    recent_files_forget(target, std::next(target));
+}
+
+/// Caller must hold `g_recent_files_mutex`. Indexes `entry` under its `path_key`. When another entry already has that key
+/// (e.g. a file was moved over another recent file) the less recent of the two is forgotten. Returns the surviving entry.
+static
+std::list<recent_file>::iterator recent_files_index_insert(std::list<recent_file>::iterator entry) noexcept
+{
+    auto [existing, inserted] = g_recent_files_index.try_emplace(entry->path_key, entry);
+    if (inserted || existing->second == entry) {
+        return entry;
     }
+
+    auto survivor = existing->second->action_time >= entry->action_time ? existing->second : entry;
+    auto forgotten = survivor == entry ? existing->second : entry;
+    existing->second = survivor;
+    recent_files_forget(forgotten);
+    return survivor;
 }
 
-u64 global_state::recent_files_find_idx(char const *search_path) noexcept
+/// Caller must hold `g_recent_files_mutex`. Forgets the least recent entries beyond `MAX_RECENT_FILES`.
+static
+void recent_files_trim() noexcept
 {
-    std::scoped_lock lock(g_recent_files_mutex);
+    while (g_recent_files.size() > global_constants::MAX_RECENT_FILES) {
+        recent_files_forget(std::prev(g_recent_files.end()));
+    }
+}
+
+/// Caller must hold `g_recent_files_mutex`. Puts an entry back where its `action_time` places it.
+static
+void recent_files_restore(recent_file &&entry, char const *path, char dir_sep_utf8) noexcept
+{
+    entry.path = path_create(path);
+    path_force_separator(entry.path, dir_sep_utf8);
+    entry.path_key = path_loose_hash(entry.path.data());
+
+    auto position = std::find_if(g_recent_files.begin(), g_recent_files.end(), [&](recent_file const &rf) noexcept { return rf.action_time < entry.action_time; });
+    (void) recent_files_index_insert(g_recent_files.insert(position, std::move(entry)));
+    recent_files_trim();
+}
+
+/// Caller must hold `g_recent_files_mutex`. Remembers `rf`, deleted into the recycle bin as `recycle_bin_path` followed by `rest`,
+/// so undelete can bring it back.
+static
+void recent_files_remember_recycled(recent_file const &rf, char const *recycle_bin_path, char const *rest) noexcept
+try {
+    recent_file entry = rf;
+    entry.icon_GLtexID = 0; // stays with the forgotten entry
+    entry.selected = false;
+    entry.path = path_create(recycle_bin_path);
+    if (cstr_empty(rest) || path_append(entry.path, rest)) {
+        entry.path_key = path_loose_hash(entry.path.data());
+        g_recent_files_recycled.insert_or_assign(entry.path_key, std::move(entry));
+    }
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
+
+/// Caller must hold `g_recent_files_mutex`. Applies `changes` in one pass over the recent files, however many there are:
+/// the outermost changed directory an entry is in is found by looking up each of its ancestors, hashed as its path is read.
+/// The directories of one batch must not be inside one another, as those renamed or moved together never are.
+static
+u64 recent_files_apply_directory_changes(std::vector<recent_files_directory_change> const &changes) noexcept
+try {
+    if (changes.empty()) {
+        return 0;
+    }
+
+    char dir_sep_utf8 = global_state::settings().dir_separator_utf8;
+
+    // `path_loose_hash` of the directory -> its change
+    std::unordered_map<u64, recent_files_directory_change const *> changes_by_key = {};
+    changes_by_key.reserve(changes.size());
+    bool any_restored = false;
+
+    for (auto const &change : changes) {
+        changes_by_key.emplace(path_loose_hash(change.old_path.c_str()), &change);
+        any_restored |= !change.deleted;
+    }
+
+    // the change of the directory `path` is in or is, and the length of that directory's path in `path`
+    auto find_change = [&](char const *path) noexcept -> std::pair<recent_files_directory_change const *, u64> {
+        u64 hashes[sizeof(swan_path) / 2 + 1]; // a separator at most every other char
+        u64 lens[sizeof(swan_path) / 2 + 1];
 
-    for (u64 i = 0; i < g_recent_files.size(); ++i) {
-        auto const &recent_file = g_recent_files[i];
-        if (path_loosely_same(recent_file.path.data(), search_path)) {
-            return i;
+        u64 num_prefixes = path_loose_hash_prefixes(path, hashes, lens, lengthof(hashes));
+
+        for (u64 i = 0; i < num_prefixes; ++i) {
+            auto found = changes_by_key.find(hashes[i]);
+            if (found != changes_by_key.end()) {
+                return { found->second, lens[i] };
+            }
+        }
+        return { nullptr, 0 };
+    };
+
+    u64 num_changed = 0;
+    std::vector<std::list<recent_file>::iterator> renamed = {};
+
+    for (auto iter = g_recent_files.begin(); iter != g_recent_files.end(); ) {
+        auto [change, directory_len] = find_change(iter->path.data());
+
+        if (change == nullptr) {
+            ++iter;
+            continue;
+        }
+
+        char const *rest = iter->path.data() + directory_len; // empty for the directory itself
+
+        if (change->deleted) {
+            if (!cstr_empty(rest)) {
+                if (!change->recycle_bin_path.empty()) {
+                    recent_files_remember_recycled(*iter, change->recycle_bin_path.c_str(), rest);
+                }
+                recent_files_forget(iter++);
+                ++num_changed;
+                continue;
+            }
+        }
+        else {
+            swan_path updated_path = path_create(change->new_path.c_str());
+            if (cstr_empty(rest) || path_append(updated_path, rest)) {
+                path_force_separator(updated_path, dir_sep_utf8);
+                g_recent_files_index.erase(iter->path_key);
+                iter->path = updated_path;
+                iter->path_key = path_loose_hash(iter->path.data());
+                renamed.push_back(iter);
+            }
+        }
+        ++iter;
+    }
+
+    // reindexed once all are renamed, so an entry's new key is not mistaken for one still waiting to change
+    for (auto iter : renamed) {
+        (void) recent_files_index_insert(iter);
+    }
+    num_changed += renamed.size();
+
+    if (any_restored) {
+        for (auto iter = g_recent_files_recycled.begin(); iter != g_recent_files_recycled.end(); ) {
+            auto [change, directory_len] = find_change(iter->second.path.data());
+            char const *rest = iter->second.path.data() + directory_len;
+
+            if (change == nullptr || change->deleted || cstr_empty(rest)) {
+                ++iter;
+                continue;
+            }
+            swan_path restored_path = path_create(change->new_path.c_str());
+            if (path_append(restored_path, rest)) {
+                recent_files_restore(std::move(iter->second), restored_path.data(), dir_sep_utf8);
+                ++num_changed;
+            }
+            iter = g_recent_files_recycled.erase(iter);
         }
     }
 
-    return u64(-1);
+    return num_changed;
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+    return 0;
 }
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return 0;
+}
+
+/// Forgets recent files deleted by a file operation, remembering them by their recycle bin path (if any) so undelete can
+/// bring them back. A directory takes every recent file inside it along, in a pass over every recent file: to delete many
+/// directories, collect them for `recent_files_directories_changed` instead. Returns the number of recent files forgotten.
+u64 global_state::recent_files_deleted(char const *path, char const *recycle_bin_path, bool is_directory, std::scoped_lock<std::mutex> *supplied_lock) noexcept
+try {
+    auto lock = supplied_lock ? std::unique_lock<std::mutex>() : std::unique_lock<std::mutex>(g_recent_files_mutex);
+
+    bool recycled = recycle_bin_path != nullptr && !cstr_empty(recycle_bin_path);
 
-void global_state::recent_files_move_to_front(u64 recent_file_idx, char const *new_action) noexcept
+    if (!is_directory) {
+        auto rf = recent_files_index_find(path_loose_hash(path));
+        if (rf == g_recent_files.end()) {
+            return 0;
+        }
+        if (recycled) {
+            recent_files_remember_recycled(*rf, recycle_bin_path, "");
+        }
+        recent_files_forget(rf);
+        return 1;
+    }
+
+    return recent_files_apply_directory_changes({ { path, "", recycled ? recycle_bin_path : "", true } });
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+    return 0;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return 0;
+}
+
+/// Keeps recent files pointing at their file after it is renamed, moved, or undeleted (`old_path` in the recycle bin).
+/// Files are found through the index in O(1). A directory carries every recent file inside it along, in a pass over every
+/// recent file: to rename or move many directories, collect them for `recent_files_directories_changed` instead.
+/// Returns the number of recent files changed.
+u64 global_state::recent_files_path_changed(char const *old_path, char const *new_path, bool is_directory, std::scoped_lock<std::mutex> *supplied_lock) noexcept
+try {
+    auto lock = supplied_lock ? std::unique_lock<std::mutex>() : std::unique_lock<std::mutex>(g_recent_files_mutex);
+
+    if (is_directory) {
+        return recent_files_apply_directory_changes({ { old_path, new_path, "", false } });
+    }
+
+    char dir_sep_utf8 = global_state::settings().dir_separator_utf8;
+
+    u64 old_path_key = path_loose_hash(old_path);
+    auto rf = recent_files_index_find(old_path_key);
+
+    if (rf == g_recent_files.end()) {
+        auto recycled = g_recent_files_recycled.find(old_path_key);
+        if (recycled == g_recent_files_recycled.end()) {
+            return 0;
+        }
+        recent_file entry = std::move(recycled->second);
+        g_recent_files_recycled.erase(recycled);
+        recent_files_restore(std::move(entry), new_path, dir_sep_utf8);
+        return 1;
+    }
+
+    g_recent_files_index.erase(rf->path_key);
+    rf->path = path_create(new_path);
+    path_force_separator(rf->path, dir_sep_utf8);
+    rf->path_key = path_loose_hash(rf->path.data());
+    (void) recent_files_index_insert(rf);
+    return 1;
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+    return 0;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return 0;
+}
+
+/// Applies the directory renames, moves, undeletes and deletes of a whole bulk rename or file operation in one pass over the
+/// recent files, so k directories cost one pass rather than k. Returns the number of recent files changed.
+u64 global_state::recent_files_directories_changed(std::vector<recent_files_directory_change> const &changes, std::scoped_lock<std::mutex> *supplied_lock) noexcept
 {
-    auto recent_files = global_state::recent_files_get();
+    auto lock = supplied_lock ? std::unique_lock<std::mutex>() : std::unique_lock<std::mutex>(g_recent_files_mutex);
+    return recent_files_apply_directory_changes(changes);
+}
 
-    std::scoped_lock lock(*recent_files.mutex);
+/// Moves the recent file for `full_path` to the front, or adds one there. O(1), no matter how many recent files are kept.
+void global_state::recent_files_update(char const *action, char const *full_path) noexcept
+try {
+    swan_path path = path_create(full_path);
+    u64 path_key = path_loose_hash(path.data());
 
-    auto temp = recent_files.container->operator[](recent_file_idx);
-    temp.action_time = get_time_system();
-    if (new_action) {
-        temp.action.clear();
-        temp.action = new_action;
+    std::scoped_lock lock(g_recent_files_mutex);
+
+    auto existing = recent_files_index_find(path_key);
+
+    if (existing != g_recent_files.end()) {
+        existing->action = action;
+        existing->action_time = get_time_system();
+        existing->path = path;
+        g_recent_files.splice(g_recent_files.begin(), g_recent_files, existing);
+    }
+    else {
+        g_recent_files.emplace_front(action, get_time_system(), 0, ImVec2(), path, false, path_key);
+        g_recent_files_index.emplace(path_key, g_recent_files.begin());
+        recent_files_trim();
     }
-    auto delete_iter = g_recent_files.begin() + recent_file_idx;
-    erase(recent_files, delete_iter, delete_iter + 1, false);
-    recent_files.container->push_front(temp);
+
+    ++g_recent_files_num_touched_since_save;
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
 }
 
-void global_state::recent_files_add(char const *action, char const *full_file_path) noexcept
+bool global_state::recent_files_contains(char const *search_path) noexcept
 {
-    swan_path path = path_create(full_file_path);
+    u64 path_key = path_loose_hash(search_path);
 
-    auto recent_files = global_state::recent_files_get();
+    std::scoped_lock lock(g_recent_files_mutex);
 
-    std::scoped_lock lock(*recent_files.mutex);
+    return recent_files_index_find(path_key) != g_recent_files.end();
+}
 
-    if (recent_files.container->size() >= global_constants::MAX_RECENT_FILES) {
-        erase(recent_files, recent_files.container->begin() + global_constants::MAX_RECENT_FILES, recent_files.container->end());
+void global_state::recent_files_move_to_front(u64 path_key, char const *new_action) noexcept
+try {
+    std::scoped_lock lock(g_recent_files_mutex);
+
+    auto target = recent_files_index_find(path_key);
+    if (target == g_recent_files.end()) {
+        return;
+    }
+
+    target->action_time = get_time_system();
+    if (new_action) {
+        target->action = new_action;
     }
-    g_recent_files.emplace_front(action, get_time_system(), 0, ImVec2(), path, "", false);
+    g_recent_files.splice(g_recent_files.begin(), g_recent_files, target);
+
+    ++g_recent_files_num_touched_since_save;
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
 }
 
-void global_state::recent_files_remove(u64 recent_file_idx) noexcept
+void global_state::recent_files_remove(u64 path_key) noexcept
 {
     auto recent_files = global_state::recent_files_get();
 
     std::scoped_lock lock(*recent_files.mutex);
 
-    auto elem_iter = recent_files.container->begin() + recent_file_idx;
-    erase(recent_files, elem_iter, elem_iter + 1);
+    auto target = recent_files_index_find(path_key);
+    if (target != g_recent_files.end()) {
+        erase(recent_files, target, std::next(target));
+    }
+}
+
+static
+void recent_files_write(std::ostream &out, recent_file const &file) noexcept
+{
+    out << file.action.size() << ' '
+        << file.action.c_str() << ' '
+        << std::chrono::system_clock::to_time_t(file.action_time) << ' '
+        << path_length(file.path) << ' '
+        << file.path.data() << '\n';
+}
+
+/// Caller must hold `g_recent_files_mutex`.
+static
+bool recent_files_rewrite_on_disk(std::filesystem::path full_path) noexcept
+try {
+    std::ostringstream out;
+
+    for (auto const &file : g_recent_files) {
+        recent_files_write(out, file);
+    }
+    g_recent_files_num_lines_on_disk = g_recent_files.size();
+    g_recent_files_num_touched_since_save = 0;
+
+    persistence_write(std::move(full_path), std::move(out).str());
+    return true;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return false;
 }
 
 bool global_state::recent_files_save_to_disk(std::scoped_lock<std::mutex> *supplied_lock) noexcept
 try {
     std::filesystem::path full_path = global_state::execution_path() / "data\\recent_files.txt";
 
-    std::ofstream iss(full_path);
+    auto lock = supplied_lock ? std::unique_lock<std::mutex>() : std::unique_lock<std::mutex>(g_recent_files_mutex);
 
-    if (!iss) {
-        return false;
-    }
+    return recent_files_rewrite_on_disk(std::move(full_path));
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+    return false;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return false;
+}
+
+/// Persists the entries moved to the front since the last save by appending a line each, so opening a file costs the same with
+/// tens of thousands of recent files as with a handful. The loader orders lines by time and drops superseded ones,
+/// the file is rewritten once they make up most of it.
+bool global_state::recent_files_save_latest_to_disk(std::scoped_lock<std::mutex> *supplied_lock) noexcept
+try {
+    std::filesystem::path full_path = global_state::execution_path() / "data\\recent_files.txt";
 
     auto lock = supplied_lock ? std::unique_lock<std::mutex>() : std::unique_lock<std::mutex>(g_recent_files_mutex);
 
-    for (auto const &file : g_recent_files) {
-        iss << file.action.size() << ' '
-            << file.action.c_str() << ' '
-            << std::chrono::system_clock::to_time_t(file.action_time) << ' '
-            << path_length(file.path) << ' '
-            << file.path.data() << '\n';
+    if (g_recent_files.empty()) {
+        return true;
+    }
+
+    if (g_recent_files_num_lines_on_disk >= std::max(2 * g_recent_files.size(), u64(256))) {
+        return recent_files_rewrite_on_disk(std::move(full_path));
     }
 
-    print_debug_msg("SUCCESS");
+    u64 num_touched = std::min(g_recent_files_num_touched_since_save, u64(g_recent_files.size()));
+
+    if (num_touched == 0) {
+        return true;
+    }
+
+    std::ostringstream out;
+
+    // oldest first, although the loader does not care
+    for (auto iter = std::next(g_recent_files.begin(), s64(num_touched)); iter != g_recent_files.begin(); ) {
+        recent_files_write(out, *--iter);
+    }
+    g_recent_files_num_lines_on_disk += num_touched;
+    g_recent_files_num_touched_since_save = 0;
+
+    persistence_write(std::move(full_path), std::move(out).str(), true);
     return true;
 }
 catch (std::exception const &except) {
@@ -141,6 +501,7 @@ try {
     std::scoped_lock lock(g_recent_files_mutex);
 
     g_recent_files.clear();
+    g_recent_files_index.clear();
 
     std::string line = {};
     line.reserve(global_state::page_size() - 1);
@@ -171,13 +532,23 @@ try {
 
         path_force_separator(stored_path, dir_separator);
 
-        g_recent_files.emplace_back(stored_action, stored_time, 0, ImVec2(), stored_path, "", false);
+        g_recent_files.emplace_back(stored_action, stored_time, 0, ImVec2(), stored_path, false, path_loose_hash(stored_path.data()));
 
         ++num_loaded_successfully;
 
         line.clear();
     }
 
+    in.close();
+
+    // lines appended by `recent_files_save_latest_to_disk` come in any order and supersede earlier ones for the same path
+    g_recent_files_num_lines_on_disk = num_loaded_successfully;
+    u64 num_superseded = recent_files_reorder_and_dedupe(g_recent_files);
+
+    if (num_superseded > 0) {
+        (void) recent_files_rewrite_on_disk(full_path);
+    }
+
     print_debug_msg("SUCCESS global_state::recent_files_load_from_disk, loaded %zu files", num_loaded_successfully);
     return { true, num_loaded_successfully };
 }
@@ -190,7 +561,7 @@ catch (...) {
     return { false, 0 };
 }
 
-u64 deselect_all(std::deque<recent_file> &recent_files) noexcept
+u64 deselect_all(std::list<recent_file> &recent_files) noexcept
 {
     u64 num_deselected = 0;
 
@@ -206,6 +577,14 @@ u64 deselect_all(std::deque<recent_file> &recent_files) noexcept
 
 bool swan_windows::render_recent_files(bool &open, bool any_popups_open) noexcept
 {
+    {
+        std::scoped_lock lock(g_recent_files_mutex);
+        for (s64 &icon_GLtexID : g_recent_files_orphaned_icons) {
+            delete_icon_texture(icon_GLtexID, "recent_file");
+        }
+        g_recent_files_orphaned_icons.clear();
+    }
+
     if (!imgui::Begin(swan_windows::get_name(swan_windows::id::recent_files), &open)) {
         return false;
     }
@@ -257,20 +636,19 @@ bool swan_windows::render_recent_files(bool &open, bool any_popups_open) noexcep
         if (status.value_or(false)) {
             std::scoped_lock lock(*recent_files.mutex);
             erase(recent_files, recent_files.container->begin(), recent_files.container->end());
-            (void) global_state::recent_files_save_to_disk(&lock);
+            global_state::mark_dirty(persisted_file::recent_files);
         }
     }
 
     static recent_file *s_context_menu_target = nullptr;
-    static u64 s_context_menu_target_idx = u64(-1);
     static std::optional<ImRect> s_context_menu_target_rect = std::nullopt;
     static u64 s_latest_selected_row_idx = u64(-1);
     static u64 s_num_selected_when_context_menu_opened = 0;
 
     auto &io = imgui::GetIO();
     bool window_hovered = imgui::IsWindowHovered(ImGuiFocusedFlags_ChildWindows);
-    u64 move_to_front_idx = u64(-1);
-    u64 remove_idx = u64(-1);
+    std::optional<u64> move_to_front_key = std::nullopt;
+    std::optional<u64> remove_key = std::nullopt;
     bool execute_forget_selection_immediately = false;
     time_point_system_t current_time = get_time_system();
 
@@ -330,9 +708,23 @@ bool swan_windows::render_recent_files(bool &open, bool any_popups_open) noexcep
         assert(g_recent_files.size() <= (u64)INT32_MAX);
         clipper.Begin((s32)g_recent_files.size());
 
+        // the list has no random access, walk a cursor to each range the clipper asks for (ranges come in ascending order)
+        auto row_iter = g_recent_files.begin();
+        u64 row_iter_idx = 0;
+
+        auto seek = [&](u64 idx) noexcept {
+            if (idx < row_iter_idx) {
+                row_iter = g_recent_files.begin();
+                row_iter_idx = 0;
+            }
+            std::advance(row_iter, idx - row_iter_idx);
+            row_iter_idx = idx;
+        };
+
         while (clipper.Step())
         for (u64 i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i) {
-            auto &file = g_recent_files[i];
+            seek(i);
+            auto &file = *row_iter;
             char *full_path = file.path.data();
             char *file_name = path_find_filename(full_path);
             auto directory = path_extract_location(full_path);
@@ -391,8 +783,9 @@ bool swan_windows::render_recent_files(bool &open, bool any_popups_open) noexcep
                     if (io.KeyShift) {
                         auto [first_idx, last_idx] = imgui::SelectRange(s_latest_selected_row_idx, i);
                         s_latest_selected_row_idx = last_idx;
-                        for (u64 j = first_idx; j <= last_idx; ++j) {
-                            g_recent_files[j].selected = true;
+                        auto range_iter = std::next(g_recent_files.begin(), first_idx);
+                        for (u64 j = first_idx; j <= last_idx; ++j, ++range_iter) {
+                            range_iter->selected = true;
                         }
                     } else {
                         s_latest_selected_row_idx = i;
@@ -406,16 +799,15 @@ bool swan_windows::render_recent_files(bool &open, bool any_popups_open) noexcep
                 auto res = open_file(file_name, file_directory.data()); // TODO async
 
                 if (res.success) {
-                    move_to_front_idx = i;
+                    move_to_front_key = file.path_key;
                 } else {
                     swan_popup_modals::open_error(make_str("Open file [%s].", full_path).c_str(), res.error_or_utf8_path.c_str());
-                    remove_idx = i;
+                    remove_key = file.path_key;
                 }
             }
             if (right_clicked) {
                 imgui::OpenPopup("## recent_files context_menu");
-                s_context_menu_target = &g_recent_files[i];
-                s_context_menu_target_idx = i;
+                s_context_menu_target = &file;
                 s_context_menu_target_rect = imgui::GetItemRect();
 
                 bool keep_any_selected_state = s_context_menu_target->selected;
@@ -448,7 +840,6 @@ bool swan_windows::render_recent_files(bool &open, bool any_popups_open) noexcep
             }
         } else {
             s_context_menu_target = nullptr;
-            s_context_menu_target_idx = u64(-1);
             s_context_menu_target_rect = std::nullopt;
         }
 
@@ -472,7 +863,7 @@ bool swan_windows::render_recent_files(bool &open, bool any_popups_open) noexcep
                             std::string action = make_str("Open file location [%s].", full_path);
                             char const *failure = "File not found.";
                             swan_popup_modals::open_error(action.c_str(), failure);
-                            remove_idx = s_context_menu_target_idx;
+                            remove_key = s_context_menu_target->path_key;
                         }
                         else {
                             (void) find_in_swan_explorer_0(full_path);
@@ -526,7 +917,7 @@ bool swan_windows::render_recent_files(bool &open, bool any_popups_open) noexcep
                             /* on_yes_callback      = */
                             [&reveal_selection]() noexcept {
                                 reveal_selection();
-                                (void) global_state::settings().save_to_disk();
+                                global_state::mark_dirty(persisted_file::settings);
                             },
                             /* confirmation_enabled = */ &(global_state::settings().confirm_recent_files_reveal_selected_in_win_file_expl)
                         );
@@ -536,7 +927,7 @@ bool swan_windows::render_recent_files(bool &open, bool any_popups_open) noexcep
 
             if (imgui::Selectable("Forget")) {
                 if (s_num_selected_when_context_menu_opened <= 1) {
-                    remove_idx = s_context_menu_target_idx;
+                    remove_key = s_context_menu_target->path_key;
                 }
                 else {
                     execute_forget_selection_immediately = imgui::OpenConfirmationModal(
@@ -552,8 +943,7 @@ bool swan_windows::render_recent_files(bool &open, bool any_popups_open) noexcep
                 {
                     std::string clipboard = {};
 
-                    for (u64 i = 0; i < g_recent_files.size(); ++i) {
-                        auto const &cfo = g_recent_files[i];
+                    for (auto const &cfo : g_recent_files) {
                         if (cfo.selected) {
                             std::string_view copy_content = extract(cfo);
                             clipboard.append(copy_content);
@@ -606,62 +996,70 @@ bool swan_windows::render_recent_files(bool &open, bool any_popups_open) noexcep
             if (execute_forget_selection_immediately || status.value_or(false)) {
                 auto recent_files = global_state::recent_files_get();
 
-                auto delete_iter = std::stable_partition(g_recent_files.begin(), g_recent_files.end(),
-                    [](recent_file const &rf) noexcept { return !rf.selected; });
-
-                erase(recent_files, delete_iter, g_recent_files.end());
+                for (auto iter = g_recent_files.begin(); iter != g_recent_files.end(); ) {
+                    auto next = std::next(iter);
+                    if (iter->selected) {
+                        erase(recent_files, iter, next);
+                    }
+                    iter = next;
+                }
 
-                (void) global_state::recent_files_save_to_disk(&recent_files_lock);
-                (void) global_state::settings().save_to_disk(); // persist potential change to confirmation checkbox
+                global_state::mark_dirty(persisted_file::recent_files);
+                global_state::mark_dirty(persisted_file::settings); // persist potential change to confirmation checkbox
             }
         }
 
         imgui::EndTable();
     }
 
-    if (remove_idx != u64(-1)) {
-        (void) global_state::recent_files_remove(remove_idx);
-        (void) global_state::recent_files_save_to_disk(nullptr);
+    if (remove_key.has_value()) {
+        (void) global_state::recent_files_remove(remove_key.value());
+        global_state::mark_dirty(persisted_file::recent_files);
     }
-    if (move_to_front_idx != u64(-1)) {
-        global_state::recent_files_move_to_front(move_to_front_idx, "Opened");
-        (void) global_state::recent_files_save_to_disk(nullptr);
+    if (move_to_front_key.has_value()) {
+        global_state::recent_files_move_to_front(move_to_front_key.value(), "Opened");
+        global_state::mark_dirty(persisted_file::recent_files_latest);
     }
 
     return true;
 }
 
-u64 recent_files_reorder_and_dedupe(std::deque<recent_file> &elems) noexcept
-{
-    u64 failures = 0;
-
-    // Order by recency descending
-    std::sort(elems.begin(), elems.end(), [](recent_file const &a, recent_file const &b) noexcept {
+/// Orders `elems` by recency and drops all but the most recent entry of each path, as well as entries beyond `MAX_RECENT_FILES`.
+/// Run on `g_recent_files` after loading, it also rebuilds the recent files index. Returns the number of entries dropped.
+u64 recent_files_reorder_and_dedupe(std::list<recent_file> &elems) noexcept
+try {
+    // Order by recency descending, stable so the earliest of equally recent duplicates is kept
+    elems.sort([](recent_file const &a, recent_file const &b) noexcept {
         return a.action_time > b.action_time;
     });
 
-    // Standardize each element to avoid the need for path_loosely_same
-    for (auto &elem : elems) {
-        auto [success, utf8_lower] = utf8_lowercase(elem.path.data());
-        if (success) {
-            elem.path2 = utf8_lower.data();
-            std::replace(elem.path2.begin(), elem.path2.end(), '\\', '/');
-        } else {
-            elem.path2 = "";
-            ++failures;
-        }
-    }
+    std::unordered_map<u64, std::list<recent_file>::iterator> index = {};
+    index.reserve(elems.size());
 
-    std::unordered_set<std::string> paths_seen = {};
+    u64 num_dropped = 0;
 
     for (auto iter = elems.begin(); iter != elems.end(); ) {
-        if (paths_seen.contains(iter->path2)) {
-            iter = elems.erase(iter);
-        } else {
-            paths_seen.emplace(iter->path2);
+        iter->path_key = path_loose_hash(iter->path.data());
+
+        if (index.size() < global_constants::MAX_RECENT_FILES && index.try_emplace(iter->path_key, iter).second) {
             ++iter;
+        } else {
+            iter = elems.erase(iter);
+            ++num_dropped;
         }
     }
 
-    return failures;
+    if (&elems == &g_recent_files) {
+        g_recent_files_index = std::move(index);
+    }
+
+    return num_dropped;
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+    return 0;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return 0;
 }
@@ -46,7 +46,7 @@ bool swan_windows::render_settings(bool &open, [[maybe_unused]] bool any_popups_
 
     if (s_regular_change) {
         s_regular_change = false;
-        (void) settings.save_to_disk();
+        global_state::mark_dirty(persisted_file::settings);
     }
 
     return true;
@@ -54,11 +54,7 @@ bool swan_windows::render_settings(bool &open, [[maybe_unused]] bool any_popups_
 
 bool swan_settings::save_to_disk() const noexcept
 try {
-    std::filesystem::path full_path = global_state::execution_path() / "data\\swan_settings.txt";
-    std::ofstream ofs(full_path);
-    if (!ofs) {
-        return false;
-    }
+    std::ostringstream ofs;
 
     static_assert(s8(1) == s8(true));
     static_assert(s8(0) == s8(false));
@@ -101,6 +97,7 @@ try {
 
     write_bool("file_operations_src_path_full", this->file_operations_src_path_full);
     write_bool("file_operations_dst_path_full", this->file_operations_dst_path_full);
+    write_bool("file_operations_verify_copies", this->file_operations_verify_copies);
 
     write_bool("startup_with_window_maximized", this->startup_with_window_maximized);
     write_bool("startup_with_previous_window_pos_and_size", this->startup_with_previous_window_pos_and_size);
@@ -136,6 +133,7 @@ try {
     write_bool("show.imgui_demo", this->show.imgui_demo);
     write_bool("show.theme_editor", this->show.theme_editor);
     write_bool("show.icon_library", this->show.icon_library);
+    write_bool("show.disk_usage", this->show.disk_usage);
 
     write_ImVec4("color.success", this->success_color);
     write_ImVec4("color.warning", this->warning_color);
@@ -211,7 +209,7 @@ try {
 
     ofs << serialize_ImGuiStyle(imgui::GetStyle(), 8192, serialize_ImGuiStyle_mode::plain_text);
 
-    print_debug_msg("SUCCESS");
+    persistence_write(global_state::execution_path() / "data\\swan_settings.txt", std::move(ofs).str());
     return true;
 }
 catch (std::exception const &except) {
@@ -404,6 +402,9 @@ try {
             else if (remainder == "imspinner_demo") {
                 this->show.imspinner_demo = extract_bool();
             }
+            else if (remainder == "disk_usage") {
+                this->show.disk_usage = extract_bool();
+            }
             else {
                 print_debug_msg("Unknown property [%s] at line %zu, skipping...", property.c_str(), line_num);
                 ++num_lines_skipped;
@@ -1052,6 +1053,9 @@ try {
             else if (property == "file_operations_dst_path_full") {
                 this->file_operations_dst_path_full = extract_bool();
             }
+            else if (property == "file_operations_verify_copies") {
+                this->file_operations_verify_copies = extract_bool();
+            }
 
             else if (property == "startup_with_window_maximized") {
                 this->startup_with_window_maximized = extract_bool();
@@ -0,0 +1,209 @@
+#include "stdafx.hpp"
+#include "data_types.hpp"
+#include "common_functions.hpp"
+#include "imgui_dependent_functions.hpp"
+
+/*
+    Shortcut (.lnk) classification: whether a shortcut points to a file, a directory or nothing takes loading it through COM
+    and stat'ing its target, too slow to do for every .lnk while listing a directory. Listings show unknown shortcuts as
+    `symlink_ambiguous`, explorers hand those to `shortcut_kinds_resolve_deferred`, and one worker resolves them in batches
+    into shortcut_kind_cache, after each of which the explorer upgrades its entries (see `apply_known_shortcut_kinds` in explorer.cpp).
+*/
+
+namespace swan_shortcuts
+{
+    static swan_thread_pool_t g_thread_pool(1);
+
+    static u64 const BATCH_SIZE = 32;
+
+    static shortcut_kind_cache g_cache = {};
+    static std::mutex g_cache_mutex = {};
+
+    struct request
+    {
+        s32 expl_id;
+        swan_path directory;
+        std::vector<shortcut_to_resolve> shortcuts;
+    };
+
+    static std::mutex g_queue_mutex = {};
+    static std::deque<request> g_queue = {};
+    static bool g_worker_scheduled = false; // guarded by `g_queue_mutex`
+}
+
+global_state::shortcut_cache global_state::shortcut_cache_get() noexcept { return { &swan_shortcuts::g_cache, &swan_shortcuts::g_cache_mutex }; }
+
+bool shortcut_kind_cache::find(u64 lnk_key, platform_file_time lnk_write_time, basic_dirent::kind &out) noexcept
+{
+    auto found = this->targets.find(lnk_key);
+
+    if (found == this->targets.end() || found->second.lnk_write_time != lnk_write_time) {
+        ++this->num_misses;
+        return false;
+    }
+
+    ++this->num_hits;
+    out = found->second.kind;
+    return true;
+}
+
+void shortcut_kind_cache::store(u64 lnk_key, platform_file_time lnk_write_time, basic_dirent::kind kind) noexcept
+try {
+    if (this->targets.size() >= MAX_SHORTCUTS && !this->targets.contains(lnk_key)) {
+        this->targets.clear();
+    }
+    this->targets[lnk_key] = { lnk_write_time, kind };
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    this->targets.clear();
+}
+
+bool shortcut_kind_find_cached(char const *lnk_path_utf8, platform_file_time lnk_write_time, basic_dirent::kind &out) noexcept
+{
+    auto shortcut_cache = global_state::shortcut_cache_get();
+    std::scoped_lock lock(*shortcut_cache.mutex);
+
+    return shortcut_cache.container->find(path_loose_hash(lnk_path_utf8), lnk_write_time, out);
+}
+
+basic_dirent::kind shortcut_kind_resolve(char const *lnk_path_utf8, platform_file_time lnk_write_time) noexcept
+{
+    SWAN_PROFILE_FUNCTION();
+
+    u64 lnk_key = path_loose_hash(lnk_path_utf8);
+    {
+        auto shortcut_cache = global_state::shortcut_cache_get();
+        std::scoped_lock lock(*shortcut_cache.mutex);
+
+        if (basic_dirent::kind kind; shortcut_cache.container->find(lnk_key, lnk_write_time, kind)) {
+            return kind;
+        }
+    }
+
+    // threads calling this live as long as the process, so their COM apartment and shell link objects do too
+    static thread_local IShellLinkW *s_shell_link = nullptr;
+    static thread_local IPersistFile *s_persist_file = nullptr;
+    static thread_local bool s_initialized = false;
+
+    if (!s_initialized) {
+        s_initialized = true;
+
+        HRESULT result = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+
+        if ((FAILED(result) && result != RPC_E_CHANGED_MODE) ||
+            FAILED(CoCreateInstance(CLSID_ShellLink, nullptr, CLSCTX_INPROC_SERVER, IID_IShellLinkW, (LPVOID *)&s_shell_link)) ||
+            FAILED(s_shell_link->QueryInterface(IID_IPersistFile, (LPVOID *)&s_persist_file)))
+        {
+            print_debug_msg("FAILED to initialize COM for resolving shortcuts on this thread");
+            s_persist_file = nullptr;
+        }
+    }
+
+    if (s_persist_file == nullptr) {
+        return basic_dirent::kind::symlink_ambiguous; // not cached, maybe another thread has better luck
+    }
+
+    basic_dirent::kind kind = basic_dirent::kind::invalid_symlink; // default value, if something fails below
+
+    wchar_t lnk_path_utf16[MAX_PATH];
+
+    if (!utf8_to_utf16(lnk_path_utf8, lnk_path_utf16, lengthof(lnk_path_utf16))) {
+        return basic_dirent::kind::symlink_ambiguous;
+    }
+
+    // Load the shortcut
+    HRESULT com_handle = s_persist_file->Load(lnk_path_utf16, STGM_READ);
+    if (FAILED(com_handle)) {
+        WCOUT_IF_DEBUG("FAILED IPersistFile::Load [" << lnk_path_utf16 << "]\n");
+    }
+    else {
+        // Get the target path
+        wchar_t target_path_utf16[MAX_PATH];
+        com_handle = s_shell_link->GetPath(target_path_utf16, lengthof(target_path_utf16), NULL, SLGP_RAWPATH);
+        if (FAILED(com_handle)) {
+            WCOUT_IF_DEBUG("FAILED IShellLinkW::GetPath [" << lnk_path_utf16 << "]\n");
+        }
+        else {
+            if      (PathIsDirectoryW(target_path_utf16)) kind = basic_dirent::kind::symlink_to_directory;
+            else if (PathFileExistsW(target_path_utf16))  kind = basic_dirent::kind::symlink_to_file;
+            else                                          kind = basic_dirent::kind::invalid_symlink;
+        }
+    }
+
+    {
+        auto shortcut_cache = global_state::shortcut_cache_get();
+        std::scoped_lock lock(*shortcut_cache.mutex);
+        shortcut_cache.container->store(lnk_key, lnk_write_time, kind);
+    }
+
+    return kind;
+}
+
+static
+void shortcut_resolve_worker() noexcept
+{
+    SWAN_PROFILE_THREAD_NAME("shortcuts");
+    SWAN_PROFILE_FUNCTION();
+
+    using namespace swan_shortcuts;
+
+    while (true) {
+        request req;
+        {
+            std::scoped_lock lock(g_queue_mutex);
+
+            if (g_queue.empty()) {
+                g_worker_scheduled = false;
+                return;
+            }
+            req = std::move(g_queue.front());
+            g_queue.pop_front();
+        }
+
+        u64 directory_key = path_loose_hash(req.directory.data());
+
+        for (u64 batch_start = 0; batch_start < req.shortcuts.size(); batch_start += BATCH_SIZE) {
+            u64 batch_end = std::min(batch_start + BATCH_SIZE, req.shortcuts.size());
+
+            for (u64 i = batch_start; i < batch_end; ++i) {
+                swan_path lnk_path = req.directory;
+                if (path_append(lnk_path, req.shortcuts[i].name.data(), '\\', true)) {
+                    (void) shortcut_kind_resolve(lnk_path.data(), req.shortcuts[i].lnk_write_time);
+                }
+            }
+
+            global_state::explorers()[req.expl_id].resolved_shortcuts_key.store(directory_key);
+            global_state::wake_render_loop();
+
+            // the explorer navigated elsewhere (or refreshed), what it wants now is queued
+            std::scoped_lock lock(g_queue_mutex);
+            if (std::any_of(g_queue.begin(), g_queue.end(), [&](request const &queued) noexcept { return queued.expl_id == req.expl_id; })) {
+                break;
+            }
+        }
+    }
+}
+
+void shortcut_kinds_resolve_deferred(s32 expl_id, swan_path const &directory, std::vector<shortcut_to_resolve> &&shortcuts) noexcept
+try {
+    using namespace swan_shortcuts;
+
+    std::scoped_lock lock(g_queue_mutex);
+
+    std::erase_if(g_queue, [&](request const &queued) noexcept { return queued.expl_id == expl_id; });
+
+    if (shortcuts.empty()) {
+        return;
+    }
+
+    g_queue.push_back({ expl_id, directory, std::move(shortcuts) });
+
+    if (!g_worker_scheduled) {
+        g_worker_scheduled = true;
+        g_thread_pool.push_task(shortcut_resolve_worker);
+    }
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+}
@@ -0,0 +1,569 @@
+#include "stdafx.hpp"
+#include "common_functions.hpp"
+#include "imgui_dependent_functions.hpp"
+#include "path.hpp"
+#include "util.hpp"
+
+static_assert(std::is_trivially_copyable_v<swan_settings>);
+static_assert(std::is_trivially_copyable_v<ImGuiStyle>);
+
+/// Fingerprint of the memory layout of `swan_settings`: the name, offset and size of every field.
+/// The settings section stores it ahead of the raw struct and is ignored unless it matches, so reordering, resizing or renaming
+/// a field falls back to the text file rather than loading garbage. Add new fields here too, most additions change the size anyway.
+static
+u64 swan_settings_layout_fingerprint() noexcept
+{
+    std::string layout = {};
+
+    auto field = [&](char const *name, u64 offset, u64 size) noexcept {
+        layout += make_str("%s %zu %zu\n", name, offset, size);
+    };
+
+#define SWAN_SETTINGS_FIELD(member) field(#member, offsetof(swan_settings, member), sizeof(swan_settings().member))
+    SWAN_SETTINGS_FIELD(success_color);
+    SWAN_SETTINGS_FIELD(warning_color);
+    SWAN_SETTINGS_FIELD(warning_lite_color);
+    SWAN_SETTINGS_FIELD(error_color);
+    SWAN_SETTINGS_FIELD(directory_color);
+    SWAN_SETTINGS_FIELD(file_color);
+    SWAN_SETTINGS_FIELD(symlink_color);
+    SWAN_SETTINGS_FIELD(num_max_file_operations);
+    SWAN_SETTINGS_FIELD(window_x);
+    SWAN_SETTINGS_FIELD(window_y);
+    SWAN_SETTINGS_FIELD(window_w);
+    SWAN_SETTINGS_FIELD(window_h);
+    SWAN_SETTINGS_FIELD(size_unit_multiplier);
+    SWAN_SETTINGS_FIELD(explorer_refresh_mode);
+    SWAN_SETTINGS_FIELD(dir_separator_utf16);
+    SWAN_SETTINGS_FIELD(dir_separator_utf8);
+    SWAN_SETTINGS_FIELD(show_debug_info);
+    SWAN_SETTINGS_FIELD(win32_file_icons);
+    SWAN_SETTINGS_FIELD(tables_alt_row_bg);
+    SWAN_SETTINGS_FIELD(table_borders_in_body);
+    SWAN_SETTINGS_FIELD(explorer_show_dotdot_dir);
+    SWAN_SETTINGS_FIELD(explorer_clear_filter_on_cwd_change);
+    SWAN_SETTINGS_FIELD(file_operations_src_path_full);
+    SWAN_SETTINGS_FIELD(file_operations_dst_path_full);
+    SWAN_SETTINGS_FIELD(file_operations_verify_copies);
+    SWAN_SETTINGS_FIELD(startup_with_window_maximized);
+    SWAN_SETTINGS_FIELD(startup_with_previous_window_pos_and_size);
+    SWAN_SETTINGS_FIELD(confirm_explorer_delete_via_keybind);
+    SWAN_SETTINGS_FIELD(confirm_explorer_delete_via_context_menu);
+    SWAN_SETTINGS_FIELD(confirm_explorer_unpin_directory);
+    SWAN_SETTINGS_FIELD(confirm_recent_files_clear);
+    SWAN_SETTINGS_FIELD(confirm_recent_files_reveal_selected_in_win_file_expl);
+    SWAN_SETTINGS_FIELD(confirm_recent_files_forget_selected);
+    SWAN_SETTINGS_FIELD(confirm_delete_pin);
+    SWAN_SETTINGS_FIELD(confirm_completed_file_operations_forget);
+    SWAN_SETTINGS_FIELD(confirm_completed_file_operations_forget_group);
+    SWAN_SETTINGS_FIELD(confirm_completed_file_operations_forget_all);
+    SWAN_SETTINGS_FIELD(confirm_theme_editor_color_reset);
+    SWAN_SETTINGS_FIELD(confirm_theme_editor_style_reset);
+    SWAN_SETTINGS_FIELD(show.explorer_0);
+    SWAN_SETTINGS_FIELD(show.explorer_1);
+    SWAN_SETTINGS_FIELD(show.explorer_2);
+    SWAN_SETTINGS_FIELD(show.explorer_3);
+    SWAN_SETTINGS_FIELD(show.explorer_0_debug);
+    SWAN_SETTINGS_FIELD(show.explorer_1_debug);
+    SWAN_SETTINGS_FIELD(show.explorer_2_debug);
+    SWAN_SETTINGS_FIELD(show.explorer_3_debug);
+    SWAN_SETTINGS_FIELD(show.finder);
+    SWAN_SETTINGS_FIELD(show.pinned);
+    SWAN_SETTINGS_FIELD(show.file_operations);
+    SWAN_SETTINGS_FIELD(show.recent_files);
+    SWAN_SETTINGS_FIELD(show.analytics);
+    SWAN_SETTINGS_FIELD(show.debug_log);
+    SWAN_SETTINGS_FIELD(show.settings);
+    SWAN_SETTINGS_FIELD(show.imgui_demo);
+    SWAN_SETTINGS_FIELD(show.theme_editor);
+    SWAN_SETTINGS_FIELD(show.icon_library);
+    SWAN_SETTINGS_FIELD(show.imspinner_demo);
+    SWAN_SETTINGS_FIELD(show.disk_usage);
+    SWAN_SETTINGS_FIELD(checks_ImGuiCol);
+    SWAN_SETTINGS_FIELD(check_success_color);
+    SWAN_SETTINGS_FIELD(check_warning_color);
+    SWAN_SETTINGS_FIELD(check_warning_lite_color);
+    SWAN_SETTINGS_FIELD(check_error_color);
+    SWAN_SETTINGS_FIELD(check_directory_color);
+    SWAN_SETTINGS_FIELD(check_file_color);
+    SWAN_SETTINGS_FIELD(check_symlink_color);
+#undef SWAN_SETTINGS_FIELD
+
+    layout += make_str("swan_settings %zu show %zu", sizeof(swan_settings), sizeof(swan_settings::window_visibility));
+
+    return xxh64(layout.data(), layout.size());
+}
+
+/// ImGuiStyle belongs to Dear ImGui, its layout only changes with the library version (or the size, for local patches).
+static
+u64 imgui_style_layout_fingerprint() noexcept
+{
+    u64 const layout[] = { u64(IMGUI_VERSION_NUM), sizeof(ImGuiStyle), u64(ImGuiCol_COUNT) };
+    return xxh64(layout, sizeof(layout));
+}
+
+static
+char const *state_snapshot_source_file(state_snapshot_section::kind kind) noexcept
+{
+    switch (kind) {
+        case state_snapshot_section::kind_settings:                  return "data\\swan_settings.txt";
+        case state_snapshot_section::kind_pinned:                    return "data\\pinned.txt";
+        case state_snapshot_section::kind_recent_files:              return "data\\recent_files.txt";
+        case state_snapshot_section::kind_completed_file_operations: return "data\\completed_file_operations.txt";
+        case state_snapshot_section::kind_explorer_0:                return "data\\explorer_0.txt";
+        case state_snapshot_section::kind_explorer_1:                return "data\\explorer_1.txt";
+        case state_snapshot_section::kind_explorer_2:                return "data\\explorer_2.txt";
+        case state_snapshot_section::kind_explorer_3:                return "data\\explorer_3.txt";
+        case state_snapshot_section::kind_window_render_order:       return "data\\window_render_order.txt";
+        case state_snapshot_section::kind_directory_jump:            return "data\\directory_jump.bin";
+        default:                                                     return "";
+    }
+}
+
+/// Last write time and size of the file `kind` mirrors, zeroes if it doesn't exist.
+static
+std::pair<u64, u64> state_snapshot_source_stamp(state_snapshot_section::kind kind) noexcept
+try {
+    std::filesystem::path full_path = global_state::execution_path() / state_snapshot_source_file(kind);
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+    if (!GetFileAttributesExW(full_path.c_str(), GetFileExInfoStandard, &attributes)) {
+        return { 0, 0 };
+    }
+
+    return { two_u32_to_one_u64(attributes.ftLastWriteTime.dwLowDateTime, attributes.ftLastWriteTime.dwHighDateTime),
+             two_u32_to_one_u64(attributes.nFileSizeLow, attributes.nFileSizeHigh) };
+}
+catch (...) {
+    return { u64(-1), u64(-1) };
+}
+
+static
+bool state_snapshot_decode_settings(std::string_view data, state_snapshot_load_result &result) noexcept
+{
+    state_snapshot_reader reader = { data };
+
+    // a layout change in either struct makes the section useless, the text file is loaded instead
+    if (reader.take<u64>() != swan_settings_layout_fingerprint()) return false;
+    auto settings = reader.take<swan_settings>();
+    if (reader.take<u64>() != imgui_style_layout_fingerprint()) return false;
+    auto style = reader.take<ImGuiStyle>();
+
+    if (!reader.ok) {
+        return false;
+    }
+
+    result.settings = settings;
+    result.style = style;
+    return true;
+}
+
+static
+bool state_snapshot_decode_pinned(std::string_view data, char dir_separator) noexcept
+try {
+    state_snapshot_reader reader = { data };
+    auto &pins = global_state::pinned_get();
+    pins.clear();
+
+    for (u32 i = 0, num_pins = reader.take<u32>(); i < num_pins && reader.ok; ++i) {
+        auto color = reader.take<ImVec4>();
+        std::string_view label = reader.take_str();
+        swan_path path = reader.take_path();
+
+        if (reader.ok && label.size() <= pinned_path::LABEL_MAX_LEN) {
+            (void) global_state::pinned_add(color, std::string(label).c_str(), path, dir_separator);
+        }
+    }
+
+    if (!reader.ok) {
+        pins.clear();
+    }
+    return reader.ok;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    global_state::pinned_get().clear();
+    return false;
+}
+
+static
+bool state_snapshot_decode_recent_files(std::string_view data, char dir_separator) noexcept
+try {
+    state_snapshot_reader reader = { data };
+    auto recent_files = global_state::recent_files_get();
+
+    std::scoped_lock lock(*recent_files.mutex);
+    recent_files.container->clear();
+
+    for (u32 i = 0, num_files = reader.take<u32>(); i < num_files && reader.ok; ++i) {
+        std::string_view action = reader.take_str();
+        time_point_system_t action_time = std::chrono::system_clock::from_time_t(reader.take<s64>());
+        swan_path path = reader.take_path();
+
+        if (reader.ok && action.size() <= recent_file::ACTION_MAX_LEN) {
+            path_force_separator(path, dir_separator);
+            recent_files.container->emplace_back(std::string(action).c_str(), action_time, 0, ImVec2(), path, false, path_loose_hash(path.data()));
+        }
+    }
+
+    if (!reader.ok) {
+        recent_files.container->clear();
+    }
+    // already ordered and deduplicated when written, this builds the recent files index
+    (void) recent_files_reorder_and_dedupe(*recent_files.container);
+
+    return reader.ok;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return false;
+}
+
+static
+bool state_snapshot_decode_completed_file_operations(std::string_view data, char dir_separator) noexcept
+try {
+    state_snapshot_reader reader = { data };
+    auto completed_file_operations = global_state::completed_file_operations_get();
+
+    std::scoped_lock lock(*completed_file_operations.mutex);
+    clear(completed_file_operations);
+
+    for (u32 i = 0, num_records = reader.take<u32>(); i < num_records && reader.ok; ++i) {
+        auto completion_time = std::chrono::system_clock::from_time_t(reader.take<s64>());
+        auto undo_time = std::chrono::system_clock::from_time_t(reader.take<s64>());
+        u32 group_id = reader.take<u32>();
+        auto op_type = reader.take<file_operation_type>();
+        auto obj_type = basic_dirent::kind(reader.take<s32>());
+        auto verification = reader.take<file_operation_verification>();
+        auto copy_strategy = reader.take<file_copy_strategy>();
+        swan_path src_path = reader.take_path();
+        swan_path dst_path = reader.take_path();
+
+        if (!reader.ok) {
+            break;
+        }
+
+        path_force_separator(src_path, dir_separator);
+        path_force_separator(dst_path, dir_separator);
+
+        auto &record = completed_file_operations.container->emplace_back(completion_time, undo_time, op_type, src_path.data(), dst_path.data(), obj_type, group_id);
+        record.verification = verification == file_operation_verification::pending ? file_operation_verification::failed : verification;
+        record.copy_strategy = copy_strategy;
+    }
+
+    if (!reader.ok) {
+        clear(completed_file_operations);
+    }
+    completed_file_operations.groups->rebuild(*completed_file_operations.container);
+
+    return reader.ok;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return false;
+}
+
+static
+bool state_snapshot_decode_explorer(std::string_view data, explorer_window &expl, char dir_separator) noexcept
+try {
+    state_snapshot_reader reader = { data };
+
+    swan_path cwd = reader.take_path();
+    std::string_view filter = reader.take_str();
+    u64 filter_mode = reader.take<u64>();
+    u16 flags = reader.take<u16>();
+    u64 wd_history_pos = reader.take<u64>();
+    u32 wd_history_size = reader.take<u32>();
+
+    if (!reader.ok || filter.size() >= expl.filter_text.max_size() || filter_mode >= explorer_window::filter_mode::count) {
+        return false;
+    }
+
+    std::deque<explorer_window::history_item> wd_history = {};
+
+    for (u32 i = 0; i < wd_history_size && reader.ok; ++i) {
+        explorer_window::history_item item = {};
+        item.path = reader.take_path();
+        item.time_departed = std::chrono::system_clock::from_time_t(reader.take<s64>());
+        wd_history.push_back(item);
+    }
+
+    if (!reader.ok) {
+        return false;
+    }
+
+    path_force_separator(cwd, dir_separator);
+    expl.cwd = cwd;
+
+    expl.filter_text = {};
+    memcpy(expl.filter_text.data(), filter.data(), filter.size());
+
+    expl.filter_mode = decltype(expl.filter_mode)(filter_mode);
+    expl.filter_case_sensitive              = flags & (1 << 0);
+    expl.filter_polarity                    = flags & (1 << 1);
+    expl.filter_show_directories            = flags & (1 << 2);
+    expl.filter_show_symlink_directories    = flags & (1 << 3);
+    expl.filter_show_files                  = flags & (1 << 4);
+    expl.filter_show_symlink_files          = flags & (1 << 5);
+    expl.filter_show_invalid_symlinks       = flags & (1 << 6);
+    expl.tree_node_open_debug_state         = flags & (1 << 7);
+    expl.tree_node_open_debug_memory        = flags & (1 << 8);
+    expl.tree_node_open_debug_performance   = flags & (1 << 9);
+    expl.tree_node_open_debug_other         = flags & (1 << 10);
+
+    expl.wd_history = std::move(wd_history);
+    expl.wd_history_pos = std::clamp(wd_history_pos, u64(0), std::max(expl.wd_history.size(), u64(1)) - 1);
+
+    return true;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return false;
+}
+
+static
+bool state_snapshot_decode_window_render_order(std::string_view data, state_snapshot_load_result &result) noexcept
+{
+    state_snapshot_reader reader = { data };
+
+    if (reader.take<u32>() != result.window_render_order.size()) {
+        return false;
+    }
+
+    for (auto &id : result.window_render_order) {
+        s32 stored_id = reader.take<s32>();
+        if (stored_id <= s32(swan_windows::id::nil_window) || stored_id >= s32(swan_windows::id::count)) {
+            return false;
+        }
+        id = swan_windows::id(stored_id);
+    }
+
+    return reader.ok;
+}
+
+/// Maps `data\swan_state.bin` and decodes every section whose source file is unchanged since the snapshot was written.
+/// Runs on a worker thread while the main thread sets up the window, so settings, the ImGui style and the window render order
+/// are returned rather than applied. Everything else is decoded straight into globals which the main thread doesn't touch until
+/// it has the result. Sections holding paths depend on the directory separator, they are only decoded along with the settings.
+state_snapshot_load_result state_snapshot_load_from_disk() noexcept
+{
+    SWAN_PROFILE_FUNCTION();
+    state_snapshot_load_result result = {};
+    result.loaded.fill(false);
+
+    f64 load_us = 0;
+    SCOPE_EXIT { global_state::startup_timings_get().state_snapshot_load_us = load_us; };
+    scoped_timer<timer_unit::MICROSECONDS> load_timer(&load_us);
+
+    try {
+        std::filesystem::path full_path = global_state::execution_path() / "data\\swan_state.bin";
+
+        HANDLE file = CreateFileW(full_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            print_debug_msg("FAILED CreateFileW, no snapshot");
+            return result;
+        }
+        SCOPE_EXIT { CloseHandle(file); };
+
+        LARGE_INTEGER file_size = {};
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+            return result;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            print_debug_msg("FAILED CreateFileMappingW: %s", get_last_winapi_error().formatted_message.c_str());
+            return result;
+        }
+        SCOPE_EXIT { CloseHandle(mapping); };
+
+        void const *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr) {
+            print_debug_msg("FAILED MapViewOfFile: %s", get_last_winapi_error().formatted_message.c_str());
+            return result;
+        }
+        SCOPE_EXIT { UnmapViewOfFile(view); };
+
+        std::vector<state_snapshot_section> sections = {};
+
+        if (!state_snapshot_unpack(std::string_view((char const *)view, u64(file_size.QuadPart)), sections)) {
+            print_debug_msg("FAILED state_snapshot_unpack, snapshot is corrupt or from another version");
+            return result;
+        }
+
+        global_state::startup_timings_get().state_snapshot_size = u64(file_size.QuadPart);
+
+        std::array<state_snapshot_section const *, state_snapshot_section::kind_count> fresh = {};
+
+        for (auto const &section : sections) {
+            if (section.id < state_snapshot_section::kind_count &&
+                state_snapshot_source_stamp(section.id) == std::make_pair(section.source_write_time, section.source_size))
+            {
+                fresh[section.id] = &section;
+            }
+        }
+
+        auto decode = [&](state_snapshot_section::kind kind, auto &&decoder) {
+            if (fresh[kind] != nullptr) {
+                result.loaded[kind] = decoder(fresh[kind]->data);
+            }
+        };
+
+        decode(state_snapshot_section::kind_settings, [&](std::string_view data) { return state_snapshot_decode_settings(data, result); });
+        decode(state_snapshot_section::kind_window_render_order, [&](std::string_view data) { return state_snapshot_decode_window_render_order(data, result); });
+        decode(state_snapshot_section::kind_directory_jump, [&](std::string_view data) { return global_state::directory_jump_get().deserialize(data); });
+
+        if (result.loaded[state_snapshot_section::kind_settings]) {
+            char dir_sep = result.settings.dir_separator_utf8;
+            auto &explorers = global_state::explorers();
+
+            decode(state_snapshot_section::kind_pinned, [&](std::string_view data) { return state_snapshot_decode_pinned(data, dir_sep); });
+            decode(state_snapshot_section::kind_recent_files, [&](std::string_view data) { return state_snapshot_decode_recent_files(data, dir_sep); });
+            decode(state_snapshot_section::kind_completed_file_operations, [&](std::string_view data) { return state_snapshot_decode_completed_file_operations(data, dir_sep); });
+
+            for (u64 i = 0; i < explorers.size(); ++i) {
+                auto kind = state_snapshot_section::kind(state_snapshot_section::kind_explorer_0 + i);
+                decode(kind, [&](std::string_view data) { return state_snapshot_decode_explorer(data, explorers[i], dir_sep); });
+            }
+        }
+
+        print_debug_msg("SUCCESS %zu of %zu sections fresh, %zu bytes", std::count(result.loaded.begin(), result.loaded.end(), true), sections.size(), u64(file_size.QuadPart));
+    }
+    catch (std::exception const &except) {
+        print_debug_msg("FAILED catch(std::exception) %s", except.what());
+    }
+    catch (...) {
+        print_debug_msg("FAILED catch(...)");
+    }
+
+    return result;
+}
+
+/// Writes the snapshot from what is in memory, stamping each section with its source file as it is now.
+/// Stamps are taken before reading the state they describe, so a text file saved in between leaves its section stale rather than wrong.
+/// Pending text file writes are flushed first, otherwise their stamps would describe files about to be replaced.
+/// Written to a temporary file then renamed over the previous snapshot, which stays intact if Swan dies mid-write.
+bool state_snapshot_save_to_disk(std::array<swan_windows::id, (u64)swan_windows::id::count - 1> const &window_render_order) noexcept
+try {
+    persistence_flush(window_render_order);
+
+    auto save_start = get_time_precise();
+
+    std::array<std::string, state_snapshot_section::kind_count> datas = {};
+    std::vector<state_snapshot_section> sections = {};
+    sections.reserve(state_snapshot_section::kind_count);
+
+    auto add_section = [&](state_snapshot_section::kind kind, auto &&encoder) {
+        auto [source_write_time, source_size] = state_snapshot_source_stamp(kind);
+        encoder(datas[kind]);
+        sections.push_back({ kind, source_write_time, source_size, datas[kind] });
+    };
+
+    add_section(state_snapshot_section::kind_settings, [](std::string &out) {
+        state_snapshot_put(out, swan_settings_layout_fingerprint());
+        state_snapshot_put(out, global_state::settings());
+        state_snapshot_put(out, imgui_style_layout_fingerprint());
+        state_snapshot_put(out, imgui::GetStyle());
+    });
+
+    add_section(state_snapshot_section::kind_pinned, [](std::string &out) {
+        auto const &pins = global_state::pinned_get();
+        state_snapshot_put(out, u32(pins.size()));
+        for (auto const &pin : pins) {
+            state_snapshot_put(out, pin.color);
+            state_snapshot_put_str(out, std::string_view(pin.label.data(), pin.label.size()));
+            state_snapshot_put_str(out, std::string_view(pin.path.data(), path_length(pin.path)));
+        }
+    });
+
+    add_section(state_snapshot_section::kind_recent_files, [](std::string &out) {
+        auto recent_files = global_state::recent_files_get();
+        std::scoped_lock lock(*recent_files.mutex);
+
+        state_snapshot_put(out, u32(recent_files.container->size()));
+        for (auto const &file : *recent_files.container) {
+            state_snapshot_put_str(out, std::string_view(file.action.data(), file.action.size()));
+            state_snapshot_put(out, s64(std::chrono::system_clock::to_time_t(file.action_time)));
+            state_snapshot_put_str(out, std::string_view(file.path.data(), path_length(file.path)));
+        }
+    });
+
+    add_section(state_snapshot_section::kind_completed_file_operations, [](std::string &out) {
+        auto completed_file_operations = global_state::completed_file_operations_get();
+        std::scoped_lock lock(*completed_file_operations.mutex);
+
+        state_snapshot_put(out, u32(completed_file_operations.container->size()));
+        for (auto const &file_op : *completed_file_operations.container) {
+            state_snapshot_put(out, s64(std::chrono::system_clock::to_time_t(file_op.completion_time)));
+            state_snapshot_put(out, s64(std::chrono::system_clock::to_time_t(file_op.undo_time)));
+            state_snapshot_put(out, file_op.group_id);
+            state_snapshot_put(out, file_op.op_type);
+            state_snapshot_put(out, s32(file_op.obj_type));
+            state_snapshot_put(out, file_op.verification);
+            state_snapshot_put(out, file_op.copy_strategy);
+            state_snapshot_put_str(out, std::string_view(file_op.src_path.data(), path_length(file_op.src_path)));
+            state_snapshot_put_str(out, std::string_view(file_op.dst_path.data(), path_length(file_op.dst_path)));
+        }
+    });
+
+    auto const &explorers = global_state::explorers();
+
+    for (u64 i = 0; i < explorers.size(); ++i) {
+        add_section(state_snapshot_section::kind(state_snapshot_section::kind_explorer_0 + i), [&expl = explorers[i]](std::string &out) {
+            u16 flags =
+                (u16(expl.filter_case_sensitive)            << 0) |
+                (u16(expl.filter_polarity)                  << 1) |
+                (u16(expl.filter_show_directories)          << 2) |
+                (u16(expl.filter_show_symlink_directories)  << 3) |
+                (u16(expl.filter_show_files)                << 4) |
+                (u16(expl.filter_show_symlink_files)        << 5) |
+                (u16(expl.filter_show_invalid_symlinks)     << 6) |
+                (u16(expl.tree_node_open_debug_state)       << 7) |
+                (u16(expl.tree_node_open_debug_memory)      << 8) |
+                (u16(expl.tree_node_open_debug_performance) << 9) |
+                (u16(expl.tree_node_open_debug_other)       << 10);
+
+            state_snapshot_put_str(out, std::string_view(expl.cwd.data(), path_length(expl.cwd)));
+            state_snapshot_put_str(out, std::string_view(expl.filter_text.data(), strlen(expl.filter_text.data())));
+            state_snapshot_put(out, u64(expl.filter_mode));
+            state_snapshot_put(out, flags);
+            state_snapshot_put(out, expl.wd_history_pos);
+            state_snapshot_put(out, u32(expl.wd_history.size()));
+            for (auto const &item : expl.wd_history) {
+                state_snapshot_put_str(out, std::string_view(item.path.data(), path_length(item.path)));
+                state_snapshot_put(out, s64(std::chrono::system_clock::to_time_t(item.time_departed)));
+            }
+        });
+    }
+
+    add_section(state_snapshot_section::kind_window_render_order, [&window_render_order](std::string &out) {
+        state_snapshot_put(out, u32(window_render_order.size()));
+        for (auto id : window_render_order) {
+            state_snapshot_put(out, s32(id));
+        }
+    });
+
+    add_section(state_snapshot_section::kind_directory_jump, [](std::string &out) {
+        out = global_state::directory_jump_get().serialize();
+    });
+
+    std::string snapshot = state_snapshot_pack(sections);
+    if (snapshot.empty()) {
+        return false;
+    }
+
+    if (!write_file_atomically(global_state::execution_path() / "data\\swan_state.bin", snapshot)) {
+        return false;
+    }
+
+    print_debug_msg("SUCCESS %zu bytes in %lld us", snapshot.size(), time_diff_us(save_start, get_time_precise()));
+    return true;
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+    return false;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return false;
+}
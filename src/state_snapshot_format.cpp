@@ -0,0 +1,114 @@
+#include "core.hpp"
+#if !SWAN_HEADLESS
+#   include "imgui_dependent_functions.hpp"
+#endif
+
+// data\swan_state.bin:
+//   8 bytes   "swanstat"
+//   u32       format version, a snapshot of any other version is ignored
+//   u32       number of sections
+//   u64       payload size
+//   u64       XXH64 of the payload
+//   payload   per section u32 kind, u32 data size, u64 source write time, u64 source size, data
+static char const STATE_SNAPSHOT_MAGIC[8] = { 's', 'w', 'a', 'n', 's', 't', 'a', 't' };
+static u32 const STATE_SNAPSHOT_VERSION = 2;
+static u64 const STATE_SNAPSHOT_HEADER_SIZE = sizeof(STATE_SNAPSHOT_MAGIC) + sizeof(u32) * 2 + sizeof(u64) * 2;
+static u64 const STATE_SNAPSHOT_SECTION_HEADER_SIZE = sizeof(u32) * 2 + sizeof(u64) * 2;
+
+std::string state_snapshot_pack(std::vector<state_snapshot_section> const &sections) noexcept
+try {
+    std::string snapshot = {};
+    {
+        u64 total_size = STATE_SNAPSHOT_HEADER_SIZE;
+        for (auto const &section : sections) {
+            total_size += STATE_SNAPSHOT_SECTION_HEADER_SIZE + section.data.size();
+        }
+        snapshot.reserve(total_size);
+    }
+
+    snapshot.append(STATE_SNAPSHOT_MAGIC, sizeof(STATE_SNAPSHOT_MAGIC));
+    state_snapshot_put(snapshot, STATE_SNAPSHOT_VERSION);
+    state_snapshot_put(snapshot, u32(sections.size()));
+    state_snapshot_put(snapshot, u64(0)); // payload size, patched below
+    state_snapshot_put(snapshot, u64(0)); // payload checksum, patched below
+
+    for (auto const &section : sections) {
+        assert(section.data.size() <= UINT32_MAX);
+        state_snapshot_put(snapshot, u32(section.id));
+        state_snapshot_put(snapshot, u32(section.data.size()));
+        state_snapshot_put(snapshot, section.source_write_time);
+        state_snapshot_put(snapshot, section.source_size);
+        snapshot.append(section.data);
+    }
+
+    u64 payload_size = snapshot.size() - STATE_SNAPSHOT_HEADER_SIZE;
+    u64 payload_checksum = xxh64(snapshot.data() + STATE_SNAPSHOT_HEADER_SIZE, payload_size);
+
+    memcpy(snapshot.data() + STATE_SNAPSHOT_HEADER_SIZE - sizeof(u64) * 2, &payload_size, sizeof(u64));
+    memcpy(snapshot.data() + STATE_SNAPSHOT_HEADER_SIZE - sizeof(u64), &payload_checksum, sizeof(u64));
+
+    return snapshot;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return {};
+}
+
+/// Validates `snapshot` and splits it into sections which point into it. Fails, leaving `out` empty, on a bad magic, another version,
+/// a truncated file, a checksum mismatch or a section overrunning the payload.
+bool state_snapshot_unpack(std::string_view snapshot, std::vector<state_snapshot_section> &out) noexcept
+try {
+    out.clear();
+
+    if (snapshot.size() < STATE_SNAPSHOT_HEADER_SIZE || !snapshot.starts_with(std::string_view(STATE_SNAPSHOT_MAGIC, sizeof(STATE_SNAPSHOT_MAGIC)))) {
+        return false;
+    }
+
+    state_snapshot_reader header = { snapshot.substr(sizeof(STATE_SNAPSHOT_MAGIC), STATE_SNAPSHOT_HEADER_SIZE - sizeof(STATE_SNAPSHOT_MAGIC)) };
+    u32 version = header.take<u32>();
+    u32 num_sections = header.take<u32>();
+    u64 payload_size = header.take<u64>();
+    u64 payload_checksum = header.take<u64>();
+
+    if (version != STATE_SNAPSHOT_VERSION || payload_size != snapshot.size() - STATE_SNAPSHOT_HEADER_SIZE) {
+        return false;
+    }
+
+    std::string_view payload = snapshot.substr(STATE_SNAPSHOT_HEADER_SIZE);
+
+    if (xxh64(payload.data(), payload.size()) != payload_checksum) {
+        return false;
+    }
+
+    state_snapshot_reader reader = { payload };
+    out.reserve(std::min(u64(num_sections), payload.size() / STATE_SNAPSHOT_SECTION_HEADER_SIZE));
+
+    for (u32 i = 0; i < num_sections; ++i) {
+        state_snapshot_section section = {};
+        section.id = state_snapshot_section::kind(reader.take<u32>());
+        u32 data_size = reader.take<u32>();
+        section.source_write_time = reader.take<u64>();
+        section.source_size = reader.take<u64>();
+
+        if (!reader.ok || reader.data.size() < data_size) {
+            out.clear();
+            return false;
+        }
+
+        section.data = reader.data.substr(0, data_size);
+        reader.data.remove_prefix(data_size);
+        out.push_back(section);
+    }
+
+    if (!reader.data.empty()) {
+        out.clear();
+        return false;
+    }
+
+    return true;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    out.clear();
+    return false;
+}
@@ -2,13 +2,16 @@
     Bunch of headers to precompile - things that aren't touched when developing swan: STL, STB libs, Boost, ImGui itself, etc.
 */
 
+#include <aclapi.h>
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <boost/circular_buffer.hpp>
 #include <boost/container/static_vector.hpp>
 #include <boost/static_string.hpp>
 #include <cassert>
+#include <charconv>
 #include <chrono>
 #include <comdef.h>
 #include <cstring>
@@ -17,8 +20,10 @@
 #include <fileapi.h>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <future>
 #include <iostream>
+#include <list>
 #include <mutex>
 #include <numbers>
 #include <numeric>
@@ -37,9 +42,12 @@
 #include <string>
 #include <stringapiset.h>
 #include <tchar.h>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <windows.h>
+#include <winioctl.h>
 
 #undef min
 #undef max
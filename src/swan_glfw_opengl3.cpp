@@ -23,9 +23,27 @@ struct failed_assertion
 static std::vector<failed_assertion>    g_failed_assertions = {};
 static std::optional<bool>              g_test_suite_ran_without_crashes = std::nullopt;
 
+static u32 const RENDER_LOOP_FRAMES_AFTER_EVENT = 4; // rendered back to back after input or a wake, so ImGui settles
+static f64 const RENDER_LOOP_BUSY_TIMEOUT_S = 1.0 / 30; // while the mouse is held or background tasks run
+static f64 const RENDER_LOOP_IDLE_TIMEOUT_S = 0.25; // focused, bounds how stale polled state gets
+static f64 const RENDER_LOOP_BACKGROUND_TIMEOUT_S = 1.0; // unfocused or minimized
+
+struct render_loop_scheduler
+{
+    u32 num_frames_left = RENDER_LOOP_FRAMES_AFTER_EVENT;
+
+    // current sample of `render_loop_stats`, rolled over every second
+    time_point_precise_t sample_start = get_time_precise();
+    f64 sample_start_cpu_ms = process_cpu_time_ms();
+    s64 sample_waited_us = 0;
+    u64 sample_num_frames = 0;
+    bool sample_had_input = false;
+};
+
 static LONG WINAPI  custom_exception_handler(EXCEPTION_POINTERS *exception_info) noexcept;
 static GLFWwindow * create_barebones_window() noexcept;
 static void         glfw_error_callback(s32 error, char const *description) noexcept;
+static void         wait_for_next_frame(GLFWwindow *window, render_loop_scheduler &scheduler) noexcept;
 static void         load_custom_fonts(GLFWwindow *window, char const *ini_file_path) noexcept;
 static void         set_window_icon(GLFWwindow *window) noexcept;
 static void         render_ntest_output_window(swan_path const &output_directory_path) noexcept;
@@ -36,10 +54,10 @@ s32 APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLi
 try {
     (void) hInstance;
     (void) hPrevInstance;
-    (void) lpCmdLine;
     // (void) nCmdShow;
 
     SetUnhandledExceptionFilter(custom_exception_handler);
+    SWAN_PROFILE_THREAD_NAME("main");
 
     {
         char exe_path[MAX_PATH];
@@ -49,6 +67,10 @@ try {
         swan_exec_path = swan_exec_path.remove_filename();
         global_state::execution_path() = swan_exec_path;
     }
+
+    // export the profiler zones of startup and the first frame, see `profiler_export_chrome_trace`
+    [[maybe_unused]] bool trace_startup = lpCmdLine != nullptr && StrStrA(lpCmdLine, "--trace-startup") != nullptr;
+
     swan_path ntest_output_directory_path = path_create( (global_state::execution_path() / "ntest").string().c_str() );
 
 #if RELEASE_MODE
@@ -81,16 +103,6 @@ try {
 }
 #endif
 
-    GLFWwindow *window = create_barebones_window();
-    if (window == nullptr) {
-        return 1;
-    }
-    global_state::window_handle() = glfwGetWin32Window(window);
-
-    if (glewInit() != GLEW_OK) {
-        return 1;
-    }
-
     // reset log file
     {
         auto log_file_path = global_state::execution_path() / "debug_log.md";
@@ -102,6 +114,19 @@ try {
         }
     }
 
+    // decode the state snapshot on a worker while the window, GL context, fonts and COM are set up
+    std::future<state_snapshot_load_result> state_snapshot_future = global_state::thread_pool().submit(state_snapshot_load_from_disk);
+
+    GLFWwindow *window = create_barebones_window();
+    if (window == nullptr) {
+        return 1;
+    }
+    global_state::window_handle() = glfwGetWin32Window(window);
+
+    if (glewInit() != GLEW_OK) {
+        return 1;
+    }
+
     print_debug_msg("SUCCESS barebones window created");
 
     std::string const ini_file_path = (global_state::execution_path() / "data\\swan_imgui.ini").generic_string();
@@ -129,6 +154,20 @@ try {
     print_debug_msg("SUCCESS COM initialized");
     SCOPE_EXIT { cleanup_explorer_COM(); };
 
+    auto &startup = global_state::startup_timings_get();
+
+    state_snapshot_load_result state_snapshot = {};
+    {
+        scoped_timer<timer_unit::MICROSECONDS> wait_timer(&startup.state_snapshot_wait_us);
+        state_snapshot = state_snapshot_future.get();
+    }
+
+    // whatever the snapshot lacks is loaded from its text file, as before the snapshot existed
+    auto from_snapshot = [&](state_snapshot_section::kind kind) noexcept {
+        ++(state_snapshot.loaded[kind] ? startup.num_sections_from_snapshot : startup.num_sections_from_text);
+        return state_snapshot.loaded[kind];
+    };
+
 #if DEBUG_MODE
     run_tests_integrated(ntest_output_directory_path);
 #endif
@@ -148,29 +187,43 @@ try {
         global_state::page_size() = system_info.dwPageSize;
         print_debug_msg("global_state::page_size = %d", global_state::page_size());
 
-        (void) global_state::settings().load_from_disk();
-        (void) global_state::pinned_load_from_disk(global_state::settings().dir_separator_utf8);
         {
-            auto result = global_state::recent_files_load_from_disk(global_state::settings().dir_separator_utf8);
-            {
-                auto recent_files = global_state::recent_files_get();
-                std::scoped_lock recent_files_lock(*recent_files.mutex);
-                if (bool success = result.first) {
-                    recent_files_reorder_and_dedupe(*recent_files.container);
-                } else {
+            scoped_timer<timer_unit::MICROSECONDS> text_fallback_timer(&startup.text_fallback_us);
+
+            if (from_snapshot(state_snapshot_section::kind_settings)) {
+                global_state::settings() = state_snapshot.settings;
+                imgui::GetStyle() = state_snapshot.style;
+            } else {
+                (void) global_state::settings().load_from_disk();
+            }
+            if (!from_snapshot(state_snapshot_section::kind_pinned)) {
+                (void) global_state::pinned_load_from_disk(global_state::settings().dir_separator_utf8);
+            }
+            if (!from_snapshot(state_snapshot_section::kind_recent_files)) {
+                auto result = global_state::recent_files_load_from_disk(global_state::settings().dir_separator_utf8);
+                if (!result.first) {
+                    auto recent_files = global_state::recent_files_get();
+                    std::scoped_lock recent_files_lock(*recent_files.mutex);
                     recent_files.container->clear();
                 }
             }
-        }
-        {
-            auto result = global_state::completed_file_operations_load_from_disk(global_state::settings().dir_separator_utf8);
-            if (!result.first) {
-                auto completed_file_operations = global_state::completed_file_operations_get();
-                std::scoped_lock recent_files_lock(*completed_file_operations.mutex);
-                completed_file_operations.container->clear();
+            if (!from_snapshot(state_snapshot_section::kind_completed_file_operations)) {
+                auto result = global_state::completed_file_operations_load_from_disk(global_state::settings().dir_separator_utf8);
+                if (!result.first) {
+                    auto completed_file_operations = global_state::completed_file_operations_get();
+                    std::scoped_lock completed_file_operations_lock(*completed_file_operations.mutex);
+                    clear(completed_file_operations);
+                }
+            }
+            if (!from_snapshot(state_snapshot_section::kind_directory_jump)) {
+                (void) global_state::directory_jump_load_from_disk();
             }
+            // only needed once an explorer shows the "On disk" column, and can be large, so not in the snapshot nor on this thread
+            global_state::thread_pool().push_task([]() noexcept { (void) global_state::directory_sizes_load_from_disk(); });
         }
 
+        bulk_rename_offer_revert_of_interrupted();
+
         if (global_state::settings().startup_with_window_maximized) {
             glfwMaximizeWindow(window);
         }
@@ -183,6 +236,8 @@ try {
     auto &explorers = global_state::explorers();
     // init explorers
     {
+        scoped_timer<timer_unit::MICROSECONDS> explorers_init_timer(&startup.explorers_init_us);
+
         char const *names[global_constants::num_explorers] = {
             swan_windows::get_name(swan_windows::id::explorer_0),
             swan_windows::get_name(swan_windows::id::explorer_1),
@@ -197,11 +252,12 @@ try {
             expl.name = names[i];
             expl.filter_error.reserve(1024);
 
-            bool load_result = explorers[i].load_from_disk(global_state::settings().dir_separator_utf8);
+            bool load_result = from_snapshot(state_snapshot_section::kind(state_snapshot_section::kind_explorer_0 + i))
+                            || explorers[i].load_from_disk(global_state::settings().dir_separator_utf8);
 
             if (!load_result) {
                 expl.cwd = path_create("");
-                (void) explorers[i].save_to_disk();
+                global_state::mark_dirty(expl);
             }
 
             auto [starting_dir_exists, _] = expl.update_cwd_entries(query_filesystem, expl.cwd.data());
@@ -217,56 +273,63 @@ try {
     };
 
     // last elem is the last window to be rendered, the most forward window
-    std::array<swan_windows::id, (u64)swan_windows::id::count - 1> window_render_order = window_render_order_load_from_disk();
+    std::array<swan_windows::id, (u64)swan_windows::id::count - 1> window_render_order =
+        from_snapshot(state_snapshot_section::kind_window_render_order) ? state_snapshot.window_render_order : window_render_order_load_from_disk();
 
     for ([[maybe_unused]] auto const &window_id : window_render_order) {
         assert(window_id != swan_windows::id::nil_window && "Forgot to add window id to initializer list of `window_render_order`");
     }
 
-    static time_point_precise_t last_window_move_or_resize_time = get_time_precise();
-    static bool window_pos_or_size_needs_write = false;
+    if (startup.num_sections_from_text > 0) {
+        // refresh now rather than at exit, so the next startup is quick even if this session doesn't end cleanly
+        (void) state_snapshot_save_to_disk(window_render_order);
+    }
 
+    // persistence debounces these, so the disk isn't spammed as the user moves or resizes the window
     glfwSetWindowPosCallback(window, [](GLFWwindow *, s32 new_x, s32 new_y) noexcept {
         global_state::settings().window_x = new_x;
         global_state::settings().window_y = new_y;
-        last_window_move_or_resize_time = get_time_precise();
-        window_pos_or_size_needs_write = true;
+        global_state::mark_dirty(persisted_file::settings);
     });
     glfwSetWindowSizeCallback(window, [](GLFWwindow *, s32 new_w, s32 new_h) noexcept {
         global_state::settings().window_w = new_w;
         global_state::settings().window_h = new_h;
-        last_window_move_or_resize_time = get_time_precise();
-        window_pos_or_size_needs_write = true;
+        global_state::mark_dirty(persisted_file::settings);
     });
 
     print_debug_msg("Entering render loop...");
 
+    render_loop_scheduler scheduler = {};
+
     while (!glfwWindowShouldClose(window)) {
         // check before polling events or starting the frame because
         // ImGui::IsPopupOpen(nullptr, ImGuiPopupFlags_AnyPopup) unexpectedly returns false after ImGuiKey_Escape is pressed if
         // this value is queried later in the frame
         bool any_popups_open = imgui::IsPopupOpen(nullptr, ImGuiPopupFlags_AnyPopup);
 
-        glfwPollEvents();
+        wait_for_next_frame(window, scheduler);
+
+        SWAN_PROFILE_FRAME_BEGIN();
 
         // this is to prevent the ugly blue border (nav focus I think it's called?) when pressing escape
         if (one_of(GLFW_PRESS, { glfwGetKey(window, GLFW_KEY_ESCAPE) })) {
             ImGui::SetWindowFocus(swan_windows::get_name(window_render_order.back()));
         }
 
-        if (window_pos_or_size_needs_write && time_diff_ms(last_window_move_or_resize_time, get_time_precise()) > 250) {
-            // we check that some time has passed since last_window_move_or_resize_time to avoid spamming the disk as the user moves or resizes the window
-            print_debug_msg("window_pos_or_size_needs_write");
-            (void) global_state::settings().save_to_disk();
-            window_pos_or_size_needs_write = false;
-        }
-
         BeginFrame_GLFW_OpenGL3(ini_file_path.c_str());
 
         auto visib_at_frame_start = global_state::settings().show;
 
         SCOPE_EXIT {
-            EndFrame_GLFW_OpenGL3(window);
+            {
+                SWAN_PROFILE_ZONE("EndFrame_GLFW_OpenGL3");
+                EndFrame_GLFW_OpenGL3(window);
+            }
+
+            if (startup.time_to_first_frame_ms == 0) {
+                startup.time_to_first_frame_ms = process_uptime_ms();
+                print_debug_msg("time to first frame: %.1f ms", startup.time_to_first_frame_ms);
+            }
 
             for (auto &id : global_state::delete_icon_textures_queue()) {
                 delete_icon_texture(id);
@@ -275,8 +338,22 @@ try {
 
             bool window_visibilities_changed = memcmp(&global_state::settings().show, &visib_at_frame_start, sizeof(visib_at_frame_start)) != 0;
             if (window_visibilities_changed) {
-                global_state::settings().save_to_disk();
+                global_state::mark_dirty(persisted_file::settings);
+            }
+
+            {
+                SWAN_PROFILE_ZONE("persistence_pump");
+                persistence_pump(window_render_order);
             }
+
+            SWAN_PROFILE_FRAME_END();
+
+        #if SWAN_PROFILER
+            if (trace_startup) {
+                trace_startup = false;
+                profiler_export_chrome_trace(global_state::execution_path() / "traces" / "trace_startup.json");
+            }
+        #endif
         };
 
         imgui::DockSpaceOverViewport(0, ImGuiDockNodeFlags_PassthruCentralNode);
@@ -421,6 +498,17 @@ try {
                     }
                     break;
                 }
+                case swan_windows::id::disk_usage: {
+                    if (window_visib.disk_usage) {
+                        if (swan_windows::render_disk_usage(window_visib.disk_usage, any_popups_open)) {
+                            if (imgui::IsWindowFocused(ImGuiFocusedFlags_ChildWindows) && imgui::GetFrameCount() > 1) {
+                                window_render_order_move_to_back(swan_windows::id::disk_usage);
+                            }
+                        }
+                        imgui::End();
+                    }
+                    break;
+                }
                 case swan_windows::id::recent_files: {
                     if (window_visib.recent_files) {
                         if (swan_windows::render_recent_files(window_visib.recent_files, any_popups_open)) {
@@ -466,7 +554,7 @@ try {
                             if (changes_applied) {
                                 glfwSetWindowPos(window, global_state::settings().window_x, global_state::settings().window_y);
                                 glfwSetWindowSize(window, global_state::settings().window_w, global_state::settings().window_h);
-                                (void) global_state::settings().save_to_disk();
+                                global_state::mark_dirty(persisted_file::settings);
                             }
                         }
                     }
@@ -521,14 +609,14 @@ try {
 
         if (memcmp(window_render_order_2.data(), window_render_order.data(), sizeof(window_render_order.front()) * window_render_order.size()) != 0) {
             // there was a change in window focus, window_render_order_2 reflects this change
-            window_render_order_save_to_disk(window_render_order_2);
             window_render_order = window_render_order_2;
+            global_state::mark_dirty(persisted_file::window_render_order);
         }
 
         if (imgui::GetFrameCount() == 1) {
             // After rendering all windows for the first time (FrameCount == 1),
             // tell imgui which window will have initial focus based on what was loaded from [focused_window.txt].
-            // Notice that we check for imgui::GetFrameCount() > 1 before calling window_render_order_save_to_disk(),
+            // Notice that we check for imgui::GetFrameCount() > 1 before marking the window render order dirty,
             // this is because imgui::IsWindowFocused(ImGuiFocusedFlags_ChildWindows) returns true for all windows on frame 1.
 
             for (auto const &window_id : window_render_order) {
@@ -537,15 +625,20 @@ try {
             }
         }
 
-        swan_popup_modals::render_single_rename();
-        swan_popup_modals::render_bulk_rename();
-        swan_popup_modals::render_new_file();
-        swan_popup_modals::render_new_directory();
-        swan_popup_modals::render_new_pin();
-        swan_popup_modals::render_edit_pin();
-        swan_popup_modals::render_error();
-
-        imgui::RenderConfirmationModal();
+        {
+            SWAN_PROFILE_ZONE("popup_modals");
+
+            swan_popup_modals::render_single_rename();
+            swan_popup_modals::render_bulk_rename();
+            swan_popup_modals::render_new_file();
+            swan_popup_modals::render_new_directory();
+            swan_popup_modals::render_mirror();
+            swan_popup_modals::render_new_pin();
+            swan_popup_modals::render_edit_pin();
+            swan_popup_modals::render_error();
+
+            imgui::RenderConfirmationModal();
+        }
 
         if (!g_test_suite_ran_without_crashes.value_or(true) || g_failed_assertions.size() > 0) {
             imgui::OpenPopup(" Test Output ");
@@ -558,6 +651,8 @@ try {
         }
     }
 
+    (void) state_snapshot_save_to_disk(window_render_order);
+
     return 0;
 }
 catch (std::exception const &except) {
@@ -577,6 +672,71 @@ catch (...) {
     return 1;
 }
 
+/// Polls or blocks for events until there is reason to render a frame: input, `global_state::wake_render_loop` from any thread, or a timeout.
+/// After input or a wake, `RENDER_LOOP_FRAMES_AFTER_EVENT` frames are rendered back to back. While the mouse is held or the
+/// thread pool has tasks, frames keep coming at a throttled rate so drags and progress displays stay live. Otherwise the loop
+/// sleeps, the timeout bounding how long polled state (debounced explorer refreshes, persistence, hover delays) can go unnoticed.
+static
+void wait_for_next_frame(GLFWwindow *window, render_loop_scheduler &scheduler) noexcept
+{
+    auto &stats = global_state::render_loop_stats_get();
+    bool waited = false;
+
+    if (scheduler.num_frames_left > 0) {
+        --scheduler.num_frames_left;
+        glfwPollEvents();
+    }
+    else {
+        bool busy = imgui::IsAnyMouseDown() || global_state::thread_pool().get_tasks_total() > 0;
+        bool foreground = glfwGetWindowAttrib(window, GLFW_FOCUSED) && !glfwGetWindowAttrib(window, GLFW_ICONIFIED);
+        f64 timeout_s = busy ? RENDER_LOOP_BUSY_TIMEOUT_S : foreground ? RENDER_LOOP_IDLE_TIMEOUT_S : RENDER_LOOP_BACKGROUND_TIMEOUT_S;
+
+        auto wait_start = get_time_precise();
+        glfwWaitEventsTimeout(timeout_s);
+        scheduler.sample_waited_us += time_diff_us(wait_start, get_time_precise());
+
+        waited = true;
+        ++stats.num_waits_total;
+    }
+
+    // the GLFW backend queues input events from its callbacks, they are consumed by the next imgui::NewFrame
+    bool input_arrived = !imgui::GetCurrentContext()->InputEventsQueue.empty();
+    bool woken = global_state::render_loop_consume_wake();
+
+    if (input_arrived || woken) {
+        scheduler.num_frames_left = RENDER_LOOP_FRAMES_AFTER_EVENT;
+    }
+    if (waited) {
+        if (input_arrived)  ++stats.num_wakes_by_input;
+        else if (woken)     ++stats.num_wakes_by_workers;
+        else                ++stats.num_wakes_by_timeout;
+    }
+
+    ++stats.num_frames_total;
+    ++scheduler.sample_num_frames;
+    scheduler.sample_had_input |= input_arrived;
+
+    auto now = get_time_precise();
+    s64 sample_us = time_diff_us(scheduler.sample_start, now);
+
+    if (sample_us >= 1'000'000) {
+        f64 cpu_ms = process_cpu_time_ms();
+
+        stats.frames_per_second = f64(scheduler.sample_num_frames) * 1'000'000 / f64(sample_us);
+        stats.waiting_percent = f64(scheduler.sample_waited_us) * 100 / f64(sample_us);
+        stats.cpu_percent = (cpu_ms - scheduler.sample_start_cpu_ms) * 1000 * 100 / f64(sample_us);
+        if (!scheduler.sample_had_input) {
+            stats.idle_cpu_percent = stats.cpu_percent;
+        }
+
+        scheduler.sample_start = now;
+        scheduler.sample_start_cpu_ms = cpu_ms;
+        scheduler.sample_waited_us = 0;
+        scheduler.sample_num_frames = 0;
+        scheduler.sample_had_input = false;
+    }
+}
+
 static
 void glfw_error_callback(s32 error, char const *description) noexcept
 {
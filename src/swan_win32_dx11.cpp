@@ -96,6 +96,9 @@ try {
         }
     }
 
+    // decode the state snapshot on a worker while the window, D3D device, fonts and COM are set up
+    std::future<state_snapshot_load_result> state_snapshot_future = global_state::thread_pool().submit(state_snapshot_load_from_disk);
+
     auto [hwnd, wndclass] = create_barebones_window(global_state::settings());
     if (hwnd == NULL) {
         return 1;
@@ -143,6 +146,20 @@ try {
     SCOPE_EXIT { cleanup_explorer_COM(); };
     print_debug_msg("SUCCESS COM initialized");
 
+    auto &startup = global_state::startup_timings_get();
+
+    state_snapshot_load_result state_snapshot = {};
+    {
+        scoped_timer<timer_unit::MICROSECONDS> wait_timer(&startup.state_snapshot_wait_us);
+        state_snapshot = state_snapshot_future.get();
+    }
+
+    // whatever the snapshot lacks is loaded from its text file, as before the snapshot existed
+    auto from_snapshot = [&](state_snapshot_section::kind kind) noexcept {
+        ++(state_snapshot.loaded[kind] ? startup.num_sections_from_snapshot : startup.num_sections_from_text);
+        return state_snapshot.loaded[kind];
+    };
+
 #if DEBUG_MODE
     run_tests_integrated(ntest_output_directory_path);
 #endif
@@ -168,7 +185,12 @@ try {
         global_state::page_size() = system_info.dwPageSize;
         print_debug_msg("global_state::page_size = %d", global_state::page_size());
 
-        (void) global_state::settings().load_from_disk();
+        if (from_snapshot(state_snapshot_section::kind_settings)) {
+            global_state::settings() = state_snapshot.settings;
+            imgui::GetStyle() = state_snapshot.style;
+        } else {
+            (void) global_state::settings().load_from_disk();
+        }
 
         s32 pos_x = 25, pos_y = 25, width = 1280, height = 720;
         if (global_state::settings().startup_with_previous_window_pos_and_size) {
@@ -180,14 +202,26 @@ try {
         SetWindowPos(hwnd, HWND_TOP, pos_x, pos_y, width, height, SWP_SHOWWINDOW);
         ShowWindow(hwnd, global_state::settings().startup_with_window_maximized ? SW_MAXIMIZE : nCmdShow);
 
-        (void) global_state::pinned_load_from_disk(global_state::settings().dir_separator_utf8);
-        (void) global_state::recent_files_load_from_disk(global_state::settings().dir_separator_utf8);
-        (void) global_state::completed_file_operations_load_from_disk(global_state::settings().dir_separator_utf8);
+        if (!from_snapshot(state_snapshot_section::kind_pinned)) {
+            (void) global_state::pinned_load_from_disk(global_state::settings().dir_separator_utf8);
+        }
+        if (!from_snapshot(state_snapshot_section::kind_recent_files)) {
+            (void) global_state::recent_files_load_from_disk(global_state::settings().dir_separator_utf8);
+        }
+        if (!from_snapshot(state_snapshot_section::kind_completed_file_operations)) {
+            (void) global_state::completed_file_operations_load_from_disk(global_state::settings().dir_separator_utf8);
+        }
+        if (!from_snapshot(state_snapshot_section::kind_directory_jump)) {
+            (void) global_state::directory_jump_load_from_disk();
+        }
+        bulk_rename_offer_revert_of_interrupted();
     }
 
     auto &explorers = global_state::explorers();
     // init explorers
     {
+        scoped_timer<timer_unit::MICROSECONDS> explorers_init_timer(&startup.explorers_init_us);
+
         char const *names[global_constants::num_explorers] = {
             swan_windows::get_name(swan_windows::id::explorer_0),
             swan_windows::get_name(swan_windows::id::explorer_1),
@@ -202,13 +236,13 @@ try {
             expl.name = names[i];
             expl.filter_error.reserve(1024);
 
-            bool load_result = explorers[i].load_from_disk(global_state::settings().dir_separator_utf8);
+            bool load_result = from_snapshot(state_snapshot_section::kind(state_snapshot_section::kind_explorer_0 + i))
+                            || explorers[i].load_from_disk(global_state::settings().dir_separator_utf8);
             print_debug_msg("[ %d ] explorer_window::load_from_disk: %d", i, load_result);
 
             if (!load_result) {
                 expl.cwd = path_create("");
-                bool save_result = explorers[i].save_to_disk();
-                print_debug_msg("[%s] save_to_disk: %d", expl.name, save_result);
+                global_state::mark_dirty(expl);
             }
 
             auto [starting_dir_exists, _] = expl.update_cwd_entries(query_filesystem, expl.cwd.data());
@@ -257,10 +291,12 @@ try {
         }
     }
 
-    std::string const ini_file_path = (global_state::execution_path() / "data\\swan_imgui.ini").generic_string();
+    if (startup.num_sections_from_text > 0) {
+        // refresh now rather than at exit, so the next startup is quick even if this session doesn't end cleanly
+        (void) state_snapshot_save_to_disk(window_render_order);
+    }
 
-    static time_point_precise_t last_window_move_or_resize_time = get_time_precise();
-    static bool window_pos_or_size_needs_write = false;
+    std::string const ini_file_path = (global_state::execution_path() / "data\\swan_imgui.ini").generic_string();
 
     print_debug_msg("Entering render loop...");
 
@@ -274,7 +310,10 @@ try {
         while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
             TranslateMessage(&msg);
             DispatchMessage(&msg);
-            if (msg.message == WM_QUIT) return 0;
+            if (msg.message == WM_QUIT) {
+                (void) state_snapshot_save_to_disk(window_render_order);
+                return 0;
+            }
         }
 
         // Handle window being minimized or screen locked
@@ -310,20 +349,15 @@ try {
             }
         }
 
-        if (window_pos_or_size_needs_write && time_diff_ms(last_window_move_or_resize_time, get_time_precise()) > 250) {
-            // we check that some time has passed since last_window_move_or_resize_time to avoid spamming the disk as the user moves or resizes the window
-            print_debug_msg("window_pos_or_size_needs_write");
-            (void) global_state::settings().save_to_disk();
-            window_pos_or_size_needs_write = false;
-        }
-
         auto visib_at_frame_start = global_state::settings().show;
 
         SCOPE_EXIT {
             bool window_visibilities_changed = memcmp(&global_state::settings().show, &visib_at_frame_start, sizeof(visib_at_frame_start)) != 0;
             if (window_visibilities_changed) {
-                global_state::settings().save_to_disk();
+                global_state::mark_dirty(persisted_file::settings);
             }
+
+            persistence_pump(window_render_order);
         };
 
         imgui::DockSpaceOverViewport(0, ImGuiDockNodeFlags_PassthruCentralNode);
@@ -403,7 +437,7 @@ try {
                                          global_state::settings().window_w, global_state::settings().window_h,
                                          SWP_SHOWWINDOW);
 
-                            (void) global_state::settings().save_to_disk();
+                            global_state::mark_dirty(persisted_file::settings);
                         }
                     }
                     break;
@@ -437,6 +471,7 @@ try {
         swan_popup_modals::render_bulk_rename();
         swan_popup_modals::render_new_file();
         swan_popup_modals::render_new_directory();
+        swan_popup_modals::render_mirror();
         swan_popup_modals::render_new_pin();
         swan_popup_modals::render_edit_pin();
         swan_popup_modals::render_error();
@@ -455,6 +490,11 @@ try {
         }
 
         g_swapChainOccluded = EndFrame_Win32_DX11(g_pd3dDeviceContext, g_mainRenderTargetView, g_pSwapChain);
+
+        if (startup.time_to_first_frame_ms == 0) {
+            startup.time_to_first_frame_ms = process_uptime_ms();
+            print_debug_msg("time to first frame: %.1f ms", startup.time_to_first_frame_ms);
+        }
     }
 
     return 0;
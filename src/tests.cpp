@@ -1,5 +1,6 @@
 #include "stdafx.hpp"
 #include "common_functions.hpp"
+#include "platform.hpp"
 
 std::optional<ntest::report_result> run_tests(std::filesystem::path const &output_path,
                                               void (*assertion_callback)(ntest::assertion const &, bool)) noexcept
@@ -12,22 +13,6 @@ try {
         [[maybe_unused]] auto const res = ntest::init(output_path);
     }
 
-    // flip_bool
-    #if 1
-    {
-        bool b = true;
-
-        flip_bool(b);
-        ntest::assert_bool(false, b);
-
-        flip_bool(b);
-        ntest::assert_bool(true, b);
-
-        flip_bool(b);
-        ntest::assert_bool(false, b);
-    }
-    #endif
-
     // StrStrA
     #if 1
     {
@@ -94,297 +79,501 @@ try {
     }
     #endif
 
-    // path_clear;
+    // directory_exists
     #if 1
     {
-        swan_path p = path_create("Text.");
-        ntest::assert_cstr("Text.", p.data());
-        path_clear(p);
-        ntest::assert_cstr("", p.data());
+        ntest::assert_bool(false, directory_exists("not_a_directory"));
+    #if DEBUG_MODE
+        ntest::assert_bool(true, directory_exists("src"));
+    #endif
     }
     #endif
 
-    // path_length;
-    #if 1
+    // rename (C stdlib) - confirmed that it doesn't work with Unicode
+    #if 0
     {
-        {
-            swan_path p = {};
-            ntest::assert_uint64(0, path_length(p));
-        }
-        {
-            swan_path p = path_create("Text.");
-            ntest::assert_cstr("Text.", p.data());
-            ntest::assert_uint64(5, path_length(p));
+        auto path1 = output_path / "Юникод 1";
+        auto path2 = output_path / "Юникод 2";
+        auto path1_str = path1.string();
+        auto path2_str = path2.string();
+
+        ntest::assert_bool(true, std::filesystem::create_directory(path1));
+
+        if (ntest::assert_int32(0, rename(path1_str.c_str(), path2_str.c_str()))) {
+            if (ntest::assert_bool(true, std::filesystem::exists(path2_str.c_str()))) {
+                ntest::assert_int32(0, rename(path2_str.c_str(), path2_str.c_str()));
+                ntest::assert_bool(true, std::filesystem::exists(path1));
+            }
         }
     }
     #endif
 
-    // path_ends_with;
+    // bulk_rename_transform::execute, bulk_rename_transform::revert
     #if 1
     {
-        {
-            swan_path p = {};
-            ntest::assert_bool(false, path_ends_with(p, ""));
-            ntest::assert_bool(false, path_ends_with(p, "text"));
-        }
-        {
-            swan_path p = path_create("Text.");
-            ntest::assert_bool(false, path_ends_with(p, "text."));
-            ntest::assert_bool(true, path_ends_with(p, "."));
-            ntest::assert_bool(true, path_ends_with(p, "xt."));
-            ntest::assert_bool(true, path_ends_with(p, "Text."));
-            ntest::assert_bool(false, path_ends_with(p, "Text.Text."));
+        bulk_rename_transform transform(basic_dirent::kind::directory, "Юникод-before", "Юникод-after");
+        transform.stat.store(bulk_rename_transform::status::ready);
+
+        std::wstring working_dir = output_path.wstring();
+        std::replace(working_dir.begin(), working_dir.end(), L'/', L'\\');
+        if (!working_dir.ends_with(L'\\')) working_dir += L'\\';
+
+        std::wstring before, after;
+
+        if (ntest::assert_stdstr( "", transform.execute(working_dir.c_str(), before, after) )) {            // execute [before]->[after]
+            if (ntest::assert_bool( true, std::filesystem::exists(after.c_str()) )) {                       // check [after] exists
+                transform.stat.store(bulk_rename_transform::status::execute_success);
+                if (ntest::assert_stdstr( "", transform.revert(working_dir.c_str(), before, after) )) {     // revert [before]<-[after]
+                    ntest::assert_bool( true, std::filesystem::exists(before.c_str()) );                    // check [before] exists
+                }
+            }
         }
     }
     #endif
 
-    // path_ends_with_one_of;
+    // build_mirror_plan
     #if 1
     {
+        std::filesystem::path root = output_path / "mirror";
+        std::error_code ec = {};
+        std::filesystem::remove_all(root, ec);
+
+        auto write_file = [](std::filesystem::path const &path, u64 size) {
+            std::filesystem::create_directories(path.parent_path());
+            std::ofstream(path, std::ios::binary) << std::string(size, 'x');
+        };
+        auto same_write_time = [](std::filesystem::path const &from, std::filesystem::path const &to) {
+            std::filesystem::last_write_time(to, std::filesystem::last_write_time(from));
+        };
+
+        write_file(root / "src" / "only_in_src.txt", 1);
+        write_file(root / "src" / "same.txt", 3);
+        write_file(root / "src" / "resized.txt", 4);
+        write_file(root / "src" / "sub" / "nested.txt", 5);
+        write_file(root / "src" / "Became_dir" / "inner.txt", 6);
+        write_file(root / "dst" / "only_in_dst.txt", 7);
+        write_file(root / "dst" / "same.txt", 3);
+        write_file(root / "dst" / "resized.txt", 8);
+        write_file(root / "dst" / "sub" / "NESTED.txt", 5); // the same file to NTFS
+        write_file(root / "dst" / "became_dir", 9);
+        same_write_time(root / "src" / "same.txt", root / "dst" / "same.txt");
+        same_write_time(root / "src" / "sub" / "nested.txt", root / "dst" / "sub" / "NESTED.txt");
+
+        auto plan_with = [&](mirror_plan::options options) {
+            progressive_task<mirror_plan> task = {};
+            std::atomic<u64> num_entries_compared = 0;
+            build_mirror_plan(task, (root / "src").wstring(), (root / "dst").wstring(), options, num_entries_compared);
+            return std::move(task.result);
+        };
+
         {
-            swan_path p = {};
-            ntest::assert_bool(false, path_ends_with_one_of(p, "abc"));
+            mirror_plan plan = plan_with({ .delete_extras = true, .compare_contents = false });
+
+            ntest::assert_uint64(0, plan.errors.size());
+            ntest::assert_uint64(2, plan.num_copies);
+            ntest::assert_uint64(1, plan.num_updates);
+            ntest::assert_uint64(2, plan.num_deletes);
+            ntest::assert_uint64(1 + 4, plan.num_bytes_to_copy);
+
+            // sorted by path, the delete of a file replaced by a directory before the copy replacing it
+            if (ntest::assert_uint64(5, plan.entries.size())) {
+                ntest::assert_bool(true, plan.entries[0].act == mirror_plan::action::del && plan.entries[0].relative_path_utf16 == L"became_dir");
+                ntest::assert_bool(true, plan.entries[1].act == mirror_plan::action::copy && plan.entries[1].relative_path_utf16 == L"Became_dir");
+                ntest::assert_bool(true, plan.entries[2].act == mirror_plan::action::del && plan.entries[2].relative_path_utf16 == L"only_in_dst.txt");
+                ntest::assert_bool(true, plan.entries[3].act == mirror_plan::action::copy && plan.entries[3].relative_path_utf16 == L"only_in_src.txt");
+                ntest::assert_bool(true, plan.entries[4].act == mirror_plan::action::update && plan.entries[4].relative_path_utf16 == L"resized.txt");
+            }
         }
         {
-            swan_path p = path_create("Text");
-            ntest::assert_bool(false, path_ends_with_one_of(p, "abc"));
-            ntest::assert_bool(false, path_ends_with_one_of(p, "T"));
-            ntest::assert_bool(true, path_ends_with_one_of(p, "t"));
-            ntest::assert_bool(true, path_ends_with_one_of(p, "tt"));
-            ntest::assert_bool(true, path_ends_with_one_of(p, "abct"));
-            ntest::assert_bool(true, path_ends_with_one_of(p, "tabc"));
+            // a file replaced by a directory still goes, extras stay
+            mirror_plan plan = plan_with({ .delete_extras = false, .compare_contents = true });
+
+            ntest::assert_uint64(0, plan.errors.size());
+            ntest::assert_uint64(1, plan.num_deletes);
+            ntest::assert_uint64(4, plan.entries.size());
         }
+
+        std::filesystem::remove_all(root, ec);
     }
     #endif
 
-    // path_append;
+    // shortcut_kind_cache
     #if 1
     {
-        {
-            swan_path p = {};
-
-            ntest::assert_uint64(1, path_append(p, "C:"));
-            ntest::assert_cstr("C:", p.data());
-
-            ntest::assert_uint64(1, path_append(p, "code\\", '\\', true));
-            ntest::assert_cstr("C:\\code\\", p.data());
-
-            ntest::assert_uint64(1, path_append(p, "swan", '\\', true));
-            ntest::assert_cstr("C:\\code\\swan", p.data());
-
-            ntest::assert_uint64(1, path_append(p, ".md"));
-            ntest::assert_cstr("C:\\code\\swan.md", p.data());
-        }
-        {
-            swan_path p = {};
-
-            // std::string temp(swan_path_t::static_capacity, 'x');
-            std::string temp(p.max_size() - 1, 'x');
-
-            ntest::assert_uint64(1, path_append(p, temp.c_str()));
-            ntest::assert_cstr(temp.c_str(), p.data());
-
-            p = {};
+        shortcut_kind_cache cache = {};
+        basic_dirent::kind kind = basic_dirent::kind::file;
+
+        cache.store(path_loose_hash("C:\\a.lnk"), 100, basic_dirent::kind::symlink_to_directory);
+
+        ntest::assert_bool(true, cache.find(path_loose_hash("c:/A.LNK"), 100, kind));
+        ntest::assert_bool(true, kind == basic_dirent::kind::symlink_to_directory);
+
+        // modified since it was resolved
+        kind = basic_dirent::kind::file;
+        ntest::assert_bool(false, cache.find(path_loose_hash("C:\\a.lnk"), 101, kind));
+        ntest::assert_bool(true, kind == basic_dirent::kind::file);
+        ntest::assert_bool(false, cache.find(path_loose_hash("C:\\b.lnk"), 100, kind));
+        ntest::assert_uint64(1, cache.num_hits);
+        ntest::assert_uint64(2, cache.num_misses);
+
+        cache.store(path_loose_hash("C:\\a.lnk"), 101, basic_dirent::kind::invalid_symlink);
+        ntest::assert_bool(true, cache.find(path_loose_hash("C:\\a.lnk"), 101, kind));
+        ntest::assert_bool(true, kind == basic_dirent::kind::invalid_symlink);
+        ntest::assert_uint64(1, cache.targets.size());
+
+        // starts over once full
+        for (u64 i = 1; i < shortcut_kind_cache::MAX_SHORTCUTS; ++i) {
+            cache.store(i, 1, basic_dirent::kind::symlink_to_file);
+        }
+        ntest::assert_uint64(shortcut_kind_cache::MAX_SHORTCUTS, cache.targets.size());
+        cache.store(u64(-1), 1, basic_dirent::kind::symlink_to_file);
+        ntest::assert_uint64(1, cache.targets.size());
+    }
+    #endif
 
-            ntest::assert_uint64(0, path_append(p, temp.c_str(), '\\', true));
-            ntest::assert_cstr("", p.data());
+    // directory_size_cache
+    #if 1
+    {
+        directory_size_cache cache = {};
+        directory_size_cache::record found = {};
+
+        cache.store(path_loose_hash("C:\\a"), { 10, 1, 4096, 1, std::string("b\0d\0", 4) });
+        cache.store(path_loose_hash("C:\\a\\b"), { 20, 2, 4096, 1, std::string("c\0", 2) });
+        cache.store(path_loose_hash("C:\\a\\b\\c"), { 30, 3, 4096, 1, "" });
+        cache.store(path_loose_hash("C:\\a\\d"), { 40, 4, 0, 0, "" });
+
+        ntest::assert_bool(true, cache.find(path_loose_hash("c:/A/b/"), 20, 2, found));
+        ntest::assert_uint64(4096, found.size_on_disk);
+        ntest::assert_uint64(1, found.num_files);
+        ntest::assert_bool(true, std::string("c\0", 2) == found.subdirectories);
+
+        // modified, or replaced by another directory of the same name
+        ntest::assert_bool(false, cache.find(path_loose_hash("C:\\a\\b"), 21, 2, found));
+        ntest::assert_bool(false, cache.find(path_loose_hash("C:\\a\\b"), 20, 5, found));
+        ntest::assert_uint64(1, cache.num_hits);
+        ntest::assert_uint64(2, cache.num_misses);
+
+        std::string serialized = cache.serialize();
+        directory_size_cache loaded = {};
+        ntest::assert_bool(true, loaded.deserialize(serialized));
+        ntest::assert_uint64(4, loaded.records.size());
+        ntest::assert_bool(true, loaded.find(path_loose_hash("C:\\a\\b\\c"), 30, 3, found));
+        ntest::assert_uint64(4096, found.size_on_disk);
+        ntest::assert_bool(true, loaded.find(path_loose_hash("C:\\a"), 10, 1, found));
+        ntest::assert_bool(true, std::string("b\0d\0", 4) == found.subdirectories);
+        ntest::assert_bool(false, loaded.deserialize(serialized.substr(0, serialized.size() - 1)));
+        ntest::assert_uint64(0, loaded.records.size());
+
+        // records hold no totals, so a change in b invalidates only b
+        ntest::assert_uint64(1, cache.invalidate("C:\\a\\b\\"));
+        ntest::assert_bool(true, cache.find(path_loose_hash("C:\\a"), 10, 1, found));
+        ntest::assert_bool(false, cache.find(path_loose_hash("C:\\a\\b"), 20, 2, found));
+        ntest::assert_bool(true, cache.find(path_loose_hash("C:\\a\\b\\c"), 30, 3, found));
+        ntest::assert_bool(true, cache.find(path_loose_hash("C:\\a\\d"), 40, 4, found));
+        ntest::assert_uint64(1, cache.num_invalidated);
+
+        // once full, the least recently used records make room rather than all of them
+        cache.clear();
+        for (u64 key = 0; key < directory_size_cache::MAX_RECORDS; ++key) {
+            cache.store(key, { 1, 1, 0, 0, "" });
+        }
+        ntest::assert_bool(true, cache.find(0, 1, 1, found));
+        cache.store(directory_size_cache::MAX_RECORDS, { 1, 1, 0, 0, "" });
+
+        ntest::assert_uint64(directory_size_cache::MAX_RECORDS - directory_size_cache::NUM_RECORDS_PER_EVICTION + 1, cache.records.size());
+        ntest::assert_uint64(directory_size_cache::NUM_RECORDS_PER_EVICTION, cache.num_evicted);
+        ntest::assert_bool(true, cache.records.contains(0));
+        ntest::assert_bool(false, cache.records.contains(1));
+        ntest::assert_bool(false, cache.records.contains(directory_size_cache::NUM_RECORDS_PER_EVICTION));
+        ntest::assert_bool(true, cache.records.contains(directory_size_cache::NUM_RECORDS_PER_EVICTION + 1));
+        ntest::assert_bool(true, cache.records.contains(directory_size_cache::MAX_RECORDS));
+    }
+    #endif
 
-            p = {};
+    // directory_sizes_compute
+    #if 1
+    {
+        std::filesystem::path root = output_path / "directory_sizes";
+        std::error_code ec = {};
+        std::filesystem::remove_all(root, ec);
+        std::filesystem::create_directories(root / "a" / "b" / "c");
+        std::ofstream(root / "a" / "1.bin", std::ios::binary) << std::string(10, 'x');
+        std::ofstream(root / "a" / "b" / "c" / "2.bin", std::ios::binary) << std::string(10, 'x');
+
+        auto compute = [&root]() noexcept {
+            std::vector<swan_path> names = { path_create("a") };
+            auto job = std::make_shared<directory_size_job>(path_create(root.string().c_str()), std::move(names));
+            directory_sizes_compute(job);
+            while (job->num_pending.load() != 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            ntest::assert_bool(true, job->done[0].load());
+            return job->sizes[0].load();
+        };
 
-            temp.pop_back();
-            ntest::assert_uint64(1, path_append(p, temp.c_str()));
-            ntest::assert_cstr(temp.c_str(), p.data());
-            // p is now one away from max capacity
+        u64 const cluster_size = volume_cluster_size(root.string().c_str());
+        u64 const before = compute();
+        ntest::assert_uint64(2 * cluster_size, before);
 
-            ntest::assert_uint64(1, path_append(p, "x"));
-            temp.push_back('x');
-            ntest::assert_cstr(temp.c_str(), p.data());
-            // p is now at max capacity, next append should fail
+        // neither a nor a\b is touched by a file added to a\b\c, a's total grows all the same
+        std::ofstream(root / "a" / "b" / "c" / "3.bin", std::ios::binary) << std::string(cluster_size + 1, 'x');
+        ntest::assert_uint64(before + 2 * cluster_size, compute());
 
-            ntest::assert_uint64(0, path_append(p, "x"));
-            ntest::assert_cstr(temp.c_str(), p.data()); // ensure state has not changed on failure
-        }
+        // and shrinks again once a\b\c is gone
+        std::filesystem::remove_all(root / "a" / "b" / "c", ec);
+        ntest::assert_uint64(cluster_size, compute());
     }
     #endif
 
-    // path_is_empty;
+    // disk_usage_tree
     #if 1
     {
-        {
-            swan_path p = {};
-            ntest::assert_bool(true, path_is_empty(p));
-        }
-        {
-            swan_path p = path_create("text");
-            ntest::assert_bool(false, path_is_empty(p));
-        }
+        disk_usage_tree tree = {};
+
+        u32 root = tree.add_node(disk_usage_tree::NIL, "C:\\", 3, 0, true);
+        u32 a = tree.add_node(root, "a", 1, 0, true);
+        u32 a_file = tree.add_node(a, "desktop.ini", 11, 4096, false);
+        u32 root_file = tree.add_node(root, "desktop.ini", 11, 8192, false);
+        tree.add_size(a, 4096);
+        tree.add_size(root, 8192);
+
+        ntest::assert_stdstr("C:\\a\\desktop.ini", tree.path(a_file));
+        ntest::assert_stdstr("C:\\desktop.ini", tree.path(root_file));
+        ntest::assert_uint64(4096 * 3, tree.nodes[root].size);
+        ntest::assert_uint64(4096, tree.nodes[a].size);
+
+        // children are threaded newest first
+        ntest::assert_uint64(root_file, tree.nodes[root].first_child);
+        ntest::assert_uint64(a, tree.nodes[root_file].next_sibling);
+        ntest::assert_uint64(disk_usage_tree::NIL, tree.nodes[a].next_sibling);
+
+        // interned
+        ntest::assert_uint64(tree.nodes[a_file].name_offset, tree.nodes[root_file].name_offset);
+        ntest::assert_uint64(strlen("C:\\") + strlen("a") + strlen("desktop.ini") + 3, tree.names.size());
+
+        // deeper than any fixed bound, the path still starts at the root
+        u32 deepest = a;
+        for (u32 depth = 0; depth < 1000; ++depth) {
+            deepest = tree.add_node(deepest, "a", 1, 0, true);
+        }
+        std::string deepest_path = tree.path(deepest);
+        ntest::assert_bool(true, deepest_path.starts_with("C:\\a\\a\\"));
+        ntest::assert_uint64(strlen("C:\\") + 1001 * 2 - 1, deepest_path.size());
     }
     #endif
 
-    // directory_exists
+    // treemap_squarify
     #if 1
     {
-        ntest::assert_bool(false, directory_exists("not_a_directory"));
-    #if DEBUG_MODE
-        ntest::assert_bool(true, directory_exists("src"));
-    #endif
+        // the example of Bruls, Huizing and van Wijk
+        u64 sizes[] = { 6, 6, 4, 3, 2, 2, 1 };
+        std::vector<treemap_cell> cells = {};
+        treemap_squarify(sizes, lengthof(sizes), ImVec2(0, 0), ImVec2(6, 4), cells);
+
+        if (ntest::assert_uint64(lengthof(sizes), cells.size())) {
+            f32 worst_aspect_ratio = 0;
+
+            for (u64 i = 0; i < cells.size(); ++i) {
+                ImVec2 size = cells[i].max - cells[i].min;
+                ntest::assert_bool(true, std::fabs(size.x * size.y - f32(sizes[i])) < 0.001f);
+                ntest::assert_bool(true, cells[i].min.x >= 0 && cells[i].min.y >= 0 && cells[i].max.x <= 6.001f && cells[i].max.y <= 4.001f);
+                worst_aspect_ratio = std::max(worst_aspect_ratio, std::max(size.x / size.y, size.y / size.x));
+            }
+            ntest::assert_bool(true, worst_aspect_ratio < 3);
+            ntest::assert_bool(true, cells[0].min.x == 0 && cells[0].min.y == 0 && cells[1].max.y == 4); // 6 and 6 stacked on the left
+        }
+
+        cells.clear();
+        u64 zeros[] = { 0, 0 };
+        treemap_squarify(zeros, lengthof(zeros), ImVec2(0, 0), ImVec2(10, 10), cells);
+        ntest::assert_uint64(2, cells.size());
     }
     #endif
 
-    // two_u32_to_one_u64
+    // completed_file_operation_group_index
     #if 1
     {
-        u32 hi = 0xFF'F0'0F'FF;
-        u32 lo = 0xFF'F1'1F'FF;
-        u64 combined = two_u32_to_one_u64(lo, hi);
-        ntest::assert_uint64(0xff'f0'0f'ff'ff'f1'1f'ff, combined);
+        std::deque<completed_file_operation> container = {};
+        completed_file_operation_group_index groups = {};
+
+        auto push = [&](u32 group_id) noexcept {
+            container.emplace_front(time_point_system_t(), time_point_system_t(), file_operation_type::copy, "src", "dst", basic_dirent::kind::file, group_id);
+            groups.on_push_front(group_id);
+        };
+
+        push(1); push(1); push(2); push(2); push(2); push(3);
+        // container: [3, 2, 2, 2, 1, 1]
+
+        ntest::assert_uint64(0, groups.index_range(3).first);
+        ntest::assert_uint64(1, groups.index_range(3).second);
+        ntest::assert_uint64(1, groups.index_range(2).first);
+        ntest::assert_uint64(4, groups.index_range(2).second);
+        ntest::assert_uint64(4, groups.index_range(1).first);
+        ntest::assert_uint64(6, groups.index_range(1).second);
+
+        groups.on_erase(container, 1, 4); // forget group 2
+        container.erase(container.begin() + 1, container.begin() + 4);
+        // container: [3, 1, 1]
+
+        ntest::assert_uint64(0, groups.index_range(2).second);
+        ntest::assert_uint64(0, groups.index_range(3).first);
+        ntest::assert_uint64(1, groups.index_range(3).second);
+        ntest::assert_uint64(1, groups.index_range(1).first);
+        ntest::assert_uint64(3, groups.index_range(1).second);
+
+        groups.on_pop_back(container.back().group_id, container.size());
+        container.pop_back();
+        // container: [3, 1]
+
+        ntest::assert_uint64(1, groups.index_range(1).first);
+        ntest::assert_uint64(2, groups.index_range(1).second);
+
+        groups.rebuild(container);
+        ntest::assert_bool(true, groups.acquire_group_id() > 3);
     }
     #endif
 
-    // path_loosely_same;
+    // choose_fast_copy_strategy, try_fast_copy_file
     #if 1
     {
+        fast_copy_candidate same_refs_volume = {};
+        same_refs_volume.src_attributes = FILE_ATTRIBUTE_ARCHIVE;
+        same_refs_volume.src_volume_serial = 1;
+        same_refs_volume.src_fs_flags = FILE_SUPPORTS_BLOCK_REFCOUNTING|FILE_SUPPORTS_SPARSE_FILES;
+        same_refs_volume.dst_volume_serial = 1;
+        same_refs_volume.dst_fs_flags = FILE_SUPPORTS_BLOCK_REFCOUNTING|FILE_SUPPORTS_SPARSE_FILES;
+
+        ntest::assert_bool(true, file_copy_strategy::clone == choose_fast_copy_strategy(same_refs_volume));
+
         {
-            swan_path p1 = path_create("1/2/3");
-            swan_path p2 = path_create("1/2/3");
-            ntest::assert_bool(true, path_loosely_same(p1, p2));
-            ntest::assert_bool(true, path_loosely_same(p2, p1));
-        }
-        {
-            swan_path p1 = path_create("1/2/3");
-            swan_path p2 = path_create("1/2/3/");
-            ntest::assert_bool(true, path_loosely_same(p1, p2));
-            ntest::assert_bool(true, path_loosely_same(p2, p1));
+            auto other_volume = same_refs_volume;
+            other_volume.dst_volume_serial = 2;
+            ntest::assert_bool(true, file_copy_strategy::none == choose_fast_copy_strategy(other_volume));
+
+            other_volume.src_attributes |= FILE_ATTRIBUTE_SPARSE_FILE;
+            ntest::assert_bool(true, file_copy_strategy::sparse == choose_fast_copy_strategy(other_volume));
+
+            other_volume.dst_fs_flags = 0;
+            ntest::assert_bool(true, file_copy_strategy::none == choose_fast_copy_strategy(other_volume));
         }
         {
-            swan_path p1 = path_create("C:\\code\\");
-            swan_path p2 = path_create("C:\\code");
-            ntest::assert_bool(true, path_loosely_same(p1, p2));
-            ntest::assert_bool(true, path_loosely_same(p2, p1));
+            auto ntfs_sparse = same_refs_volume;
+            ntfs_sparse.src_fs_flags = ntfs_sparse.dst_fs_flags = FILE_SUPPORTS_SPARSE_FILES;
+            ntest::assert_bool(true, file_copy_strategy::none == choose_fast_copy_strategy(ntfs_sparse));
+
+            ntfs_sparse.src_attributes |= FILE_ATTRIBUTE_SPARSE_FILE;
+            ntest::assert_bool(true, file_copy_strategy::sparse == choose_fast_copy_strategy(ntfs_sparse));
         }
-        {
-            swan_path p1 = path_create("C:/code/");
-            swan_path p2 = path_create("C:/code/");
-            ntest::assert_bool(true, path_loosely_same(p1, p2));
-            ntest::assert_bool(true, path_loosely_same(p2, p1));
+
+        // anything a fast copy would lose goes to IFileOperation instead
+        for (DWORD attribute : { FILE_ATTRIBUTE_DIRECTORY, FILE_ATTRIBUTE_REPARSE_POINT, FILE_ATTRIBUTE_ENCRYPTED, FILE_ATTRIBUTE_COMPRESSED }) {
+            auto c = same_refs_volume;
+            c.src_attributes |= attribute;
+            ntest::assert_bool(true, file_copy_strategy::none == choose_fast_copy_strategy(c));
         }
         {
-            swan_path p1 = path_create("C:/code///");
-            swan_path p2 = path_create("C:/code/");
-            ntest::assert_bool(true, path_loosely_same(p1, p2));
-            ntest::assert_bool(true, path_loosely_same(p2, p1));
+            auto c = same_refs_volume;
+            c.src_has_alternate_streams = true;
+            ntest::assert_bool(true, file_copy_strategy::none == choose_fast_copy_strategy(c));
         }
         {
-            swan_path p1 = path_create("C:/code///");
-            swan_path p2 = path_create("C:/code//");
-            ntest::assert_bool(true, path_loosely_same(p1, p2));
-            ntest::assert_bool(true, path_loosely_same(p2, p1));
+            auto c = same_refs_volume;
+            c.src_has_explicit_security = true;
+            ntest::assert_bool(true, file_copy_strategy::none == choose_fast_copy_strategy(c));
         }
+
+        std::filesystem::path root = output_path / "fast_copy";
+        std::error_code ec = {};
+        std::filesystem::remove_all(root, ec);
+        std::filesystem::create_directories(root / "dst");
+
+        std::wstring sparse_path = (root / "sparse.bin").wstring();
         {
-            swan_path p1 = path_create("C:/code///");
-            swan_path p2 = path_create("C:/Code//");
-            ntest::assert_bool(true, path_loosely_same(p1, p2));
-            ntest::assert_bool(true, path_loosely_same(p2, p1));
+            HANDLE handle = CreateFileW(sparse_path.c_str(), GENERIC_READ|GENERIC_WRITE, 0, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, NULL);
+            ntest::assert_bool(true, handle != INVALID_HANDLE_VALUE);
+            DWORD bytes_returned = 0;
+            ntest::assert_bool(true, DeviceIoControl(handle, FSCTL_SET_SPARSE, nullptr, 0, nullptr, 0, &bytes_returned, nullptr));
+            FILE_END_OF_FILE_INFO eof = {};
+            eof.EndOfFile.QuadPart = 8 * 1024 * 1024;
+            ntest::assert_bool(true, SetFileInformationByHandle(handle, FileEndOfFileInfo, &eof, sizeof(eof)));
+            CloseHandle(handle);
         }
 
+        // the scratch directory is NTFS or ReFS, either way a sparse source on the same volume qualifies
         {
-            swan_path p1 = path_create("C:/code///");
-            swan_path p2 = path_create("C:/cod");
-            ntest::assert_bool(false, path_loosely_same(p1, p2));
-            ntest::assert_bool(false, path_loosely_same(p2, p1));
+            file_operation_progress progress = {};
+            std::wstring dst_path = (root / "dst" / "sparse.bin").wstring();
+            file_copy_strategy strategy = try_fast_copy_file(sparse_path.c_str(), dst_path.c_str(), &progress);
+
+            ntest::assert_bool(true, strategy != file_copy_strategy::none);
+            ntest::assert_uint64(8 * 1024 * 1024, std::filesystem::file_size(dst_path));
+            ntest::assert_uint64(progress.work_total.load(), progress.work_so_far.load());
         }
+
+        // an alternate data stream would be lost, so the file is left for a full copy and nothing is left behind
+        std::ofstream((root / "sparse.bin:extra").wstring(), std::ios::binary) << "extra";
         {
-            swan_path p1 = path_create("C:\\code");
-            swan_path p2 = path_create("C:\\");
-            ntest::assert_bool(false, path_loosely_same(p1, p2));
-            ntest::assert_bool(false, path_loosely_same(p2, p1));
+            file_operation_progress progress = {};
+            std::wstring dst_path = (root / "dst" / "sparse_with_stream.bin").wstring();
+            file_copy_strategy strategy = try_fast_copy_file(sparse_path.c_str(), dst_path.c_str(), &progress);
+
+            ntest::assert_bool(true, file_copy_strategy::none == strategy);
+            ntest::assert_bool(false, std::filesystem::exists(dst_path));
+            ntest::assert_uint64(0, progress.work_total.load());
         }
-    }
-    #endif
 
-    // path_squish_adjacent_separators;
-    #if 1
-    {
-        ntest::assert_cstr("1/2/3", path_squish_adjacent_separators(path_create("1/2/3")).data());
-        ntest::assert_cstr("1/2/3", path_squish_adjacent_separators(path_create("1//2//3")).data());
-        ntest::assert_cstr("1/2/3/", path_squish_adjacent_separators(path_create("1//2//3//")).data());
+        // a paste queries each volume once, the files after the first reuse what the cache holds
+        {
+            fast_copy_volume_cache volumes = {};
+            std::wstring dst_dir = (root / "dst").wstring();
+            std::wstring dst_path_1 = (root / "dst" / "cached_1.bin").wstring();
+            std::wstring dst_path_2 = (root / "dst" / "cached_2.bin").wstring();
 
-        ntest::assert_cstr("1\\2\\3\\", path_squish_adjacent_separators(path_create("1\\2\\3\\")).data());
-        ntest::assert_cstr("1\\2\\3\\", path_squish_adjacent_separators(path_create("1\\\\\\2\\3\\\\\\")).data());
-    }
-    #endif
+            (void) try_fast_copy_file(sparse_path.c_str(), dst_path_1.c_str(), nullptr, &volumes);
+            ntest::assert_bool(true, volumes.dst_queried && volumes.dst_valid);
+            ntest::assert_bool(true, volumes.dst_directory_utf16.starts_with(dst_dir));
+            ntest::assert_uint64(1, volumes.src_volumes.size());
 
-    // temp_filename_extension_splitter;
-    #if 1
-    {
-        {
-            char name[] = "src/swan.cpp";
-            temp_filename_extension_splitter sut(name);
-            ntest::assert_cstr("swan", sut.name);
-            ntest::assert_cstr("cpp", sut.ext);
-        }
-        {
-            char name[] = "C:/code/swan/src/explorer_window.cpp";
-            temp_filename_extension_splitter sut(name);
-            ntest::assert_cstr("explorer_window", sut.name);
-            ntest::assert_cstr("cpp", sut.ext);
-        }
-        {
-            char name[] = "a.b.c";
-            temp_filename_extension_splitter sut(name);
-            ntest::assert_cstr("a.b", sut.name);
-            ntest::assert_cstr("c", sut.ext);
+            (void) try_fast_copy_file(sparse_path.c_str(), dst_path_2.c_str(), nullptr, &volumes);
+            ntest::assert_uint64(1, volumes.src_volumes.size());
         }
     }
     #endif
 
-    // one_of
-    #if 1
+    // profiler_format_chrome_trace
+    #if SWAN_PROFILER
     {
-        ntest::assert_bool(true, one_of(21, { 0, 21, 22 }));
-        ntest::assert_bool(false, one_of(21, { 0, 1, 2 }));
+        profiler_history history = {};
+        history.thread_names = { "main", "say \"hi\"" };
+        history.zone_names = { "update_cwd_entries", "sort_cwd_entries" };
+        history.events = {
+            { 5'000'000, 2'500, 1, 1, 0 },
+            { 4'000'000, 1'002'000, 0, 0, 0 },
+            { 4'500'000, 100, 7, 0, 1 },
+        };
+
+        std::string trace = profiler_format_chrome_trace(history);
+
+        ntest::assert_bool(true, trace.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"));
+        ntest::assert_bool(true, trace.ends_with("\n]}\n"));
+        ntest::assert_bool(true, trace.find("\"args\":{\"name\":\"say \\\"hi\\\"\"}}") != std::string::npos);
+        ntest::assert_bool(true, trace.find("{\"ph\":\"X\",\"pid\":1,\"name\":\"sort_cwd_entries\",\"tid\":0,\"ts\":1000.000,\"dur\":2.500}") != std::string::npos);
+        ntest::assert_bool(true, trace.find("\"name\":\"update_cwd_entries\",\"tid\":0,\"ts\":0.000,\"dur\":1002.000}") != std::string::npos);
+        ntest::assert_bool(true, trace.find("\"name\":\"?\",\"tid\":1,\"ts\":500.000,\"dur\":0.100}") != std::string::npos);
     }
     #endif
 
-    // rename (C stdlib) - confirmed that it doesn't work with Unicode
-    #if 0
+    // core engines, see tests_core_engines.cpp
+    #if 1
     {
-        auto path1 = output_path / "Юникод 1";
-        auto path2 = output_path / "Юникод 2";
-        auto path1_str = path1.string();
-        auto path2_str = path2.string();
-
-        ntest::assert_bool(true, std::filesystem::create_directory(path1));
-
-        if (ntest::assert_int32(0, rename(path1_str.c_str(), path2_str.c_str()))) {
-            if (ntest::assert_bool(true, std::filesystem::exists(path2_str.c_str()))) {
-                ntest::assert_int32(0, rename(path2_str.c_str(), path2_str.c_str()));
-                ntest::assert_bool(true, std::filesystem::exists(path1));
-            }
-        }
+        run_core_engine_tests((output_path / "core_scratch").string().c_str());
     }
     #endif
 
-    // bulk_rename_transform::execute, bulk_rename_transform::revert
+    // platform layer, see tests_platform.cpp
     #if 1
     {
-        bulk_rename_transform transform(basic_dirent::kind::directory, "Юникод-before", "Юникод-after");
-        transform.stat.store(bulk_rename_transform::status::ready);
-
-        std::wstring working_dir = output_path.wstring();
-        std::replace(working_dir.begin(), working_dir.end(), L'/', L'\\');
-        if (!working_dir.ends_with(L'\\')) working_dir += L'\\';
-
-        std::wstring before, after;
-
-        if (ntest::assert_stdstr( "", transform.execute(working_dir.c_str(), before, after) )) {            // execute [before]->[after]
-            if (ntest::assert_bool( true, std::filesystem::exists(after.c_str()) )) {                       // check [after] exists
-                transform.stat.store(bulk_rename_transform::status::execute_success);
-                if (ntest::assert_stdstr( "", transform.revert(working_dir.c_str(), before, after) )) {     // revert [before]<-[after]
-                    ntest::assert_bool( true, std::filesystem::exists(before.c_str()) );                    // check [before] exists
-                }
-            }
-        }
+        run_platform_tests((output_path / "platform_scratch").string().c_str());
     }
     #endif
 
@@ -0,0 +1,30 @@
+/*
+    Console entry point for the tests of the core (core.hpp) and the platform layer, for GCC/Clang builds where the Win32 GUI
+    (and tests.cpp) doesn't build.
+    Usage: swan_core_tests [output_directory]
+*/
+
+#include <cstdio>
+#include <filesystem>
+
+#include "ntest.hpp"
+#include "core.hpp"
+
+int main(int argc, char const *argv[])
+{
+    std::filesystem::path output_path = argc > 1 ? argv[1] : "ntest";
+
+    std::error_code ec;
+    std::filesystem::create_directories(output_path, ec);
+
+    ntest::init(output_path);
+
+    run_platform_tests((output_path / "platform_scratch").string().c_str());
+    run_core_engine_tests((output_path / "core_scratch").string().c_str());
+
+    auto const result = ntest::generate_report("swan_core_tests", output_path);
+
+    std::printf("swan_core_tests: %zu passed, %zu failed\n", result.num_passes, result.num_fails);
+
+    return result.num_fails == 0 ? 0 : 1;
+}
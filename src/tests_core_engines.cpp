@@ -0,0 +1,1135 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ntest.hpp"
+#include "core.hpp"
+
+static
+std::string core_test_path(std::filesystem::path const &directory, char const *relative_path) noexcept
+{
+    std::string path = (directory / relative_path).string();
+    std::replace(path.begin(), path.end(), '/', PLATFORM_DIR_SEPARATOR);
+    return path;
+}
+
+static
+void core_test_write_file(std::string const &path, char const *content) noexcept
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+void run_core_engine_tests(char const *scratch_directory_utf8) noexcept
+try {
+    std::filesystem::path scratch = scratch_directory_utf8;
+    std::error_code ec;
+    std::filesystem::remove_all(scratch, ec);
+    std::filesystem::create_directories(scratch, ec);
+
+    // flip_bool
+    #if 1
+    {
+        bool b = true;
+
+        flip_bool(b);
+        ntest::assert_bool(false, b);
+
+        flip_bool(b);
+        ntest::assert_bool(true, b);
+
+        flip_bool(b);
+        ntest::assert_bool(false, b);
+    }
+    #endif
+
+    // path_clear;
+    #if 1
+    {
+        swan_path p = path_create("Text.");
+        ntest::assert_cstr("Text.", p.data());
+        path_clear(p);
+        ntest::assert_cstr("", p.data());
+    }
+    #endif
+
+    // path_length;
+    #if 1
+    {
+        {
+            swan_path p = {};
+            ntest::assert_uint64(0, path_length(p));
+        }
+        {
+            swan_path p = path_create("Text.");
+            ntest::assert_cstr("Text.", p.data());
+            ntest::assert_uint64(5, path_length(p));
+        }
+    }
+    #endif
+
+    // path_ends_with;
+    #if 1
+    {
+        {
+            swan_path p = {};
+            ntest::assert_bool(false, path_ends_with(p, ""));
+            ntest::assert_bool(false, path_ends_with(p, "text"));
+        }
+        {
+            swan_path p = path_create("Text.");
+            ntest::assert_bool(false, path_ends_with(p, "text."));
+            ntest::assert_bool(true, path_ends_with(p, "."));
+            ntest::assert_bool(true, path_ends_with(p, "xt."));
+            ntest::assert_bool(true, path_ends_with(p, "Text."));
+            ntest::assert_bool(false, path_ends_with(p, "Text.Text."));
+        }
+    }
+    #endif
+
+    // path_ends_with_one_of;
+    #if 1
+    {
+        {
+            swan_path p = {};
+            ntest::assert_bool(false, path_ends_with_one_of(p, "abc"));
+        }
+        {
+            swan_path p = path_create("Text");
+            ntest::assert_bool(false, path_ends_with_one_of(p, "abc"));
+            ntest::assert_bool(false, path_ends_with_one_of(p, "T"));
+            ntest::assert_bool(true, path_ends_with_one_of(p, "t"));
+            ntest::assert_bool(true, path_ends_with_one_of(p, "tt"));
+            ntest::assert_bool(true, path_ends_with_one_of(p, "abct"));
+            ntest::assert_bool(true, path_ends_with_one_of(p, "tabc"));
+        }
+    }
+    #endif
+
+    // path_append;
+    #if 1
+    {
+        {
+            swan_path p = {};
+
+            ntest::assert_uint64(1, path_append(p, "C:"));
+            ntest::assert_cstr("C:", p.data());
+
+            ntest::assert_uint64(1, path_append(p, "code\\", '\\', true));
+            ntest::assert_cstr("C:\\code\\", p.data());
+
+            ntest::assert_uint64(1, path_append(p, "swan", '\\', true));
+            ntest::assert_cstr("C:\\code\\swan", p.data());
+
+            ntest::assert_uint64(1, path_append(p, ".md"));
+            ntest::assert_cstr("C:\\code\\swan.md", p.data());
+        }
+        {
+            swan_path p = {};
+
+            // std::string temp(swan_path_t::static_capacity, 'x');
+            std::string temp(p.max_size() - 1, 'x');
+
+            ntest::assert_uint64(1, path_append(p, temp.c_str()));
+            ntest::assert_cstr(temp.c_str(), p.data());
+
+            p = {};
+
+            ntest::assert_uint64(0, path_append(p, temp.c_str(), '\\', true));
+            ntest::assert_cstr("", p.data());
+
+            p = {};
+
+            temp.pop_back();
+            ntest::assert_uint64(1, path_append(p, temp.c_str()));
+            ntest::assert_cstr(temp.c_str(), p.data());
+            // p is now one away from max capacity
+
+            ntest::assert_uint64(1, path_append(p, "x"));
+            temp.push_back('x');
+            ntest::assert_cstr(temp.c_str(), p.data());
+            // p is now at max capacity, next append should fail
+
+            ntest::assert_uint64(0, path_append(p, "x"));
+            ntest::assert_cstr(temp.c_str(), p.data()); // ensure state has not changed on failure
+        }
+    }
+    #endif
+
+    // path_is_empty;
+    #if 1
+    {
+        {
+            swan_path p = {};
+            ntest::assert_bool(true, path_is_empty(p));
+        }
+        {
+            swan_path p = path_create("text");
+            ntest::assert_bool(false, path_is_empty(p));
+        }
+    }
+    #endif
+
+    // two_u32_to_one_u64
+    #if 1
+    {
+        u32 hi = 0xFF'F0'0F'FF;
+        u32 lo = 0xFF'F1'1F'FF;
+        u64 combined = two_u32_to_one_u64(lo, hi);
+        ntest::assert_uint64(0xff'f0'0f'ff'ff'f1'1f'ff, combined);
+    }
+    #endif
+
+    // path_loosely_same;
+    #if 1
+    {
+        {
+            swan_path p1 = path_create("1/2/3");
+            swan_path p2 = path_create("1/2/3");
+            ntest::assert_bool(true, path_loosely_same(p1, p2));
+            ntest::assert_bool(true, path_loosely_same(p2, p1));
+        }
+        {
+            swan_path p1 = path_create("1/2/3");
+            swan_path p2 = path_create("1/2/3/");
+            ntest::assert_bool(true, path_loosely_same(p1, p2));
+            ntest::assert_bool(true, path_loosely_same(p2, p1));
+        }
+        {
+            swan_path p1 = path_create("C:\\code\\");
+            swan_path p2 = path_create("C:\\code");
+            ntest::assert_bool(true, path_loosely_same(p1, p2));
+            ntest::assert_bool(true, path_loosely_same(p2, p1));
+        }
+        {
+            swan_path p1 = path_create("C:/code/");
+            swan_path p2 = path_create("C:/code/");
+            ntest::assert_bool(true, path_loosely_same(p1, p2));
+            ntest::assert_bool(true, path_loosely_same(p2, p1));
+        }
+        {
+            swan_path p1 = path_create("C:/code///");
+            swan_path p2 = path_create("C:/code/");
+            ntest::assert_bool(true, path_loosely_same(p1, p2));
+            ntest::assert_bool(true, path_loosely_same(p2, p1));
+        }
+        {
+            swan_path p1 = path_create("C:/code///");
+            swan_path p2 = path_create("C:/code//");
+            ntest::assert_bool(true, path_loosely_same(p1, p2));
+            ntest::assert_bool(true, path_loosely_same(p2, p1));
+        }
+        {
+            swan_path p1 = path_create("C:/code///");
+            swan_path p2 = path_create("C:/Code//");
+            ntest::assert_bool(true, path_loosely_same(p1, p2));
+            ntest::assert_bool(true, path_loosely_same(p2, p1));
+        }
+
+        {
+            swan_path p1 = path_create("C:/code///");
+            swan_path p2 = path_create("C:/cod");
+            ntest::assert_bool(false, path_loosely_same(p1, p2));
+            ntest::assert_bool(false, path_loosely_same(p2, p1));
+        }
+        {
+            swan_path p1 = path_create("C:\\code");
+            swan_path p2 = path_create("C:\\");
+            ntest::assert_bool(false, path_loosely_same(p1, p2));
+            ntest::assert_bool(false, path_loosely_same(p2, p1));
+        }
+    }
+    #endif
+
+    // path_loose_hash, path_loosely_inside;
+    #if 1
+    {
+        ntest::assert_bool(true, path_loose_hash("C:\\code\\swan") == path_loose_hash("c:/Code/SWAN/"));
+        ntest::assert_bool(true, path_loose_hash("C:\\code\\swan") == path_loose_hash("C:\\code\\swan\\\\"));
+        ntest::assert_bool(false, path_loose_hash("C:\\code\\swan") == path_loose_hash("C:\\code\\swa"));
+        ntest::assert_bool(true, path_loose_hash("C:\\code\\swan.txt", 12) == path_loose_hash("C:/code/swan"));
+
+        ntest::assert_bool(true, path_loosely_inside("C:\\code\\swan\\src", "C:\\code"));
+        ntest::assert_bool(true, path_loosely_inside("C:\\code\\swan\\src", "c:/CODE/"));
+        ntest::assert_bool(false, path_loosely_inside("C:\\code\\swan", "C:\\code\\swan"));
+        ntest::assert_bool(false, path_loosely_inside("C:\\code\\swan", "C:\\code\\swan\\"));
+        ntest::assert_bool(false, path_loosely_inside("C:\\codex\\swan", "C:\\code"));
+        ntest::assert_bool(false, path_loosely_inside("C:\\code\\", "C:\\code"));
+
+        {
+            u64 hashes[8], lens[8];
+            char const *path = "C:\\Code//swan\\src\\";
+            u64 count = path_loose_hash_prefixes(path, hashes, lens, lengthof(hashes));
+
+            if (ntest::assert_uint64(4, count)) {
+                for (u64 i = 0; i < count; ++i) {
+                    ntest::assert_bool(true, hashes[i] == path_loose_hash(path, lens[i]));
+                }
+                ntest::assert_bool(true, hashes[0] == path_loose_hash("c:\\"));
+                ntest::assert_bool(true, hashes[1] == path_loose_hash("c:/code"));
+                ntest::assert_bool(true, hashes[3] == path_loose_hash("c:/code//swan/src/"));
+            }
+            ntest::assert_uint64(2, path_loose_hash_prefixes(path, hashes, lens, 2));
+        }
+    }
+    #endif
+
+    // path_squish_adjacent_separators;
+    #if 1
+    {
+        ntest::assert_cstr("1/2/3", path_squish_adjacent_separators(path_create("1/2/3")).data());
+        ntest::assert_cstr("1/2/3", path_squish_adjacent_separators(path_create("1//2//3")).data());
+        ntest::assert_cstr("1/2/3/", path_squish_adjacent_separators(path_create("1//2//3//")).data());
+
+        ntest::assert_cstr("1\\2\\3\\", path_squish_adjacent_separators(path_create("1\\2\\3\\")).data());
+        ntest::assert_cstr("1\\2\\3\\", path_squish_adjacent_separators(path_create("1\\\\\\2\\3\\\\\\")).data());
+    }
+    #endif
+
+    // temp_filename_extension_splitter;
+    #if 1
+    {
+        {
+            char name[] = "src/swan.cpp";
+            temp_filename_extension_splitter sut(name);
+            ntest::assert_cstr("swan", sut.name);
+            ntest::assert_cstr("cpp", sut.ext);
+        }
+        {
+            char name[] = "C:/code/swan/src/explorer_window.cpp";
+            temp_filename_extension_splitter sut(name);
+            ntest::assert_cstr("explorer_window", sut.name);
+            ntest::assert_cstr("cpp", sut.ext);
+        }
+        {
+            char name[] = "a.b.c";
+            temp_filename_extension_splitter sut(name);
+            ntest::assert_cstr("a.b", sut.name);
+            ntest::assert_cstr("c", sut.ext);
+        }
+    }
+    #endif
+
+    // one_of
+    #if 1
+    {
+        ntest::assert_bool(true, one_of(21, { 0, 21, 22 }));
+        ntest::assert_bool(false, one_of(21, { 0, 1, 2 }));
+    }
+    #endif
+
+    // parallel_worker_count, run_parallel_workers
+    #if 1
+    {
+        ntest::assert_uint64(1, parallel_worker_count(0));
+        ntest::assert_uint64(1, parallel_worker_count(1));
+        ntest::assert_bool(true, parallel_worker_count() >= 1 && parallel_worker_count() <= 8);
+
+        std::vector<std::atomic<u64>> num_calls(5);
+        u64 num_ran = run_parallel_workers(num_calls.size(), [&num_calls](u64 worker_idx) noexcept { ++num_calls[worker_idx]; });
+
+        ntest::assert_uint64(5, num_ran);
+        for (auto const &n : num_calls) {
+            ntest::assert_uint64(1, n.load());
+        }
+    }
+    #endif
+
+    // bulk_rename_build_plan
+    #if 1
+    {
+        using step_kind = bulk_rename_plan::step_kind;
+
+        std::vector<bulk_rename_transform> transforms = {};
+        transforms.emplace_back(basic_dirent::kind::file, "img_2", "img_3");
+        transforms.emplace_back(basic_dirent::kind::file, "img_1", "img_2");
+        transforms.emplace_back(basic_dirent::kind::file, "a", "B");
+        transforms.emplace_back(basic_dirent::kind::file, "b", "A");
+        for (auto &transform : transforms) transform.stat.store(bulk_rename_transform::status::ready);
+
+        bulk_rename_plan plan = bulk_rename_build_plan(transforms, false, false);
+
+        ntest::assert_uint64(2, plan.jobs.size());
+        ntest::assert_uint64(1, plan.num_cycles);
+        ntest::assert_uint64(5, plan.num_steps);
+
+        if (plan.jobs.size() == 2 && plan.jobs[0].size() == 2 && plan.jobs[1].size() == 3) {
+            // renumbering: [img_2] moves out of the way before [img_1] takes its name
+            ntest::assert_uint64(0, plan.jobs[0][0].transform_idx);
+            ntest::assert_uint64(1, plan.jobs[0][1].transform_idx);
+
+            // swap (names compare case-insensitively): one side parks under a temporary name
+            ntest::assert_bool(true, plan.jobs[1][0].kind == step_kind::to_temp);
+            ntest::assert_bool(true, plan.jobs[1][1].kind == step_kind::direct);
+            ntest::assert_bool(true, plan.jobs[1][2].kind == step_kind::from_temp);
+            ntest::assert_uint64(plan.jobs[1][0].transform_idx, plan.jobs[1][2].transform_idx);
+        }
+
+        // revert plans the opposite direction, nothing has executed yet so nothing is included
+        ntest::assert_uint64(0, bulk_rename_build_plan(transforms, true, false).jobs.size());
+    }
+    #endif
+
+    // bulk_rename_compile_pattern, bulk_rename_apply_pattern
+    #if 1
+    {
+        ntest::assert_bool(false, bulk_rename_compile_pattern("", false).success);
+        ntest::assert_bool(false, bulk_rename_compile_pattern("<name", false).success);
+        ntest::assert_bool(false, bulk_rename_compile_pattern("name>", false).success);
+        ntest::assert_bool(false, bulk_rename_compile_pattern("<unknown>", false).success);
+        ntest::assert_bool(false, bulk_rename_compile_pattern("<4,2>", false).success);
+        ntest::assert_bool(false, bulk_rename_compile_pattern("a:b", false).success);
+
+        auto compiled = bulk_rename_compile_pattern("img_<counter:3><dotext>", false);
+        ntest::assert_bool(true, compiled.success);
+        ntest::assert_uint64(3, compiled.pattern.program.size()); // literal, counter, dotext
+
+        std::vector<bulk_rename_transform> transforms = {};
+        transforms.emplace_back(basic_dirent::kind::file, "photo.JPG", "");
+        transforms.emplace_back(basic_dirent::kind::file, "README", "");
+        transforms.emplace_back(basic_dirent::kind::directory, "dir.d", "");
+
+        bulk_rename_preview preview = {};
+        bulk_rename_apply_pattern(compiled.pattern, transforms, 9, 1, preview);
+
+        ntest::assert_cstr("img_009.JPG", preview.name(0));
+        ntest::assert_cstr("img_010", preview.name(1));
+        ntest::assert_cstr("img_011", preview.name(2)); // directories have no extension
+        ntest::assert_uint64(0, preview.num_problems);
+        ntest::assert_uint64(0, preview.num_collisions);
+
+        bulk_rename_apply_pattern(bulk_rename_compile_pattern("<1,3>", false).pattern, transforms, 0, 1, preview);
+
+        ntest::assert_cstr("hot", preview.name(0));
+        ntest::assert_cstr("EAD", preview.name(1));
+        ntest::assert_bool(true, preview.problems[2] == bulk_rename_preview::problem::ends_with_dot); // "ir."
+
+        bulk_rename_apply_pattern(bulk_rename_compile_pattern("Same", false).pattern, transforms, 0, 1, preview);
+
+        ntest::assert_uint64(2, preview.num_collisions);
+        ntest::assert_uint64(1, preview.first_collision_idx);
+
+        // rows left unchanged because of a trailing dot never collide
+        bulk_rename_apply_pattern(bulk_rename_compile_pattern("same.", false).pattern, transforms, 0, 1, preview);
+
+        ntest::assert_uint64(3, preview.num_problems);
+        ntest::assert_uint64(0, preview.num_collisions);
+
+        bulk_rename_apply_pattern(bulk_rename_compile_pattern("a  <counter>", true).pattern, transforms, 0, 1, preview);
+        ntest::assert_cstr("a 0", preview.name(0));
+
+        bulk_rename_apply_pattern(bulk_rename_compile_pattern("a  <counter>", false).pattern, transforms, 0, 1, preview);
+        ntest::assert_cstr("a  0", preview.name(0));
+    }
+    #endif
+
+    // bulk_rename_collision_index
+    #if 1
+    {
+        std::vector<std::string> untouched = { bulk_rename_collision_index::key("Existing.txt") };
+
+        std::vector<bulk_rename_transform> transforms = {};
+        transforms.emplace_back(basic_dirent::kind::file, "a.txt", "a.txt");
+        transforms.emplace_back(basic_dirent::kind::file, "b.txt", "b.txt");
+
+        bulk_rename_collision_index index = {};
+        index.rebuild(untouched, transforms);
+        ntest::assert_uint64(0, index.num_conflicting);
+
+        transforms[0].after = path_create("EXISTING.TXT"); // case-insensitive
+        index.update(transforms[0]);
+        ntest::assert_uint64(2, index.num_conflicting);
+        ntest::assert_bool(true, index.conflicts(transforms[0]));
+        ntest::assert_bool(false, index.conflicts(transforms[1]));
+
+        transforms[1].after = path_create("existing.txt");
+        index.update(transforms[1]);
+        ntest::assert_uint64(3, index.num_conflicting);
+
+        transforms[0].after = path_create("b.txt"); // swapping into a name being vacated is fine
+        index.update(transforms[0]);
+        ntest::assert_uint64(2, index.num_conflicting);
+        ntest::assert_bool(false, index.conflicts(transforms[0]));
+
+        transforms[1].after = path_create("a.txt");
+        index.update(transforms[1]);
+        ntest::assert_uint64(0, index.num_conflicting);
+
+        // empty names are reported as empty, not as conflicting with one another
+        transforms[0].after = path_create("");
+        transforms[1].after = path_create("");
+        index.update(transforms[0]);
+        index.update(transforms[1]);
+        ntest::assert_uint64(0, index.num_conflicting);
+        ntest::assert_bool(false, index.conflicts(transforms[0]));
+
+        // non-ASCII names fold by the same rule the plan compares under, which only Windows folds beyond ASCII
+        transforms[0].after = path_create("\xC3\x84.txt"); // U+00C4 A with diaeresis
+        transforms[1].after = path_create("\xC3\xA4.TXT"); // U+00E4 a with diaeresis
+        index.update(transforms[0]);
+        index.update(transforms[1]);
+    #if defined(_WIN32)
+        ntest::assert_uint64(2, index.num_conflicting);
+        ntest::assert_bool(true, index.conflicts(transforms[1]));
+    #else
+        ntest::assert_uint64(0, index.num_conflicting);
+    #endif
+    }
+    #endif
+
+    // bulk_rename_parse_text_import
+    #if 1
+    {
+        std::vector<swan_path> after = {};
+        std::vector<std::string> errors = {};
+
+        {
+            auto [success, num_chars, num_lines] = bulk_rename_parse_text_import("[0] zero.txt\r\n\r\n[2] two\n", after, 3, errors);
+            ntest::assert_bool(true, success);
+            ntest::assert_uint64(22, num_chars);
+            ntest::assert_uint64(4, num_lines);
+            ntest::assert_uint64(4, after.size());
+            ntest::assert_cstr("zero.txt", after[0].data());
+            ntest::assert_cstr("", after[1].data());
+            ntest::assert_cstr("two", after[2].data());
+        }
+        {
+            auto [success, num_chars, num_lines] = bulk_rename_parse_text_import("[0] ok\n[x] bad\n[1] a:b\n[2] dot.\n[9] big\n[3]\n", after, 6, errors);
+            ntest::assert_bool(false, success);
+            if (ntest::assert_uint64(5, errors.size())) {
+                ntest::assert_bool(true, errors[0].starts_with("Line 2,"));
+                ntest::assert_bool(true, errors[1].starts_with("Line 3,"));
+                ntest::assert_bool(true, errors[2].starts_with("Line 4,"));
+                ntest::assert_bool(true, errors[3].starts_with("Line 5,"));
+                ntest::assert_bool(true, errors[4].starts_with("Line 6,"));
+            }
+            ntest::assert_cstr("ok", after[0].data());
+        }
+        {
+            auto [success, num_chars, num_lines] = bulk_rename_parse_text_import("[0] a\n[1] b\n[2] c", after, 1, errors);
+            ntest::assert_bool(false, success);
+            ntest::assert_uint64(3, num_lines);
+        }
+        {
+            auto [success, num_chars, num_lines] = bulk_rename_parse_text_import("[0] a\rb\n[1] c\r\n", after, 2, errors); // the trailing newline makes a third, blank line
+            ntest::assert_bool(false, success);
+            if (ntest::assert_uint64(1, errors.size())) {
+                ntest::assert_bool(true, errors[0].starts_with("Line 1, name contains illegal control character [13]"));
+            }
+            ntest::assert_cstr("", after[0].data());
+            ntest::assert_cstr("c", after[1].data());
+        }
+        {
+            std::string text = "[0] " + std::string(swan_path().max_size() - 1, 'a') + "\r\n";
+            auto [success, num_chars, num_lines] = bulk_rename_parse_text_import(text.c_str(), after, 1, errors);
+            ntest::assert_bool(true, success);
+            ntest::assert_uint64(swan_path().max_size() - 1, strlen(after[0].data()));
+
+            text = "[0] " + std::string(swan_path().max_size(), 'a') + "\r\n";
+            std::tie(success, num_chars, num_lines) = bulk_rename_parse_text_import(text.c_str(), after, 1, errors);
+            ntest::assert_bool(false, success);
+            if (ntest::assert_uint64(1, errors.size())) {
+                ntest::assert_bool(true, errors[0].starts_with("Line 1, name is too long"));
+            }
+        }
+
+        // same names as the std::regex parser it replaced, on a large rename list as an external script would produce
+        {
+            u64 const num_entries = 20'000;
+            std::string text = {};
+            for (u64 i = 0; i < num_entries; ++i) {
+                text += make_str("[%zu] renamed_file_%06zu.txt\r\n", i, i);
+            }
+
+            std::vector<swan_path> after_regex = {};
+            std::vector<std::string> errors_regex = {};
+
+            (void) bulk_rename_parse_text_import_regex(text.c_str(), after_regex, num_entries, errors_regex);
+            (void) bulk_rename_parse_text_import(text.c_str(), after, num_entries, errors);
+
+            ntest::assert_bool(true, errors.empty());
+            ntest::assert_bool(true, errors_regex.empty());
+
+            u64 num_mismatched = 0;
+            for (u64 i = 0; i < num_entries; ++i) {
+                num_mismatched += u64(!path_equals_exactly(after[i], after_regex[i]));
+            }
+            ntest::assert_uint64(0, num_mismatched);
+        }
+    }
+    #endif
+
+    // bulk_rename_journal_replay
+    #if 1
+    {
+        // session 1: swap [a] and [b] through a temporary name, then rename [c] -> [d], crashed before closing
+        // session 2: rename [x] -> [y], closed normally
+        std::string journal =
+            "swan_bulk_rename_journal 1\n"
+            "W 4 C:\\d\n"
+            "B 2\n"
+            "I 0 1 a 1 b 5 0.tmp\n"
+            "I 1 1 b 1 a 5 1.tmp\n"
+            "J 3 0t 1d 0f\n"
+            "P 0\n"
+            "D 1\n"
+            "D 0\n"
+            "E\n"
+            "B 1\n"
+            "I 0 1 c 1 d 5 0.tmp\n"
+            "J 1 0d\n"
+            "D 0\n"
+            "E\n"
+            "W 4 C:\\e\n"
+            "B 1\n"
+            "I 0 1 x 1 y 5 0.tmp\n"
+            "J 1 0d\n"
+            "D 0\n"
+            "E\n"
+            "C\n"
+            "W 4 C:\\f\n"
+            "B 1\n"
+            "I 0 1 p 1"; // cut short by the crash
+
+        std::vector<bulk_rename_recovery> recoveries = bulk_rename_journal_replay(journal, false);
+
+        if (ntest::assert_uint64(1, recoveries.size())) {
+            auto const &transforms = recoveries[0].transforms;
+            ntest::assert_cstr("C:\\d", recoveries[0].working_directory.data());
+
+            if (ntest::assert_uint64(3, transforms.size())) {
+                ntest::assert_cstr("a", transforms[0].before.data());
+                ntest::assert_cstr("b", transforms[0].after.data());
+                ntest::assert_cstr("b", transforms[1].before.data());
+                ntest::assert_cstr("a", transforms[1].after.data());
+                ntest::assert_cstr("c", transforms[2].before.data());
+                ntest::assert_cstr("d", transforms[2].after.data());
+                ntest::assert_bool(true, transforms[0].stat.load() == bulk_rename_transform::status::execute_success);
+            }
+        }
+
+        // a cycle parked but never completed stays under its temporary name, a reverted transaction cancels out
+        journal =
+            "swan_bulk_rename_journal 1\n"
+            "W 4 C:\\d\n"
+            "B 2\n"
+            "I 0 1 a 1 b 5 0.tmp\n"
+            "I 1 1 b 1 a 5 1.tmp\n"
+            "J 3 0t 1d 0f\n"
+            "P 0\n"
+            "F 1\n"
+            "F 0\n"
+            "E\n"
+            "B 1\n"
+            "I 0 1 m 1 n 5 0.tmp\n"
+            "J 1 0d\n"
+            "D 0\n"
+            "E\n"
+            "B 1\n"
+            "I 0 1 n 1 m 5 0.tmp\n"
+            "J 1 0d\n"
+            "D 0\n"
+            "E\n";
+
+        recoveries = bulk_rename_journal_replay(journal, false);
+
+        if (ntest::assert_uint64(1, recoveries.size()) && ntest::assert_uint64(1, recoveries[0].transforms.size())) {
+            ntest::assert_cstr("a", recoveries[0].transforms[0].before.data());
+            ntest::assert_cstr("0.tmp", recoveries[0].transforms[0].after.data());
+        }
+
+        ntest::assert_uint64(0, bulk_rename_journal_replay("not a journal\nW 1 x\n", false).size());
+    }
+    #endif
+
+    // directory_jump_index
+    #if 1
+    {
+        directory_jump_index jump_index = {};
+        u32 now = 1'700'000'000;
+        std::vector<directory_jump_index::match> matches = {};
+
+        auto matched_path = [&](u64 i) noexcept { return std::string(jump_index.path(jump_index.entries[matches[i].entry_idx])); };
+
+        for (u64 i = 0; i < 5; ++i) jump_index.visit("C:\\code\\swan", now - 100);
+        jump_index.visit("C:\\code\\swan\\src", now - 100);
+        for (u64 i = 0; i < 3; ++i) jump_index.visit("C:\\Users\\me\\Documents", now - 60*60*24*30);
+        jump_index.visit("D:\\Swanky", now);
+
+        ntest::assert_uint64(4, jump_index.entries.size());
+
+        jump_index.query("swan", now, 0, 10, matches);
+        if (ntest::assert_uint64(3, matches.size())) {
+            ntest::assert_stdstr("C:\\code\\swan", matched_path(0));
+            ntest::assert_stdstr("D:\\Swanky", matched_path(1));
+            ntest::assert_stdstr("C:\\code\\swan\\src", matched_path(2));
+        }
+
+        jump_index.query("swan", now, path_loose_hash("c:/code/swan/"), 10, matches);
+        if (ntest::assert_uint64(2, matches.size())) {
+            ntest::assert_stdstr("D:\\Swanky", matched_path(0));
+        }
+
+        jump_index.query("code src", now, 0, 10, matches);
+        if (ntest::assert_uint64(1, matches.size())) {
+            ntest::assert_stdstr("C:\\code\\swan\\src", matched_path(0));
+        }
+
+        jump_index.query("dcs", now, 0, 10, matches);
+        if (ntest::assert_uint64(1, matches.size())) {
+            ntest::assert_stdstr("C:\\Users\\me\\Documents", matched_path(0));
+        }
+
+        jump_index.query("src code", now, 0, 10, matches);
+        ntest::assert_uint64(0, matches.size());
+
+        std::string serialized = jump_index.serialize();
+        directory_jump_index loaded = {};
+
+        if (ntest::assert_bool(true, loaded.deserialize(serialized))) {
+            ntest::assert_uint64(4, loaded.entries.size());
+            ntest::assert_bool(true, loaded.forget("c:/CODE/swan"));
+            ntest::assert_bool(false, loaded.forget("C:\\code\\swan"));
+            ntest::assert_uint64(3, loaded.entries.size());
+            ntest::assert_uint64(3, loaded.index.size());
+        }
+        ntest::assert_bool(false, loaded.deserialize(std::string_view(serialized).substr(0, serialized.size() - 1)));
+        ntest::assert_uint64(0, loaded.entries.size());
+
+        // aging keeps the total rank bounded and forgets rarely visited directories
+        for (u64 i = 0; i < 20'000; ++i) {
+            jump_index.visit(make_str("C:\\dir_%zu", i % 4000), now);
+        }
+        ntest::assert_bool(true, jump_index.total_rank <= directory_jump_index::MAX_TOTAL_RANK);
+        ntest::assert_uint64(jump_index.entries.size(), jump_index.index.size());
+    }
+    #endif
+
+    // directory_listing_cache
+    #if 1
+    {
+        directory_listing_cache cache = {};
+
+        auto make_listing = [](char const *directory, u64 num_entries) noexcept {
+            directory_listing_cache::listing listing = {};
+            listing.directory_key = path_loose_hash(directory);
+            listing.directory_write_time = 42;
+            for (u64 i = 0; i < num_entries; ++i) {
+                basic_dirent dirent = {};
+                dirent.size = i;
+                dirent.type = i % 2 ? basic_dirent::kind::file : basic_dirent::kind::directory;
+                dirent.path = path_create(make_str("entry_%zu", i).c_str());
+                listing.append(dirent);
+            }
+            return listing;
+        };
+
+        cache.store(make_listing("C:\\a", 3));
+        cache.store(make_listing("C:\\b", 2));
+
+        ntest::assert_bool(true, cache.find(path_loose_hash("c:/A/")) != nullptr);
+        ntest::assert_bool(true, cache.find(path_loose_hash("C:\\c")) == nullptr);
+        ntest::assert_uint64(1, cache.num_hits);
+        ntest::assert_uint64(1, cache.num_misses);
+        ntest::assert_uint64(5, cache.num_entries_total);
+
+        if (auto const *listing = cache.find(path_loose_hash("C:\\a")); ntest::assert_bool(true, listing != nullptr)) {
+            ntest::assert_uint64(3, listing->entries.size());
+            ntest::assert_stdstr("entry_2", std::string(listing->name(listing->entries[2])));
+            ntest::assert_uint64(2, listing->entries[2].size);
+            ntest::assert_bool(true, listing->entries[1].type == basic_dirent::kind::file);
+        }
+
+        // storing again replaces
+        cache.store(make_listing("C:\\A", 1));
+        ntest::assert_uint64(2, cache.listings.size());
+        ntest::assert_uint64(3, cache.num_entries_total);
+
+        // least recently used go first
+        (void) cache.find(path_loose_hash("C:\\b"));
+        for (u64 i = 0; i < directory_listing_cache::MAX_LISTINGS - 1; ++i) {
+            cache.store(make_listing(make_str("D:\\%zu", i).c_str(), 1));
+        }
+        ntest::assert_uint64(directory_listing_cache::MAX_LISTINGS, cache.listings.size());
+        ntest::assert_bool(true, cache.find(path_loose_hash("C:\\a")) == nullptr);
+        ntest::assert_bool(true, cache.find(path_loose_hash("C:\\b")) != nullptr);
+        ntest::assert_uint64(cache.listings.size(), cache.index.size());
+
+        ntest::assert_bool(true, cache.erase(path_loose_hash("C:\\b")));
+        ntest::assert_bool(false, cache.erase(path_loose_hash("C:\\b")));
+        ntest::assert_uint64(directory_listing_cache::MAX_LISTINGS - 1, cache.num_entries_total);
+
+        // prefetched listings count as used once, or as unused when they go away first
+        {
+            auto prefetched = make_listing("E:\\used", 1);
+            prefetched.prefetched_unused = true;
+            cache.store(std::move(prefetched));
+        }
+        {
+            auto prefetched = make_listing("E:\\unused", 1);
+            prefetched.prefetched_unused = true;
+            cache.store(std::move(prefetched));
+        }
+        (void) cache.find(path_loose_hash("E:\\used"));
+        (void) cache.find(path_loose_hash("E:\\used"));
+        ntest::assert_uint64(1, cache.num_prefetch_hits);
+        ntest::assert_bool(true, cache.contains(path_loose_hash("e:/unused")));
+        cache.store(make_listing("E:\\unused", 2));
+        ntest::assert_uint64(1, cache.num_prefetch_unused);
+        (void) cache.erase(path_loose_hash("E:\\used"));
+        ntest::assert_uint64(1, cache.num_prefetch_unused);
+
+        // a file written to in place leaves the directory's write time alone, revalidation compares entries
+        {
+            auto cached = make_listing("F:\\", 3);
+            auto fresh = make_listing("F:\\", 3);
+            fresh.entries[2].type = basic_dirent::kind::symlink_to_file;
+            ntest::assert_bool(true, cached.same_entries_as(fresh));
+
+            fresh.entries[1].last_write_time_raw += 1;
+            ntest::assert_bool(false, cached.same_entries_as(fresh));
+
+            ntest::assert_bool(false, cached.same_entries_as(make_listing("F:\\", 2)));
+
+            auto resized = make_listing("F:\\", 3);
+            resized.entries[0].size += 1;
+            ntest::assert_bool(false, cached.same_entries_as(resized));
+        }
+    }
+    #endif
+
+    // state_snapshot_pack, state_snapshot_unpack
+    #if 1
+    {
+        std::string large_data(100'000, 'x');
+
+        std::vector<state_snapshot_section> sections = {
+            { state_snapshot_section::kind_settings, 123, 456, "settings" },
+            { state_snapshot_section::kind_pinned, 0, 0, "" },
+            { state_snapshot_section::kind_recent_files, u64(-1), 1, large_data },
+        };
+
+        std::string snapshot = state_snapshot_pack(sections);
+        std::vector<state_snapshot_section> unpacked = {};
+
+        if (ntest::assert_bool(true, state_snapshot_unpack(snapshot, unpacked)) && ntest::assert_uint64(3, unpacked.size())) {
+            ntest::assert_uint64(state_snapshot_section::kind_settings, unpacked[0].id);
+            ntest::assert_uint64(123, unpacked[0].source_write_time);
+            ntest::assert_uint64(456, unpacked[0].source_size);
+            ntest::assert_stdstr("settings", std::string(unpacked[0].data));
+            ntest::assert_uint64(0, unpacked[1].data.size());
+            ntest::assert_uint64(u64(-1), unpacked[2].source_write_time);
+            ntest::assert_bool(true, unpacked[2].data == large_data);
+        }
+
+        ntest::assert_bool(true, state_snapshot_unpack(state_snapshot_pack({}), unpacked));
+        ntest::assert_uint64(0, unpacked.size());
+
+        // any flipped bit in the payload fails the checksum
+        std::string corrupt = snapshot;
+        corrupt[corrupt.size() / 2] ^= 0x10;
+        ntest::assert_bool(false, state_snapshot_unpack(corrupt, unpacked));
+        ntest::assert_uint64(0, unpacked.size());
+
+        ntest::assert_bool(false, state_snapshot_unpack(std::string_view(snapshot).substr(0, snapshot.size() - 1), unpacked));
+        ntest::assert_bool(false, state_snapshot_unpack(snapshot + '\0', unpacked));
+        ntest::assert_bool(false, state_snapshot_unpack(std::string_view(snapshot).substr(0, 10), unpacked));
+        ntest::assert_bool(false, state_snapshot_unpack("", unpacked));
+
+        std::string other_version = snapshot;
+        other_version[8] += 1;
+        ntest::assert_bool(false, state_snapshot_unpack(other_version, unpacked));
+    }
+    #endif
+
+    // xxh64, xxh64_update
+    #if 1
+    {
+        ntest::assert_uint64(0xef46db3751d8e999ull, xxh64("", 0));
+        ntest::assert_uint64(0xd24ec4f1a98c6e5bull, xxh64("a", 1));
+
+        char const *str = "Nobody inspects the spammish repetition";
+        u64 len = strlen(str);
+
+        ntest::assert_uint64(0xfbcea83c8a378bf1ull, xxh64(str, len));
+
+        // streaming in uneven chunks must agree with the one-shot hash
+        xxh64_state state;
+        xxh64_reset(state);
+        xxh64_update(state, str, 3);
+        xxh64_update(state, str + 3, 30);
+        xxh64_update(state, str + 33, len - 33);
+
+        ntest::assert_uint64(xxh64(str, len), xxh64_digest(state));
+    }
+    #endif
+
+    // sort_dirents
+    #if 1
+    {
+        auto make_dirent = [](u32 id, char const *name, basic_dirent::kind type, u64 size, platform_file_time last_write_time) noexcept {
+            listed_dirent dirent = {};
+            dirent.basic.id = id;
+            dirent.basic.path = path_create(name);
+            dirent.basic.type = type;
+            dirent.basic.size = size;
+            dirent.basic.last_write_time_raw = last_write_time;
+            return dirent;
+        };
+
+        std::vector<listed_dirent> dirents = {
+            make_dirent(0, "b.txt", basic_dirent::kind::file, 300, 20),
+            make_dirent(1, "A", basic_dirent::kind::directory, 0, 10),
+            make_dirent(2, "c.txt", basic_dirent::kind::file, 100, 30),
+            make_dirent(3, "a.txt", basic_dirent::kind::file, 100, 40),
+            make_dirent(4, "d.txt", basic_dirent::kind::file, 100, 40),
+        };
+        dirents[2].filtered = true;
+
+        auto sorted_names = [&](std::initializer_list<dirent_sort_spec> specs) {
+            auto first_filtered = sort_dirents(dirents, std::span<dirent_sort_spec const>(specs.begin(), specs.size()));
+            std::string names = {};
+            for (auto it = dirents.begin(); it != first_filtered; ++it) {
+                names += it->basic.path.data();
+                names += ' ';
+            }
+            return names;
+        };
+
+        using key = dirent_sort_spec::key;
+
+        // ascending puts names A to Z, but the largest sizes and times and directories first, as the explorer's columns do
+        ntest::assert_stdstr("A a.txt b.txt d.txt ", sorted_names({ { key::path, true } }));
+        ntest::assert_stdstr("d.txt b.txt a.txt A ", sorted_names({ { key::path, false } }));
+        ntest::assert_stdstr("A a.txt d.txt b.txt ", sorted_names({ { key::kind, true }, { key::size, false } }));
+        ntest::assert_stdstr("b.txt a.txt d.txt A ", sorted_names({ { key::size, true } })); // ties broken by id
+        ntest::assert_stdstr("A b.txt a.txt d.txt ", sorted_names({ { key::last_write_time, false } }));
+        ntest::assert_stdstr("d.txt a.txt b.txt A ", sorted_names({ { key::last_write_time, true }, { key::id, true } }));
+        ntest::assert_bool(true, dirents.back().filtered);
+    }
+    #endif
+
+    // filter_dirents
+    #if 1
+    {
+        std::vector<listed_dirent> dirents(4);
+        dirents[0].basic.path = path_create("Alpha.txt");
+        dirents[0].basic.type = basic_dirent::kind::file;
+        dirents[1].basic.path = path_create("beta.TXT");
+        dirents[1].basic.type = basic_dirent::kind::file;
+        dirents[2].basic.path = path_create("gamma.md");
+        dirents[2].basic.type = basic_dirent::kind::file;
+        dirents[3].basic.path = path_create("Docs");
+        dirents[3].basic.type = basic_dirent::kind::directory;
+
+        dirent_filter filter = {};
+        std::fill(std::begin(filter.kind_visible), std::end(filter.kind_visible), true);
+
+        auto visible_names = [&]() {
+            std::string names = {};
+            for (auto const &dirent : dirents) {
+                if (!dirent.filtered) {
+                    names += dirent.basic.path.data();
+                    names += ' ';
+                }
+            }
+            return names;
+        };
+
+        filter.text = "txt";
+        ntest::assert_stdstr("", filter_dirents(dirents, filter));
+        ntest::assert_stdstr("Alpha.txt beta.TXT ", visible_names());
+        ntest::assert_int64(6, dirents[0].highlight_start_idx);
+        ntest::assert_uint64(3, dirents[0].highlight_len);
+
+        filter.case_sensitive = true;
+        (void) filter_dirents(dirents, filter);
+        ntest::assert_stdstr("Alpha.txt ", visible_names());
+
+        filter.case_sensitive = false;
+        filter.polarity = false;
+        (void) filter_dirents(dirents, filter);
+        ntest::assert_stdstr("gamma.md Docs ", visible_names());
+        ntest::assert_uint64(0, dirents[2].highlight_len);
+
+        filter.polarity = true;
+        filter.how = dirent_filter::mode::regex_match;
+        filter.text = ".*\\.txt";
+        f64 regex_compile_us = -1;
+        ntest::assert_stdstr("", filter_dirents(dirents, filter, &regex_compile_us));
+        ntest::assert_stdstr("Alpha.txt beta.TXT ", visible_names());
+        ntest::assert_uint64(8, dirents[1].highlight_len);
+        ntest::assert_bool(true, regex_compile_us >= 0);
+
+        filter.case_sensitive = true;
+        (void) filter_dirents(dirents, filter);
+        ntest::assert_stdstr("Alpha.txt ", visible_names());
+
+        // a regex which doesn't compile filters by kind alone
+        filter.text = "([";
+        filter.kind_visible[(u64)basic_dirent::kind::directory] = false;
+        ntest::assert_bool(false, filter_dirents(dirents, filter).empty());
+        ntest::assert_stdstr("Alpha.txt beta.TXT gamma.md ", visible_names());
+
+        filter.text = "";
+        ntest::assert_stdstr("", filter_dirents(dirents, filter));
+        ntest::assert_stdstr("Alpha.txt beta.TXT gamma.md ", visible_names());
+    }
+    #endif
+
+    // directory_listing_enumerate
+    #if 1
+    {
+        std::string const listing_dir = core_test_path(scratch, "listing");
+        std::filesystem::create_directories(core_test_path(scratch, "listing/sub"), ec);
+        core_test_write_file(core_test_path(scratch, "listing/file_a"), "12345");
+        core_test_write_file(core_test_path(scratch, "listing/link.lnk"), "x");
+
+        auto kinds_by_name = [](directory_listing_cache::listing const &listing) {
+            std::map<std::string, basic_dirent::kind> kinds = {};
+            for (auto const &entry : listing.entries) {
+                kinds[std::string(listing.name(entry))] = entry.type;
+            }
+            return kinds;
+        };
+
+        directory_listing_cache::listing listing = {};
+
+        if (ntest::assert_bool(true, directory_listing_enumerate(listing_dir.c_str(), 100, listing) == directory_listing_enumerate_result::success)) {
+            auto kinds = kinds_by_name(listing);
+            ntest::assert_uint64(4, kinds.size());
+            ntest::assert_bool(true, kinds[".."] == basic_dirent::kind::directory);
+            ntest::assert_bool(true, kinds["sub"] == basic_dirent::kind::directory);
+            ntest::assert_bool(true, kinds["file_a"] == basic_dirent::kind::file);
+            ntest::assert_bool(true, kinds["link.lnk"] == basic_dirent::kind::file); // no lookup
+            ntest::assert_bool(true, listing.directory_write_time != 0);
+            ntest::assert_uint64(path_loose_hash(listing_dir.c_str()), listing.directory_key);
+
+            for (auto const &entry : listing.entries) {
+                if (listing.name(entry) == "file_a") {
+                    ntest::assert_uint64(5, entry.size);
+                }
+            }
+        }
+
+        shortcut_kind_lookup_t known = [](char const *lnk_path_utf8, platform_file_time, basic_dirent::kind &out) noexcept {
+            out = basic_dirent::kind::symlink_to_directory;
+            return cstr_ends_with(lnk_path_utf8, "link.lnk");
+        };
+        shortcut_kind_lookup_t unknown = [](char const *, platform_file_time, basic_dirent::kind &) noexcept {
+            return false;
+        };
+
+        (void) directory_listing_enumerate(listing_dir.c_str(), 100, listing, known);
+        ntest::assert_bool(true, kinds_by_name(listing)["link.lnk"] == basic_dirent::kind::symlink_to_directory);
+
+        (void) directory_listing_enumerate(listing_dir.c_str(), 100, listing, unknown);
+        ntest::assert_bool(true, kinds_by_name(listing)["link.lnk"] == basic_dirent::kind::symlink_ambiguous);
+
+        ntest::assert_bool(true, directory_listing_enumerate(listing_dir.c_str(), 2, listing) == directory_listing_enumerate_result::too_many_entries);
+        ntest::assert_bool(true, directory_listing_enumerate(core_test_path(scratch, "missing").c_str(), 100, listing) == directory_listing_enumerate_result::failed);
+
+    #if !defined(_WIN32)
+        // a root has no ".."
+        (void) directory_listing_enumerate("/", u64(-1), listing);
+        ntest::assert_bool(false, kinds_by_name(listing).contains(".."));
+    #endif
+    }
+    #endif
+
+    // traverse_directory_recursively
+    #if 1
+    {
+        std::filesystem::create_directories(core_test_path(scratch, "finder/sub/alpha_dir"), ec);
+        core_test_write_file(core_test_path(scratch, "finder/alpha.txt"), "");
+        core_test_write_file(core_test_path(scratch, "finder/other.md"), "");
+        core_test_write_file(core_test_path(scratch, "finder/sub/beta_alpha.txt"), "");
+        core_test_write_file(core_test_path(scratch, "finder/sub/alpha.lnk"), "");
+
+        swan_path const finder_dir = path_create(core_test_path(scratch, "finder").c_str());
+        std::atomic<u64> num_entries_checked = 0;
+        progressive_task<std::vector<finder_match>> task = {};
+
+        static std::atomic<u64> s_num_progress_calls = 0;
+        finder_traversal_hooks hooks = {
+            .progress = []() noexcept { ++s_num_progress_calls; },
+            .resolve_shortcut = [](char const *, platform_file_time) noexcept { return basic_dirent::kind::symlink_to_file; },
+        };
+
+        auto kinds_by_name = [&]() {
+            std::map<std::string, basic_dirent::kind> kinds = {};
+            for (auto const &match : task.result) {
+                kinds[path_cfind_filename(match.basic.path.data())] = match.basic.type;
+            }
+            return kinds;
+        };
+
+        traverse_directory_recursively(finder_dir, num_entries_checked, task, "alpha", strlen("alpha"), true, hooks);
+
+        ntest::assert_uint64(6, num_entries_checked.load());
+        if (ntest::assert_uint64(4, task.result.size())) {
+            auto kinds = kinds_by_name();
+            ntest::assert_bool(true, kinds["alpha.txt"] == basic_dirent::kind::file);
+            ntest::assert_bool(true, kinds["beta_alpha.txt"] == basic_dirent::kind::file);
+            ntest::assert_bool(true, kinds["alpha_dir"] == basic_dirent::kind::directory);
+            ntest::assert_bool(true, kinds["alpha.lnk"] == basic_dirent::kind::symlink_to_file);
+
+            for (auto const &match : task.result) {
+                char const *name = path_cfind_filename(match.basic.path.data());
+                ntest::assert_bool(true, path_loosely_inside(match.basic.path.data(), finder_dir.data()));
+                ntest::assert_int64(cstr_eq(name, "beta_alpha.txt") ? 5 : 0, match.highlight_start_idx);
+                ntest::assert_uint64(5, match.highlight_len);
+            }
+        }
+        ntest::assert_bool(true, s_num_progress_calls.load() >= 4);
+
+        // shortcuts are left unresolved unless asked for, and the search is case-sensitive
+        task.result.clear();
+        traverse_directory_recursively(finder_dir, num_entries_checked, task, "alpha.", strlen("alpha."), false, hooks);
+        if (ntest::assert_uint64(3, task.result.size())) {
+            ntest::assert_bool(true, kinds_by_name()["alpha.lnk"] == basic_dirent::kind::symlink_ambiguous);
+        }
+
+        task.result.clear();
+        traverse_directory_recursively(finder_dir, num_entries_checked, task, "ALPHA", strlen("ALPHA"), false);
+        ntest::assert_uint64(0, task.result.size());
+
+        task.result.clear();
+        task.cancellation_token.store(true);
+        traverse_directory_recursively(finder_dir, num_entries_checked, task, "alpha", strlen("alpha"), false);
+        ntest::assert_uint64(0, task.result.size());
+    }
+    #endif
+
+    // write_file_atomically
+    #if 1
+    {
+        std::filesystem::path const path = core_test_path(scratch, "atomic.bin");
+        auto read_back = [&]() {
+            std::ifstream file(path, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        };
+
+        ntest::assert_bool(true, write_file_atomically(path, std::string_view("first\0x", 7)));
+        ntest::assert_stdstr(std::string("first\0x", 7), read_back());
+
+        // replaces the existing file, and leaves no temporary behind
+        ntest::assert_bool(true, write_file_atomically(path, "second"));
+        ntest::assert_stdstr("second", read_back());
+        ntest::assert_bool(false, std::filesystem::exists(core_test_path(scratch, "atomic.bin.tmp"), ec));
+
+        ntest::assert_bool(false, write_file_atomically(core_test_path(scratch, "missing/atomic.bin"), "x"));
+    }
+    #endif
+
+    std::filesystem::remove_all(scratch, ec);
+}
+catch (...) {
+    ntest::assert_bool(true, false);
+}
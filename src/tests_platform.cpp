@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ntest.hpp"
+#include "platform.hpp"
+
+static
+std::string platform_test_path(std::filesystem::path const &directory, char const *name) noexcept
+{
+    std::string path = (directory / name).string();
+    std::replace(path.begin(), path.end(), '/', PLATFORM_DIR_SEPARATOR);
+    return path;
+}
+
+static
+void platform_test_write_file(std::string const &path, char const *content) noexcept
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+static
+std::string platform_test_read_file(std::string const &path) noexcept
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void run_platform_tests(char const *scratch_directory_utf8) noexcept
+try {
+    std::filesystem::path scratch = scratch_directory_utf8;
+    std::error_code ec;
+    std::filesystem::remove_all(scratch, ec);
+    std::filesystem::create_directories(scratch, ec);
+
+    std::string const dir_path = platform_test_path(scratch, "dir");
+    std::string const file_a_path = platform_test_path(scratch, "a.txt");
+    std::string const file_b_path = platform_test_path(scratch, "B.txt");
+    std::string const file_c_path = platform_test_path(scratch, "c.txt");
+
+    //
+    {
+        ntest::assert_bool(true, platform_create_directory(dir_path.c_str()).ok());
+        ntest::assert_bool(false, platform_create_directory(dir_path.c_str()).ok());
+
+        platform_test_write_file(file_a_path, "hello");
+        platform_test_write_file(file_b_path, "world!");
+    }
+
+    // enumeration
+    {
+        platform_directory_enumerator enumerator;
+        ntest::assert_bool(true, enumerator.open(scratch.string().c_str()).ok());
+
+        std::vector<std::string> names = {};
+        u64 size_of_a = 0;
+        platform_file_kind kind_of_dir = platform_file_kind::nil;
+        platform_dirent entry;
+
+        while (enumerator.next(entry)) {
+            names.emplace_back(entry.name);
+            if (std::strcmp(entry.name, "a.txt") == 0) size_of_a = entry.info.size;
+            if (std::strcmp(entry.name, "dir") == 0) kind_of_dir = entry.info.kind;
+        }
+
+        std::sort(names.begin(), names.end(), [](std::string const &l, std::string const &r) noexcept {
+            return platform_compare_names(l.c_str(), r.c_str()) < 0;
+        });
+
+        ntest::assert_uint64(3, names.size());
+        ntest::assert_bool(true, names == std::vector<std::string>({ "a.txt", "B.txt", "dir" }));
+        ntest::assert_uint64(5, size_of_a);
+        ntest::assert_bool(true, kind_of_dir == platform_file_kind::directory);
+
+        platform_directory_enumerator missing;
+        ntest::assert_bool(false, missing.open(platform_test_path(scratch, "missing").c_str()).ok());
+        ntest::assert_bool(false, missing.next(entry));
+    }
+
+    // stat
+    {
+        platform_file_info info = {};
+
+        ntest::assert_bool(true, platform_stat(file_b_path.c_str(), info).ok());
+        ntest::assert_uint64(6, info.size);
+        ntest::assert_bool(true, info.kind == platform_file_kind::file);
+        ntest::assert_bool(true, info.last_write_time > 0);
+
+        ntest::assert_bool(true, platform_stat(dir_path.c_str(), info).ok());
+        ntest::assert_bool(true, info.kind == platform_file_kind::directory);
+
+        auto result = platform_stat(platform_test_path(scratch, "missing").c_str(), info);
+        ntest::assert_bool(false, result.ok());
+        ntest::assert_bool(false, platform_error_string(result.error_code).empty());
+    }
+
+    // rename never replaces, and keeps the file ID
+    {
+        u64 id_of_a = 0, id_of_b = 0, id_of_c = 0;
+        ntest::assert_bool(true, platform_file_id(file_a_path.c_str(), id_of_a).ok());
+        ntest::assert_bool(true, platform_file_id(file_b_path.c_str(), id_of_b).ok());
+        ntest::assert_bool(true, id_of_a != id_of_b);
+
+        ntest::assert_bool(false, platform_rename(file_a_path.c_str(), file_b_path.c_str()).ok());
+        ntest::assert_stdstr("world!", platform_test_read_file(file_b_path));
+
+        ntest::assert_bool(true, platform_rename(file_a_path.c_str(), file_c_path.c_str()).ok());
+        ntest::assert_stdstr("hello", platform_test_read_file(file_c_path));
+
+        ntest::assert_bool(true, platform_file_id(file_c_path.c_str(), id_of_c).ok());
+        ntest::assert_uint64(id_of_a, id_of_c);
+
+        platform_file_info info = {};
+        ntest::assert_bool(false, platform_stat(file_a_path.c_str(), info).ok());
+        ntest::assert_bool(false, platform_file_id(file_a_path.c_str(), id_of_a).ok());
+    }
+
+    // copy
+    {
+        ntest::assert_bool(false, platform_copy_file(file_c_path.c_str(), file_b_path.c_str(), false).ok());
+        ntest::assert_stdstr("world!", platform_test_read_file(file_b_path));
+
+        ntest::assert_bool(true, platform_copy_file(file_c_path.c_str(), file_b_path.c_str(), true).ok());
+        ntest::assert_stdstr("hello", platform_test_read_file(file_b_path));
+
+        ntest::assert_bool(true, platform_copy_file(file_c_path.c_str(), file_a_path.c_str(), false).ok());
+        ntest::assert_stdstr("hello", platform_test_read_file(file_a_path));
+
+        platform_file_info source = {}, copy = {};
+        platform_stat(file_c_path.c_str(), source);
+        platform_stat(file_a_path.c_str(), copy);
+        ntest::assert_uint64(source.last_write_time, copy.last_write_time);
+    }
+
+    // watch
+    {
+        platform_directory_watcher watcher;
+        ntest::assert_bool(true, watcher.watch(dir_path.c_str()).ok());
+        ntest::assert_bool(false, watcher.changed());
+
+        platform_test_write_file(platform_test_path(scratch / "dir", "new.txt"), "x");
+
+        ntest::assert_bool(true, watcher.changed());
+        ntest::assert_bool(false, watcher.changed());
+
+        watcher.stop();
+        ntest::assert_bool(false, watcher.changed());
+    }
+
+    // delete
+    {
+        ntest::assert_bool(false, platform_delete(dir_path.c_str()).ok()); // not empty
+        ntest::assert_bool(true, platform_delete(platform_test_path(scratch / "dir", "new.txt").c_str()).ok());
+        ntest::assert_bool(true, platform_delete(dir_path.c_str()).ok());
+        ntest::assert_bool(true, platform_delete(file_a_path.c_str()).ok());
+        ntest::assert_bool(false, platform_delete(file_a_path.c_str()).ok());
+    }
+
+    // collation
+    {
+        ntest::assert_bool(true, platform_compare_names("abc", "ABC") == 0);
+        ntest::assert_bool(true, platform_compare_names("abc", "ABD") < 0);
+        ntest::assert_bool(true, platform_compare_names("b.txt", "A.txt") > 0);
+
+        char const *haystack = "Swan File Explorer";
+        ntest::assert_cstr("File Explorer", platform_find_substring(haystack, "File", true));
+        ntest::assert_cstr(nullptr, platform_find_substring(haystack, "file", true));
+        ntest::assert_cstr("File Explorer", platform_find_substring(haystack, "file", false));
+        ntest::assert_cstr(nullptr, platform_find_substring(haystack, "files", false));
+    }
+
+    std::filesystem::remove_all(scratch, ec);
+}
+catch (...) {
+    ntest::assert_bool(true, false);
+}
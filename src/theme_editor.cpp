@@ -81,7 +81,7 @@ static void render_colors_tab_content(context ctx) noexcept
                 for (auto const &col_def : s_swan_colors) {
                     *col_def.data = col_def.get_default_data();
                 }
-                (void) global_state::settings().save_to_disk();
+                global_state::mark_dirty(persisted_file::settings);
             },
             /* confirmation_enabled = */ &(global_state::settings().confirm_theme_editor_color_reset)
         );
@@ -413,7 +413,7 @@ static void render_style_tab_content(context ctx) noexcept
                 (void) std::memcpy(&style, &fallback_style, sizeof(style));
                 (void) std::memcpy(&style.Colors, &colors, sizeof(style.Colors));
 
-                (void) global_state::settings().save_to_disk();
+                global_state::mark_dirty(persisted_file::settings);
             },
             /* confirmation_enabled = */ &(global_state::settings().confirm_theme_editor_style_reset)
         );
@@ -700,14 +700,14 @@ bool swan_windows::render_theme_editor(bool &open, ImGuiStyle const &fallback_st
     if (s_save_requested) {
         if (!s_last_save_time.has_value()) {
             // first save, don't wait
-            (void) global_state::settings().save_to_disk();
+            global_state::mark_dirty(persisted_file::settings);
             s_last_save_time = get_time_precise();
             s_save_requested = false;
         }
         else {
             s64 ms_since_last_save = time_diff_ms(s_last_save_time.value(), get_time_precise());
             if (ms_since_last_save >= 250) {
-                (void) global_state::settings().save_to_disk();
+                global_state::mark_dirty(persisted_file::settings);
                 s_last_save_time = get_time_precise();
                 s_save_requested = false;
             } else {
@@ -16,10 +16,38 @@ HRESULT undelete_directory_progress_sink::PreMoveItem(DWORD, IShellItem *, IShel
 HRESULT undelete_directory_progress_sink::PreNewItem(DWORD, IShellItem *, LPCWSTR)                noexcept { print_debug_msg("undelete_directory_progress_sink :: PreNewItem");    return S_OK; }
 HRESULT undelete_directory_progress_sink::PreRenameItem(DWORD, IShellItem *, LPCWSTR)             noexcept { print_debug_msg("undelete_directory_progress_sink :: PreRenameItem"); return S_OK; }
 
-HRESULT undelete_directory_progress_sink::PostMoveItem(DWORD, IShellItem *, IShellItem *, LPCWSTR, HRESULT, IShellItem *) noexcept { print_debug_msg("undelete_directory_progress_sink :: PostMoveItem");   return S_OK; }
 HRESULT undelete_directory_progress_sink::PostDeleteItem(DWORD, IShellItem *, HRESULT, IShellItem *)                      noexcept { print_debug_msg("undelete_directory_progress_sink :: PostDeleteItem"); return S_OK; }
 HRESULT undelete_directory_progress_sink::PostCopyItem(DWORD, IShellItem *, IShellItem *, LPCWSTR, HRESULT, IShellItem *) noexcept { print_debug_msg("undelete_directory_progress_sink :: PostCopyItem");   return S_OK; }
 
+HRESULT undelete_directory_progress_sink::PostMoveItem(DWORD, IShellItem *src_item, IShellItem *, LPCWSTR, HRESULT result, IShellItem *dst_item) noexcept
+{
+    print_debug_msg("undelete_directory_progress_sink :: PostMoveItem");
+
+    if (FAILED(result) || dst_item == nullptr) {
+        return S_OK;
+    }
+
+    wchar_t *src_path_utf16 = nullptr;
+    if (FAILED(src_item->GetDisplayName(SIGDN_FILESYSPATH, &src_path_utf16))) {
+        return S_OK;
+    }
+    SCOPE_EXIT { CoTaskMemFree(src_path_utf16); };
+
+    wchar_t *dst_path_utf16 = nullptr;
+    if (FAILED(dst_item->GetDisplayName(SIGDN_FILESYSPATH, &dst_path_utf16))) {
+        return S_OK;
+    }
+    SCOPE_EXIT { CoTaskMemFree(dst_path_utf16); };
+
+    swan_path src_path_utf8, dst_path_utf8;
+    if (utf16_to_utf8(src_path_utf16, src_path_utf8.data(), src_path_utf8.max_size()) && utf16_to_utf8(dst_path_utf16, dst_path_utf8.data(), dst_path_utf8.max_size())) {
+        // recent files inside the directory were remembered by their recycle bin path when it was deleted
+        this->num_recent_files_changed += global_state::recent_files_path_changed(src_path_utf8.data(), dst_path_utf8.data(), true, nullptr);
+    }
+
+    return S_OK;
+}
+
 HRESULT undelete_directory_progress_sink::UpdateProgress(UINT work_total, UINT work_so_far) noexcept
 {
     print_debug_msg("undelete_directory_progress_sink :: UpdateProgress %zu/%zu", work_so_far, work_total);
@@ -48,10 +76,16 @@ HRESULT undelete_directory_progress_sink::FinishOperations(HRESULT) noexcept
 
         if (found != completed_file_operations.container->end()) {
             found->undo_time = get_time_system();
-            (void) global_state::completed_file_operations_save_to_disk(&lock);
+            global_state::mark_dirty(persisted_file::completed_file_operations);
         }
     }
 
+    if (this->num_recent_files_changed > 0) {
+        global_state::mark_dirty(persisted_file::recent_files);
+    }
+
+    global_state::wake_render_loop();
+
     return S_OK;
 }
 
@@ -1,8 +1,23 @@
-#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#   define NOMINMAX
+#   include <windows.h>
+#   include <shlobj.h>
+#else
+#   include <fcntl.h>
+#   include <time.h>
+#   include <unistd.h>
+#endif
 
-#include "stdafx.hpp"
-#include "util.hpp"
-#include "imgui_dependent_functions.hpp"
+#include "core.hpp"
+#if !SWAN_HEADLESS
+#   include "imgui_dependent_functions.hpp"
+#endif
 
 static u64 g_fast_rand_seed = {};
 void seed_fast_rand(u64 v) noexcept
@@ -42,6 +57,7 @@ u64 two_u32_to_one_u64(u32 low, u32 high) noexcept
     return result;
 }
 
+#if defined(_WIN32)
 s32 directory_exists(char const *path_utf8) noexcept
 {
     wchar_t path_utf16[MAX_PATH];
@@ -51,6 +67,76 @@ s32 directory_exists(char const *path_utf8) noexcept
     DWORD attributes = GetFileAttributesW(path_utf16);
     return (attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY));
 }
+#endif
+
+bool write_file_atomically(std::filesystem::path const &full_path, std::string_view content) noexcept
+try {
+    std::filesystem::path temp_path = full_path;
+    temp_path += ".tmp";
+
+#if defined(_WIN32)
+    HANDLE handle = CreateFileW(temp_path.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (handle == INVALID_HANDLE_VALUE) {
+        print_debug_msg("FAILED CreateFileW: %s", platform_error_string(s32(GetLastError())).c_str());
+        return false;
+    }
+
+    DWORD num_written = 0;
+    BOOL written = WriteFile(handle, content.data(), DWORD(content.size()), &num_written, NULL) && num_written == content.size();
+    CloseHandle(handle);
+
+    if (!written) {
+        print_debug_msg("FAILED WriteFile: %s", platform_error_string(s32(GetLastError())).c_str());
+        return false;
+    }
+
+    if (!MoveFileExW(temp_path.c_str(), full_path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        print_debug_msg("FAILED MoveFileExW: %s", platform_error_string(s32(GetLastError())).c_str());
+        return false;
+    }
+#else
+    s32 fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+    if (fd == -1) {
+        print_debug_msg("FAILED open: %s", platform_error_string(errno).c_str());
+        return false;
+    }
+
+    u64 num_written = 0;
+    while (num_written < content.size()) {
+        ssize_t written = write(fd, content.data() + num_written, content.size() - num_written);
+        if (written <= 0) {
+            break;
+        }
+        num_written += u64(written);
+    }
+    // fsync stands in for MOVEFILE_WRITE_THROUGH, the content must be on disk before the rename can be
+    bool written = num_written == content.size() && fsync(fd) == 0;
+    close(fd);
+
+    if (!written) {
+        print_debug_msg("FAILED write: %s", platform_error_string(errno).c_str());
+        return false;
+    }
+
+    // unlike platform_rename, replaces `full_path` if it exists
+    if (rename(temp_path.c_str(), full_path.c_str()) != 0) {
+        print_debug_msg("FAILED rename: %s", platform_error_string(errno).c_str());
+        return false;
+    }
+#endif
+
+    return true;
+}
+catch (std::exception const &except) {
+    print_debug_msg("FAILED catch(std::exception) %s", except.what());
+    return false;
+}
+catch (...) {
+    print_debug_msg("FAILED catch(...)");
+    return false;
+}
 
 std::array<char, 32> format_file_size(u64 file_size, u64 unit_multiplier) noexcept
 {
@@ -104,7 +190,7 @@ s64 time_diff_us(time_point_precise_t start, time_point_precise_t end) noexcept
 
 time_point_precise_t get_time_precise() noexcept
 {
-    return std::chrono::high_resolution_clock::now();
+    return std::chrono::steady_clock::now();
 }
 
 time_point_system_t get_time_system() noexcept
@@ -182,6 +268,52 @@ std::array<char, 64> time_diff_str(time_point_system_t start, time_point_system_
     return out;
 }
 
+f64 process_uptime_ms() noexcept
+{
+#if defined(_WIN32)
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+
+    if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+        return -1;
+    }
+
+    FILETIME now;
+    GetSystemTimePreciseAsFileTime(&now);
+
+    u64 created = two_u32_to_one_u64(creation_time.dwLowDateTime, creation_time.dwHighDateTime);
+    u64 elapsed = two_u32_to_one_u64(now.dwLowDateTime, now.dwHighDateTime) - created;
+
+    return f64(elapsed) / 10'000.0; // FILETIME ticks are 100ns
+#else
+    return -1; // no portable query for the creation time of this process
+#endif
+}
+
+f64 process_cpu_time_ms() noexcept
+{
+#if defined(_WIN32)
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+
+    if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+        return -1;
+    }
+
+    u64 kernel = two_u32_to_one_u64(kernel_time.dwLowDateTime, kernel_time.dwHighDateTime);
+    u64 user = two_u32_to_one_u64(user_time.dwLowDateTime, user_time.dwHighDateTime);
+
+    return f64(kernel + user) / 10'000.0;
+#else
+    timespec ts;
+
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0) {
+        return -1;
+    }
+
+    return (f64(ts.tv_sec) * 1'000.0) + (f64(ts.tv_nsec) / 1'000'000.0);
+#endif
+}
+
+#if defined(_WIN32)
 s32 utf8_to_utf16(char const *utf8_text, wchar_t *utf16_text, u64 utf16_text_capacity, std::source_location sloc) noexcept
 {
     assert(utf8_text != nullptr);
@@ -191,8 +323,8 @@ s32 utf8_to_utf16(char const *utf8_text, wchar_t *utf16_text, u64 utf16_text_cap
     s32 chars_written = MultiByteToWideChar(CP_UTF8, 0, utf8_text, -1, utf16_text, (s32)utf16_text_capacity);
 
     if (chars_written == 0) {
-        auto last_error = get_last_winapi_error();
-        print_debug_msg({ "FAILED utf8_to_utf16: %d %s", sloc }, last_error.code, last_error.formatted_message.c_str());
+        DWORD last_error = GetLastError();
+        print_debug_msg({ "FAILED utf8_to_utf16: %d %s", sloc }, last_error, platform_error_string(last_error).c_str());
     }
 
     return chars_written;
@@ -207,12 +339,13 @@ s32 utf16_to_utf8(wchar_t const *utf16_text, char *utf8_text, u64 utf8_text_capa
     s32 chars_written = WideCharToMultiByte(CP_UTF8, 0, utf16_text, -1, utf8_text, (s32)utf8_text_capacity, "!", nullptr);
 
     if (chars_written == 0) {
-        auto last_error = get_last_winapi_error();
-        print_debug_msg({ "FAILED utf16_to_utf8: %d %s", sloc }, last_error.code, last_error.formatted_message.c_str());
+        DWORD last_error = GetLastError();
+        print_debug_msg({ "FAILED utf16_to_utf8: %d %s", sloc }, last_error, platform_error_string(last_error).c_str());
     }
 
     return chars_written;
 }
+#endif
 
 bool cstr_eq(char const *s1, char const *s2) noexcept
 {
@@ -496,12 +629,40 @@ void cstr_clear(wchar_t *s) noexcept
     s[0] = L'\0';
 }
 
+#if defined(_WIN32)
 bool set_thread_priority(s32 priority_relative_to_normal) noexcept
 {
     HANDLE handle = GetCurrentThread();
     auto result = SetThreadPriority(handle, priority_relative_to_normal);
     return result;
 }
+#endif
+
+u64 parallel_worker_count(u64 max_useful) noexcept
+{
+    u64 num_cores = std::max(u64(std::thread::hardware_concurrency()), u64(1));
+    return std::clamp(std::min(num_cores, u64(8)), u64(1), std::max(max_useful, u64(1)));
+}
+
+u64 run_parallel_workers(u64 num_workers, std::function<void (u64 worker_idx)> const &work) noexcept
+{
+    std::vector<std::jthread> helpers = {};
+
+    try {
+        helpers.reserve(num_workers > 0 ? num_workers - 1 : 0);
+
+        for (u64 i = 1; i < num_workers; ++i) {
+            helpers.emplace_back(work, i);
+        }
+    }
+    catch (...) {
+        print_debug_msg("FAILED to spawn worker thread, continuing with %zu", helpers.size() + 1);
+    }
+
+    work(0);
+
+    return helpers.size() + 1; // helpers join as they go out of scope
+}
 
 char const *cstr_ltrim(char const *s, std::initializer_list<char> const &chars) noexcept
 {
@@ -582,13 +743,18 @@ build_mode get_build_mode() noexcept
     return retval;
 }
 
-std::pair<s32, std::array<char, 64>> filetime_to_string(FILETIME *time) noexcept
+#if defined(_WIN32)
+std::pair<s32, std::array<char, 64>> filetime_to_string(u64 filetime) noexcept
 {
+    FILETIME time;
+    time.dwLowDateTime = u32(filetime);
+    time.dwHighDateTime = u32(filetime >> 32);
+
     std::array<char, 64> buffer_raw;
     std::array<char, 64> buffer_final;
 
     DWORD flags = FDTF_SHORTDATE | FDTF_SHORTTIME;
-    s32 length = SHFormatDateTimeA(time, &flags, buffer_raw.data(), (u32)buffer_raw.size());
+    s32 length = SHFormatDateTimeA(&time, &flags, buffer_raw.data(), (u32)buffer_raw.size());
 
     // for some reason, SHFormatDateTimeA will pad parts of the string with ASCII 63 (?)
     // when using LONGDATE or LONGTIME, we are discarding them
@@ -598,6 +764,7 @@ std::pair<s32, std::array<char, 64>> filetime_to_string(FILETIME *time) noexcept
 
     return { length, buffer_final };
 }
+#endif
 
 bool cstr_starts_with(char const *str, char const *prefix) noexcept
 {
@@ -637,17 +804,154 @@ void cstr_fill(wchar_t *s, wchar_t fill_ch) noexcept
     }
 }
 
+namespace xxh64_detail
+{
+    constexpr u64 prime_1 = 0x9E3779B185EBCA87ull;
+    constexpr u64 prime_2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr u64 prime_3 = 0x165667B19E3779F9ull;
+    constexpr u64 prime_4 = 0x85EBCA77C2B2AE63ull;
+    constexpr u64 prime_5 = 0x27D4EB2F165667C5ull;
+
+    static inline u64 rotl(u64 x, u32 r) noexcept { return (x << r) | (x >> (64 - r)); }
+
+    static inline u64 read_u64(u8 const *p) noexcept { u64 v; memcpy(&v, p, sizeof(v)); return v; }
+    static inline u32 read_u32(u8 const *p) noexcept { u32 v; memcpy(&v, p, sizeof(v)); return v; }
+
+    static inline u64 mix_round(u64 acc, u64 input) noexcept
+    {
+        acc += input * prime_2;
+        acc = rotl(acc, 31);
+        acc *= prime_1;
+        return acc;
+    }
+
+    static inline u64 merge_round(u64 acc, u64 val) noexcept
+    {
+        acc ^= mix_round(0, val);
+        acc = acc * prime_1 + prime_4;
+        return acc;
+    }
+}
+
+void xxh64_reset(xxh64_state &state, u64 seed) noexcept
+{
+    using namespace xxh64_detail;
+
+    state.total_len = 0;
+    state.v[0] = seed + prime_1 + prime_2;
+    state.v[1] = seed + prime_2;
+    state.v[2] = seed;
+    state.v[3] = seed - prime_1;
+    state.buffer_len = 0;
+    state.seed = seed;
+}
+
+void xxh64_update(xxh64_state &state, void const *data, u64 len) noexcept
+{
+    using namespace xxh64_detail;
+
+    u8 const *p = static_cast<u8 const *>(data);
+    u8 const *end = p + len;
+
+    state.total_len += len;
+
+    if (state.buffer_len + len < 32) {
+        memcpy(state.buffer + state.buffer_len, p, len);
+        state.buffer_len += u32(len);
+        return;
+    }
+
+    if (state.buffer_len > 0) {
+        u32 fill = 32 - state.buffer_len;
+        memcpy(state.buffer + state.buffer_len, p, fill);
+        p += fill;
+        state.v[0] = mix_round(state.v[0], read_u64(state.buffer +  0));
+        state.v[1] = mix_round(state.v[1], read_u64(state.buffer +  8));
+        state.v[2] = mix_round(state.v[2], read_u64(state.buffer + 16));
+        state.v[3] = mix_round(state.v[3], read_u64(state.buffer + 24));
+        state.buffer_len = 0;
+    }
+
+    while (end - p >= 32) {
+        state.v[0] = mix_round(state.v[0], read_u64(p +  0));
+        state.v[1] = mix_round(state.v[1], read_u64(p +  8));
+        state.v[2] = mix_round(state.v[2], read_u64(p + 16));
+        state.v[3] = mix_round(state.v[3], read_u64(p + 24));
+        p += 32;
+    }
+
+    if (p < end) {
+        memcpy(state.buffer, p, u64(end - p));
+        state.buffer_len = u32(end - p);
+    }
+}
+
+u64 xxh64_digest(xxh64_state const &state) noexcept
+{
+    using namespace xxh64_detail;
+
+    u64 h = 0;
+
+    if (state.total_len >= 32) {
+        h = rotl(state.v[0], 1) + rotl(state.v[1], 7) + rotl(state.v[2], 12) + rotl(state.v[3], 18);
+        h = merge_round(h, state.v[0]);
+        h = merge_round(h, state.v[1]);
+        h = merge_round(h, state.v[2]);
+        h = merge_round(h, state.v[3]);
+    } else {
+        h = state.seed + prime_5;
+    }
+
+    h += state.total_len;
+
+    u8 const *p = state.buffer;
+    u8 const *end = state.buffer + state.buffer_len;
+
+    while (end - p >= 8) {
+        h ^= mix_round(0, read_u64(p));
+        h = rotl(h, 27) * prime_1 + prime_4;
+        p += 8;
+    }
+    if (end - p >= 4) {
+        h ^= u64(read_u32(p)) * prime_1;
+        h = rotl(h, 23) * prime_2 + prime_3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= u64(*p) * prime_5;
+        h = rotl(h, 11) * prime_1;
+        ++p;
+    }
+
+    h ^= h >> 33;
+    h *= prime_2;
+    h ^= h >> 29;
+    h *= prime_3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+u64 xxh64(void const *data, u64 len, u64 seed) noexcept
+{
+    xxh64_state state;
+    xxh64_reset(state, seed);
+    xxh64_update(state, data, len);
+    return xxh64_digest(state);
+}
+
+#if defined(_WIN32)
 std::optional<bool> win32_is_mouse_inside_window(HWND hwnd) noexcept
 {
     POINT cp;
     if (!GetCursorPos(&cp)) {
-        print_debug_msg("FAILED GetCursorPos: %s", get_last_winapi_error().formatted_message.c_str());
+        print_debug_msg("FAILED GetCursorPos: %s", platform_error_string(GetLastError()).c_str());
         return std::nullopt;
     }
 
     RECT wr;
     if (!GetWindowRect(hwnd, &wr)) {
-        print_debug_msg("FAILED GetWindowRect: %s", get_last_winapi_error().formatted_message.c_str());
+        print_debug_msg("FAILED GetWindowRect: %s", platform_error_string(GetLastError()).c_str());
         return std::nullopt;
     }
 
@@ -679,14 +983,17 @@ std::optional<bool> win32_is_mouse_inside_window(HWND hwnd) noexcept
 
     return result;
 }
+#endif
 
 bool path_drive_like(char const *path, u64 len) noexcept
 {
     if (len == 0) len = strlen(path);
-    return (len == 2 && IsCharAlphaA(path[0]) && path[1] == ':')
-        || (len == 3 && IsCharAlphaA(path[0]) && path[1] == ':' && strchr("\\/", path[2]));
+    auto is_drive_letter = [](char ch) noexcept { return (ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z'); };
+    return (len == 2 && is_drive_letter(path[0]) && path[1] == ':')
+        || (len == 3 && is_drive_letter(path[0]) && path[1] == ':' && strchr("\\/", path[2]));
 }
 
+#if defined(_WIN32)
 std::pair<bool, std::string> utf8_lowercase(char const *utf8_text) noexcept
 {
     // Step 1: Convert UTF-8 to UTF-16
@@ -718,3 +1025,4 @@ std::pair<bool, std::string> utf8_lowercase(char const *utf8_text) noexcept
 
     return { true, std::string(utf8_chars_lower.data()) };
 }
+#endif
@@ -1,6 +1,24 @@
 #pragma once
 
-#include "stdafx.hpp"
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <functional>
+#include <initializer_list>
+#include <istream>
+#include <optional>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "primitives.hpp"
+
+#if defined(_WIN32)
+    typedef struct HWND__ *HWND; // as declared by <windows.h>, which this header leaves out
+#endif
 
 #if defined(NDEBUG)
 #   define DEBUG_MODE 0
@@ -17,8 +35,8 @@
 #endif
 
 // TIME RELATED TYPES AND FUNCTIONS
-
-    typedef std::chrono::high_resolution_clock::time_point time_point_precise_t;
+    // MSVC's high_resolution_clock is steady_clock, libstdc++'s is system_clock which would collide with the overloads below
+    typedef std::chrono::steady_clock::time_point time_point_precise_t;
     typedef std::chrono::system_clock::time_point time_point_system_t;
 
     time_point_precise_t get_time_precise() noexcept;
@@ -31,6 +49,12 @@
     std::array<char, 64> time_diff_str(time_point_precise_t start, time_point_precise_t end) noexcept;
     std::array<char, 64> time_diff_str(time_point_system_t start, time_point_system_t end) noexcept;
 
+    /// Milliseconds since the OS created this process, or -1 if that can't be queried.
+    f64 process_uptime_ms() noexcept;
+
+    /// Milliseconds of CPU time, user and kernel, consumed by all threads of this process so far, or -1 if that can't be queried.
+    f64 process_cpu_time_ms() noexcept;
+
 /// MISCELLANEOUS FUNCTIONS AND TYPES
 
     /// Toggle bool state.
@@ -51,13 +75,25 @@
     /// Return `true` at a chance of (1 / probability_fraction).
     bool chance(f64 probability_fraction) noexcept;
 
+#if defined(_WIN32)
     bool set_thread_priority(s32 priority_relative_to_normal) noexcept;
+#endif
+
+    /// Threads for a parallel filesystem job of at most `max_useful` independent pieces: one per core, at most 8 as more mostly queue up in the filesystem.
+    u64 parallel_worker_count(u64 max_useful = u64(-1)) noexcept;
+
+    /// Calls `work(worker_idx)` for every worker_idx in [0, num_workers), worker 0 on this thread and the rest on threads of their own,
+    /// and returns once all have returned. This thread does its share, so the job completes even if no helper could be spawned,
+    /// hence `work` must not rely on every worker running. Returns how many did.
+    u64 run_parallel_workers(u64 num_workers, std::function<void (u64 worker_idx)> const &work) noexcept;
 
+#if defined(_WIN32)
     s32 utf8_to_utf16(char const *utf8_text, wchar_t *utf16_text, u64 utf16_text_capacity, std::source_location sloc = std::source_location::current()) noexcept;
 
     s32 utf16_to_utf8(wchar_t const *utf16_text, char *utf8_text, u64 utf8_text_capacity, std::source_location sloc = std::source_location::current()) noexcept;
 
     std::pair<bool, std::string> utf8_lowercase(char const *utf8_text) noexcept;
+#endif
 
     struct build_mode
     {
@@ -70,15 +106,35 @@
 
     std::string make_str(char const *fmt, ...) noexcept;
 
+#if defined(_WIN32)
     std::optional<bool> win32_is_mouse_inside_window(HWND hwnd) noexcept;
+#endif
+
+    /// Streaming state for XXH64, a fast non-cryptographic 64-bit hash. Feed bytes with `xxh64_update` in chunks of any size,
+    /// the digest is identical to hashing all bytes in one go with `xxh64`.
+    struct xxh64_state
+    {
+        u64 total_len;
+        u64 v[4];
+        u8 buffer[32];
+        u32 buffer_len;
+        u64 seed;
+    };
+
+    void xxh64_reset(xxh64_state &state, u64 seed = 0) noexcept;
+    void xxh64_update(xxh64_state &state, void const *data, u64 len) noexcept;
+    u64 xxh64_digest(xxh64_state const &state) noexcept;
+    u64 xxh64(void const *data, u64 len, u64 seed = 0) noexcept;
 
 // FILESYSTEM RELATED FUNCTIONS
 
+#if defined(_WIN32)
     /// Returns truthy int if `path_utf8` is a valid directory. Accepts Unicode characters. Performs UTF8 to UTF16 conversion. Expensive function, don't call it often.
     s32 directory_exists(char const *path_utf8) noexcept;
 
-    /// Formats a FILETIME into a buffer. Returns length in `.first` and the formatted buffer in `.second`.
-    std::pair<s32, std::array<char, 64>> filetime_to_string(FILETIME *time) noexcept;
+    /// Formats a FILETIME, given as its 100ns tick count (`platform_file_time`), into a buffer. Returns length in `.first` and the formatted buffer in `.second`.
+    std::pair<s32, std::array<char, 64>> filetime_to_string(u64 filetime) noexcept;
+#endif
     std::array<char, 32> format_file_size(u64 file_size, u64 unit_multiplier) noexcept;
     void format_file_size(u64 file_size, char *out, u64 out_size, u64 unit_multiplier) noexcept;
     wchar_t const *windows_illegal_filename_chars() noexcept;